@@ -1,6 +1,7 @@
 #include "plugin.hpp"
 #include "widgets/Knobs.hpp"
 #include "widgets/PanelTheme.hpp"
+#include "EnvelopeDSP.hpp"
 
 struct EnhancedTextLabel : TransparentWidget {
     std::string text;
@@ -304,25 +305,26 @@ struct ADGenerator : Module {
     float bpfCutoffs[3] = {200.0f, 1000.0f, 5000.0f};
     float bpfGains[3] = {3.0f, 3.0f, 3.0f};
     
+    // 每個軌道最多 16 聲部，以 float_4 為一組處理
+    static constexpr int MAX_POLY = 16;
+    static constexpr int MAX_GROUPS = MAX_POLY / 4;
+
+    /**
+     * 4 聲部 SVF 帶通（Q = 1），係數只在截止頻率或取樣率改變時重算
+     */
     struct BandPassFilter {
-        float ic1eq = 0.0f;
-        float ic2eq = 0.0f;
+        simd::float_4 ic1eq = 0.0f;
+        simd::float_4 ic2eq = 0.0f;
 
         void reset() {
             ic1eq = 0.0f;
             ic2eq = 0.0f;
         }
 
-        float process(float input, float cutoff, float sampleRate) {
-            float g = std::tan(M_PI * clamp(cutoff, 20.0f, sampleRate * 0.49f) / sampleRate);
-            float k = 1.0f; // Q = 1.0
-            float a1 = 1.0f / (1.0f + g * (g + k));
-            float a2 = g * a1;
-            float a3 = g * a2;
-
-            float v3 = input - ic2eq;
-            float v1 = a1 * ic1eq + a2 * v3;
-            float v2 = ic2eq + a2 * ic1eq + a3 * v3;
+        simd::float_4 process(simd::float_4 input, float a1, float a2, float a3) {
+            simd::float_4 v3 = input - ic2eq;
+            simd::float_4 v1 = a1 * ic1eq + a2 * v3;
+            simd::float_4 v2 = ic2eq + a2 * ic1eq + a3 * v3;
 
             ic1eq = 2.0f * v1 - ic1eq;
             ic2eq = 2.0f * v2 - ic2eq;
@@ -331,208 +333,34 @@ struct ADGenerator : Module {
             return v1;
         }
     };
-    
-    BandPassFilter bpfFilters[3];
-
-    struct ADEnvelope {
-        enum Phase {
-            IDLE,
-            ATTACK,
-            DECAY
-        };
-        
-        Phase phase = IDLE;
-        float triggerOutput = 0.0f;
-        float followerOutput = 0.0f;
-        float attackTime = 0.01f;
-        float decayTime = 1.0f;
-        float phaseTime = 0.0f;
-        float curve = 0.0f;
-        float followerState = 0.0f;
-        float attackCoeff = 0.0f;
-        float releaseCoeff = 0.0f;
-        
-        dsp::SchmittTrigger trigger;
-        
-        Phase oldPhase = IDLE;
-        float oldOutput = 0.0f;
-        float oldAttackTime = 0.01f;
-        float oldDecayTime = 1.0f;
-        float oldPhaseTime = 0.0f;
-        float oldCurve = 0.0f;
-        dsp::SchmittTrigger oldTrigger;
-        
-        void reset() {
-            phase = IDLE;
-            triggerOutput = 0.0f;
-            followerOutput = 0.0f;
-            followerState = 0.0f;
-            phaseTime = 0.0f;
-            oldPhase = IDLE;
-            oldOutput = 0.0f;
-            oldPhaseTime = 0.0f;
-        }
-        
-        float applyCurve(float x, float curvature) {
-            x = clamp(x, 0.0f, 1.0f);
-            
-            if (curvature == 0.0f) {
-                return x;
-            }
-            
-            float k = curvature;
-            float abs_x = std::abs(x);
-            float denominator = k - 2.0f * k * abs_x + 1.0f;
-            
-            if (std::abs(denominator) < 1e-6f) {
-                return x;
-            }
-            
-            return (x - k * x) / denominator;
-        }
-        
-        float processEnvelopeFollower(float triggerVoltage, float sampleTime, float attackTime, float releaseTime, float curve) {
-            attackCoeff = 1.0f - std::exp(-sampleTime / std::max(0.0005f, attackTime * 0.1f));
-            releaseCoeff = 1.0f - std::exp(-sampleTime / std::max(0.001f, releaseTime * 0.5f));
-            
-            attackCoeff = clamp(attackCoeff, 0.0f, 1.0f);
-            releaseCoeff = clamp(releaseCoeff, 0.0f, 1.0f);
-            
-            float rectified = std::abs(triggerVoltage) / 10.0f;
-            rectified = clamp(rectified, 0.0f, 1.0f);
-            
-            float targetCoeff;
-            if (rectified > followerState) {
-                float progress = attackCoeff;
-                targetCoeff = applyCurve(progress, curve);
-            } else {
-                float progress = releaseCoeff;
-                targetCoeff = applyCurve(progress, curve);
-            }
-            
-            targetCoeff = clamp(targetCoeff, 0.0f, 1.0f);
-            
-            followerState += (rectified - followerState) * targetCoeff;
-            followerState = clamp(followerState, 0.0f, 1.0f);
-            
-            return followerState;
-        }
-        
-        float processTriggerEnvelope(float triggerVoltage, float sampleTime, float attack, float decay, float curve) {
-            bool isHighVoltage = (std::abs(triggerVoltage) > 9.5f);
-            
-            if (phase == IDLE && isHighVoltage && trigger.process(triggerVoltage)) {
-                phase = ATTACK;
-                phaseTime = 0.0f;
-            }
-            
-            switch (phase) {
-                case IDLE:
-                    triggerOutput = 0.0f;
-                    break;
-                    
-                case ATTACK:
-                    phaseTime += sampleTime;
-                    if (phaseTime >= attack) {
-                        phase = DECAY;
-                        phaseTime = 0.0f;
-                        triggerOutput = 1.0f;
-                    } else {
-                        float t = phaseTime / attack;
-                        triggerOutput = applyCurve(t, curve);
-                    }
-                    break;
-                    
-                case DECAY:
-                    phaseTime += sampleTime;
-                    if (phaseTime >= decay) {
-                        triggerOutput = 0.0f;
-                        phase = IDLE;
-                        phaseTime = 0.0f;
-                    } else {
-                        float t = phaseTime / decay;
-                        triggerOutput = 1.0f - applyCurve(t, curve);
-                    }
-                    break;
-            }
-            
-            return clamp(triggerOutput, 0.0f, 1.0f);
-        }
-        
-        float processOldVersion(float sampleTime, float triggerVoltage, float attack, float decay, float curveParam, float atkAll, float decAll) {
-            float atkOffset = atkAll * 0.5f;
-            float decOffset = decAll * 0.5f;
-            
-            oldAttackTime = std::pow(10.0f, (attack - 0.5f) * 6.0f) + atkOffset;
-            oldDecayTime = std::pow(10.0f, (decay - 0.5f) * 6.0f) + decOffset;
-            
-            oldAttackTime = std::max(0.001f, oldAttackTime);
-            oldDecayTime = std::max(0.001f, oldDecayTime);
-            
-            oldCurve = curveParam;
-            
-            if (oldPhase == IDLE && oldTrigger.process(triggerVoltage)) {
-                oldPhase = ATTACK;
-                oldPhaseTime = 0.0f;
-            }
-            
-            switch (oldPhase) {
-                case IDLE:
-                    oldOutput = 0.0f;
-                    break;
-                    
-                case ATTACK:
-                    oldPhaseTime += sampleTime;
-                    if (oldPhaseTime >= oldAttackTime) {
-                        oldPhase = DECAY;
-                        oldPhaseTime = 0.0f;
-                        oldOutput = 1.0f;
-                    } else {
-                        float t = oldPhaseTime / oldAttackTime;
-                        oldOutput = applyCurve(t, oldCurve);
-                    }
-                    break;
-                    
-                case DECAY:
-                    oldPhaseTime += sampleTime;
-                    if (oldPhaseTime >= oldDecayTime) {
-                        oldOutput = 0.0f;
-                        oldPhase = IDLE;
-                        oldPhaseTime = 0.0f;
-                    } else {
-                        float t = oldPhaseTime / oldDecayTime;
-                        oldOutput = 1.0f - applyCurve(t, oldCurve);
-                    }
-                    break;
-            }
-            
-            oldOutput = clamp(oldOutput, 0.0f, 1.0f);
-            return oldOutput * 10.0f;
-        }
-        
-        float process(float sampleTime, float triggerVoltage, float attack, float decay, float curveParam, float atkAll, float decAll, bool useBPF) {
-            if (!useBPF) {
-                return processOldVersion(sampleTime, triggerVoltage, attack, decay, curveParam, atkAll, decAll);
-            } else {
-                float atkOffset = atkAll * 0.5f;
-                float decOffset = decAll * 0.5f;
-
-                attackTime = std::pow(10.0f, (attack - 0.5f) * 6.0f) + atkOffset;
-                decayTime = std::pow(10.0f, (decay - 0.5f) * 6.0f) + decOffset;
 
-                attackTime = std::max(0.001f, attackTime);
-                decayTime = std::max(0.001f, decayTime);
+    struct BandPassCoeffs {
+        float a1 = 0.0f, a2 = 0.0f, a3 = 0.0f;
+        float lastCutoff = -1.0f;
+        float lastSampleRate = 0.0f;
 
-                curve = curveParam;
+        void update(float cutoff, float sampleRate) {
+            if (cutoff == lastCutoff && sampleRate == lastSampleRate) return;
+            lastCutoff = cutoff;
+            lastSampleRate = sampleRate;
 
-                float output = processEnvelopeFollower(triggerVoltage, sampleTime, attackTime, decayTime, curve);
-
-                return output * 10.0f;
-            }
+            float g = std::tan(M_PI * clamp(cutoff, 20.0f, sampleRate * 0.49f) / sampleRate);
+            float k = 1.0f; // Q = 1.0
+            a1 = 1.0f / (1.0f + g * (g + k));
+            a2 = g * a1;
+            a3 = g * a2;
         }
     };
-    
-    ADEnvelope envelopes[3];
+
+    BandPassFilter bpfFilters[3][MAX_GROUPS];
+    BandPassCoeffs bpfCoeffs[3];
+
+    // 觸發包絡（BPF 關閉）與包絡跟隨器（BPF 開啟）
+    ADEnvelopeBank envelopes[3][MAX_GROUPS];
+    EnvelopeFollowerBank followers[3][MAX_GROUPS];
+    dsp::TSchmittTrigger<simd::float_4> triggers[3][MAX_GROUPS];
+    ADEnvelopeTimes envelopeTimes[3];
+    EnvelopeFollowerCoeffs followerCoeffs[3];
 
     ADGenerator() {
         config(PARAMS_LEN, INPUTS_LEN, OUTPUTS_LEN, LIGHTS_LEN);
@@ -579,8 +407,12 @@ struct ADGenerator : Module {
 
     void onReset() override {
         for (int i = 0; i < 3; ++i) {
-            envelopes[i].reset();
-            bpfFilters[i].reset();
+            for (int g = 0; g < MAX_GROUPS; ++g) {
+                envelopes[i][g].reset();
+                followers[i][g].reset();
+                bpfFilters[i][g].reset();
+                triggers[i][g].reset();
+            }
         }
     }
 
@@ -658,7 +490,8 @@ struct ADGenerator : Module {
     }
 
     void process(const ProcessArgs& args) override {
-        float sumOutput = 0.0f;
+        using simd::float_4;
+
         float atkAll = params[ATK_ALL_PARAM].getValue();
         float decAll = params[DEC_ALL_PARAM].getValue();
         
@@ -670,42 +503,55 @@ struct ADGenerator : Module {
             bpfGains[i] = params[TRACK1_BPF_GAIN_PARAM + i * 6].getValue();
         }
         
-        float inputSignals[3];
-        
-        if (autoRouteEnabled) {
-            float input1Signal = inputs[TRACK1_TRIG_INPUT].getVoltage();
-            inputSignals[0] = input1Signal;
-            inputSignals[1] = input1Signal;
-            inputSignals[2] = input1Signal;
-        } else {
-            inputSignals[0] = inputs[TRACK1_TRIG_INPUT].getVoltage();
-            inputSignals[1] = inputs[TRACK2_TRIG_INPUT].getVoltage();
-            inputSignals[2] = inputs[TRACK3_TRIG_INPUT].getVoltage();
-        }
+        alignas(16) float sumOutput[MAX_POLY] = {};
+        int sumChannels = 1;
         
         for (int i = 0; i < 3; ++i) {
-            float processedSignal = inputSignals[i];
-            if (bpfEnabled[i]) {
-                processedSignal = bpfFilters[i].process(inputSignals[i], bpfCutoffs[i], args.sampleRate);
-            }
+            Input& input = inputs[autoRouteEnabled ? TRACK1_TRIG_INPUT : TRACK1_TRIG_INPUT + i];
+            int channels = std::max(1, input.getChannels());
+            sumChannels = std::max(sumChannels, channels);
             
             float attackParam = params[TRACK1_ATTACK_PARAM + i * 6].getValue();
             float decayParam = params[TRACK1_DECAY_PARAM + i * 6].getValue();
             float curveParam = params[TRACK1_CURVE_PARAM + i * 6].getValue();
             
-            float envelopeOutput = envelopes[i].process(args.sampleTime, processedSignal, attackParam, decayParam, curveParam, atkAll, decAll, bpfEnabled[i]);
-            
+            envelopeTimes[i].update(attackParam, decayParam, atkAll * 0.5f, decAll * 0.5f);
             if (bpfEnabled[i]) {
-                envelopeOutput *= bpfGains[i];
+                bpfCoeffs[i].update(bpfCutoffs[i], args.sampleRate);
+                followerCoeffs[i].update(args.sampleTime, envelopeTimes[i].attackTime,
+                                         envelopeTimes[i].decayTime, curveParam);
             }
             
-            outputs[TRACK1_OUTPUT + i].setVoltage(envelopeOutput);
-            
-            sumOutput += envelopeOutput * 0.33f;
+            Output& output = outputs[TRACK1_OUTPUT + i];
+            for (int c = 0; c < channels; c += 4) {
+                int g = c / 4;
+                float_4 inputSignal = input.getPolyVoltageSimd<float_4>(c);
+                float_4 envelopeOutput;
+                
+                if (bpfEnabled[i]) {
+                    const BandPassCoeffs& bc = bpfCoeffs[i];
+                    float_4 processedSignal = bpfFilters[i][g].process(inputSignal, bc.a1, bc.a2, bc.a3);
+                    envelopeOutput = followers[i][g].process(processedSignal, followerCoeffs[i]) * (10.0f * bpfGains[i]);
+                } else {
+                    // 只在閒置時接受觸發
+                    float_4 triggered = triggers[i][g].process(inputSignal) & envelopes[i][g].idleMask();
+                    envelopeOutput = envelopes[i][g].process(triggered, float_4(0.0f), args.sampleTime,
+                                                             envelopeTimes[i], curveParam, false) * 10.0f;
+                }
+                
+                output.setVoltageSimd(envelopeOutput, c);
+                
+                float_4 sum = float_4::load(&sumOutput[c]) + envelopeOutput * 0.33f;
+                sum.store(&sumOutput[c]);
+            }
+            output.setChannels(channels);
         }
         
-        sumOutput = clamp(sumOutput, 0.0f, 10.0f);
-        outputs[SUM_OUTPUT].setVoltage(sumOutput);
+        for (int c = 0; c < sumChannels; c += 4) {
+            float_4 sum = simd::clamp(float_4::load(&sumOutput[c]), 0.0f, 10.0f);
+            outputs[SUM_OUTPUT].setVoltageSimd(sum, c);
+        }
+        outputs[SUM_OUTPUT].setChannels(sumChannels);
         
         lights[AUTO_ROUTE_LIGHT].setBrightness(autoRouteEnabled ? 1.0f : 0.0f);
         for (int i = 0; i < 3; ++i) {
@@ -1,5 +1,6 @@
 #include "plugin.hpp"
 #include "widgets/Knobs.hpp"
+#include "widgets/CVModulation.hpp"
 #include "widgets/PanelTheme.hpp"
 #include <cmath>
 
@@ -238,7 +239,7 @@ struct ALEXANDERPLATZ : Module {
     bool soloState[ALEX_TRACKS] = {false};
     dsp::SchmittTrigger muteTrigger[ALEX_TRACKS];
     dsp::SchmittTrigger soloTrigger[ALEX_TRACKS];
-    float levelCvModulation[ALEX_TRACKS] = {0.0f};
+    madzine::widgets::CVModBank<ALEX_TRACKS> levelCvMods;  // 每軌 Level 旋鈕的 CV 調變顯示
     float vuLevelL[ALEX_TRACKS] = {-60.0f};
     float vuLevelR[ALEX_TRACKS] = {-60.0f};
 
@@ -347,6 +348,15 @@ struct ALEXANDERPLATZ : Module {
             mod = mod->rightExpander.module;
         }
 
+        // Level CV 調變顯示（靜音軌道在下方會被跳過，故在通道迴圈外發佈）
+        for (int t = 0; t < ALEX_TRACKS; t++) {
+            if (inputs[LEVEL_CV_INPUT + t].isConnected()) {
+                levelCvMods.publish(t, clamp(inputs[LEVEL_CV_INPUT + t].getVoltage() / 10.0f, -1.0f, 1.0f));
+            } else {
+                levelCvMods.clear(t);
+            }
+        }
+
         for (int c = 0; c < maxChannels; c++) {
             float mixL = 0.0f;
             float mixR = 0.0f;
@@ -402,9 +412,6 @@ struct ALEXANDERPLATZ : Module {
                 if (inputs[LEVEL_CV_INPUT + t].isConnected()) {
                     float cv = clamp(inputs[LEVEL_CV_INPUT + t].getPolyVoltage(c) / 10.0f, -1.0f, 1.0f);
                     level = clamp(level + cv, 0.0f, 2.0f);
-                    if (c == 0) levelCvModulation[t] = cv;
-                } else {
-                    if (c == 0) levelCvModulation[t] = 0.0f;
                 }
 
                 float duck = 1.0f;
@@ -623,6 +630,7 @@ struct AlexEQLabel : TransparentWidget {
 struct ALEXANDERPLATZWidget : ModuleWidget {
     PanelThemeHelper panelThemeHelper;
     TechnoStandardBlackKnob* levelKnobs[ALEX_TRACKS] = {nullptr};
+    madzine::widgets::CVModRingSync<ALEX_TRACKS> levelCvModSync;
 
     // Chain 自動接線（模組移開後保持連接）
     int64_t autoChainLeftCableId = -1;
@@ -674,6 +682,7 @@ struct ALEXANDERPLATZWidget : ModuleWidget {
             addChild(new AlexTextLabel(Vec(trackX - 5, 89), Vec(trackWidth + 10, 10), "LEVEL", 8.f, nvgRGB(255, 255, 255)));
             levelKnobs[t] = createParamCentered<TechnoStandardBlackKnob>(Vec(centerX, 123), module, ALEXANDERPLATZ::LEVEL_PARAM + t);
             addParam(levelKnobs[t]);
+            levelCvModSync.bind(t, levelKnobs[t]);
             addInput(createInputCentered<PJ301MPort>(Vec(centerX, 161), module, ALEXANDERPLATZ::LEVEL_CV_INPUT + t));
 
             // DUCK
@@ -723,16 +732,8 @@ struct ALEXANDERPLATZWidget : ModuleWidget {
         if (module) {
             panelThemeHelper.step(module);
 
-            // Level 旋鈕 CV 調變顯示
-            for (int t = 0; t < ALEX_TRACKS; t++) {
-                if (levelKnobs[t]) {
-                    bool cvConnected = module->inputs[ALEXANDERPLATZ::LEVEL_CV_INPUT + t].isConnected();
-                    levelKnobs[t]->setModulationEnabled(cvConnected);
-                    if (cvConnected) {
-                        levelKnobs[t]->setModulation(module->levelCvModulation[t]);
-                    }
-                }
-            }
+            // Level 旋鈕 CV 調變顯示（僅在數值變化時）
+            levelCvModSync.sync(module->levelCvMods);
 
             // Chain 自動接線（模組移開後保持連接，用戶可手動刪除）
             // 先驗證現有的自動 cable（被手動刪除時清除 ID）
@@ -0,0 +1,113 @@
+#pragma once
+#include "plugin.hpp"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ============================================================
+// BackgroundWorker - 所有模組實例共用的背景執行緒
+// ============================================================
+
+namespace madzine {
+
+/**
+ * 背景工作介面
+ * 音訊執行緒只設定工作自己的 atomic 旗標，不做任何喚醒（避免 futex 系統呼叫）；
+ * 共用執行緒定期輪詢每個已註冊的工作。
+ */
+struct BackgroundTask {
+    virtual ~BackgroundTask() {}
+
+    /**
+     * 背景執行緒呼叫
+     * @return true 表示仍有工作在進行，下一輪以較短間隔輪詢
+     */
+    virtual bool service() = 0;
+};
+
+/**
+ * 第一個工作註冊時才啟動執行緒，最後一個工作移除時停止，
+ * 因此沒有使用這些功能的 patch 不會多出任何執行緒。
+ */
+struct BackgroundWorker {
+    static constexpr int BUSY_INTERVAL_MS = 2;
+    static constexpr int IDLE_INTERVAL_MS = 10;
+
+    static BackgroundWorker& instance() {
+        static BackgroundWorker worker;
+        return worker;
+    }
+
+    void add(BackgroundTask* task) {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(task);
+        if (!thread.joinable()) {
+            uint32_t g = ++generation;
+            thread = std::thread([this, g]() { run(g); });
+        }
+    }
+
+    /**
+     * 移除工作；返回後保證 task->service() 不會再被呼叫
+     */
+    void remove(BackgroundTask* task) {
+        std::thread stopping;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.erase(std::remove(tasks.begin(), tasks.end(), task), tasks.end());
+            if (tasks.empty() && thread.joinable()) {
+                generation++;
+                stopping = std::move(thread);
+            }
+        }
+        if (stopping.joinable()) {
+            cv.notify_all();
+            stopping.join();
+        }
+    }
+
+    ~BackgroundWorker() {
+        std::thread stopping;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            generation++;
+            stopping = std::move(thread);
+        }
+        if (stopping.joinable()) {
+            cv.notify_all();
+            stopping.join();
+        }
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::thread thread;
+    std::vector<BackgroundTask*> tasks;
+    // 每次啟動或停止都遞增；執行緒發現與啟動時的值不同就結束，
+    // 停止後立刻重新啟動時舊執行緒也不會繼續跑
+    uint32_t generation = 0;
+
+    BackgroundWorker() {}
+
+    void run(uint32_t g) {
+        // Rack 的亂數狀態是 thread_local，未初始化時 random::u32() 固定回傳同一序列
+        random::init();
+        std::unique_lock<std::mutex> lock(mutex);
+        while (g == generation) {
+            // 持鎖呼叫 service()，remove() 因此會等目前這一輪結束
+            bool busy = false;
+            for (BackgroundTask* task : tasks) {
+                busy |= task->service();
+            }
+            auto interval = std::chrono::milliseconds(busy ? BUSY_INTERVAL_MS : IDLE_INTERVAL_MS);
+            cv.wait_for(lock, interval, [this, g]() { return g != generation; });
+        }
+    }
+};
+
+} // namespace madzine
@@ -0,0 +1,564 @@
+#pragma once
+#include "plugin.hpp"
+#include "ResampleDSP.hpp"
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// ============================================================
+// BinauralDSP - KEN 的實測 HRIR 雙耳渲染
+// ============================================================
+
+/**
+ * 一個量測方向的左右耳脈衝響應
+ * IR 已去掉起始延遲（onset），延遲另存於 onset[]，內插時分開混合，
+ * 避免不同 ITD 的 IR 直接相加造成梳狀濾波。
+ */
+struct HRIRMeasurement {
+    float azimuth = 0.f;    // 度，正值 = 右（順時針）
+    float elevation = 0.f;  // 度，正值 = 上
+    float dir[3] = {};      // 單位向量：x 右、y 上、z 前
+    float onset[2] = {};    // 樣本
+    std::vector<float> ir[2];
+};
+
+inline void hrirDirection(float azimuth, float elevation, float* dir) {
+    float az = azimuth * float(M_PI) / 180.f;
+    float el = elevation * float(M_PI) / 180.f;
+    dir[0] = std::sin(az) * std::cos(el);
+    dir[1] = std::sin(el);
+    dir[2] = std::cos(az) * std::cos(el);
+}
+
+/**
+ * 檔名中的方向
+ * 支援 MIT KEMAR 的 "H<仰角>e<方位角>a"（例如 H-10e270a），
+ * 以及含 "az" / "el" 標記的名稱（例如 azi_45_ele_-30、az45el30）。
+ * 方位角換算到 -180..180 度。
+ */
+inline bool parseHRIRDirection(const std::string& stem, float& azimuth, float& elevation) {
+    std::string s = string::lowercase(stem);
+
+    int el, az;
+    char tail;
+    bool found = std::sscanf(s.c_str(), "h%de%d%c", &el, &az, &tail) == 3 && tail == 'a';
+    if (found) {
+        azimuth = (float)az;
+        elevation = (float)el;
+    } else {
+        // 標記之後略過字母與分隔符，再讀一個帶號數字
+        auto tagged = [&](const char* tag, float& value) {
+            for (size_t pos = s.find(tag); pos != std::string::npos; pos = s.find(tag, pos + 1)) {
+                size_t i = pos + std::strlen(tag);
+                while (i < s.size() && (std::isalpha((unsigned char)s[i]) || s[i] == '_' || s[i] == '=' || s[i] == ' ')) i++;
+                const char* start = s.c_str() + i;
+                char* end = nullptr;
+                float v = std::strtof(start, &end);
+                if (end != start) {
+                    value = v;
+                    return true;
+                }
+            }
+            return false;
+        };
+        float a = 0.f, e = 0.f;
+        if (!tagged("az", a)) return false;
+        tagged("el", e);
+        azimuth = a;
+        elevation = e;
+    }
+
+    azimuth = std::fmod(azimuth, 360.f);
+    if (azimuth > 180.f) azimuth -= 360.f;
+    if (azimuth <= -180.f) azimuth += 360.f;
+    return elevation >= -90.f && elevation <= 90.f;
+}
+
+/**
+ * 讀取立體聲 WAV（PCM 16/24/32 bit 或 32 bit float），只取前兩個聲道
+ */
+inline bool loadStereoWav(const std::string& path, std::vector<float>& left, std::vector<float>& right, float& sampleRate) {
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) return false;
+
+    char riff[4], wave[4];
+    uint32_t fileSize;
+    if (std::fread(riff, 1, 4, file) != 4 || std::fread(&fileSize, 4, 1, file) != 1 || std::fread(wave, 1, 4, file) != 4
+        || std::memcmp(riff, "RIFF", 4) != 0 || std::memcmp(wave, "WAVE", 4) != 0) {
+        std::fclose(file);
+        return false;
+    }
+
+    uint16_t format = 0, numChannels = 0, bitsPerSample = 0;
+    uint32_t rate = 0, dataSize = 0;
+    bool hasData = false;
+    while (true) {
+        char chunkId[4];
+        uint32_t chunkSize;
+        if (std::fread(chunkId, 1, 4, file) != 4) break;
+        if (std::fread(&chunkSize, 4, 1, file) != 1) break;
+
+        if (std::memcmp(chunkId, "fmt ", 4) == 0 && chunkSize >= 16) {
+            uint8_t fmt[40] = {};
+            uint32_t n = std::min(chunkSize, (uint32_t)sizeof(fmt));
+            if (std::fread(fmt, 1, n, file) != n) break;
+            std::memcpy(&format, fmt, 2);
+            std::memcpy(&numChannels, fmt + 2, 2);
+            std::memcpy(&rate, fmt + 4, 4);
+            std::memcpy(&bitsPerSample, fmt + 14, 2);
+            // WAVE_FORMAT_EXTENSIBLE：實際格式在 SubFormat GUID 的前兩個位元組
+            if (format == 0xFFFE && chunkSize >= 26) std::memcpy(&format, fmt + 24, 2);
+            std::fseek(file, (chunkSize - n) + (chunkSize & 1), SEEK_CUR);
+        } else if (std::memcmp(chunkId, "data", 4) == 0) {
+            dataSize = chunkSize;
+            hasData = true;
+            break;
+        } else {
+            std::fseek(file, chunkSize + (chunkSize & 1), SEEK_CUR);
+        }
+    }
+
+    bool pcm = (format == 1) && (bitsPerSample == 16 || bitsPerSample == 24 || bitsPerSample == 32);
+    bool ieee = (format == 3) && (bitsPerSample == 32);
+    if (!hasData || numChannels < 2 || rate == 0 || !(pcm || ieee)) {
+        std::fclose(file);
+        return false;
+    }
+
+    // 標頭的 data 大小不可信（串流寫出的檔案常為 0xFFFFFFFF），以檔案實際剩餘長度為上限
+    long dataStart = std::ftell(file);
+    std::fseek(file, 0, SEEK_END);
+    long fileEnd = std::ftell(file);
+    std::fseek(file, dataStart, SEEK_SET);
+    if (dataStart < 0 || fileEnd < dataStart) {
+        std::fclose(file);
+        return false;
+    }
+    dataSize = (uint32_t)std::min<long>(dataSize, fileEnd - dataStart);
+
+    int bytesPerSample = bitsPerSample / 8;
+    int frameBytes = bytesPerSample * numChannels;
+    int frames = dataSize / frameBytes;
+    std::vector<uint8_t> data((size_t)frames * frameBytes);
+    frames = (int)(std::fread(data.data(), 1, data.size(), file) / frameBytes);
+    std::fclose(file);
+
+    auto sampleAt = [&](const uint8_t* p) {
+        if (ieee) {
+            float f;
+            std::memcpy(&f, p, 4);
+            return f;
+        }
+        if (bitsPerSample == 16) {
+            int16_t s16;
+            std::memcpy(&s16, p, 2);
+            return s16 / 32768.f;
+        }
+        if (bitsPerSample == 24) {
+            int32_t s24 = (p[2] << 24) | (p[1] << 16) | (p[0] << 8);
+            return (s24 >> 8) / 8388608.f;
+        }
+        int32_t s32;
+        std::memcpy(&s32, p, 4);
+        return s32 / 2147483648.f;
+    };
+
+    left.resize(frames);
+    right.resize(frames);
+    for (int i = 0; i < frames; i++) {
+        const uint8_t* frame = &data[(size_t)i * frameBytes];
+        left[i] = sampleAt(frame);
+        right[i] = sampleAt(frame + bytesPerSample);
+    }
+    sampleRate = (float)rate;
+    return frames > 0;
+}
+
+/**
+ * 一組 HRIR（已轉換到引擎取樣率）
+ */
+struct HRIRSet {
+    std::vector<HRIRMeasurement> measurements;
+    int length = 0;  // 所有 IR（含最大 onset）的長度上限
+    std::string name;
+
+    bool empty() const {
+        return measurements.empty();
+    }
+
+    /**
+     * 方向 (azimuth, elevation) 的 HRIR：取角距離最近的三個量測點，以距離反比加權，
+     * 去延遲的 IR 與 onset 分別內插，onset 以線性分數延遲放回
+     * @param out 左右耳各 length 個樣本
+     */
+    void interpolate(float azimuth, float elevation, float* outL, float* outR) const {
+        std::fill(outL, outL + length, 0.f);
+        std::fill(outR, outR + length, 0.f);
+        if (measurements.empty()) return;
+
+        float dir[3];
+        hrirDirection(azimuth, elevation, dir);
+
+        int nearest[3] = {-1, -1, -1};
+        float nearestDot[3] = {-2.f, -2.f, -2.f};
+        for (int i = 0; i < (int)measurements.size(); i++) {
+            const float* d = measurements[i].dir;
+            float dot = d[0] * dir[0] + d[1] * dir[1] + d[2] * dir[2];
+            for (int k = 0; k < 3; k++) {
+                if (dot > nearestDot[k]) {
+                    for (int j = 2; j > k; j--) {
+                        nearest[j] = nearest[j - 1];
+                        nearestDot[j] = nearestDot[j - 1];
+                    }
+                    nearest[k] = i;
+                    nearestDot[k] = dot;
+                    break;
+                }
+            }
+        }
+
+        float weights[3] = {};
+        float weightSum = 0.f;
+        for (int k = 0; k < 3; k++) {
+            if (nearest[k] < 0) continue;
+            float angle = std::acos(clamp(nearestDot[k], -1.f, 1.f));
+            if (angle < 1e-4f) {
+                // 正好落在量測點上
+                std::fill(weights, weights + 3, 0.f);
+                weights[k] = weightSum = 1.f;
+                break;
+            }
+            weights[k] = 1.f / angle;
+            weightSum += weights[k];
+        }
+
+        float* out[2] = {outL, outR};
+        for (int ear = 0; ear < 2; ear++) {
+            float onset = 0.f;
+            for (int k = 0; k < 3; k++) {
+                if (weights[k] > 0.f) onset += measurements[nearest[k]].onset[ear] * weights[k] / weightSum;
+            }
+            int delay = (int)onset;
+            float frac = onset - delay;
+
+            for (int k = 0; k < 3; k++) {
+                if (weights[k] <= 0.f) continue;
+                const std::vector<float>& ir = measurements[nearest[k]].ir[ear];
+                float w = weights[k] / weightSum;
+                int n = std::min((int)ir.size(), length - delay - 1);
+                for (int i = 0; i < n; i++) {
+                    out[ear][delay + i] += ir[i] * w * (1.f - frac);
+                    out[ear][delay + i + 1] += ir[i] * w * frac;
+                }
+            }
+        }
+    }
+};
+
+/**
+ * 載入資料夾內的 HRIR WAV（檔名帶方向，見 parseHRIRDirection）
+ * 以 sinc 內插轉換到 sampleRate，截到 maxLength，並正規化為最大能量 1
+ */
+inline bool loadHRIRFolder(const std::string& dir, float sampleRate, int maxLength, HRIRSet& set, std::string& error) {
+    set.measurements.clear();
+    set.length = 0;
+    set.name = system::getFilename(dir);
+
+    std::vector<std::string> entries = system::getEntries(dir);
+    std::sort(entries.begin(), entries.end());
+
+    float peakEnergy = 0.f;
+    for (const std::string& path : entries) {
+        if (string::lowercase(system::getExtension(path)) != ".wav") continue;
+
+        HRIRMeasurement m;
+        if (!parseHRIRDirection(system::getStem(path), m.azimuth, m.elevation)) continue;
+
+        std::vector<float> raw[2];
+        float fileRate;
+        if (!loadStereoWav(path, raw[0], raw[1], fileRate)) continue;
+        hrirDirection(m.azimuth, m.elevation, m.dir);
+
+        float energy[2] = {};
+        for (int ear = 0; ear < 2; ear++) {
+            // 轉換取樣率（前後補零，避免 sinc 讀到循環另一端）
+            const std::vector<float>& src = raw[ear];
+            float ratio = fileRate / sampleRate;
+            int pad = SincTable::BASE_TAPS << SincTable::BANDS;
+            int srcLength = (int)src.size() + 2 * pad;
+            auto fetch = [&](int i) {
+                int k = i - pad;
+                return (k >= 0 && k < (int)src.size()) ? src[k] : 0.f;
+            };
+            int frames = std::min((int)std::ceil(src.size() / ratio), maxLength);
+            std::vector<float> ir(frames);
+            for (int i = 0; i < frames; i++) {
+                if (ratio == 1.f) {
+                    ir[i] = src[i];
+                    continue;
+                }
+                float pos = i * ratio + pad;
+                int index = (int)pos;
+                ir[i] = resampleRead(RESAMPLE_SINC, fetch, srcLength, index, pos - index, ratio);
+            }
+
+            // onset = 第一個超過峰值 20% 的樣本，往前保留 2 個樣本
+            float peak = 0.f;
+            for (float v : ir) peak = std::max(peak, std::fabs(v));
+            int onset = 0;
+            while (onset < frames && std::fabs(ir[onset]) < peak * 0.2f) onset++;
+            onset = std::max(0, onset - 2);
+
+            m.onset[ear] = (float)onset;
+            m.ir[ear].assign(ir.begin() + std::min(onset, frames), ir.end());
+            for (float v : m.ir[ear]) energy[ear] += v * v;
+        }
+        peakEnergy = std::max(peakEnergy, std::max(energy[0], energy[1]));
+        set.measurements.push_back(std::move(m));
+    }
+
+    if (set.measurements.empty()) {
+        error = "No stereo HRIR WAVs with a direction in the file name";
+        return false;
+    }
+
+    float norm = (peakEnergy > 0.f) ? 1.f / std::sqrt(peakEnergy) : 1.f;
+    for (HRIRMeasurement& m : set.measurements) {
+        for (int ear = 0; ear < 2; ear++) {
+            for (float& v : m.ir[ear]) v *= norm;
+            set.length = std::max(set.length, (int)m.ir[ear].size() + (int)m.onset[ear] + 1);
+        }
+    }
+    set.length = std::min(set.length, maxLength);
+    return true;
+}
+
+/**
+ * 均勻分段 FFT 卷積（uniformly partitioned overlap-save）
+ * 每個聲源的輸入區塊 FFT 一次，存入頻域延遲線，與左右耳濾波器的各分段相乘累加；
+ * 所有聲源在頻域加總，每個區塊每耳只做一次反 FFT。
+ *
+ * 工作排程：一個區塊收集完成後，下一個區塊期間把工作平均分散到各樣本
+ * （每個聲源一個工作，最後一個工作做反 FFT），單一樣本的 CPU 尖峰不會
+ * 隨聲源數增加。代價是 2 * BLOCK 樣本的延遲。
+ *
+ * 濾波器更新先暫存時域 IR，每個樣本只轉換一個分段的 FFT（與卷積工作一樣分散），
+ * 全部分段完成後在下一個區塊邊界套用，該區塊同時以新舊濾波器計算並交叉淡化。
+ */
+template <int SOURCES>
+struct BinauralConvolver {
+    static constexpr int BLOCK = 128;
+    static constexpr int FFT_SIZE = BLOCK * 2;
+    static constexpr int MAX_PARTITIONS = 8;
+    static constexpr int MAX_IR = BLOCK * MAX_PARTITIONS;
+    static constexpr int TASKS = SOURCES + 1;
+
+    struct Spectrum {
+        alignas(16) float v[FFT_SIZE];
+    };
+
+    struct Source {
+        Spectrum fdl[MAX_PARTITIONS];            // 輸入頻域延遲線
+        Spectrum filters[3][2][MAX_PARTITIONS];  // [濾波器組][耳][分段]
+        int partitions[3] = {};
+        int fdlHead = 0;
+        int current = 0;
+        int previous = 0;
+        int pending = -1;
+        bool fading = false;
+        int silentBlocks = MAX_PARTITIONS;  // 連續全零的輸入區塊數
+        bool collectedSignal = false;
+
+        // 轉換中的濾波器：staged[耳] 為時域 IR，stageNext 為下一個要轉換的分段（ear * parts + p）
+        alignas(16) float staged[2][MAX_IR];
+        int stageSlot = -1;
+        int stageParts = 0;
+        int stageNext = 0;
+    };
+
+    dsp::RealFFT fft{FFT_SIZE};
+    Source sources[SOURCES];
+
+    alignas(16) float collect[SOURCES][BLOCK] = {};
+    alignas(16) float work[SOURCES][FFT_SIZE] = {};  // [上一區塊, 目前區塊]
+    bool workActive[SOURCES] = {};
+    Spectrum acc[2];
+    Spectrum accOld[2];
+    alignas(16) float scratch[FFT_SIZE];
+    alignas(16) float scratchOld[FFT_SIZE];
+    float output[2][BLOCK] = {};
+    float nextOutput[2][BLOCK] = {};
+    bool anyFading = false;
+    int position = 0;
+    int nextTask = TASKS;
+    int stageCursor = 0;  // 下一個要轉換分段的聲源（每個樣本換下一個）
+
+    BinauralConvolver() {
+        reset();
+    }
+
+    void reset() {
+        for (Source& s : sources) {
+            std::memset(s.fdl, 0, sizeof(s.fdl));
+            s.fdlHead = 0;
+            s.previous = s.current;
+            s.fading = false;
+            s.silentBlocks = MAX_PARTITIONS;
+            s.collectedSignal = false;
+        }
+        std::memset(collect, 0, sizeof(collect));
+        std::memset(work, 0, sizeof(work));
+        std::memset(output, 0, sizeof(output));
+        std::memset(nextOutput, 0, sizeof(nextOutput));
+        position = 0;
+        nextTask = TASKS;
+    }
+
+    /**
+     * 設定聲源的左右耳 HRIR（length <= MAX_IR）
+     * 只複製時域 IR；分段 FFT 在之後的樣本中逐一完成，再於區塊邊界開始交叉淡化。
+     * 轉換尚未完成時再次呼叫，以新的 IR 重新開始。
+     */
+    void setFilter(int source, const float* irL, const float* irR, int length) {
+        Source& s = sources[source];
+        // 尚未套用的舊更新作廢，沿用它的位置（不可是 current / previous）
+        s.pending = -1;
+        if (s.stageSlot < 0) {
+            s.stageSlot = 0;
+            while (s.stageSlot == s.current || s.stageSlot == s.previous) s.stageSlot++;
+        }
+        length = clamp(length, 0, MAX_IR);
+        std::memcpy(s.staged[0], irL, length * sizeof(float));
+        std::memcpy(s.staged[1], irR, length * sizeof(float));
+        std::fill(s.staged[0] + length, s.staged[0] + MAX_IR, 0.f);
+        std::fill(s.staged[1] + length, s.staged[1] + MAX_IR, 0.f);
+        s.stageParts = clamp((length + BLOCK - 1) / BLOCK, 1, MAX_PARTITIONS);
+        s.stageNext = 0;
+    }
+
+    /**
+     * 每個樣本呼叫一次
+     * @param in SOURCES 個輸入
+     * @param out 左右輸出（延遲 2 * BLOCK 樣本）
+     */
+    void process(const float* in, float* out) {
+        for (int s = 0; s < SOURCES; s++) {
+            collect[s][position] = in[s];
+            if (in[s] != 0.f) sources[s].collectedSignal = true;
+        }
+        out[0] = output[0][position];
+        out[1] = output[1][position];
+
+        while (nextTask < TASKS && position >= nextTask * BLOCK / TASKS) {
+            runTask(nextTask++);
+        }
+        stageStep();
+
+        if (++position >= BLOCK) {
+            while (nextTask < TASKS) runTask(nextTask++);
+            startBlock();
+            position = 0;
+        }
+    }
+
+private:
+    /**
+     * 轉換一個暫存濾波器分段；該聲源全部完成時排入下一個區塊邊界
+     * 每轉換一段就換下一個有待轉換的聲源，多個聲源同時更新時平均前進
+     */
+    void stageStep() {
+        for (int k = 0; k < SOURCES; k++) {
+            Source& s = sources[stageCursor];
+            stageCursor = (stageCursor + 1) % SOURCES;
+            if (s.stageSlot >= 0) {
+                int ear = s.stageNext / s.stageParts;
+                int p = s.stageNext % s.stageParts;
+                std::memcpy(scratch, s.staged[ear] + p * BLOCK, BLOCK * sizeof(float));
+                std::fill(scratch + BLOCK, scratch + FFT_SIZE, 0.f);
+                fft.rfftUnordered(scratch, s.filters[s.stageSlot][ear][p].v);
+                if (++s.stageNext >= 2 * s.stageParts) {
+                    s.partitions[s.stageSlot] = s.stageParts;
+                    s.pending = s.stageSlot;
+                    s.stageSlot = -1;
+                }
+                return;
+            }
+        }
+    }
+
+    void startBlock() {
+        std::memcpy(output, nextOutput, sizeof(output));
+
+        anyFading = false;
+        for (int i = 0; i < SOURCES; i++) {
+            Source& s = sources[i];
+            s.previous = s.current;
+            s.fading = false;
+            if (s.pending >= 0) {
+                s.current = s.pending;
+                s.pending = -1;
+                s.fading = true;
+                anyFading = true;
+            }
+
+            std::memcpy(work[i], work[i] + BLOCK, BLOCK * sizeof(float));
+            std::memcpy(work[i] + BLOCK, collect[i], BLOCK * sizeof(float));
+            s.silentBlocks = s.collectedSignal ? 0 : std::min(s.silentBlocks + 1, MAX_PARTITIONS + 1);
+            s.collectedSignal = false;
+            // 延遲線內都是零頻譜時整個聲源跳過
+            workActive[i] = s.silentBlocks <= MAX_PARTITIONS;
+        }
+
+        for (int ear = 0; ear < 2; ear++) {
+            std::memset(acc[ear].v, 0, sizeof(acc[ear].v));
+            if (anyFading) std::memset(accOld[ear].v, 0, sizeof(accOld[ear].v));
+        }
+        nextTask = 0;
+    }
+
+    void runTask(int task) {
+        if (task < SOURCES) {
+            if (workActive[task]) convolveSource(task);
+        } else {
+            finishBlock();
+        }
+    }
+
+    void convolveSource(int index) {
+        Source& s = sources[index];
+        s.fdlHead = (s.fdlHead + 1) % MAX_PARTITIONS;
+        fft.rfftUnordered(work[index], s.fdl[s.fdlHead].v);
+
+        const float scale = 1.f / FFT_SIZE;
+        for (int ear = 0; ear < 2; ear++) {
+            for (int p = 0; p < s.partitions[s.current]; p++) {
+                const Spectrum& x = s.fdl[(s.fdlHead - p + MAX_PARTITIONS) % MAX_PARTITIONS];
+                pffft_zconvolve_accumulate(fft.setup, x.v, s.filters[s.current][ear][p].v, acc[ear].v, scale);
+            }
+            if (anyFading) {
+                for (int p = 0; p < s.partitions[s.previous]; p++) {
+                    const Spectrum& x = s.fdl[(s.fdlHead - p + MAX_PARTITIONS) % MAX_PARTITIONS];
+                    pffft_zconvolve_accumulate(fft.setup, x.v, s.filters[s.previous][ear][p].v, accOld[ear].v, scale);
+                }
+            }
+        }
+    }
+
+    void finishBlock() {
+        for (int ear = 0; ear < 2; ear++) {
+            // overlap-save：後半段為有效輸出
+            fft.irfftUnordered(acc[ear].v, scratch);
+            if (!anyFading) {
+                std::memcpy(nextOutput[ear], scratch + BLOCK, BLOCK * sizeof(float));
+                continue;
+            }
+            fft.irfftUnordered(accOld[ear].v, scratchOld);
+            for (int i = 0; i < BLOCK; i++) {
+                float w = (i + 0.5f) / BLOCK;
+                nextOutput[ear][i] = scratchOld[BLOCK + i] + (scratch[BLOCK + i] - scratchOld[BLOCK + i]) * w;
+            }
+        }
+    }
+};
@@ -1,5 +1,7 @@
 #include "plugin.hpp"
+#include "PyramidDSP.hpp"
 #include "widgets/Knobs.hpp"
+#include "widgets/CVModulation.hpp"
 #include "widgets/PanelTheme.hpp"
 struct DECAPyramid : Module {
     enum ParamId {
@@ -41,9 +43,7 @@ struct DECAPyramid : Module {
         LIGHTS_LEN
     };
 
-    struct SpeakerPosition {
-        float x, y, z;
-    };
+    using SpeakerPosition = PyramidSpeakerPosition;
 
     SpeakerPosition speakers[8] = {
         {-1.0f, -1.0f,  1.0f},
@@ -56,31 +56,36 @@ struct DECAPyramid : Module {
         { 1.0f,  1.0f, -1.0f}
     };
 
-    dsp::TBiquadFilter<> filter1[8];
-    dsp::TBiquadFilter<> filter2[8];
+    // 軌道濾波器：8 軌分成兩組 float_4（軌 1-4 / 5-8）
+    PyramidCascadeBiquad<simd::float_4> trackFilters[2];
+    PyramidFilterCoeffCache trackFilterCache[8];
+    bool trackGroupFiltered[2] = {false, false};
+
+    // CV 調變顯示用，索引為 track * 3 + axis（axis: 0=X, 1=Y, 2=Z）
+    static constexpr int NUM_CVMODS = 8 * 3;
+    madzine::widgets::CVModBank<NUM_CVMODS> cvMods;
 
-    // CV 調變顯示用 [track][axis: 0=X, 1=Y, 2=Z]
-    float cvMod[8][3] = {{0.0f}};
-    dsp::TBiquadFilter<> rtnAFilter1, rtnAFilter2;
-    dsp::TBiquadFilter<> rtnBFilter1, rtnBFilter2;
+    // 位置、VBAP 增益與濾波係數以控制率更新，音訊率做線性插值
+    static constexpr int CONTROL_DIVISION = 16;
+    dsp::ClockDivider controlDivider;
+    VBAPGainRamp vbapRamp[8];
+
+    // Return 濾波器：(AL, AR, BL, BR) 打包成一組 float_4
+    PyramidCascadeBiquad<simd::float_4> returnFilter;
+    PyramidFilterCoeffCache rtnAFilterCache, rtnBFilterCache;
     dsp::VuMeter2 vuMeterPre[8];
     dsp::VuMeter2 vuMeterPost[8];
 
     bool sendPreLevel = false;
     int panelTheme = 1;
     float panelContrast = madzineDefaultContrast;
-    int lastRtnAFilterMode = 0;
-    int lastRtnBFilterMode = 0;
-    float lastRtnAFilterValue = 0.f;
-    float lastRtnBFilterValue = 0.f;
     float smoothedRtnAFilter = 0.f;
     float smoothedRtnBFilter = 0.f;
-    int lastFilterMode[8] = {0};
-    float lastFilterValue[8] = {0.f};
     float smoothedFilter[8] = {0.f};
 
     DECAPyramid() {
         config(PARAMS_LEN, INPUTS_LEN, OUTPUTS_LEN, LIGHTS_LEN);
+        controlDivider.setDivision(CONTROL_DIVISION);
         
         for (int i = 0; i < 8; i++) {
             configParam(X_PARAM_1 + i * 7, -1.f, 1.f, -1.f, "Track " + std::to_string(i + 1) + " X Position", "", 0.f, 1.f);
@@ -119,182 +124,120 @@ struct DECAPyramid : Module {
         configOutput(SENDB_OUTPUT, "Send B");
     }
 
-    float distance3D(float x1, float y1, float z1, float x2, float y2, float z2) {
-        float dx = x2 - x1;
-        float dy = y2 - y1;
-        float dz = z2 - z1;
-        return std::sqrt(dx*dx + dy*dy + dz*dz);
-    }
+    /**
+     * 控制率：讀取各軌位置參數與 CV，位置改變時重新計算 VBAP 目標增益
+     */
+    void updateTrackPositions() {
+        for (int track = 0; track < 8; track++) {
+            float x = params[X_PARAM_1 + track * 7].getValue();
+            float y = params[Y_PARAM_1 + track * 7].getValue();
+            float z = params[Z_PARAM_1 + track * 7].getValue();
 
-    void calculateVBAP(float sourceX, float sourceY, float sourceZ, float gains[8]) {
-        for (int i = 0; i < 8; i++) {
-            float distance = distance3D(sourceX, sourceY, sourceZ, 
-                                      speakers[i].x, speakers[i].y, speakers[i].z);
-            
-            distance = std::max(distance, 0.001f);
-            
-            float gain = 1.0f / (1.0f + distance + distance * distance * 2.0f);
-            
-            float fadeOut = 1.0f;
-            
-            if (sourceX <= -0.8f && speakers[i].x > 0) {
-                fadeOut *= std::max(0.0f, (sourceX + 1.0f) / 0.2f);
-            }
-            if (sourceX >= 0.8f && speakers[i].x < 0) {
-                fadeOut *= std::max(0.0f, (1.0f - sourceX) / 0.2f);
-            }
-            
-            if (sourceY <= -0.8f && speakers[i].y > 0) {
-                fadeOut *= std::max(0.0f, (sourceY + 1.0f) / 0.2f);
-            }
-            if (sourceY >= 0.8f && speakers[i].y < 0) {
-                fadeOut *= std::max(0.0f, (1.0f - sourceY) / 0.2f);
+            if (inputs[X_CV_INPUT_1 + track * 4].isConnected()) {
+                float cv = inputs[X_CV_INPUT_1 + track * 4].getVoltage();
+                x += cv * 0.2f;
+                x = clamp(x, -1.f, 1.f);
+                cvMods.publish(track * 3 + 0, clamp(cv / 10.0f, -1.0f, 1.0f));
+            } else {
+                cvMods.clear(track * 3 + 0);
             }
-            
-            if (sourceZ <= -0.8f && speakers[i].z > 0) {
-                fadeOut *= std::max(0.0f, (sourceZ + 1.0f) / 0.2f);
+            if (inputs[Y_CV_INPUT_1 + track * 4].isConnected()) {
+                float cv = inputs[Y_CV_INPUT_1 + track * 4].getVoltage();
+                y += cv * 0.2f;
+                y = clamp(y, -1.f, 1.f);
+                cvMods.publish(track * 3 + 1, clamp(cv / 10.0f, -1.0f, 1.0f));
+            } else {
+                cvMods.clear(track * 3 + 1);
             }
-            if (sourceZ >= 0.8f && speakers[i].z < 0) {
-                fadeOut *= std::max(0.0f, (1.0f - sourceZ) / 0.2f);
+            if (inputs[Z_CV_INPUT_1 + track * 4].isConnected()) {
+                float cv = inputs[Z_CV_INPUT_1 + track * 4].getVoltage();
+                z += cv * 0.2f;
+                z = clamp(z, -1.f, 1.f);
+                cvMods.publish(track * 3 + 2, clamp(cv / 10.0f, -1.0f, 1.0f));
+            } else {
+                cvMods.clear(track * 3 + 2);
             }
-            
-            gains[i] = gain * fadeOut;
+
+            vbapRamp[track].update(speakers, x, y, -z, CONTROL_DIVISION);
         }
-        
-        float totalGain = 0.0f;
-        for (int i = 0; i < 8; i++) {
-            totalGain += gains[i] * gains[i];
+    }
+
+    /**
+     * 控制率：平滑濾波旋鈕並更新係數（量化值未變時沿用快取）
+     */
+    void updateFilters(float sampleRate) {
+        // 等效於原本每樣本 0.005 的一階平滑
+        const float smooth = 1.f - std::pow(1.f - 0.005f, (float)CONTROL_DIVISION);
+
+        smoothedRtnAFilter += (params[RTN_A_FILTER_PARAM].getValue() - smoothedRtnAFilter) * smooth;
+        smoothedRtnBFilter += (params[RTN_B_FILTER_PARAM].getValue() - smoothedRtnBFilter) * smooth;
+
+        if (rtnAFilterCache.update(smoothedRtnAFilter, sampleRate)) {
+            returnFilter.resetLane(0);
+            returnFilter.resetLane(1);
         }
-        
-        if (totalGain > 0.0f) {
-            float normalizeFactor = 1.0f / std::sqrt(totalGain);
-            for (int i = 0; i < 8; i++) {
-                gains[i] *= normalizeFactor;
+        if (rtnBFilterCache.update(smoothedRtnBFilter, sampleRate)) {
+            returnFilter.resetLane(2);
+            returnFilter.resetLane(3);
+        }
+        returnFilter.setLaneCoeffs(0, rtnAFilterCache.coeffs);
+        returnFilter.setLaneCoeffs(1, rtnAFilterCache.coeffs);
+        returnFilter.setLaneCoeffs(2, rtnBFilterCache.coeffs);
+        returnFilter.setLaneCoeffs(3, rtnBFilterCache.coeffs);
+
+        trackGroupFiltered[0] = false;
+        trackGroupFiltered[1] = false;
+        for (int track = 0; track < 8; track++) {
+            float filter = params[FILTER_PARAM_1 + track * 7].getValue();
+            smoothedFilter[track] += (filter - smoothedFilter[track]) * smooth;
+
+            PyramidCascadeBiquad<simd::float_4>& group = trackFilters[track / 4];
+            if (trackFilterCache[track].update(smoothedFilter[track], sampleRate)) {
+                group.resetLane(track % 4);
+            }
+            group.setLaneCoeffs(track % 4, trackFilterCache[track].coeffs);
+            if (trackFilterCache[track].mode != 0) {
+                trackGroupFiltered[track / 4] = true;
             }
         }
     }
 
     void process(const ProcessArgs& args) override {
+        if (controlDivider.process() || !vbapRamp[0].initialized) {
+            updateTrackPositions();
+            updateFilters(args.sampleRate);
+        }
+
         float sendAOut = 0.0f;
         float sendBOut = 0.0f;
         
-        float returnAL = inputs[RETURN_AL_INPUT].getVoltage();
-        float returnAR = inputs[RETURN_AR_INPUT].getVoltage();
-        float returnBL = inputs[RETURN_BL_INPUT].getVoltage();
-        float returnBR = inputs[RETURN_BR_INPUT].getVoltage();
+        simd::float_4 returns(inputs[RETURN_AL_INPUT].getVoltage(),
+                              inputs[RETURN_AR_INPUT].getVoltage(),
+                              inputs[RETURN_BL_INPUT].getVoltage(),
+                              inputs[RETURN_BR_INPUT].getVoltage());
+        if (rtnAFilterCache.mode != 0 || rtnBFilterCache.mode != 0) {
+            returns = returnFilter.process(returns);
+        }
         
         float rtnALevel = params[RTN_A_LEVEL_PARAM].getValue();
-        float rtnAFilter = params[RTN_A_FILTER_PARAM].getValue();
         float rtnBLevel = params[RTN_B_LEVEL_PARAM].getValue();
-        float rtnBFilter = params[RTN_B_FILTER_PARAM].getValue();
-        
-        float filterSmooth = 0.005f;
-        smoothedRtnAFilter += (rtnAFilter - smoothedRtnAFilter) * filterSmooth;
-        smoothedRtnBFilter += (rtnBFilter - smoothedRtnBFilter) * filterSmooth;
-        
-        if (smoothedRtnAFilter < -0.001f) {
-            if (lastRtnAFilterMode != -1) {
-                rtnAFilter1.reset();
-                rtnAFilter2.reset();
-                lastRtnAFilterMode = -1;
-            }
-            float freq = rescale(smoothedRtnAFilter, -1.f, 0.f, 20.f, 22000.f);
-            rtnAFilter1.setParameters(dsp::TBiquadFilter<>::LOWPASS, freq / args.sampleRate, 0.707f, 1.f);
-            rtnAFilter2.setParameters(dsp::TBiquadFilter<>::LOWPASS, freq / args.sampleRate, 0.707f, 1.f);
-            returnAL = rtnAFilter2.process(rtnAFilter1.process(returnAL));
-            returnAR = rtnAFilter2.process(rtnAFilter1.process(returnAR));
-        } else if (smoothedRtnAFilter > 0.001f) {
-            if (lastRtnAFilterMode != 1) {
-                rtnAFilter1.reset();
-                rtnAFilter2.reset();
-                lastRtnAFilterMode = 1;
-            }
-            float freq = rescale(smoothedRtnAFilter, 0.f, 1.f, 10.f, 8000.f);
-            rtnAFilter1.setParameters(dsp::TBiquadFilter<>::HIGHPASS, freq / args.sampleRate, 0.707f, 1.f);
-            rtnAFilter2.setParameters(dsp::TBiquadFilter<>::HIGHPASS, freq / args.sampleRate, 0.707f, 1.f);
-            returnAL = rtnAFilter2.process(rtnAFilter1.process(returnAL));
-            returnAR = rtnAFilter2.process(rtnAFilter1.process(returnAR));
-        } else {
-            lastRtnAFilterMode = 0;
-        }
-        
-        if (smoothedRtnBFilter < -0.001f) {
-            if (lastRtnBFilterMode != -1) {
-                rtnBFilter1.reset();
-                rtnBFilter2.reset();
-                lastRtnBFilterMode = -1;
-            }
-            float freq = rescale(smoothedRtnBFilter, -1.f, 0.f, 20.f, 22000.f);
-            rtnBFilter1.setParameters(dsp::TBiquadFilter<>::LOWPASS, freq / args.sampleRate, 0.707f, 1.f);
-            rtnBFilter2.setParameters(dsp::TBiquadFilter<>::LOWPASS, freq / args.sampleRate, 0.707f, 1.f);
-            returnBL = rtnBFilter2.process(rtnBFilter1.process(returnBL));
-            returnBR = rtnBFilter2.process(rtnBFilter1.process(returnBR));
-        } else if (smoothedRtnBFilter > 0.001f) {
-            if (lastRtnBFilterMode != 1) {
-                rtnBFilter1.reset();
-                rtnBFilter2.reset();
-                lastRtnBFilterMode = 1;
-            }
-            float freq = rescale(smoothedRtnBFilter, 0.f, 1.f, 10.f, 8000.f);
-            rtnBFilter1.setParameters(dsp::TBiquadFilter<>::HIGHPASS, freq / args.sampleRate, 0.707f, 1.f);
-            rtnBFilter2.setParameters(dsp::TBiquadFilter<>::HIGHPASS, freq / args.sampleRate, 0.707f, 1.f);
-            returnBL = rtnBFilter2.process(rtnBFilter1.process(returnBL));
-            returnBR = rtnBFilter2.process(rtnBFilter1.process(returnBR));
-        } else {
-            lastRtnBFilterMode = 0;
-        }
-        
-        returnAL *= rtnALevel;
-        returnAR *= rtnALevel;
-        returnBL *= rtnBLevel;
-        returnBR *= rtnBLevel;
+        returns *= simd::float_4(rtnALevel, rtnALevel, rtnBLevel, rtnBLevel);
         
         float output14Level = params[OUTPUT_1_4_LEVEL_PARAM].getValue();
         float output58Level = params[OUTPUT_5_8_LEVEL_PARAM].getValue();
         float masterLevel = params[MASTER_OUTPUT_LEVEL_PARAM].getValue();
         
-        for (int speaker = 0; speaker < 8; speaker++) {
-            outputs[MASTER_OUTPUT_1 + speaker].setVoltage(0.0f);
-        }
+        alignas(16) float trackSignal[8];
         
         for (int track = 0; track < 8; track++) {
             float audioIn = inputs[AUDIO_INPUT_1 + track * 4].getVoltage();
             
             vuMeterPre[track].process(args.sampleTime, audioIn);
             
-            float x = params[X_PARAM_1 + track * 7].getValue();
-            float y = params[Y_PARAM_1 + track * 7].getValue();
-            float z = params[Z_PARAM_1 + track * 7].getValue();
             float level = params[LEVEL_PARAM_1 + track * 7].getValue();
-            float filter = params[FILTER_PARAM_1 + track * 7].getValue();
             float sendA = params[SENDA_PARAM_1 + track * 7].getValue();
             float sendB = params[SENDB_PARAM_1 + track * 7].getValue();
             
-            if (inputs[X_CV_INPUT_1 + track * 4].isConnected()) {
-                float cv = inputs[X_CV_INPUT_1 + track * 4].getVoltage();
-                x += cv * 0.2f;
-                x = clamp(x, -1.f, 1.f);
-                cvMod[track][0] = clamp(cv / 10.0f, -1.0f, 1.0f);
-            } else {
-                cvMod[track][0] = 0.0f;
-            }
-            if (inputs[Y_CV_INPUT_1 + track * 4].isConnected()) {
-                float cv = inputs[Y_CV_INPUT_1 + track * 4].getVoltage();
-                y += cv * 0.2f;
-                y = clamp(y, -1.f, 1.f);
-                cvMod[track][1] = clamp(cv / 10.0f, -1.0f, 1.0f);
-            } else {
-                cvMod[track][1] = 0.0f;
-            }
-            if (inputs[Z_CV_INPUT_1 + track * 4].isConnected()) {
-                float cv = inputs[Z_CV_INPUT_1 + track * 4].getVoltage();
-                z += cv * 0.2f;
-                z = clamp(z, -1.f, 1.f);
-                cvMod[track][2] = clamp(cv / 10.0f, -1.0f, 1.0f);
-            } else {
-                cvMod[track][2] = 0.0f;
-            }
-            
             outputs[INSERT_SEND_1 + track].setVoltage(audioIn);
             
             if (inputs[INSERT_RETURN_1 + track].isConnected()) {
@@ -317,54 +260,43 @@ struct DECAPyramid : Module {
             sendAOut += sendATrack;
             sendBOut += sendBTrack;
             
-            float filterSmooth = 0.005f;
-            smoothedFilter[track] += (filter - smoothedFilter[track]) * filterSmooth;
-
-            if (smoothedFilter[track] < -0.001f) {
-                if (lastFilterMode[track] != -1) {
-                    filter1[track].reset();
-                    filter2[track].reset();
-                    lastFilterMode[track] = -1;
-                }
-                float freq = rescale(smoothedFilter[track], -1.f, 0.f, 20.f, 22000.f);
-                filter1[track].setParameters(dsp::TBiquadFilter<>::LOWPASS, freq / args.sampleRate, 0.707f, 1.f);
-                filter2[track].setParameters(dsp::TBiquadFilter<>::LOWPASS, freq / args.sampleRate, 0.707f, 1.f);
-                audioIn = filter2[track].process(filter1[track].process(audioIn));
-            } else if (smoothedFilter[track] > 0.001f) {
-                if (lastFilterMode[track] != 1) {
-                    filter1[track].reset();
-                    filter2[track].reset();
-                    lastFilterMode[track] = 1;
-                }
-                float freq = rescale(smoothedFilter[track], 0.f, 1.f, 10.f, 8000.f);
-                filter1[track].setParameters(dsp::TBiquadFilter<>::HIGHPASS, freq / args.sampleRate, 0.707f, 1.f);
-                filter2[track].setParameters(dsp::TBiquadFilter<>::HIGHPASS, freq / args.sampleRate, 0.707f, 1.f);
-                audioIn = filter2[track].process(filter1[track].process(audioIn));
-            } else {
-                lastFilterMode[track] = 0;
+            trackSignal[track] = audioIn;
+        }
+        
+        // 8x8 增益矩陣乘法：lo = 喇叭 1-4，hi = 喇叭 5-8
+        // Return 不分軌，先累加各軌增益再一次相乘
+        simd::float_4 mixLo = 0.0f;
+        simd::float_4 mixHi = 0.0f;
+        simd::float_4 gainSumLo = 0.0f;
+        simd::float_4 gainSumHi = 0.0f;
+        
+        for (int group = 0; group < 2; group++) {
+            simd::float_4 signal = simd::float_4::load(&trackSignal[group * 4]);
+            if (trackGroupFiltered[group]) {
+                signal = trackFilters[group].process(signal);
             }
             
-            float gains[8];
-            calculateVBAP(x, y, -z, gains);
-            
-            for (int speaker = 0; speaker < 8; speaker++) {
-                float outputVoltage = audioIn * gains[speaker];
-                
-                if (speaker % 2 == 0) {
-                    outputVoltage += returnAL * gains[speaker];
-                    outputVoltage += returnBL * gains[speaker];
-                } else {
-                    outputVoltage += returnAR * gains[speaker];
-                    outputVoltage += returnBR * gains[speaker];
-                }
-                
-                float levelMultiplier = (speaker < 4) ? output14Level : output58Level;
-                outputVoltage *= levelMultiplier * masterLevel;
-                
-                outputs[MASTER_OUTPUT_1 + speaker].setVoltage(outputs[MASTER_OUTPUT_1 + speaker].getVoltage() + outputVoltage);
+            for (int lane = 0; lane < 4; lane++) {
+                VBAPGainRamp& ramp = vbapRamp[group * 4 + lane];
+                ramp.step();
+                mixLo += signal[lane] * ramp.gainLo;
+                mixHi += signal[lane] * ramp.gainHi;
+                gainSumLo += ramp.gainLo;
+                gainSumHi += ramp.gainHi;
             }
         }
         
+        float returnL = returns[0] + returns[2];
+        float returnR = returns[1] + returns[3];
+        simd::float_4 returnVec(returnL, returnR, returnL, returnR);
+        simd::float_4 outLo = (mixLo + returnVec * gainSumLo) * (output14Level * masterLevel);
+        simd::float_4 outHi = (mixHi + returnVec * gainSumHi) * (output58Level * masterLevel);
+        
+        for (int speaker = 0; speaker < 4; speaker++) {
+            outputs[MASTER_OUTPUT_1 + speaker].setVoltage(outLo[speaker]);
+            outputs[MASTER_OUTPUT_1 + 4 + speaker].setVoltage(outHi[speaker]);
+        }
+        
         outputs[SENDA_OUTPUT].setVoltage(sendAOut);
         outputs[SENDB_OUTPUT].setVoltage(sendBOut);
     }
@@ -809,6 +741,7 @@ struct DECAPyramidWidget : ModuleWidget {
     PanelThemeHelper panelThemeHelper;
     // [track][axis: 0=X, 1=Y, 2=Z]
     StandardBlackKnob26* xyzKnobs[8][3] = {{nullptr}};
+    madzine::widgets::CVModRingSync<DECAPyramid::NUM_CVMODS> cvModSync;
 
     DECAPyramidWidget(DECAPyramid* module) {
         setModule(module);
@@ -855,6 +788,7 @@ struct DECAPyramidWidget : ModuleWidget {
                 } else {
                     StandardBlackKnob26* knob = createParamCentered<StandardBlackKnob26>(Vec(baseX, trackY[j] + 10), module, trackParams[j] + i * 7);
                     xyzKnobs[i][j - 1] = knob;  // j-1: 1->0(X), 2->1(Y), 3->2(Z)
+                    cvModSync.bind(i * 3 + j - 1, knob);
                     addParam(knob);
                     addInput(createInputCentered<PJ301MPort>(Vec(baseX, trackY[j] + inputOffsets[j]), module, trackInputs[j] + i * 4));
                 }
@@ -1000,21 +934,8 @@ struct DECAPyramidWidget : ModuleWidget {
         if (module) {
             panelThemeHelper.step(module);
 
-            // CV 調變顯示更新
-            for (int track = 0; track < 8; track++) {
-                for (int axis = 0; axis < 3; axis++) {
-                    StandardBlackKnob26* knob = xyzKnobs[track][axis];
-                    if (knob) {
-                        // axis: 0=X, 1=Y, 2=Z
-                        int inputId = DECAPyramid::X_CV_INPUT_1 + axis + track * 4;
-                        bool connected = module->inputs[inputId].isConnected();
-                        knob->setModulationEnabled(connected);
-                        if (connected) {
-                            knob->setModulation(module->cvMod[track][axis]);
-                        }
-                    }
-                }
-            }
+            // CV 調變顯示更新（僅在數值變化時）
+            cvModSync.sync(module->cvMods);
         }
         ModuleWidget::step();
     }
@@ -11,6 +11,7 @@
 #include "plugin.hpp"
 #include "WorldRhythm/MinimalDrumSynth.hpp"
 #include "widgets/Knobs.hpp"
+#include "widgets/CVModulation.hpp"
 #include "widgets/PanelTheme.hpp"
 
 using namespace worldrhythm;
@@ -266,10 +267,40 @@ struct Drummmmmmer : Module {
     // Last triggered voice index per role (0=v1, 1=v2)
     int lastTriggeredVoice[4] = {0, 0, 0, 0};
 
-    // CV modulation display values
-    float styleCvMod = 0.0f;
-    float freqCvMod[4] = {};
-    float decayCvMod[4] = {};
+    // Equal-power pan gains per role, recomputed only when SPREAD changes
+    simd::float_4 panGainL = 0.f;
+    simd::float_4 panGainR = 0.f;
+    float panSpread = -1.f;
+
+    void updatePanGains(float spread) {
+        // Panning positions: TL=-0.5, FD=0, GR=+0.3, LD=+0.7
+        const float panPositions[4] = {-0.5f, 0.f, 0.3f, 0.7f};
+        for (int v = 0; v < 4; v++) {
+            float pan = panPositions[v] * spread;
+            panGainL[v] = std::cos((pan + 1.f) * 0.25f * M_PI);
+            panGainR[v] = std::sin((pan + 1.f) * 0.25f * M_PI);
+        }
+        panSpread = spread;
+    }
+
+    // Voice parameters are refreshed on a control clock and only pushed to the
+    // synth when they change; FREQ is smoothed between control ticks
+    static const int CONTROL_DIVISION = 16;
+    static constexpr float FREQ_SMOOTHING = 0.5f;
+    dsp::ClockDivider controlDivider;
+    bool controlInitialized = false;
+    float synthSampleRate = 0.f;
+    float targetFreq[4] = {};    // octaves, params + CV
+    float smoothedFreq[4] = {};
+    float appliedFreq[4] = {};
+    float appliedDecay[4] = {};
+
+    // CV modulation display values: STYLE, then FREQ and DECAY per voice
+    static constexpr int CVMOD_STYLE = 0;
+    static constexpr int CVMOD_FREQ = 1;
+    static constexpr int CVMOD_DECAY = 5;
+    static constexpr int NUM_CVMODS = 9;
+    madzine::widgets::CVModBank<NUM_CVMODS> cvMods;
 
     // Panel theme
     int panelTheme = -1;
@@ -315,6 +346,7 @@ struct Drummmmmmer : Module {
 
         // Initialize with default style
         applyDrummerPreset(drumSynth, 0);
+        controlDivider.setDivision(CONTROL_DIVISION);
 
         // Load global settings
         panelTheme = madzineDefaultTheme;
@@ -322,43 +354,59 @@ struct Drummmmmmer : Module {
     }
 
     void onSampleRateChange() override {
-        drumSynth.setSampleRate(APP->engine->getSampleRate());
+        synthSampleRate = APP->engine->getSampleRate();
+        drumSynth.setSampleRate(synthSampleRate);
     }
 
-    void process(const ProcessArgs& args) override {
-        // Update sample rate
-        drumSynth.setSampleRate(args.sampleRate);
+    void onReset() override {
+        controlInitialized = false;
+    }
+
+    void applyRoleParams(int v) {
+        const DrummerStylePreset& preset = DRUMMER_PRESETS[currentStyle];
+        int v1 = v * 2;
+        int v2 = v * 2 + 1;
+        float ratio = std::pow(2.f, smoothedFreq[v]);
+        float decayParam = appliedDecay[v];
+
+        drumSynth.setVoiceParams(v1, preset.voices[v1].mode, preset.voices[v1].freq * ratio, preset.voices[v1].decay * decayParam,
+                                 preset.voices[v1].sweep, preset.voices[v1].bend);
+        drumSynth.setVoiceParams(v2, preset.voices[v2].mode, preset.voices[v2].freq * ratio, preset.voices[v2].decay * decayParam,
+                                 preset.voices[v2].sweep, preset.voices[v2].bend);
+        appliedFreq[v] = smoothedFreq[v];
+    }
+
+    /**
+     * Control rate: style, FREQ/DECAY with CV; voices are only updated when
+     * their values change
+     */
+    void updateControls(float sampleRate) {
+        bool force = !controlInitialized;
+
+        if (sampleRate != synthSampleRate) {
+            synthSampleRate = sampleRate;
+            drumSynth.setSampleRate(sampleRate);
+        }
 
         // Read style parameter with CV
         float styleValue = params[STYLE_PARAM].getValue();
         if (inputs[STYLE_CV_INPUT].isConnected()) {
             float cv = inputs[STYLE_CV_INPUT].getVoltage();
             styleValue += cv;
-            styleCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+            cvMods.publish(CVMOD_STYLE, clamp(cv / 10.0f, -1.0f, 1.0f));
         } else {
-            styleCvMod = 0.0f;
+            cvMods.clear(CVMOD_STYLE);
         }
         int newStyle = clamp((int)std::round(styleValue), 0, 9);
 
         // Apply style preset if changed
-        if (newStyle != currentStyle) {
+        if (newStyle != currentStyle || force) {
             currentStyle = newStyle;
             applyDrummerPreset(drumSynth, currentStyle);
+            force = true;
         }
 
-        // Get base preset for parameter modulation (8 voices)
-        const DrummerStylePreset& preset = DRUMMER_PRESETS[currentStyle];
-
-        // Voice variation probability
-        float voiceProb = params[VOICE_PARAM].getValue();
-
-        // Process each role (4 roles × 2 voices each)
-        float voiceOutputs[4];
-
         for (int v = 0; v < 4; v++) {
-            int v1 = v * 2;
-            int v2 = v * 2 + 1;
-
             // Read parameters with CV modulation
             float freqParam = params[FREQ_PARAM_TL + v].getValue();
             float decayParam = params[DECAY_PARAM_TL + v].getValue();
@@ -367,36 +415,59 @@ struct Drummmmmmer : Module {
             if (inputs[FREQ_CV_INPUT_TL + v].isConnected()) {
                 float cv = inputs[FREQ_CV_INPUT_TL + v].getVoltage();
                 freqParam += cv * 0.2f;
-                freqCvMod[v] = clamp(cv / 10.0f, -1.0f, 1.0f);
+                cvMods.publish(CVMOD_FREQ + v, clamp(cv / 10.0f, -1.0f, 1.0f));
             } else {
-                freqCvMod[v] = 0.0f;
+                cvMods.clear(CVMOD_FREQ + v);
             }
-            freqParam = clamp(freqParam, -1.f, 1.f);
+            targetFreq[v] = clamp(freqParam, -1.f, 1.f);
 
             // DECAY CV: ±5V = ±0.9 multiplier
             if (inputs[DECAY_CV_INPUT_TL + v].isConnected()) {
                 float cv = inputs[DECAY_CV_INPUT_TL + v].getVoltage();
                 decayParam += cv * 0.18f;
-                decayCvMod[v] = clamp(cv / 10.0f, -1.0f, 1.0f);
+                cvMods.publish(CVMOD_DECAY + v, clamp(cv / 10.0f, -1.0f, 1.0f));
             } else {
-                decayCvMod[v] = 0.0f;
+                cvMods.clear(CVMOD_DECAY + v);
             }
             decayParam = clamp(decayParam, 0.2f, 2.f);
 
-            // Apply modulation to both voices (each with its own base freq/decay)
-            float modFreq1 = preset.voices[v1].freq * std::pow(2.f, freqParam);
-            float modDecay1 = preset.voices[v1].decay * decayParam;
-            float modFreq2 = preset.voices[v2].freq * std::pow(2.f, freqParam);
-            float modDecay2 = preset.voices[v2].decay * decayParam;
+            float freq = smoothedFreq[v] + (targetFreq[v] - smoothedFreq[v]) * FREQ_SMOOTHING;
+            if (force || std::fabs(targetFreq[v] - freq) < 1e-4f) freq = targetFreq[v];
+            smoothedFreq[v] = freq;
+
+            if (force || freq != appliedFreq[v] || decayParam != appliedDecay[v]) {
+                appliedDecay[v] = decayParam;
+                applyRoleParams(v);
+            }
+        }
+
+        controlInitialized = true;
+    }
+
+    void process(const ProcessArgs& args) override {
+        if (controlDivider.process() || !controlInitialized) {
+            updateControls(args.sampleRate);
+        }
+
+        // Voice variation probability
+        float voiceProb = params[VOICE_PARAM].getValue();
 
-            drumSynth.setVoiceParams(v1, preset.voices[v1].mode, modFreq1, modDecay1,
-                                     preset.voices[v1].sweep, preset.voices[v1].bend);
-            drumSynth.setVoiceParams(v2, preset.voices[v2].mode, modFreq2, modDecay2,
-                                     preset.voices[v2].sweep, preset.voices[v2].bend);
+        // Voice outputs: [first voice of each role, second voice of each role]
+        alignas(16) float voiceOutputs[8];
+
+        for (int v = 0; v < 4; v++) {
+            int v1 = v * 2;
+            int v2 = v * 2 + 1;
 
             // Trigger detection — select v1 or v2 based on VOICE probability
             if (inputs[TRIG_INPUT_TL + v].isConnected()) {
                 if (trigSchmitt[v].process(inputs[TRIG_INPUT_TL + v].getVoltage(), 0.1f, 2.f)) {
+                    // A hit starts at the target pitch, not mid-glide
+                    if (smoothedFreq[v] != targetFreq[v]) {
+                        smoothedFreq[v] = targetFreq[v];
+                        applyRoleParams(v);
+                    }
+
                     float velocity = 1.0f;
                     if (inputs[VEL_INPUT_TL + v].isConnected()) {
                         velocity = clamp(inputs[VEL_INPUT_TL + v].getVoltage() / 10.f, 0.f, 1.f);
@@ -408,29 +479,27 @@ struct Drummmmmmer : Module {
                 }
             }
 
-            // Process both voices and sum (one decaying, one possibly fresh)
-            voiceOutputs[v] = drumSynth.processVoice(v1) + drumSynth.processVoice(v2);
+            // Process both voices (one decaying, one possibly fresh)
+            voiceOutputs[v] = drumSynth.processVoice(v1);
+            voiceOutputs[4 + v] = drumSynth.processVoice(v2);
         }
 
+        // Sum both voices per role
+        simd::float_4 roles = simd::float_4::load(voiceOutputs) + simd::float_4::load(voiceOutputs + 4);
+
         // Output per-voice audio
         for (int v = 0; v < 4; v++) {
-            outputs[AUDIO_OUTPUT_TL + v].setVoltage(voiceOutputs[v] * 5.f);
+            outputs[AUDIO_OUTPUT_TL + v].setVoltage(roles[v] * 5.f);
         }
 
         // Stereo mix with spread
         float spread = params[SPREAD_PARAM].getValue();
-        float mixL = 0.f, mixR = 0.f;
+        if (spread != panSpread) updatePanGains(spread);
 
-        // Panning positions: TL=-0.5, FD=0, GR=+0.3, LD=+0.7
-        const float panPositions[4] = {-0.5f, 0.f, 0.3f, 0.7f};
-
-        for (int v = 0; v < 4; v++) {
-            float pan = panPositions[v] * spread;
-            float gainL = std::cos((pan + 1.f) * 0.25f * M_PI);
-            float gainR = std::sin((pan + 1.f) * 0.25f * M_PI);
-            mixL += voiceOutputs[v] * gainL;
-            mixR += voiceOutputs[v] * gainR;
-        }
+        simd::float_4 left = roles * panGainL;
+        simd::float_4 right = roles * panGainR;
+        float mixL = left[0] + left[1] + left[2] + left[3];
+        float mixR = right[0] + right[1] + right[2] + right[3];
 
         // Soft limiting
         outputs[MIX_L_OUTPUT].setVoltage(std::tanh(mixL) * 5.f);
@@ -586,6 +655,7 @@ struct DrummmmmmerWidget : ModuleWidget {
     TechnoSnapKnob30* styleKnob = nullptr;
     MediumGrayKnob* freqKnobs[4] = {};
     MediumGrayKnob* decayKnobs[4] = {};
+    madzine::widgets::CVModRingSync<Drummmmmmer::NUM_CVMODS> cvModSync;
 
     DrummmmmmerWidget(Drummmmmmer* module) {
         setModule(module);
@@ -606,6 +676,7 @@ struct DrummmmmmerWidget : ModuleWidget {
         // STYLE knob (TechnoSnapKnob30, 30px) X=18, Y=56
         styleKnob = createParamCentered<TechnoSnapKnob30>(Vec(18.f, 56.f), module, Drummmmmmer::STYLE_PARAM);
         addParam(styleKnob);
+        cvModSync.bind(Drummmmmmer::CVMOD_STYLE, styleKnob);
         // STYLE CV port (24px) X=106, Y=56
         addInput(createInputCentered<PJ301MPort>(Vec(106.f, 56.f), module, Drummmmmmer::STYLE_CV_INPUT));
 
@@ -629,8 +700,10 @@ struct DrummmmmmerWidget : ModuleWidget {
             addInput(createInputCentered<PJ301MPort>(Vec(trigX, sY), module, Drummmmmmer::TRIG_INPUT_TL + vi));
             freqKnobs[vi] = createParamCentered<MediumGrayKnob>(Vec(freqX, sY), module, Drummmmmmer::FREQ_PARAM_TL + vi);
             addParam(freqKnobs[vi]);
+            cvModSync.bind(Drummmmmmer::CVMOD_FREQ + vi, freqKnobs[vi]);
             decayKnobs[vi] = createParamCentered<MediumGrayKnob>(Vec(decayX, sY), module, Drummmmmmer::DECAY_PARAM_TL + vi);
             addParam(decayKnobs[vi]);
+            cvModSync.bind(Drummmmmmer::CVMOD_DECAY + vi, decayKnobs[vi]);
             addOutput(createOutputCentered<PJ301MPort>(Vec(outX, sY), module, Drummmmmmer::AUDIO_OUTPUT_TL + vi));
 
             // Row 2 (sY+26): VEL port | FREQ CV port | DECAY CV port
@@ -697,23 +770,8 @@ struct DrummmmmmerWidget : ModuleWidget {
         if (m) {
             panelHelper.step(m);
 
-            if (styleKnob) {
-                bool connected = m->inputs[Drummmmmmer::STYLE_CV_INPUT].isConnected();
-                styleKnob->setModulationEnabled(connected);
-                if (connected) styleKnob->setModulation(m->styleCvMod);
-            }
-            for (int v = 0; v < 4; v++) {
-                if (freqKnobs[v]) {
-                    bool connected = m->inputs[Drummmmmmer::FREQ_CV_INPUT_TL + v].isConnected();
-                    freqKnobs[v]->setModulationEnabled(connected);
-                    if (connected) freqKnobs[v]->setModulation(m->freqCvMod[v]);
-                }
-                if (decayKnobs[v]) {
-                    bool connected = m->inputs[Drummmmmmer::DECAY_CV_INPUT_TL + v].isConnected();
-                    decayKnobs[v]->setModulationEnabled(connected);
-                    if (connected) decayKnobs[v]->setModulation(m->decayCvMod[v]);
-                }
-            }
+            // CV modulation ring display (only touches knobs whose value changed)
+            cvModSync.sync(m->cvMods);
         }
         ModuleWidget::step();
     }
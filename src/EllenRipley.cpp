@@ -1,6 +1,8 @@
 #include "plugin.hpp"
 #include "widgets/Knobs.hpp"
+#include "widgets/CVModulation.hpp"
 #include "widgets/PanelTheme.hpp"
+#include "RipleyDSP.hpp"
 
 using namespace rack;
 using namespace rack::engine;
@@ -62,353 +64,6 @@ struct WhiteBackgroundBox : Widget {
 // StandardBlackKnob 現在從 widgets/Knobs.hpp 引入
 
 
-struct ChaosGenerator {
-    float x = 0.1f;
-    float y = 0.1f;
-    float z = 0.1f;
-    
-    void reset() {
-        x = 0.1f;
-        y = 0.1f;
-        z = 0.1f;
-    }
-    
-    float process(float rate) {
-        float dt = rate * 0.001f;
-        
-        float dx = 7.5f * (y - x);
-        float dy = x * (30.9f - z) - y;
-        float dz = x * y - 1.02f * z;
-        
-        x += dx * dt;
-        y += dy * dt;
-        z += dz * dt;
-        
-        // Prevent numerical explosion
-        if (std::isnan(x) || std::isnan(y) || std::isnan(z) || 
-            std::abs(x) > 100.0f || std::abs(y) > 100.0f || std::abs(z) > 100.0f) {
-            reset();
-        }
-        
-        return clamp(x * 0.1f, -1.0f, 1.0f);
-    }
-};
-
-struct ReverbProcessor {
-    // Freeverb-style parallel comb filters + series allpass
-    static constexpr int COMB_1_SIZE = 1557;  // ~32ms at 48kHz
-    static constexpr int COMB_2_SIZE = 1617;  // ~34ms
-    static constexpr int COMB_3_SIZE = 1491;  // ~31ms
-    static constexpr int COMB_4_SIZE = 1422;  // ~30ms
-    static constexpr int COMB_5_SIZE = 1277;  // ~27ms (for stereo)
-    static constexpr int COMB_6_SIZE = 1356;  // ~28ms (for stereo)
-    static constexpr int COMB_7_SIZE = 1188;  // ~25ms (for stereo)
-    static constexpr int COMB_8_SIZE = 1116;  // ~23ms (for stereo)
-    
-    float combBuffer1[COMB_1_SIZE];
-    float combBuffer2[COMB_2_SIZE];
-    float combBuffer3[COMB_3_SIZE];
-    float combBuffer4[COMB_4_SIZE];
-    float combBuffer5[COMB_5_SIZE];
-    float combBuffer6[COMB_6_SIZE];
-    float combBuffer7[COMB_7_SIZE];
-    float combBuffer8[COMB_8_SIZE];
-    
-    int combIndex1 = 0, combIndex2 = 0, combIndex3 = 0, combIndex4 = 0;
-    int combIndex5 = 0, combIndex6 = 0, combIndex7 = 0, combIndex8 = 0;
-    
-    // Lowpass filters in comb feedback loops
-    float combLp1 = 0.0f, combLp2 = 0.0f, combLp3 = 0.0f, combLp4 = 0.0f;
-    float combLp5 = 0.0f, combLp6 = 0.0f, combLp7 = 0.0f, combLp8 = 0.0f;
-    
-    // Highpass filter for reverb output (to remove sub-100Hz)
-    float hpState = 0.0f;
-    
-    // Series allpass filters for diffusion
-    static constexpr int ALLPASS_1_SIZE = 556;
-    static constexpr int ALLPASS_2_SIZE = 441;
-    static constexpr int ALLPASS_3_SIZE = 341;
-    static constexpr int ALLPASS_4_SIZE = 225;
-    
-    float allpassBuffer1[ALLPASS_1_SIZE];
-    float allpassBuffer2[ALLPASS_2_SIZE];
-    float allpassBuffer3[ALLPASS_3_SIZE];
-    float allpassBuffer4[ALLPASS_4_SIZE];
-    
-    int allpassIndex1 = 0, allpassIndex2 = 0, allpassIndex3 = 0, allpassIndex4 = 0;
-    
-    ReverbProcessor() { reset(); }
-    
-    void reset() {
-        for (int i = 0; i < COMB_1_SIZE; i++) combBuffer1[i] = 0.0f;
-        for (int i = 0; i < COMB_2_SIZE; i++) combBuffer2[i] = 0.0f;
-        for (int i = 0; i < COMB_3_SIZE; i++) combBuffer3[i] = 0.0f;
-        for (int i = 0; i < COMB_4_SIZE; i++) combBuffer4[i] = 0.0f;
-        for (int i = 0; i < COMB_5_SIZE; i++) combBuffer5[i] = 0.0f;
-        for (int i = 0; i < COMB_6_SIZE; i++) combBuffer6[i] = 0.0f;
-        for (int i = 0; i < COMB_7_SIZE; i++) combBuffer7[i] = 0.0f;
-        for (int i = 0; i < COMB_8_SIZE; i++) combBuffer8[i] = 0.0f;
-        
-        for (int i = 0; i < ALLPASS_1_SIZE; i++) allpassBuffer1[i] = 0.0f;
-        for (int i = 0; i < ALLPASS_2_SIZE; i++) allpassBuffer2[i] = 0.0f;
-        for (int i = 0; i < ALLPASS_3_SIZE; i++) allpassBuffer3[i] = 0.0f;
-        for (int i = 0; i < ALLPASS_4_SIZE; i++) allpassBuffer4[i] = 0.0f;
-        
-        combIndex1 = combIndex2 = combIndex3 = combIndex4 = 0;
-        combIndex5 = combIndex6 = combIndex7 = combIndex8 = 0;
-        allpassIndex1 = allpassIndex2 = allpassIndex3 = allpassIndex4 = 0;
-        
-        combLp1 = combLp2 = combLp3 = combLp4 = 0.0f;
-        combLp5 = combLp6 = combLp7 = combLp8 = 0.0f;
-        hpState = 0.0f;
-    }
-    
-    float processComb(float input, float* buffer, int size, int& index, float feedback, float& lp, float damping) {
-        float output = buffer[index];
-        
-        // Apply lowpass filter to feedback signal
-        lp = lp + (output - lp) * damping;
-        
-        // Write input + filtered feedback
-        buffer[index] = input + lp * feedback;
-        index = (index + 1) % size;
-        
-        return output;
-    }
-    
-    float processAllpass(float input, float* buffer, int size, int& index, float gain) {
-        float delayed = buffer[index];
-        float output = -input * gain + delayed;
-        buffer[index] = input + delayed * gain;
-        index = (index + 1) % size;
-        return output;
-    }
-    
-    float process(float inputL, float inputR, float grainDensity,
-                  float roomSize, float damping, float decay, bool isLeftChannel,
-                  bool chaosEnabled, float chaosOutput, float sampleRate) {
-        
-        // Use proper stereo input instead of mixing to mono
-        float input = isLeftChannel ? inputL : inputR;
-        
-        // Calculate feedback based on decay - much wider range for 10+ second tails
-        float feedback = 0.5f + decay * 0.485f; // 0.5 to 0.985 (near infinite at max)
-        if (chaosEnabled) {
-            feedback += chaosOutput * 0.5f; // Enhanced chaos effect 10x from 0.05f
-            feedback = clamp(feedback, 0.0f, 0.995f);
-        }
-        
-        // Damping: low value = more damping (darker), high value = less damping (brighter)
-        float dampingCoeff = 0.05f + damping * 0.9f;
-        
-        // Room size affects delay buffer read positions dramatically
-        float roomScale = 0.3f + roomSize * 1.4f; // 0.3 to 1.7 scaling
-        
-        float combOut = 0.0f;
-        
-        if (isLeftChannel) {
-            // Room size creates variable delay taps for room simulation
-            // Ensure room offsets are always positive
-            int roomOffset1 = std::max(0, (int)(roomSize * 400 + chaosOutput * 50)); // 0-450 samples
-            int roomOffset2 = std::max(0, (int)(roomSize * 350 + chaosOutput * 40));
-            // Unused room offsets (corresponding read indices are not used)
-            // int roomOffset3 = std::max(0, (int)(roomSize * 300 + chaosOutput * 60));
-            // int roomOffset4 = std::max(0, (int)(roomSize * 500 + chaosOutput * 70));
-            
-            // Use room-modulated delay reads with safe modulo operation
-            int readIdx1 = ((combIndex1 - roomOffset1) % COMB_1_SIZE + COMB_1_SIZE) % COMB_1_SIZE;
-            int readIdx2 = ((combIndex2 - roomOffset2) % COMB_2_SIZE + COMB_2_SIZE) % COMB_2_SIZE;
-            // Unused read indices
-            // int readIdx3 = ((combIndex3 - roomOffset3) % COMB_3_SIZE + COMB_3_SIZE) % COMB_3_SIZE;
-            // int readIdx4 = ((combIndex4 - roomOffset4) % COMB_4_SIZE + COMB_4_SIZE) % COMB_4_SIZE;
-            
-            float roomInput = input * roomScale;
-            combOut += processComb(roomInput, combBuffer1, COMB_1_SIZE, combIndex1, feedback, combLp1, dampingCoeff);
-            combOut += processComb(roomInput, combBuffer2, COMB_2_SIZE, combIndex2, feedback, combLp2, dampingCoeff);
-            combOut += processComb(roomInput, combBuffer3, COMB_3_SIZE, combIndex3, feedback, combLp3, dampingCoeff);
-            combOut += processComb(roomInput, combBuffer4, COMB_4_SIZE, combIndex4, feedback, combLp4, dampingCoeff);
-            
-            // Add room reflections
-            combOut += combBuffer1[readIdx1] * roomSize * 0.15f;
-            combOut += combBuffer2[readIdx2] * roomSize * 0.12f;
-        } else {
-            // Right channel: different room characteristics
-            // Ensure room offsets are always positive
-            int roomOffset5 = std::max(0, (int)(roomSize * 380 + chaosOutput * 45));
-            int roomOffset6 = std::max(0, (int)(roomSize * 420 + chaosOutput * 55));
-            // Unused room offsets (corresponding read indices are not used)
-            // int roomOffset7 = std::max(0, (int)(roomSize * 280 + chaosOutput * 35));
-            // int roomOffset8 = std::max(0, (int)(roomSize * 460 + chaosOutput * 65));
-            
-            // Use safe modulo operation
-            int readIdx5 = ((combIndex5 - roomOffset5) % COMB_5_SIZE + COMB_5_SIZE) % COMB_5_SIZE;
-            int readIdx6 = ((combIndex6 - roomOffset6) % COMB_6_SIZE + COMB_6_SIZE) % COMB_6_SIZE;
-            // Unused read indices
-            // int readIdx7 = ((combIndex7 - roomOffset7) % COMB_7_SIZE + COMB_7_SIZE) % COMB_7_SIZE;
-            // int readIdx8 = ((combIndex8 - roomOffset8) % COMB_8_SIZE + COMB_8_SIZE) % COMB_8_SIZE;
-            
-            float roomInput = input * roomScale;
-            combOut += processComb(roomInput, combBuffer5, COMB_5_SIZE, combIndex5, feedback, combLp5, dampingCoeff);
-            combOut += processComb(roomInput, combBuffer6, COMB_6_SIZE, combIndex6, feedback, combLp6, dampingCoeff);
-            combOut += processComb(roomInput, combBuffer7, COMB_7_SIZE, combIndex7, feedback, combLp7, dampingCoeff);
-            combOut += processComb(roomInput, combBuffer8, COMB_8_SIZE, combIndex8, feedback, combLp8, dampingCoeff);
-            
-            // Add room reflections
-            combOut += combBuffer5[readIdx5] * roomSize * 0.13f;
-            combOut += combBuffer6[readIdx6] * roomSize * 0.11f;
-        }
-        
-        // Scale comb output
-        combOut *= 0.25f;
-        
-        // Series allpass diffusion
-        float diffused = combOut;
-        diffused = processAllpass(diffused, allpassBuffer1, ALLPASS_1_SIZE, allpassIndex1, 0.5f);
-        diffused = processAllpass(diffused, allpassBuffer2, ALLPASS_2_SIZE, allpassIndex2, 0.5f);
-        diffused = processAllpass(diffused, allpassBuffer3, ALLPASS_3_SIZE, allpassIndex3, 0.5f);
-        diffused = processAllpass(diffused, allpassBuffer4, ALLPASS_4_SIZE, allpassIndex4, 0.5f);
-        
-        // Apply highpass filter to remove frequencies below ~100Hz
-        // Cutoff frequency calculation for 100Hz at 48kHz: fc = 100/(48000/2) = 0.00416
-        float hpCutoff = 100.0f / (sampleRate * 0.5f); // Normalized frequency
-        hpCutoff = clamp(hpCutoff, 0.001f, 0.1f); // Safety clamp
-        hpState += (diffused - hpState) * hpCutoff;
-        float hpOutput = diffused - hpState;
-        
-        return hpOutput;
-    }
-};
-
-struct GrainProcessor {
-    static constexpr int GRAIN_BUFFER_SIZE = 8192;
-    float grainBuffer[GRAIN_BUFFER_SIZE];
-    int grainWriteIndex = 0;
-    
-    struct Grain {
-        bool active = false;
-        float position = 0.0f;
-        float size = 0.0f;
-        float envelope = 0.0f;
-        float direction = 1.0f;
-        float pitch = 1.0f;
-    };
-    
-    static constexpr int MAX_GRAINS = 16;
-    Grain grains[MAX_GRAINS];
-    
-    float phase = 0.0f;
-    dsp::SchmittTrigger grainTrigger;
-    
-    void reset() {
-        for (int i = 0; i < GRAIN_BUFFER_SIZE; i++) {
-            grainBuffer[i] = 0.0f;
-        }
-        grainWriteIndex = 0;
-        
-        for (int i = 0; i < MAX_GRAINS; i++) {
-            grains[i].active = false;
-        }
-        phase = 0.0f;
-    }
-    
-    float process(float input, float grainSize, float density, float position, 
-                  bool chaosEnabled, float chaosOutput, float sampleRate) {
-        
-        grainBuffer[grainWriteIndex] = input;
-        grainWriteIndex = (grainWriteIndex + 1) % GRAIN_BUFFER_SIZE;
-        
-        float grainSizeMs = grainSize * 99.0f + 1.0f;
-        float grainSamples = (grainSizeMs / 1000.0f) * sampleRate;
-        
-        float densityValue = density;
-        if (chaosEnabled) {
-            densityValue += chaosOutput * 0.3f;
-        }
-        densityValue = clamp(densityValue, 0.0f, 1.0f);
-        
-        float triggerRate = densityValue * 50.0f + 1.0f;
-        phase += triggerRate / sampleRate;
-        
-        if (phase >= 1.0f) {
-            phase -= 1.0f;
-            
-            for (int i = 0; i < MAX_GRAINS; i++) {
-                if (!grains[i].active) {
-                    grains[i].active = true;
-                    grains[i].size = grainSamples;
-                    grains[i].envelope = 0.0f;
-                    
-                    float pos = position;
-                    if (chaosEnabled) {
-                        pos += chaosOutput * 20.0f; // Enhanced shift 10x from 2.0f
-                        if (random::uniform() < 0.3f) {
-                            grains[i].direction = -1.0f;
-                        } else {
-                            grains[i].direction = 1.0f;
-                        }
-                        
-                        if (densityValue > 0.7f && random::uniform() < 0.2f) {
-                            grains[i].pitch = random::uniform() < 0.5f ? 0.5f : 2.0f;
-                        } else {
-                            grains[i].pitch = 1.0f;
-                        }
-                    } else {
-                        grains[i].direction = 1.0f;
-                        grains[i].pitch = 1.0f;
-                    }
-                    
-                    pos = clamp(pos, 0.0f, 1.0f);
-                    grains[i].position = pos * GRAIN_BUFFER_SIZE;
-                    break;
-                }
-            }
-        }
-        
-        float output = 0.0f;
-        int activeGrains = 0;
-        
-        for (int i = 0; i < MAX_GRAINS; i++) {
-            if (grains[i].active) {
-                float envPhase = grains[i].envelope / grains[i].size;
-                
-                if (envPhase >= 1.0f) {
-                    grains[i].active = false;
-                    continue;
-                }
-                
-                float env = 0.5f * (1.0f - cos(envPhase * 2.0f * M_PI));
-                
-                int readPos = (int)grains[i].position;
-                // Ensure readPos is always valid
-                readPos = ((readPos % GRAIN_BUFFER_SIZE) + GRAIN_BUFFER_SIZE) % GRAIN_BUFFER_SIZE;
-                
-                float sample = grainBuffer[readPos];
-                output += sample * env;
-                
-                // Update position with proper boundary handling
-                grains[i].position += grains[i].direction * grains[i].pitch;
-                
-                // Handle position wrapping to prevent accumulated floating point errors
-                while (grains[i].position >= GRAIN_BUFFER_SIZE) {
-                    grains[i].position -= GRAIN_BUFFER_SIZE;
-                }
-                while (grains[i].position < 0) {
-                    grains[i].position += GRAIN_BUFFER_SIZE;
-                }
-                
-                grains[i].envelope += 1.0f;
-                activeGrains++;
-            }
-        }
-        
-        if (activeGrains > 0) {
-            output /= sqrt(activeGrains);
-        }
-        
-        return output;
-    }
-};
-
 struct EllenRipley : rack::engine::Module {
     int panelTheme = madzineDefaultTheme;
     float panelContrast = madzineDefaultContrast; // -1 = Auto (follow VCV) // 0 = Sashimi, 1 = Boring
@@ -462,32 +117,52 @@ struct EllenRipley : rack::engine::Module {
         NUM_LIGHTS
     };
 
-    static constexpr int DELAY_BUFFER_SIZE = 96000;
     static constexpr int MAX_POLY = 16;
-    float leftDelayBuffer[MAX_POLY][DELAY_BUFFER_SIZE];
-    float rightDelayBuffer[MAX_POLY][DELAY_BUFFER_SIZE];
-    int delayWriteIndex[MAX_POLY];
+
+    // Per-channel delay line (2 s at the engine sample rate), allocated on
+    // demand for the channels actually in use
+    struct Channel {
+        float sampleRate;
+        RipleyDelayLine delay;
+
+        explicit Channel(float sr) : sampleRate(sr), delay(sr) {}
+
+        void reset() {
+            delay.reset();
+        }
+    };
+    LazyChannelPool<Channel, MAX_POLY> channelPool{APP->engine->getSampleRate()};
+
+    // Grain and reverb state is fixed-size and always present, so the chain
+    // keeps running while a channel's delay line is still being allocated
+    GrainProcessor leftGrain[MAX_POLY];
+    GrainProcessor rightGrain[MAX_POLY];
+    ReverbProcessor leftReverb[MAX_POLY];
+    ReverbProcessor rightReverb[MAX_POLY];
 
     ChaosGenerator chaosGen[MAX_POLY];
-    GrainProcessor leftGrainProcessor[MAX_POLY];
-    GrainProcessor rightGrainProcessor[MAX_POLY];
-    ReverbProcessor leftReverbProcessor[MAX_POLY];
-    ReverbProcessor rightReverbProcessor[MAX_POLY];
+    // Chaos step (S&H) state per channel
+    float chaosStepValue[MAX_POLY] = {};
+    float chaosStepPhase[MAX_POLY] = {};
     
     bool delayChaosMod = false;
     bool grainChaosMod = false;
     bool reverbChaosMod = false;
 
     // CV 調變顯示用
-    float delayTimeLCvMod = 0.0f;
-    float delayTimeRCvMod = 0.0f;
-    float delayFeedbackCvMod = 0.0f;
-    float grainSizeCvMod = 0.0f;
-    float grainDensityCvMod = 0.0f;
-    float grainPositionCvMod = 0.0f;
-    float reverbRoomSizeCvMod = 0.0f;
-    float reverbDampingCvMod = 0.0f;
-    float reverbDecayCvMod = 0.0f;
+    enum CvModId {
+        CVMOD_DELAY_TIME_L,
+        CVMOD_DELAY_TIME_R,
+        CVMOD_DELAY_FEEDBACK,
+        CVMOD_GRAIN_SIZE,
+        CVMOD_GRAIN_DENSITY,
+        CVMOD_GRAIN_POSITION,
+        CVMOD_REVERB_ROOM_SIZE,
+        CVMOD_REVERB_DAMPING,
+        CVMOD_REVERB_DECAY,
+        NUM_CVMODS
+    };
+    madzine::widgets::CVModBank<NUM_CVMODS> cvMods;
     
     EllenRipley() {
         config(NUM_PARAMS, NUM_INPUTS, NUM_OUTPUTS, NUM_LIGHTS);
@@ -534,29 +209,25 @@ struct EllenRipley : rack::engine::Module {
         configLight(REVERB_CHAOS_LIGHT, "Reverb Chaos");
         configLight(CHAOS_SHAPE_LIGHT, "Chaos Shape");
 
-        // Initialize buffers for all polyphonic channels
+        // Decorrelate L/R grain scheduling from one per-channel seed
         for (int c = 0; c < MAX_POLY; c++) {
-            for (int i = 0; i < DELAY_BUFFER_SIZE; i++) {
-                leftDelayBuffer[c][i] = 0.0f;
-                rightDelayBuffer[c][i] = 0.0f;
-            }
-            delayWriteIndex[c] = 0;
+            uint32_t seed = random::u32();
+            leftGrain[c].seed(seed);
+            rightGrain[c].seed(seed ^ 0x9E3779B9u);
         }
     }
     
     void onReset() override {
         for (int c = 0; c < MAX_POLY; c++) {
             chaosGen[c].reset();
-            leftGrainProcessor[c].reset();
-            rightGrainProcessor[c].reset();
-            leftReverbProcessor[c].reset();
-            rightReverbProcessor[c].reset();
-            for (int i = 0; i < DELAY_BUFFER_SIZE; i++) {
-                leftDelayBuffer[c][i] = 0.0f;
-                rightDelayBuffer[c][i] = 0.0f;
-            }
-            delayWriteIndex[c] = 0;
+            chaosStepValue[c] = 0.0f;
+            chaosStepPhase[c] = 0.0f;
+            leftGrain[c].reset();
+            rightGrain[c].reset();
+            leftReverb[c].reset();
+            rightReverb[c].reset();
         }
+        channelPool.forEach([](Channel& ch) { ch.reset(); });
     }
 
     json_t* dataToJson() override {
@@ -592,6 +263,8 @@ struct EllenRipley : rack::engine::Module {
         outputs[RIGHT_AUDIO_OUTPUT].setChannels(channels);
         outputs[CHAOS_CV_OUTPUT].setChannels(channels);
 
+        channelPool.update(channels, args.sampleRate);
+
         delayChaosMod = params[DELAY_CHAOS_PARAM].getValue() > 0.5f;
         grainChaosMod = params[GRAIN_CHAOS_PARAM].getValue() > 0.5f;
         reverbChaosMod = params[REVERB_CHAOS_PARAM].getValue() > 0.5f;
@@ -621,15 +294,13 @@ struct EllenRipley : rack::engine::Module {
             float chaosOutput;
             if (chaosStep) {
                 // Use chaos rate to control step update frequency per channel
-                static float lastStep[MAX_POLY] = {};
-                static float stepPhase[MAX_POLY] = {};
                 float stepRate = chaosRate * 10.0f; // Scale rate for step frequency
-                stepPhase[c] += stepRate / args.sampleRate;
-                if (stepPhase[c] >= 1.0f) {
-                    lastStep[c] = chaosRaw;
-                    stepPhase[c] = 0.0f;
+                chaosStepPhase[c] += stepRate / args.sampleRate;
+                if (chaosStepPhase[c] >= 1.0f) {
+                    chaosStepValue[c] = chaosRaw;
+                    chaosStepPhase[c] = 0.0f;
                 }
-                chaosOutput = lastStep[c];
+                chaosOutput = chaosStepValue[c];
             } else {
                 chaosOutput = chaosRaw;
             }
@@ -661,9 +332,9 @@ struct EllenRipley : rack::engine::Module {
             if (inputs[DELAY_TIME_L_CV_INPUT].isConnected()) {
                 float cv = getCVInput(inputs[DELAY_TIME_L_CV_INPUT], c);
                 delayTimeL += cv * 0.2f;
-                if (c == 0) delayTimeLCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+                if (c == 0) cvMods.publish(CVMOD_DELAY_TIME_L, clamp(cv / 10.0f, -1.0f, 1.0f));
             } else if (c == 0) {
-                delayTimeLCvMod = 0.0f;
+                cvMods.clear(CVMOD_DELAY_TIME_L);
             }
             if (delayChaosMod) {
                 delayTimeL += chaosOutput * 0.1f;
@@ -674,9 +345,9 @@ struct EllenRipley : rack::engine::Module {
             if (inputs[DELAY_TIME_R_CV_INPUT].isConnected()) {
                 float cv = getCVInput(inputs[DELAY_TIME_R_CV_INPUT], c);
                 delayTimeR += cv * 0.2f;
-                if (c == 0) delayTimeRCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+                if (c == 0) cvMods.publish(CVMOD_DELAY_TIME_R, clamp(cv / 10.0f, -1.0f, 1.0f));
             } else if (c == 0) {
-                delayTimeRCvMod = 0.0f;
+                cvMods.clear(CVMOD_DELAY_TIME_R);
             }
             if (delayChaosMod) {
                 delayTimeR += chaosOutput * 0.1f;
@@ -687,34 +358,41 @@ struct EllenRipley : rack::engine::Module {
             if (inputs[DELAY_FEEDBACK_CV_INPUT].isConnected()) {
                 float cv = getCVInput(inputs[DELAY_FEEDBACK_CV_INPUT], c);
                 feedback += cv * 0.1f;
-                if (c == 0) delayFeedbackCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+                if (c == 0) cvMods.publish(CVMOD_DELAY_FEEDBACK, clamp(cv / 10.0f, -1.0f, 1.0f));
             } else if (c == 0) {
-                delayFeedbackCvMod = 0.0f;
+                cvMods.clear(CVMOD_DELAY_FEEDBACK);
             }
             if (delayChaosMod) {
                 feedback += chaosOutput * 0.1f;
             }
             feedback = clamp(feedback, 0.0f, 0.95f);
 
-            int delaySamplesL = (int)(delayTimeL * args.sampleRate);
-            delaySamplesL = clamp(delaySamplesL, 1, DELAY_BUFFER_SIZE - 1);
+            // The delay line is allocated off the audio thread; until it is
+            // ready (right after the channel count grows) only the delay stage
+            // is bypassed
+            Channel* ch = channelPool.get(c);
+            float leftDelayedSignal = 0.0f;
+            float rightDelayedSignal = 0.0f;
+            if (ch) {
+                RipleyDelayLine& delay = ch->delay;
 
-            int delaySamplesR = (int)(delayTimeR * args.sampleRate);
-            delaySamplesR = clamp(delaySamplesR, 1, DELAY_BUFFER_SIZE - 1);
+                int delaySamplesL = (int)(delayTimeL * args.sampleRate);
+                delaySamplesL = clamp(delaySamplesL, 1, delay.size - 1);
 
-            int readIndexL = (delayWriteIndex[c] - delaySamplesL + DELAY_BUFFER_SIZE) % DELAY_BUFFER_SIZE;
-            int readIndexR = (delayWriteIndex[c] - delaySamplesR + DELAY_BUFFER_SIZE) % DELAY_BUFFER_SIZE;
+                int delaySamplesR = (int)(delayTimeR * args.sampleRate);
+                delaySamplesR = clamp(delaySamplesR, 1, delay.size - 1);
 
-            float leftDelayedSignal = leftDelayBuffer[c][readIndexL];
-            float rightDelayedSignal = rightDelayBuffer[c][readIndexR];
+                leftDelayedSignal = delay.left[delay.readIndex(delaySamplesL)];
+                rightDelayedSignal = delay.right[delay.readIndex(delaySamplesR)];
+            }
 
             float grainSize = params[GRAIN_SIZE_PARAM].getValue();
             if (inputs[GRAIN_SIZE_CV_INPUT].isConnected()) {
                 float cv = getCVInput(inputs[GRAIN_SIZE_CV_INPUT], c);
                 grainSize += cv * 0.1f;
-                if (c == 0) grainSizeCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+                if (c == 0) cvMods.publish(CVMOD_GRAIN_SIZE, clamp(cv / 10.0f, -1.0f, 1.0f));
             } else if (c == 0) {
-                grainSizeCvMod = 0.0f;
+                cvMods.clear(CVMOD_GRAIN_SIZE);
             }
             grainSize = clamp(grainSize, 0.0f, 1.0f);
 
@@ -722,9 +400,9 @@ struct EllenRipley : rack::engine::Module {
             if (inputs[GRAIN_DENSITY_CV_INPUT].isConnected()) {
                 float cv = getCVInput(inputs[GRAIN_DENSITY_CV_INPUT], c);
                 grainDensity += cv * 0.1f;
-                if (c == 0) grainDensityCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+                if (c == 0) cvMods.publish(CVMOD_GRAIN_DENSITY, clamp(cv / 10.0f, -1.0f, 1.0f));
             } else if (c == 0) {
-                grainDensityCvMod = 0.0f;
+                cvMods.clear(CVMOD_GRAIN_DENSITY);
             }
             grainDensity = clamp(grainDensity, 0.0f, 1.0f);
 
@@ -732,9 +410,9 @@ struct EllenRipley : rack::engine::Module {
             if (inputs[GRAIN_POSITION_CV_INPUT].isConnected()) {
                 float cv = getCVInput(inputs[GRAIN_POSITION_CV_INPUT], c);
                 grainPosition += cv * 0.1f;
-                if (c == 0) grainPositionCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+                if (c == 0) cvMods.publish(CVMOD_GRAIN_POSITION, clamp(cv / 10.0f, -1.0f, 1.0f));
             } else if (c == 0) {
-                grainPositionCvMod = 0.0f;
+                cvMods.clear(CVMOD_GRAIN_POSITION);
             }
             grainPosition = clamp(grainPosition, 0.0f, 1.0f);
 
@@ -742,9 +420,9 @@ struct EllenRipley : rack::engine::Module {
             if (inputs[REVERB_ROOM_SIZE_CV_INPUT].isConnected()) {
                 float cv = getCVInput(inputs[REVERB_ROOM_SIZE_CV_INPUT], c);
                 reverbRoomSize += cv * 0.1f;
-                if (c == 0) reverbRoomSizeCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+                if (c == 0) cvMods.publish(CVMOD_REVERB_ROOM_SIZE, clamp(cv / 10.0f, -1.0f, 1.0f));
             } else if (c == 0) {
-                reverbRoomSizeCvMod = 0.0f;
+                cvMods.clear(CVMOD_REVERB_ROOM_SIZE);
             }
             reverbRoomSize = clamp(reverbRoomSize, 0.0f, 1.0f);
 
@@ -752,9 +430,9 @@ struct EllenRipley : rack::engine::Module {
             if (inputs[REVERB_DAMPING_CV_INPUT].isConnected()) {
                 float cv = getCVInput(inputs[REVERB_DAMPING_CV_INPUT], c);
                 reverbDamping += cv * 0.1f;
-                if (c == 0) reverbDampingCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+                if (c == 0) cvMods.publish(CVMOD_REVERB_DAMPING, clamp(cv / 10.0f, -1.0f, 1.0f));
             } else if (c == 0) {
-                reverbDampingCvMod = 0.0f;
+                cvMods.clear(CVMOD_REVERB_DAMPING);
             }
             reverbDamping = clamp(reverbDamping, 0.0f, 1.0f);
 
@@ -762,46 +440,47 @@ struct EllenRipley : rack::engine::Module {
             if (inputs[REVERB_DECAY_CV_INPUT].isConnected()) {
                 float cv = getCVInput(inputs[REVERB_DECAY_CV_INPUT], c);
                 reverbDecay += cv * 0.1f;
-                if (c == 0) reverbDecayCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+                if (c == 0) cvMods.publish(CVMOD_REVERB_DECAY, clamp(cv / 10.0f, -1.0f, 1.0f));
             } else if (c == 0) {
-                reverbDecayCvMod = 0.0f;
+                cvMods.clear(CVMOD_REVERB_DECAY);
             }
             reverbDecay = clamp(reverbDecay, 0.0f, 1.0f);
 
-            float leftDelayInput = leftInput + leftDelayedSignal * feedback;
-            float rightDelayInput = rightInput + rightDelayedSignal * feedback;
-
-            leftDelayBuffer[c][delayWriteIndex[c]] = leftDelayInput;
-            rightDelayBuffer[c][delayWriteIndex[c]] = rightDelayInput;
-            delayWriteIndex[c] = (delayWriteIndex[c] + 1) % DELAY_BUFFER_SIZE;
+            if (ch) {
+                float leftDelayInput = leftInput + leftDelayedSignal * feedback;
+                float rightDelayInput = rightInput + rightDelayedSignal * feedback;
+                ch->delay.write(leftDelayInput, rightDelayInput);
+            }
 
             // True serial chain: each stage feeds the next
 
-            // Stage 1: Delay wet/dry mix
-            float delayWetDryMix = params[WET_DRY_PARAM].getValue();
+            // Stage 1: Delay wet/dry mix (dry while the delay line is pending)
+            float delayWetDryMix = ch ? params[WET_DRY_PARAM].getValue() : 0.0f;
             float leftStage1 = leftInput * (1.0f - delayWetDryMix) + leftDelayedSignal * delayWetDryMix;
             float rightStage1 = rightInput * (1.0f - delayWetDryMix) + rightDelayedSignal * delayWetDryMix;
 
             // Stage 2: Grain processing on stage 1 output
-            float leftGrainOutput = leftGrainProcessor[c].process(leftStage1, grainSize, grainDensity, grainPosition, grainChaosMod, chaosOutput, args.sampleRate);
-            float rightGrainOutput = rightGrainProcessor[c].process(rightStage1, grainSize, grainDensity, grainPosition, grainChaosMod, chaosOutput * -1.0f, args.sampleRate);
+            float leftGrainOutput = leftGrain[c].process(leftStage1, grainSize, grainDensity, grainPosition, grainChaosMod, chaosOutput, args.sampleRate);
+            float rightGrainOutput = rightGrain[c].process(rightStage1, grainSize, grainDensity, grainPosition, grainChaosMod, chaosOutput * -1.0f, args.sampleRate);
 
             float grainWetDryMix = params[GRAIN_WET_DRY_PARAM].getValue();
             float leftStage2 = leftStage1 * (1.0f - grainWetDryMix) + leftGrainOutput * grainWetDryMix;
             float rightStage2 = rightStage1 * (1.0f - grainWetDryMix) + rightGrainOutput * grainWetDryMix;
 
             // Stage 3: Reverb processing on stage 2 output
-            float leftReverbOutput = leftReverbProcessor[c].process(leftStage2, rightStage2, grainDensity, reverbRoomSize, reverbDamping, reverbDecay, true, reverbChaosMod, chaosOutput, args.sampleRate);
-            float rightReverbOutput = rightReverbProcessor[c].process(leftStage2, rightStage2, grainDensity, reverbRoomSize, reverbDamping, reverbDecay, false, reverbChaosMod, chaosOutput, args.sampleRate);
+            float leftReverbOutput = leftReverb[c].process(leftStage2, rightStage2, reverbRoomSize, reverbDamping, reverbDecay, true, reverbChaosMod, chaosOutput, args.sampleRate);
+            float rightReverbOutput = rightReverb[c].process(leftStage2, rightStage2, reverbRoomSize, reverbDamping, reverbDecay, false, reverbChaosMod, chaosOutput, args.sampleRate);
 
             float reverbWetDryMix = params[REVERB_WET_DRY_PARAM].getValue();
             float leftFinal = leftStage2 * (1.0f - reverbWetDryMix) + leftReverbOutput * reverbWetDryMix;
             float rightFinal = rightStage2 * (1.0f - reverbWetDryMix) + rightReverbOutput * reverbWetDryMix;
 
             // Add reverb feedback to delay input for next frame (creates extended decay)
-            float reverbFeedbackAmount = reverbDecay * 0.3f;
-            leftDelayBuffer[c][delayWriteIndex[c]] += leftReverbOutput * reverbFeedbackAmount;
-            rightDelayBuffer[c][delayWriteIndex[c]] += rightReverbOutput * reverbFeedbackAmount;
+            if (ch) {
+                float reverbFeedbackAmount = reverbDecay * 0.3f;
+                ch->delay.left[ch->delay.writeIndex] += leftReverbOutput * reverbFeedbackAmount;
+                ch->delay.right[ch->delay.writeIndex] += rightReverbOutput * reverbFeedbackAmount;
+            }
 
             // Final output validation
             if (!std::isfinite(leftFinal)) leftFinal = 0.0f;
@@ -846,6 +525,7 @@ struct EllenRipleyWidget : ModuleWidget {
     StandardBlackKnob26* reverbRoomSizeKnob = nullptr;
     StandardBlackKnob26* reverbDampingKnob = nullptr;
     StandardBlackKnob26* reverbDecayKnob = nullptr;
+    madzine::widgets::CVModRingSync<EllenRipley::NUM_CVMODS> cvModSync;
 
     EllenRipleyWidget(EllenRipley* module) {
         setModule(module);
@@ -931,6 +611,16 @@ struct EllenRipleyWidget : ModuleWidget {
         addInput(createInputCentered<PJ301MPort>(Vec(x + 12, reverbY + 47), module, EllenRipley::REVERB_DECAY_CV_INPUT));
         x += 30;
         
+        cvModSync.bind(EllenRipley::CVMOD_DELAY_TIME_L, delayTimeLKnob);
+        cvModSync.bind(EllenRipley::CVMOD_DELAY_TIME_R, delayTimeRKnob);
+        cvModSync.bind(EllenRipley::CVMOD_DELAY_FEEDBACK, delayFeedbackKnob);
+        cvModSync.bind(EllenRipley::CVMOD_GRAIN_SIZE, grainSizeKnob);
+        cvModSync.bind(EllenRipley::CVMOD_GRAIN_DENSITY, grainDensityKnob);
+        cvModSync.bind(EllenRipley::CVMOD_GRAIN_POSITION, grainPositionKnob);
+        cvModSync.bind(EllenRipley::CVMOD_REVERB_ROOM_SIZE, reverbRoomSizeKnob);
+        cvModSync.bind(EllenRipley::CVMOD_REVERB_DAMPING, reverbDampingKnob);
+        cvModSync.bind(EllenRipley::CVMOD_REVERB_DECAY, reverbDecayKnob);
+
         addChild(new EnhancedTextLabel(Vec(x, reverbY), Vec(25, 10), "C", 8.f, nvgRGB(200, 200, 200), true));
         addParam(createLightParamCentered<VCVLightLatch<MediumSimpleLight<WhiteLight>>>(Vec(x + 12, reverbY + 22), module, EllenRipley::REVERB_CHAOS_PARAM, EllenRipley::REVERB_CHAOS_LIGHT));
 
@@ -978,24 +668,8 @@ struct EllenRipleyWidget : ModuleWidget {
         if (module) {
             panelThemeHelper.step(module);
 
-            // 更新 CV 調變顯示
-            auto updateKnob = [&](StandardBlackKnob26* knob, int inputId, float cvMod) {
-                if (knob) {
-                    bool connected = module->inputs[inputId].isConnected();
-                    knob->setModulationEnabled(connected);
-                    if (connected) knob->setModulation(cvMod);
-                }
-            };
-
-            updateKnob(delayTimeLKnob, EllenRipley::DELAY_TIME_L_CV_INPUT, module->delayTimeLCvMod);
-            updateKnob(delayTimeRKnob, EllenRipley::DELAY_TIME_R_CV_INPUT, module->delayTimeRCvMod);
-            updateKnob(delayFeedbackKnob, EllenRipley::DELAY_FEEDBACK_CV_INPUT, module->delayFeedbackCvMod);
-            updateKnob(grainSizeKnob, EllenRipley::GRAIN_SIZE_CV_INPUT, module->grainSizeCvMod);
-            updateKnob(grainDensityKnob, EllenRipley::GRAIN_DENSITY_CV_INPUT, module->grainDensityCvMod);
-            updateKnob(grainPositionKnob, EllenRipley::GRAIN_POSITION_CV_INPUT, module->grainPositionCvMod);
-            updateKnob(reverbRoomSizeKnob, EllenRipley::REVERB_ROOM_SIZE_CV_INPUT, module->reverbRoomSizeCvMod);
-            updateKnob(reverbDampingKnob, EllenRipley::REVERB_DAMPING_CV_INPUT, module->reverbDampingCvMod);
-            updateKnob(reverbDecayKnob, EllenRipley::REVERB_DECAY_CV_INPUT, module->reverbDecayCvMod);
+            // 更新 CV 調變顯示（僅在數值變化時）
+            cvModSync.sync(module->cvMods);
         }
         ModuleWidget::step();
     }
@@ -1,6 +1,7 @@
 #include "plugin.hpp"
 #include "widgets/Knobs.hpp"
 #include "widgets/PanelTheme.hpp"
+#include "EnvelopeDSP.hpp"
 #include <cmath>
 
 // Enhanced text label (same as other modules)
@@ -58,161 +59,6 @@ struct WhiteBackgroundBox : Widget {
     }
 };
 
-// AD/AHR Envelope class (based on ADGenerator)
-struct ADEnvelope {
-    enum Phase {
-        IDLE,
-        ATTACK,
-        HOLD,    // New hold phase for AHR mode
-        DECAY    // Also serves as Release in AHR mode
-    };
-
-    Phase phase = IDLE;
-    float triggerOutput = 0.0f;
-    float followerOutput = 0.0f;
-    float attackTime = 0.01f;
-    float decayTime = 1.0f;
-    float phaseTime = 0.0f;
-    float curve = -0.9f;  // Default shape
-    float followerState = 0.0f;
-    float attackCoeff = 0.0f;
-    float releaseCoeff = 0.0f;
-    bool ahrMode = false;  // false = AD mode, true = AHR mode
-    bool gateHigh = false; // Track gate state for AHR mode
-
-    dsp::SchmittTrigger trigger;
-
-    void reset() {
-        phase = IDLE;
-        triggerOutput = 0.0f;
-        followerOutput = 0.0f;
-        phaseTime = 0.0f;
-        followerState = 0.0f;
-    }
-
-    float applyCurve(float x, float curvature) {
-        x = clamp(x, 0.0f, 1.0f);
-
-        if (curvature == 0.0f) {
-            return x;
-        }
-
-        float k = curvature;
-        float abs_x = std::abs(x);
-        float denominator = k - 2.0f * k * abs_x + 1.0f;
-
-        if (std::abs(denominator) < 1e-6f) {
-            return x;
-        }
-
-        return (x - k * x) / denominator;
-    }
-
-    float processEnvelopeFollower(float triggerVoltage, float sampleTime, float attackTime, float releaseTime, float curve) {
-        attackCoeff = 1.0f - std::exp(-sampleTime / std::max(0.0005f, attackTime * 0.1f));
-        releaseCoeff = 1.0f - std::exp(-sampleTime / std::max(0.001f, releaseTime * 0.5f));
-
-        attackCoeff = clamp(attackCoeff, 0.0f, 1.0f);
-        releaseCoeff = clamp(releaseCoeff, 0.0f, 1.0f);
-
-        float rectified = std::abs(triggerVoltage) / 10.0f;
-        rectified = clamp(rectified, 0.0f, 1.0f);
-
-        float targetCoeff;
-        if (rectified > followerState) {
-            float progress = attackCoeff;
-            targetCoeff = applyCurve(progress, curve);
-        } else {
-            float progress = releaseCoeff;
-            targetCoeff = applyCurve(progress, curve);
-        }
-
-        targetCoeff = clamp(targetCoeff, 0.0f, 1.0f);
-
-        followerState += (rectified - followerState) * targetCoeff;
-        followerState = clamp(followerState, 0.0f, 1.0f);
-
-        return followerState;
-    }
-
-    float processTriggerEnvelope(float triggerVoltage, float sampleTime, float attack, float decay, float curve) {
-        bool currentGateHigh = triggerVoltage > 1.0f;
-
-        // Trigger on rising edge (SchmittTrigger uses 0.1V low / 2.0V high thresholds)
-        if (trigger.process(triggerVoltage)) {
-            phase = ATTACK;
-            phaseTime = 0.0f;
-        }
-
-        // In AHR mode, detect gate release to start release phase
-        if (ahrMode && gateHigh && !currentGateHigh && phase == HOLD) {
-            phase = DECAY;  // Start release phase
-            phaseTime = 0.0f;
-        }
-        gateHigh = currentGateHigh;
-
-        switch (phase) {
-            case IDLE:
-                triggerOutput = 0.0f;
-                break;
-
-            case ATTACK:
-                phaseTime += sampleTime;
-                if (phaseTime >= attack) {
-                    if (ahrMode) {
-                        phase = HOLD;  // Go to hold phase in AHR mode
-                        triggerOutput = 1.0f;
-                    } else {
-                        phase = DECAY;  // Go directly to decay in AD mode
-                        phaseTime = 0.0f;
-                    }
-                    triggerOutput = 1.0f;
-                } else {
-                    float t = phaseTime / attack;
-                    triggerOutput = applyCurve(t, curve);
-                }
-                break;
-
-            case HOLD:
-                // Stay at full level while gate is high (AHR mode only)
-                triggerOutput = 1.0f;
-                if (!gateHigh) {
-                    phase = DECAY;
-                    phaseTime = 0.0f;
-                }
-                break;
-
-            case DECAY:
-                phaseTime += sampleTime;
-                if (phaseTime >= decay) {
-                    triggerOutput = 0.0f;
-                    phase = IDLE;
-                    phaseTime = 0.0f;
-                } else {
-                    float t = phaseTime / decay;
-                    triggerOutput = 1.0f - applyCurve(t, curve);
-                }
-                break;
-        }
-
-        return clamp(triggerOutput, 0.0f, 1.0f);
-    }
-
-    float process(float sampleTime, float triggerVoltage, float attack, float decay) {
-        float attackTime = std::pow(10.0f, (attack - 0.5f) * 6.0f);
-        float decayTime = std::pow(10.0f, (decay - 0.5f) * 6.0f);
-
-        attackTime = std::max(0.001f, attackTime);
-        decayTime = std::max(0.001f, decayTime);
-
-        // Only use trigger envelope - gate voltage amplitude should NOT affect envelope output
-        float triggerEnv = processTriggerEnvelope(triggerVoltage, sampleTime, attackTime, decayTime, curve);
-
-        return triggerEnv;
-    }
-};
-
-
 struct EnvVCA6 : Module {
     int panelTheme = madzineDefaultTheme;
     float panelContrast = madzineDefaultContrast; // -1 = Auto (follow VCV) // 0 = Sashimi, 1 = Boring
@@ -339,13 +185,27 @@ struct EnvVCA6 : Module {
         LIGHTS_LEN
     };
 
-    ADEnvelope envelopes[6];
+    // 每個通道最多 16 聲部，包絡以 float_4 為一組處理
+    static constexpr int MAX_POLY = 16;
+    static constexpr int MAX_GROUPS = MAX_POLY / 4;
+    static constexpr float ENVELOPE_CURVE = -0.9f;
+
+    ADEnvelopeBank envelopes[6][MAX_GROUPS];
+    ADEnvelopeTimes envelopeTimes[6]; // 旋鈕改變時才重算 pow
+    dsp::TSchmittTrigger<simd::float_4> gateTriggers[6][MAX_GROUPS];
     dsp::SchmittTrigger sumLatchTriggers[6]; // Only for sum latch buttons
-    bool gateOutputStates[6] = {false}; // Track gate output states
-    bool lastEnvelopeActive[6] = {false}; // Track envelope state for end-of-cycle trigger
-    dsp::PulseGenerator endOfCyclePulses[6]; // Generate end-of-cycle triggers
-    dsp::PulseGenerator startOfCyclePulses[6]; // Generate start-of-cycle triggers
-    bool lastGateHigh[6] = {false}; // Track gate input state for start trigger
+    bool gateOutputStates[6][MAX_POLY] = {}; // Track gate output states
+    bool lastEnvelopeActive[6][MAX_POLY] = {}; // Track envelope state for end-of-cycle trigger
+    dsp::PulseGenerator endOfCyclePulses[6][MAX_POLY]; // Generate end-of-cycle triggers
+    dsp::PulseGenerator startOfCyclePulses[6][MAX_POLY]; // Generate start-of-cycle triggers
+    bool lastGateHigh[6][MAX_POLY] = {}; // Track gate input state for start trigger
+
+    // 每樣本的輸出暫存（CH1-5 可加總到 CH6）
+    alignas(16) float envBuffer[6][MAX_POLY] = {};
+    alignas(16) float outLBuffer[6][MAX_POLY] = {};
+    alignas(16) float outRBuffer[6][MAX_POLY] = {};
+    alignas(16) float gainBuffer[6][MAX_POLY] = {};
+    alignas(16) float gateBuffer[6][MAX_POLY] = {};
 
     EnvVCA6() {
         config(PARAMS_LEN, INPUTS_LEN, OUTPUTS_LEN, LIGHTS_LEN);
@@ -410,141 +270,188 @@ struct EnvVCA6 : Module {
     }
 
     void process(const ProcessArgs& args) override {
+        using simd::float_4;
+
+        int gateMode = (int)params[GATE_MODE_PARAM].getValue(); // 0 = full cycle, 1 = end trigger, 2 = start+end
+        int channelCounts[6];
+
         for (int i = 0; i < 6; i++) {
             // Get parameters for this channel (6 params per channel)
             float attackParam = params[CH1_ATTACK_PARAM + i * 6].getValue();
             float releaseParam = params[CH1_RELEASE_PARAM + i * 6].getValue();
             float outVolParam = params[CH1_OUT_VOL_PARAM + i * 6].getValue();
-            bool manualGatePressed = params[CH1_GATE_TRIG_PARAM + i * 6].getValue() > 0.5f;
-            bool sumLatchPressed = params[CH1_SUM_LATCH_PARAM + i * 6].getValue() > 0.5f;
             bool ahrMode = params[CH1_ENV_MODE_PARAM + i * 6].getValue() > 0.5f;
 
-            // Set envelope mode
-            envelopes[i].ahrMode = ahrMode;
+            envelopeTimes[i].update(attackParam, releaseParam);
+
+            Input& inLPort = inputs[CH1_IN_L_INPUT + i * 4];
+            Input& inRPort = inputs[CH1_IN_R_INPUT + i * 4];
+            Input& gatePort = inputs[CH1_GATE_INPUT + i * 4];
+            Input& volPort = inputs[CH1_VOL_CTRL_INPUT + i * 4];
 
-            // Get inputs
-            float inL = inputs[CH1_IN_L_INPUT + i * 4].getVoltage();
-            float inR = inputs[CH1_IN_R_INPUT + i * 4].getVoltage();
-            float gateIn = inputs[CH1_GATE_INPUT + i * 4].getVoltage();
-            float volCtrl = inputs[CH1_VOL_CTRL_INPUT + i * 4].getVoltage();
+            // 聲部數取 Gate 與音訊輸入中最多者
+            int channels = std::max({1, gatePort.getChannels(), inLPort.getChannels(), inRPort.getChannels()});
+            channelCounts[i] = channels;
 
             // Mono-to-stereo: if only L input connected, copy to R
-            if (!inputs[CH1_IN_R_INPUT + i * 4].isConnected() && inputs[CH1_IN_L_INPUT + i * 4].isConnected()) {
-                inR = inL;
-            }
+            bool copyLToR = !inRPort.isConnected() && inLPort.isConnected();
+            bool volConnected = volPort.isConnected();
 
             // Manual gate logic: momentary (only while button pressed)
             bool manualGateActive = params[CH1_GATE_TRIG_PARAM + i * 6].getValue() > 0.5f;
 
-            // Combine gate sources (input + momentary manual gate)
-            float combinedGate = std::max(gateIn, manualGateActive ? 10.f : 0.f);
+            for (int c = 0; c < channels; c += 4) {
+                int g = c / 4;
 
-            // Process envelope
-            float envelopeOutput = envelopes[i].process(args.sampleTime, combinedGate, attackParam, releaseParam);
+                // Combine gate sources (input + momentary manual gate)
+                float_4 combinedGate = gatePort.getPolyVoltageSimd<float_4>(c);
+                if (manualGateActive) {
+                    combinedGate = simd::fmax(combinedGate, 10.f);
+                }
 
-            // Apply VCA (envelope controls volume)
-            float vcaGain = envelopeOutput;
+                float_4 triggered = gateTriggers[i][g].process(combinedGate);
+                float_4 gateHigh = combinedGate > 1.f;
 
-            // Apply volume control CV (0-10V range) - default to 1.0 if not connected
-            float volCtrlGain = 1.f;
-            if (inputs[CH1_VOL_CTRL_INPUT + i * 4].isConnected()) {
-                volCtrlGain = clamp(volCtrl / 10.f, 0.f, 1.f);
-            }
-            vcaGain *= volCtrlGain;
+                // Only use trigger envelope - gate voltage amplitude should NOT affect envelope output
+                float_4 envelopeOutput = envelopes[i][g].process(triggered, gateHigh, args.sampleTime,
+                                                                 envelopeTimes[i], ENVELOPE_CURVE, ahrMode);
 
-            // Apply output volume knob
-            vcaGain *= outVolParam;
+                // Apply volume control CV (0-10V range) - default to 1.0 if not connected
+                float_4 vcaGain = envelopeOutput * outVolParam;
+                if (volConnected) {
+                    vcaGain *= simd::clamp(volPort.getPolyVoltageSimd<float_4>(c) / 10.f, 0.f, 1.f);
+                }
 
-            // Process audio
-            float outL = inL * vcaGain;
-            float outR = inR * vcaGain;
+                float_4 inL = inLPort.getPolyVoltageSimd<float_4>(c);
+                float_4 inR = copyLToR ? inL : inRPort.getPolyVoltageSimd<float_4>(c);
 
-            // Gate output logic (three modes)
-            int gateMode = (int)params[GATE_MODE_PARAM].getValue(); // 0 = full cycle, 1 = end trigger, 2 = start+end
-            float gateOutputVoltage = 0.f;
+                envelopeOutput.store(&envBuffer[i][c]);
+                vcaGain.store(&gainBuffer[i][c]);
+                (inL * vcaGain).store(&outLBuffer[i][c]);
+                (inR * vcaGain).store(&outRBuffer[i][c]);
+                combinedGate.store(&gateBuffer[i][c]);
+            }
 
-            if (gateMode == 0) {
-                // Mode 0: Full cycle gate (gate high during entire envelope)
-                if (combinedGate > 1.f) {
-                    gateOutputStates[i] = true;
-                }
-                if (envelopes[i].phase == ADEnvelope::IDLE && envelopeOutput <= 0.001f) {
-                    gateOutputStates[i] = false;
-                }
-                gateOutputVoltage = gateOutputStates[i] ? 10.f : 0.f;
-            } else if (gateMode == 1) {
-                // Mode 1: End of cycle trigger only
-                bool envelopeActive = (envelopeOutput > 0.001f);
-                if (lastEnvelopeActive[i] && !envelopeActive) {
-                    // Envelope just finished - trigger pulse
-                    endOfCyclePulses[i].trigger(1e-3f); // 1ms pulse
-                }
-                lastEnvelopeActive[i] = envelopeActive;
-                gateOutputVoltage = endOfCyclePulses[i].process(args.sampleTime) ? 10.f : 0.f;
-            } else {
-                // Mode 2: Start + End of cycle triggers
-                bool gateHigh = (combinedGate > 1.f);
-                bool envelopeActive = (envelopeOutput > 0.001f);
+            // Gate output logic (three modes) — 逐聲部的狀態判斷
+            float maxGain = 0.f;
+            for (int c = 0; c < channels; c++) {
+                float envelopeOutput = envBuffer[i][c];
+                float combinedGate = gateBuffer[i][c];
+                float gateOutputVoltage = 0.f;
+
+                if (gateMode == 0) {
+                    // Mode 0: Full cycle gate (gate high during entire envelope)
+                    if (combinedGate > 1.f) {
+                        gateOutputStates[i][c] = true;
+                    }
+                    bool idle = envelopes[i][c / 4].phase[c % 4] == ADEnvelopeBank::IDLE;
+                    if (idle && envelopeOutput <= 0.001f) {
+                        gateOutputStates[i][c] = false;
+                    }
+                    gateOutputVoltage = gateOutputStates[i][c] ? 10.f : 0.f;
+                } else if (gateMode == 1) {
+                    // Mode 1: End of cycle trigger only
+                    bool envelopeActive = (envelopeOutput > 0.001f);
+                    if (lastEnvelopeActive[i][c] && !envelopeActive) {
+                        // Envelope just finished - trigger pulse
+                        endOfCyclePulses[i][c].trigger(1e-3f); // 1ms pulse
+                    }
+                    lastEnvelopeActive[i][c] = envelopeActive;
+                    gateOutputVoltage = endOfCyclePulses[i][c].process(args.sampleTime) ? 10.f : 0.f;
+                } else {
+                    // Mode 2: Start + End of cycle triggers
+                    bool gateHigh = (combinedGate > 1.f);
+                    bool envelopeActive = (envelopeOutput > 0.001f);
 
-                // Detect rising edge of gate (start of cycle)
-                if (gateHigh && !lastGateHigh[i]) {
-                    startOfCyclePulses[i].trigger(1e-3f); // 1ms pulse at start
-                }
-                lastGateHigh[i] = gateHigh;
+                    // Detect rising edge of gate (start of cycle)
+                    if (gateHigh && !lastGateHigh[i][c]) {
+                        startOfCyclePulses[i][c].trigger(1e-3f); // 1ms pulse at start
+                    }
+                    lastGateHigh[i][c] = gateHigh;
+
+                    // Detect end of envelope (end of cycle)
+                    if (lastEnvelopeActive[i][c] && !envelopeActive) {
+                        endOfCyclePulses[i][c].trigger(1e-3f); // 1ms pulse at end
+                    }
+                    lastEnvelopeActive[i][c] = envelopeActive;
 
-                // Detect end of envelope (end of cycle)
-                if (lastEnvelopeActive[i] && !envelopeActive) {
-                    endOfCyclePulses[i].trigger(1e-3f); // 1ms pulse at end
+                    // Output either trigger (start OR end)
+                    bool startTrigger = startOfCyclePulses[i][c].process(args.sampleTime);
+                    bool endTrigger = endOfCyclePulses[i][c].process(args.sampleTime);
+                    gateOutputVoltage = (startTrigger || endTrigger) ? 10.f : 0.f;
                 }
-                lastEnvelopeActive[i] = envelopeActive;
 
-                // Output either trigger (start OR end)
-                bool startTrigger = startOfCyclePulses[i].process(args.sampleTime);
-                bool endTrigger = endOfCyclePulses[i].process(args.sampleTime);
-                gateOutputVoltage = (startTrigger || endTrigger) ? 10.f : 0.f;
+                outputs[CH1_GATE_OUTPUT + i * 4].setVoltage(gateOutputVoltage, c);
+                maxGain = std::max(maxGain, gainBuffer[i][c]);
             }
-
-            // Set outputs
-            outputs[CH1_GATE_OUTPUT + i * 4].setVoltage(gateOutputVoltage);
-            outputs[CH1_ENV_OUTPUT + i * 4].setVoltage(envelopeOutput * 10.f);
-            outputs[CH1_OUT_L_OUTPUT + i * 4].setVoltage(outL);
-            outputs[CH1_OUT_R_OUTPUT + i * 4].setVoltage(outR);
+            outputs[CH1_GATE_OUTPUT + i * 4].setChannels(channels);
 
             // VCA light shows current VCA level
-            lights[CH1_VCA_LIGHT + i].setBrightness(vcaGain);
+            lights[CH1_VCA_LIGHT + i].setBrightness(maxGain);
         }
 
         // Sum outputs to CH6 (if sum latch is enabled) - ADD to CH6, don't replace
-        float sumL = 0.f;
-        float sumR = 0.f;
-        float sumEnv = 0.f;
-        int sumCount = 0;
+        // 逐聲部加總：CH1-5 的第 c 聲部加到 CH6 的第 c 聲部
+        alignas(16) float sumL[MAX_POLY] = {};
+        alignas(16) float sumR[MAX_POLY] = {};
+        alignas(16) float sumEnv[MAX_POLY] = {};
+        int sumCount[MAX_POLY] = {};
+        int sumChannels = 0;
 
         for (int i = 0; i < 5; i++) { // Only sum first 5 channels (CH1-CH5)
             bool sumEnabled = params[CH1_SUM_LATCH_PARAM + i * 6].getValue() > 0.5f;
-            if (sumEnabled) {
-                sumL += outputs[CH1_OUT_L_OUTPUT + i * 4].getVoltage() * 0.3f; // Scale for mixing
-                sumR += outputs[CH1_OUT_R_OUTPUT + i * 4].getVoltage() * 0.3f;
+            if (!sumEnabled) continue;
+
+            sumChannels = std::max(sumChannels, channelCounts[i]);
+            for (int c = 0; c < channelCounts[i]; c++) {
+                sumL[c] += outLBuffer[i][c] * 0.3f; // Scale for mixing
+                sumR[c] += outRBuffer[i][c] * 0.3f;
 
                 // Sum envelopes with RMS-like scaling to prevent overload
-                float envValue = outputs[CH1_ENV_OUTPUT + i * 4].getVoltage() / 10.f; // Convert to 0-1
-                sumEnv += envValue * envValue; // Square for RMS
-                sumCount++;
+                float envValue = envBuffer[i][c];
+                sumEnv[c] += envValue * envValue; // Square for RMS
+                sumCount[c]++;
             }
         }
 
         // ADD sum to CH6 outputs (not replace) if any channels are summed
-        if (sumCount > 0) {
-            // Add summed audio to CH6's own output
-            float ch6L = outputs[CH1_OUT_L_OUTPUT + 5 * 4].getVoltage();
-            float ch6R = outputs[CH1_OUT_R_OUTPUT + 5 * 4].getVoltage();
-            outputs[CH1_OUT_L_OUTPUT + 5 * 4].setVoltage(ch6L + sumL);
-            outputs[CH1_OUT_R_OUTPUT + 5 * 4].setVoltage(ch6R + sumR);
-
-            // Add RMS envelope sum to CH6's envelope
-            float ch6Env = outputs[CH1_ENV_OUTPUT + 5 * 4].getVoltage();
-            float rmsEnv = std::sqrt(sumEnv / sumCount) * 10.f; // Back to 0-10V range
-            outputs[CH1_ENV_OUTPUT + 5 * 4].setVoltage(std::max(ch6Env, rmsEnv)); // Use max to preserve CH6 envelope
+        if (sumChannels > 0) {
+            // CH6 超出自身聲部數的部分視為 0
+            for (int c = channelCounts[5]; c < sumChannels; c++) {
+                envBuffer[5][c] = 0.f;
+                outLBuffer[5][c] = 0.f;
+                outRBuffer[5][c] = 0.f;
+                outputs[CH1_GATE_OUTPUT + 5 * 4].setVoltage(0.f, c);
+            }
+            channelCounts[5] = std::max(channelCounts[5], sumChannels);
+            outputs[CH1_GATE_OUTPUT + 5 * 4].setChannels(channelCounts[5]);
+
+            for (int c = 0; c < sumChannels; c++) {
+                if (sumCount[c] == 0) continue;
+                // Add summed audio to CH6's own output
+                outLBuffer[5][c] += sumL[c];
+                outRBuffer[5][c] += sumR[c];
+
+                // Add RMS envelope sum to CH6's envelope, use max to preserve CH6 envelope
+                float rmsEnv = std::sqrt(sumEnv[c] / sumCount[c]);
+                envBuffer[5][c] = std::max(envBuffer[5][c], rmsEnv);
+            }
+        }
+
+        // Set outputs
+        for (int i = 0; i < 6; i++) {
+            int channels = channelCounts[i];
+            Output& envOut = outputs[CH1_ENV_OUTPUT + i * 4];
+            Output& outL = outputs[CH1_OUT_L_OUTPUT + i * 4];
+            Output& outR = outputs[CH1_OUT_R_OUTPUT + i * 4];
+            for (int c = 0; c < channels; c += 4) {
+                envOut.setVoltageSimd(float_4::load(&envBuffer[i][c]) * 10.f, c);
+                outL.setVoltageSimd(float_4::load(&outLBuffer[i][c]), c);
+                outR.setVoltageSimd(float_4::load(&outRBuffer[i][c]), c);
+            }
+            envOut.setChannels(channels);
+            outL.setChannels(channels);
+            outR.setChannels(channels);
         }
     }
 };
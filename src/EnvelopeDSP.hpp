@@ -0,0 +1,173 @@
+#pragma once
+#include "plugin.hpp"
+
+// ============================================================
+// EnvelopeDSP - EnvVCA6 / ADGenerator 共用的 float_4 AD/AHR 包絡
+// ============================================================
+
+/**
+ * 曲線塑形：k < 0 偏指數，k > 0 偏對數，k = 0 為線性
+ */
+inline float envelopeCurve(float x, float k) {
+    x = clamp(x, 0.0f, 1.0f);
+    if (k == 0.0f) return x;
+
+    float denominator = k - 2.0f * k * x + 1.0f;
+    if (std::abs(denominator) < 1e-6f) return x;
+
+    return (x - k * x) / denominator;
+}
+
+inline simd::float_4 envelopeCurve(simd::float_4 x, float k) {
+    x = simd::clamp(x, 0.0f, 1.0f);
+    if (k == 0.0f) return x;
+
+    simd::float_4 denominator = k - 2.0f * k * x + 1.0f;
+    simd::float_4 shaped = (x - k * x) / denominator;
+    return simd::ifelse(simd::abs(denominator) < 1e-6f, x, shaped);
+}
+
+/**
+ * 旋鈕 → 時間換算（10^((v - 0.5) * 6) 秒，約 1ms ~ 1000s）
+ * 只在旋鈕值改變時重算 pow，偏移量（例如 ATK ALL）直接相加
+ */
+struct ADEnvelopeTimes {
+    float attackTime = 0.01f;
+    float decayTime = 1.0f;
+    float attackInv = 100.0f;
+    float decayInv = 1.0f;
+
+    float attackBase = 0.0f;
+    float decayBase = 0.0f;
+    float lastAttackKnob = -1.0f;
+    float lastDecayKnob = -1.0f;
+
+    void update(float attackKnob, float decayKnob, float attackOffset = 0.0f, float decayOffset = 0.0f) {
+        if (attackKnob != lastAttackKnob) {
+            attackBase = std::pow(10.0f, (attackKnob - 0.5f) * 6.0f);
+            lastAttackKnob = attackKnob;
+        }
+        if (decayKnob != lastDecayKnob) {
+            decayBase = std::pow(10.0f, (decayKnob - 0.5f) * 6.0f);
+            lastDecayKnob = decayKnob;
+        }
+        attackTime = std::max(0.001f, attackBase + attackOffset);
+        decayTime = std::max(0.001f, decayBase + decayOffset);
+        attackInv = 1.0f / attackTime;
+        decayInv = 1.0f / decayTime;
+    }
+};
+
+/**
+ * 4 聲部 AD/AHR 包絡（一個 float_4 一組）
+ * 相位以浮點數編碼，狀態轉移全部以遮罩完成，沒有逐聲部分支。
+ */
+struct ADEnvelopeBank {
+    static constexpr float IDLE = 0.0f;
+    static constexpr float ATTACK = 1.0f;
+    static constexpr float HOLD = 2.0f;    // 僅 AHR 模式
+    static constexpr float DECAY = 3.0f;   // AHR 模式下即 Release
+
+    simd::float_4 phase = 0.0f;
+    simd::float_4 phaseTime = 0.0f;
+    simd::float_4 output = 0.0f;
+
+    void reset() {
+        phase = IDLE;
+        phaseTime = 0.0f;
+        output = 0.0f;
+    }
+
+    simd::float_4 idleMask() const {
+        return phase == IDLE;
+    }
+
+    /**
+     * @param triggered 觸發遮罩，對應聲部重新開始 Attack
+     * @param gateHigh Gate 高電位遮罩，AHR 模式下 Gate 放開時由 Hold 進入 Release
+     * @return 0 ~ 1 的包絡值
+     */
+    simd::float_4 process(simd::float_4 triggered, simd::float_4 gateHigh, float sampleTime,
+                          const ADEnvelopeTimes& times, float curve, bool ahrMode) {
+        using simd::float_4;
+
+        phase = simd::ifelse(triggered, float_4(ATTACK), phase);
+        phaseTime = simd::ifelse(triggered, float_4(0.0f), phaseTime);
+
+        if (ahrMode) {
+            float_4 release = (phase == HOLD) & ~gateHigh;
+            phase = simd::ifelse(release, float_4(DECAY), phase);
+            phaseTime = simd::ifelse(release, float_4(0.0f), phaseTime);
+        }
+
+        float_4 inAttack = (phase == ATTACK);
+        float_4 inHold = (phase == HOLD);
+        float_4 inDecay = (phase == DECAY);
+
+        phaseTime += simd::ifelse(inAttack | inDecay, float_4(sampleTime), float_4(0.0f));
+
+        float_4 attackDone = inAttack & (phaseTime >= times.attackTime);
+        float_4 decayDone = inDecay & (phaseTime >= times.decayTime);
+
+        float_4 attackOut = envelopeCurve(phaseTime * times.attackInv, curve);
+        float_4 decayOut = 1.0f - envelopeCurve(phaseTime * times.decayInv, curve);
+
+        float_4 out = 0.0f;
+        out = simd::ifelse(inAttack, simd::ifelse(attackDone, float_4(1.0f), attackOut), out);
+        out = simd::ifelse(inHold, float_4(1.0f), out);
+        out = simd::ifelse(inDecay & ~decayDone, decayOut, out);
+
+        // Attack 結束：AD 直接進入 Decay，AHR 進入 Hold
+        phase = simd::ifelse(attackDone, float_4(ahrMode ? HOLD : DECAY), phase);
+        phase = simd::ifelse(decayDone, float_4(IDLE), phase);
+        phaseTime = simd::ifelse(attackDone | decayDone, float_4(0.0f), phaseTime);
+
+        output = simd::clamp(out, 0.0f, 1.0f);
+        return output;
+    }
+};
+
+/**
+ * 包絡跟隨器係數（已套用曲線），只在時間、曲線或取樣率改變時重算 exp
+ */
+struct EnvelopeFollowerCoeffs {
+    float attackCoeff = 0.0f;
+    float releaseCoeff = 0.0f;
+
+    float lastSampleTime = -1.0f;
+    float lastAttackTime = -1.0f;
+    float lastReleaseTime = -1.0f;
+    float lastCurve = 0.0f;
+
+    void update(float sampleTime, float attackTime, float releaseTime, float curve) {
+        if (sampleTime == lastSampleTime && attackTime == lastAttackTime
+            && releaseTime == lastReleaseTime && curve == lastCurve) return;
+        lastSampleTime = sampleTime;
+        lastAttackTime = attackTime;
+        lastReleaseTime = releaseTime;
+        lastCurve = curve;
+
+        float a = 1.0f - std::exp(-sampleTime / std::max(0.0005f, attackTime * 0.1f));
+        float r = 1.0f - std::exp(-sampleTime / std::max(0.001f, releaseTime * 0.5f));
+        attackCoeff = clamp(envelopeCurve(clamp(a, 0.0f, 1.0f), curve), 0.0f, 1.0f);
+        releaseCoeff = clamp(envelopeCurve(clamp(r, 0.0f, 1.0f), curve), 0.0f, 1.0f);
+    }
+};
+
+struct EnvelopeFollowerBank {
+    simd::float_4 state = 0.0f;
+
+    void reset() {
+        state = 0.0f;
+    }
+
+    simd::float_4 process(simd::float_4 in, const EnvelopeFollowerCoeffs& coeffs) {
+        simd::float_4 rectified = simd::clamp(simd::abs(in) * 0.1f, 0.0f, 1.0f);
+        simd::float_4 coeff = simd::ifelse(rectified > state,
+                                           simd::float_4(coeffs.attackCoeff),
+                                           simd::float_4(coeffs.releaseCoeff));
+        state += (rectified - state) * coeff;
+        state = simd::clamp(state, 0.0f, 1.0f);
+        return state;
+    }
+};
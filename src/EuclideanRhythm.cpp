@@ -1,5 +1,6 @@
 #include "plugin.hpp"
 #include "widgets/Knobs.hpp"
+#include "widgets/CVModulation.hpp"
 #include "widgets/PanelTheme.hpp"
 #include <vector>
 #include <numeric>
@@ -269,8 +270,9 @@ struct EuclideanRhythm : Module {
     };
     TrackState tracks[3];
 
-    // CV 調變顯示用 [track][param: 0=Length, 1=Fill, 2=Shift]
-    float cvMod[3][3] = {{0.0f}};
+    // CV 調變顯示用，索引為 track * 3 + param（param: 0=Length, 1=Fill, 2=Shift）
+    static constexpr int NUM_CVMODS = 3 * 3;
+    madzine::widgets::CVModBank<NUM_CVMODS> cvMods;
 
     struct ChainedSequence {
         int currentTrackIndex = 0;
@@ -500,9 +502,9 @@ struct EuclideanRhythm : Module {
                 float cv = inputs[TRACK1_LENGTH_CV_INPUT + i * 3].getVoltage();
                 float lengthCVAtten = params[TRACK1_LENGTH_CV_ATTEN_PARAM + i * 7].getValue();
                 lengthCV = cv * lengthCVAtten;
-                cvMod[i][0] = clamp(cv / 5.0f * lengthCVAtten, -1.0f, 1.0f);
+                cvMods.publish(i * 3 + 0, clamp(cv / 5.0f * lengthCVAtten, -1.0f, 1.0f));
             } else {
-                cvMod[i][0] = 0.0f;
+                cvMods.clear(i * 3 + 0);
             }
             track.length = (int)std::round(clamp(lengthParam + lengthCV, 1.0f, 32.0f));
 
@@ -512,9 +514,9 @@ struct EuclideanRhythm : Module {
                 float cv = inputs[TRACK1_FILL_CV_INPUT + i * 3].getVoltage();
                 float fillCVAtten = params[TRACK1_FILL_CV_ATTEN_PARAM + i * 7].getValue();
                 fillCV = cv * fillCVAtten * 10.0f;
-                cvMod[i][1] = clamp(cv / 5.0f * fillCVAtten, -1.0f, 1.0f);
+                cvMods.publish(i * 3 + 1, clamp(cv / 5.0f * fillCVAtten, -1.0f, 1.0f));
             } else {
-                cvMod[i][1] = 0.0f;
+                cvMods.clear(i * 3 + 1);
             }
             float fillPercentage = clamp(fillParam + fillCV, 0.0f, 100.0f);
             track.fill = (int)std::round((fillPercentage / 100.0f) * track.length);
@@ -525,9 +527,9 @@ struct EuclideanRhythm : Module {
                 float cv = inputs[TRACK1_SHIFT_CV_INPUT + i * 3].getVoltage();
                 float shiftCVAtten = params[TRACK1_SHIFT_CV_ATTEN_PARAM + i * 7].getValue();
                 shiftCV = cv * shiftCVAtten;
-                cvMod[i][2] = clamp(cv / 5.0f * shiftCVAtten, -1.0f, 1.0f);
+                cvMods.publish(i * 3 + 2, clamp(cv / 5.0f * shiftCVAtten, -1.0f, 1.0f));
             } else {
-                cvMod[i][2] = 0.0f;
+                cvMods.clear(i * 3 + 2);
             }
             track.shift = (int)std::round(clamp(shiftParam + shiftCV, 0.0f, (float)track.length - 1.0f));
 
@@ -600,6 +602,7 @@ struct EuclideanRhythmWidget : ModuleWidget {
     PanelThemeHelper panelThemeHelper;
     // [track][param: 0=Length, 1=Fill, 2=Shift]
     madzine::widgets::BaseCustomKnob* knobs[3][3] = {{nullptr}};
+    madzine::widgets::CVModRingSync<EuclideanRhythm::NUM_CVMODS> cvModSync;
 
     EuclideanRhythmWidget(EuclideanRhythm* module) {
         setModule(module);
@@ -627,6 +630,7 @@ struct EuclideanRhythmWidget : ModuleWidget {
             addChild(new EnhancedTextLabel(Vec(x, y), Vec(25, 10), "LEN"));
             knobs[i][0] = createParamCentered<madzine::widgets::SnapKnob>(Vec(x + 12, y + 22), module, EuclideanRhythm::TRACK1_LENGTH_PARAM + i * 7);
             addParam(knobs[i][0]);
+            cvModSync.bind(i * 3 + 0, knobs[i][0]);
             addInput(createInputCentered<PJ301MPort>(Vec(x + 12, y + 47), module, EuclideanRhythm::TRACK1_LENGTH_CV_INPUT + i * 3));
             addParam(createParamCentered<Trimpot>(Vec(x + 12, y + 69), module, EuclideanRhythm::TRACK1_LENGTH_CV_ATTEN_PARAM + i * 7));
             x += 31;
@@ -634,6 +638,7 @@ struct EuclideanRhythmWidget : ModuleWidget {
             addChild(new EnhancedTextLabel(Vec(x, y), Vec(25, 10), "FILL"));
             knobs[i][1] = createParamCentered<madzine::widgets::StandardBlackKnob26>(Vec(x + 12, y + 22), module, EuclideanRhythm::TRACK1_FILL_PARAM + i * 7);
             addParam(knobs[i][1]);
+            cvModSync.bind(i * 3 + 1, knobs[i][1]);
             addInput(createInputCentered<PJ301MPort>(Vec(x + 12, y + 47), module, EuclideanRhythm::TRACK1_FILL_CV_INPUT + i * 3));
             addParam(createParamCentered<Trimpot>(Vec(x + 12, y + 69), module, EuclideanRhythm::TRACK1_FILL_CV_ATTEN_PARAM + i * 7));
             x += 31;
@@ -641,6 +646,7 @@ struct EuclideanRhythmWidget : ModuleWidget {
             addChild(new EnhancedTextLabel(Vec(x, y), Vec(25, 10), "SHFT"));
             knobs[i][2] = createParamCentered<madzine::widgets::SnapKnob>(Vec(x + 12, y + 22), module, EuclideanRhythm::TRACK1_SHIFT_PARAM + i * 7);
             addParam(knobs[i][2]);
+            cvModSync.bind(i * 3 + 2, knobs[i][2]);
             addInput(createInputCentered<PJ301MPort>(Vec(x + 12, y + 47), module, EuclideanRhythm::TRACK1_SHIFT_CV_INPUT + i * 3));
             addParam(createParamCentered<Trimpot>(Vec(x + 12, y + 69), module, EuclideanRhythm::TRACK1_SHIFT_CV_ATTEN_PARAM + i * 7));
             x += 30;
@@ -694,20 +700,8 @@ struct EuclideanRhythmWidget : ModuleWidget {
         if (module) {
             panelThemeHelper.step(module);
 
-            // CV 調變顯示更新
-            for (int track = 0; track < 3; track++) {
-                for (int param = 0; param < 3; param++) {
-                    if (knobs[track][param]) {
-                        // param: 0=Length, 1=Fill, 2=Shift
-                        int inputId = EuclideanRhythm::TRACK1_LENGTH_CV_INPUT + track * 3 + param;
-                        bool connected = module->inputs[inputId].isConnected();
-                        knobs[track][param]->setModulationEnabled(connected);
-                        if (connected) {
-                            knobs[track][param]->setModulation(module->cvMod[track][param]);
-                        }
-                    }
-                }
-            }
+            // CV 調變顯示更新（僅在數值變化時）
+            cvModSync.sync(module->cvMods);
         }
         ModuleWidget::step();
     }
@@ -1,5 +1,6 @@
 #include "plugin.hpp"
 #include "widgets/Knobs.hpp"
+#include "widgets/CVModulation.hpp"
 #include "widgets/PanelTheme.hpp"
 #include "RipleyDSP.hpp"
 
@@ -160,12 +161,16 @@ struct Facehugger : Module {
     float shPhase[MAX_POLY] = {};
 
     // CV 調變顯示
-    float sizeCvMod = 0.0f;
-    float breakCvMod = 0.0f;
-    float shiftCvMod = 0.0f;
-    float mixCvMod = 0.0f;
-    float chaosCvMod = 0.0f;
-    float rateCvMod = 0.0f;
+    enum CvModId {
+        CVMOD_SIZE,
+        CVMOD_BREAK,
+        CVMOD_SHIFT,
+        CVMOD_MIX,
+        CVMOD_CHAOS,
+        CVMOD_RATE,
+        NUM_CVMODS
+    };
+    madzine::widgets::CVModBank<NUM_CVMODS> cvMods;
 
     Facehugger() {
         config(NUM_PARAMS, NUM_INPUTS, NUM_OUTPUTS, NUM_LIGHTS);
@@ -239,9 +244,9 @@ struct Facehugger : Module {
             if (inputs[CHAOS_CV_INPUT].isConnected()) {
                 float cv = inputs[CHAOS_CV_INPUT].getPolyVoltage(c < inputs[CHAOS_CV_INPUT].getChannels() ? c : 0);
                 chaosAmount += cv * 0.1f;
-                if (c == 0) chaosCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+                if (c == 0) cvMods.publish(CVMOD_CHAOS, clamp(cv / 10.0f, -1.0f, 1.0f));
             } else if (c == 0) {
-                chaosCvMod = 0.0f;
+                cvMods.clear(CVMOD_CHAOS);
             }
             chaosAmount = clamp(chaosAmount, 0.0f, 1.0f);
 
@@ -250,9 +255,9 @@ struct Facehugger : Module {
             if (inputs[RATE_CV_INPUT].isConnected()) {
                 float cv = inputs[RATE_CV_INPUT].getPolyVoltage(c < inputs[RATE_CV_INPUT].getChannels() ? c : 0);
                 chaosRate += cv * 0.2f;
-                if (c == 0) rateCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+                if (c == 0) cvMods.publish(CVMOD_RATE, clamp(cv / 10.0f, -1.0f, 1.0f));
             } else if (c == 0) {
-                rateCvMod = 0.0f;
+                cvMods.clear(CVMOD_RATE);
             }
             chaosRate = clamp(chaosRate, 0.01f, 2.0f);
 
@@ -293,9 +298,9 @@ struct Facehugger : Module {
             if (inputs[SIZE_CV_INPUT].isConnected()) {
                 float cv = inputs[SIZE_CV_INPUT].getPolyVoltage(c < inputs[SIZE_CV_INPUT].getChannels() ? c : 0);
                 grainSize += cv * 0.1f;
-                if (c == 0) sizeCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+                if (c == 0) cvMods.publish(CVMOD_SIZE, clamp(cv / 10.0f, -1.0f, 1.0f));
             } else if (c == 0) {
-                sizeCvMod = 0.0f;
+                cvMods.clear(CVMOD_SIZE);
             }
             grainSize = clamp(grainSize, 0.0f, 1.0f);
 
@@ -304,9 +309,9 @@ struct Facehugger : Module {
             if (inputs[BREAK_CV_INPUT].isConnected()) {
                 float cv = inputs[BREAK_CV_INPUT].getPolyVoltage(c < inputs[BREAK_CV_INPUT].getChannels() ? c : 0);
                 grainDensity += cv * 0.1f;
-                if (c == 0) breakCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+                if (c == 0) cvMods.publish(CVMOD_BREAK, clamp(cv / 10.0f, -1.0f, 1.0f));
             } else if (c == 0) {
-                breakCvMod = 0.0f;
+                cvMods.clear(CVMOD_BREAK);
             }
             grainDensity = clamp(grainDensity, 0.0f, 1.0f);
 
@@ -315,9 +320,9 @@ struct Facehugger : Module {
             if (inputs[SHIFT_CV_INPUT].isConnected()) {
                 float cv = inputs[SHIFT_CV_INPUT].getPolyVoltage(c < inputs[SHIFT_CV_INPUT].getChannels() ? c : 0);
                 grainPosition += cv * 0.1f;
-                if (c == 0) shiftCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+                if (c == 0) cvMods.publish(CVMOD_SHIFT, clamp(cv / 10.0f, -1.0f, 1.0f));
             } else if (c == 0) {
-                shiftCvMod = 0.0f;
+                cvMods.clear(CVMOD_SHIFT);
             }
             grainPosition = clamp(grainPosition, 0.0f, 1.0f);
 
@@ -335,9 +340,9 @@ struct Facehugger : Module {
             if (inputs[MIX_CV_INPUT].isConnected()) {
                 float cv = inputs[MIX_CV_INPUT].getPolyVoltage(c < inputs[MIX_CV_INPUT].getChannels() ? c : 0);
                 mix += cv * 0.1f;
-                if (c == 0) mixCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+                if (c == 0) cvMods.publish(CVMOD_MIX, clamp(cv / 10.0f, -1.0f, 1.0f));
             } else if (c == 0) {
-                mixCvMod = 0.0f;
+                cvMods.clear(CVMOD_MIX);
             }
             mix = clamp(mix, 0.0f, 1.0f);
 
@@ -381,6 +386,7 @@ struct FacehuggerWidget : ModuleWidget {
     StandardBlackKnob26* mixKnob = nullptr;
     StandardBlackKnob26* chaosKnob = nullptr;
     StandardBlackKnob26* rateKnob = nullptr;
+    madzine::widgets::CVModRingSync<Facehugger::NUM_CVMODS> cvModSync;
 
     // 自動配線追蹤
     int64_t autoSendLeftCableId = -1;
@@ -434,6 +440,13 @@ struct FacehuggerWidget : ModuleWidget {
         rateKnob = createParamCentered<StandardBlackKnob26>(Vec(rightX, 162), module, Facehugger::RATE_PARAM);
         addParam(rateKnob);
 
+        cvModSync.bind(Facehugger::CVMOD_SIZE, sizeKnob);
+        cvModSync.bind(Facehugger::CVMOD_BREAK, breakKnob);
+        cvModSync.bind(Facehugger::CVMOD_SHIFT, shiftKnob);
+        cvModSync.bind(Facehugger::CVMOD_MIX, mixKnob);
+        cvModSync.bind(Facehugger::CVMOD_CHAOS, chaosKnob);
+        cvModSync.bind(Facehugger::CVMOD_RATE, rateKnob);
+
         // CV Row 1 (Y=197, 標籤 Y=173)
         addChild(new FacehuggerParamLabel(Vec(0, 173), Vec(30, 15), "SIZE"));
         addInput(createInputCentered<PJ301MPort>(Vec(leftX, 197), module, Facehugger::SIZE_CV_INPUT));
@@ -479,36 +492,8 @@ struct FacehuggerWidget : ModuleWidget {
         if (module) {
             panelThemeHelper.step(module);
 
-            if (sizeKnob) {
-                bool connected = module->inputs[Facehugger::SIZE_CV_INPUT].isConnected();
-                sizeKnob->setModulationEnabled(connected);
-                if (connected) sizeKnob->setModulation(module->sizeCvMod);
-            }
-            if (breakKnob) {
-                bool connected = module->inputs[Facehugger::BREAK_CV_INPUT].isConnected();
-                breakKnob->setModulationEnabled(connected);
-                if (connected) breakKnob->setModulation(module->breakCvMod);
-            }
-            if (shiftKnob) {
-                bool connected = module->inputs[Facehugger::SHIFT_CV_INPUT].isConnected();
-                shiftKnob->setModulationEnabled(connected);
-                if (connected) shiftKnob->setModulation(module->shiftCvMod);
-            }
-            if (mixKnob) {
-                bool connected = module->inputs[Facehugger::MIX_CV_INPUT].isConnected();
-                mixKnob->setModulationEnabled(connected);
-                if (connected) mixKnob->setModulation(module->mixCvMod);
-            }
-            if (chaosKnob) {
-                bool connected = module->inputs[Facehugger::CHAOS_CV_INPUT].isConnected();
-                chaosKnob->setModulationEnabled(connected);
-                if (connected) chaosKnob->setModulation(module->chaosCvMod);
-            }
-            if (rateKnob) {
-                bool connected = module->inputs[Facehugger::RATE_CV_INPUT].isConnected();
-                rateKnob->setModulationEnabled(connected);
-                if (connected) rateKnob->setModulation(module->rateCvMod);
-            }
+            // 更新 CV 調變顯示（僅在數值變化時）
+            cvModSync.sync(module->cvMods);
 
             // 自動配線到 YAMANOTE Send/Return
             Module* leftModule = module->leftExpander.module;
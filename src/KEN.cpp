@@ -1,12 +1,47 @@
 #include "plugin.hpp"
 #include "widgets/Knobs.hpp"
 #include "widgets/PanelTheme.hpp"
+#include "BinauralDSP.hpp"
+#include <atomic>
+#include <mutex>
+#include <osdialog.h>
+#include <thread>
+using simd::float_4;
+
+/**
+ * 4 個聲源並行的 biquad（每個 lane 各自的係數，Direct Form I）
+ * 係數由 dsp::TBiquadFilter<float> 在控制率計算後逐 lane 寫入
+ */
+struct KENBiquad4 {
+    float_4 b[3] = {1.f, 0.f, 0.f};
+    float_4 a[2] = {0.f, 0.f};
+    float_4 x[2] = {0.f, 0.f};
+    float_4 y[2] = {0.f, 0.f};
+
+    void setLane(int lane, const dsp::TBiquadFilter<float>& f) {
+        for (int k = 0; k < 3; k++) b[k][lane] = f.b[k];
+        for (int k = 0; k < 2; k++) a[k][lane] = f.a[k];
+    }
+
+    float_4 process(float_4 in) {
+        float_4 out = b[0] * in + b[1] * x[0] + b[2] * x[1] - a[0] * y[0] - a[1] * y[1];
+        x[1] = x[0];
+        x[0] = in;
+        y[1] = y[0];
+        y[0] = out;
+        return out;
+    }
+};
+
 struct KEN : Module {
     int panelTheme = madzineDefaultTheme;
     float panelContrast = madzineDefaultContrast; // -1 = Auto (follow VCV) // 0 = Sashimi, 1 = Boring
 
     enum ParamId {
         LEVEL_PARAM,
+        ENUMS(AZIMUTH_PARAM, 8),
+        ENUMS(ELEVATION_PARAM, 8),
+        ENUMS(DISTANCE_PARAM, 8),
         PARAMS_LEN
     };
     enum InputId {
@@ -18,6 +53,10 @@ struct KEN : Module {
         INPUT_6,
         INPUT_7,
         INPUT_8,
+        // 複音 CV：第 i 聲道調變第 i 個輸入的位置
+        AZIMUTH_CV_INPUT,
+        ELEVATION_CV_INPUT,
+        DISTANCE_CV_INPUT,
         INPUTS_LEN
     };
     enum OutputId {
@@ -30,35 +69,68 @@ struct KEN : Module {
     };
 
     struct SpeakerPosition {
-        float x, y, z;
         float azimuth, elevation;
         float distance;
     };
 
+    // 預設佈局（參數預設值），執行時為平滑後的目前位置
     SpeakerPosition speakers[8] = {
-        {-1.0f, 0.0f,  1.0f, -45.0f, 30.0f, 0.5f},   // FL Upper
-        { 1.0f, 0.0f,  1.0f,  45.0f, 30.0f, 0.5f},   // FR Upper
-        {-1.0f, 0.0f, -1.0f, -135.0f, 30.0f, 2.0f},  // BL Upper
-        { 1.0f, 0.0f, -1.0f,  135.0f, 30.0f, 2.0f},  // BR Upper
-        {-1.0f, 0.0f,  1.0f, -45.0f, -30.0f, 0.5f},  // FL Lower
-        { 1.0f, 0.0f,  1.0f,  45.0f, -30.0f, 0.5f},  // FR Lower
-        {-1.0f, 0.0f, -1.0f, -135.0f, -30.0f, 2.0f}, // BL Lower
-        { 1.0f, 0.0f, -1.0f,  135.0f, -30.0f, 2.0f}  // BR Lower
+        { -45.0f,  30.0f, 0.5f},  // FL Upper
+        {  45.0f,  30.0f, 0.5f},  // FR Upper
+        {-135.0f,  30.0f, 2.0f},  // BL Upper
+        { 135.0f,  30.0f, 2.0f},  // BR Upper
+        { -45.0f, -30.0f, 0.5f},  // FL Lower
+        {  45.0f, -30.0f, 0.5f},  // FR Lower
+        {-135.0f, -30.0f, 2.0f},  // BL Lower
+        { 135.0f, -30.0f, 2.0f}   // BR Lower
     };
 
-    float hrtfGains[8][2];
-    float smoothedGains[8][2];
-    
-    float delayBufferL[8][128];
-    float delayBufferR[8][128];
-    int delayPosL[8];
-    int delayPosR[8];
-    int delaySamplesL[8];
-    int delaySamplesR[8];
-
-    dsp::TBiquadFilter<> distanceFilters[8][2];
-    dsp::TBiquadFilter<> elevationFilters[8][2];
-    dsp::TBiquadFilter<> reverbFilters[8][2];
+    // ===== 控制率 =====
+    // 位置、增益、ITD 與濾波器係數每 CONTROL_DIVISION 個樣本計算一次（8 個聲源以 float_4 並行），
+    // 樣本之間只做線性內插，移動聲源時每個樣本沒有超越函數運算
+    static const int CONTROL_DIVISION = 32;
+    static constexpr float POSITION_SMOOTHING = 0.1f;  // 每次控制率更新
+    dsp::ClockDivider controlDivider;
+    bool controlInitialized = false;
+
+    // ===== Classic 引擎（8 個聲源 = 2 組 float_4）=====
+    static const int DELAY_SIZE = 128;
+    float_4 delayLine[2][DELAY_SIZE] = {};
+    int delayPos = 0;
+    float_4 delay[2][2] = {};      // [組][耳] 分數延遲（樣本）
+    float_4 delayStep[2][2] = {};
+    float_4 gain[2][2] = {};
+    float_4 gainStep[2][2] = {};
+    float_4 reverbMix[2] = {};
+    KENBiquad4 distanceFilters[2][2];
+    KENBiquad4 elevationFilters[2][2];
+    KENBiquad4 reverbFilters[2][2];
+
+    // ===== 實測 HRIR 引擎 =====
+    // HRIR 組在背景執行緒載入到非使用中的那一組，完成後切換 hrirSlot
+    typedef BinauralConvolver<8> Convolver;
+    HRIRSet hrirSets[2];
+    std::atomic<int> hrirSlot{0};
+    std::atomic<bool> hrirReady{false};
+    std::atomic<bool> hrirEnabled{false};
+    std::atomic<int> hrirGeneration{0};
+    int appliedGeneration = -1;
+    bool hrirActive = false;
+    std::thread hrirWorker;
+    std::mutex hrirMutex;
+    std::string hrirPath;
+    std::string hrirStatus = "No HRIR set loaded";
+    Convolver convolver;
+    float hrirScratch[2][Convolver::MAX_IR];
+    // 目前濾波器對應的位置；移動超過 HRIR_THRESHOLD 度才重新內插
+    static constexpr float HRIR_THRESHOLD = 1.0f;
+    SpeakerPosition hrirPositions[8];
+    dsp::ClockDivider hrirDivider;
+    // 待重新內插的聲源（bit i），每個樣本最多處理一個
+    int hrirRefresh = 0;
+    int hrirRefreshCursor = 0;
+    float_4 inputGain[2] = {};  // 距離衰減
+    float_4 inputGainStep[2] = {};
 
     KEN() {
         config(PARAMS_LEN, INPUTS_LEN, OUTPUTS_LEN, LIGHTS_LEN);
@@ -74,26 +146,86 @@ struct KEN : Module {
         configInput(INPUT_7, "7");
         configInput(INPUT_8, "8");
 
+        for (int i = 0; i < 8; i++) {
+            configParam(AZIMUTH_PARAM + i, -180.f, 180.f, speakers[i].azimuth, string::f("Input %d azimuth", i + 1), "°");
+            configParam(ELEVATION_PARAM + i, -90.f, 90.f, speakers[i].elevation, string::f("Input %d elevation", i + 1), "°");
+            configParam(DISTANCE_PARAM + i, 0.f, 4.f, speakers[i].distance, string::f("Input %d distance", i + 1));
+        }
+        configInput(AZIMUTH_CV_INPUT, "Azimuth CV (36°/V, poly: channel N moves input N)");
+        configInput(ELEVATION_CV_INPUT, "Elevation CV (18°/V, poly: channel N moves input N)");
+        configInput(DISTANCE_CV_INPUT, "Distance CV (0.4/V, poly: channel N moves input N)");
+
         configOutput(LEFT_OUTPUT, "Left");
         configOutput(RIGHT_OUTPUT, "Right");
 
-        initializeHRTF();
-        initializeDelays();
-        initializeDistanceFilters();
-        initializeElevationFilters();
-        initializeReverbFilters();
-        
-        for (int i = 0; i < 8; i++) {
-            for (int j = 0; j < 2; j++) {
-                smoothedGains[i][j] = hrtfGains[i][j];
+        controlDivider.setDivision(CONTROL_DIVISION);
+        hrirDivider.setDivision(Convolver::BLOCK);
+    }
+
+    ~KEN() {
+        if (hrirWorker.joinable()) hrirWorker.join();
+    }
+
+    /**
+     * 在背景執行緒載入 HRIR 資料夾（轉換到目前的取樣率）
+     */
+    void loadHRIRAsync(const std::string& path) {
+        if (hrirWorker.joinable()) hrirWorker.join();
+        {
+            std::lock_guard<std::mutex> lock(hrirMutex);
+            hrirPath = path;
+            hrirStatus = "Loading...";
+        }
+        float sampleRate = APP->engine->getSampleRate();
+        hrirWorker = std::thread([this, path, sampleRate]() {
+            int next = 1 - hrirSlot.load();
+            std::string error;
+            bool ok = loadHRIRFolder(path, sampleRate, Convolver::MAX_IR, hrirSets[next], error);
+
+            std::lock_guard<std::mutex> lock(hrirMutex);
+            if (ok) {
+                hrirSlot.store(next, std::memory_order_release);
+                hrirReady = true;
+                hrirGeneration++;
+                hrirStatus = string::f("%s: %d directions, %d samples", hrirSets[next].name.c_str(),
+                                       (int)hrirSets[next].measurements.size(), hrirSets[next].length);
+            } else {
+                hrirStatus = "Error: " + error;
             }
+        });
+    }
+
+    void onSampleRateChange(const SampleRateChangeEvent& e) override {
+        controlInitialized = false;
+        std::string path;
+        {
+            std::lock_guard<std::mutex> lock(hrirMutex);
+            path = hrirPath;
         }
+        if (!path.empty()) loadHRIRAsync(path);
+    }
+
+    void onReset() override {
+        controlInitialized = false;
+    }
+
+    /**
+     * 以目前的 HRIR 組重新計算聲源的濾波器
+     */
+    void applyHRIRFilter(int i) {
+        const HRIRSet& set = hrirSets[hrirSlot.load(std::memory_order_acquire)];
+        set.interpolate(speakers[i].azimuth, speakers[i].elevation, hrirScratch[0], hrirScratch[1]);
+        convolver.setFilter(i, hrirScratch[0], hrirScratch[1], set.length);
+        hrirPositions[i] = speakers[i];
     }
 
     json_t* dataToJson() override {
         json_t* rootJ = json_object();
         json_object_set_new(rootJ, "panelTheme", json_integer(panelTheme));
         json_object_set_new(rootJ, "panelContrast", json_real(panelContrast));
+        json_object_set_new(rootJ, "hrirEnabled", json_boolean(hrirEnabled));
+        std::lock_guard<std::mutex> lock(hrirMutex);
+        json_object_set_new(rootJ, "hrirPath", json_string(hrirPath.c_str()));
         return rootJ;
     }
 
@@ -106,225 +238,255 @@ struct KEN : Module {
         if (contrastJ) {
             panelContrast = json_real_value(contrastJ);
         }
+        json_t* hrirEnabledJ = json_object_get(rootJ, "hrirEnabled");
+        if (hrirEnabledJ) {
+            hrirEnabled = json_boolean_value(hrirEnabledJ);
+        }
+        json_t* hrirPathJ = json_object_get(rootJ, "hrirPath");
+        if (hrirPathJ && json_string_length(hrirPathJ) > 0) {
+            loadHRIRAsync(json_string_value(hrirPathJ));
+        }
+        controlInitialized = false;
     }
 
-    void initializeHRTF() {
-        for (int i = 0; i < 8; i++) {
-            float azimuth = speakers[i].azimuth * M_PI / 180.0f;
-            float elevation = speakers[i].elevation * M_PI / 180.0f;
-            
-            hrtfGains[i][0] = calculateAdvancedHRTF(azimuth, elevation, 0, i);
-            hrtfGains[i][1] = calculateAdvancedHRTF(azimuth, elevation, 1, i);
-        }
+    static float wrapAzimuth(float degrees) {
+        degrees = std::fmod(degrees + 180.f, 360.f);
+        if (degrees < 0.f) degrees += 360.f;
+        return degrees - 180.f;
     }
 
-    void initializeDistanceFilters() {
-        for (int i = 0; i < 8; i++) {
-            for (int ear = 0; ear < 2; ear++) {
-                float sampleRate = 44100.0f;
-                float distance = speakers[i].distance;
-                float cutoffFreq = 20000.0f / (1.0f + distance * 3.0f);
-                cutoffFreq = clamp(cutoffFreq, 1000.0f, 20000.0f);
-                
-                distanceFilters[i][ear].setParameters(
-                    dsp::TBiquadFilter<>::LOWPASS, 
-                    cutoffFreq / sampleRate,
-                    0.8f,
-                    1.0f
-                );
-            }
-        }
+    /**
+     * ILD、頭部遮蔽、仰角與距離的增益（弧度，4 個聲源並行）
+     */
+    static float_4 calculateAdvancedHRTF(float_4 azimuth, float_4 elevation, float_4 distance, int ear) {
+        const float pi = float(M_PI);
+        // > 0 = 聲源在這隻耳朵同側
+        float_4 side = (ear == 0) ? -azimuth : azimuth;
+        float_4 ildEffect = simd::ifelse(side < 0.f, 1.0f + (side / pi) * 0.8f, 1.0f + (side / pi) * 0.3f);
+
+        float_4 headShadowEffect = simd::ifelse(simd::abs(azimuth) > pi / 2, float_4(0.6f), float_4(1.0f));
+
+        float_4 elevationEffect = simd::ifelse(elevation > 0.f, 1.0f + elevation * 0.8f, 0.7f - simd::abs(elevation) * 0.4f);
+
+        float_4 distanceGain = 1.0f / (1.0f + distance * distance);
+
+        float_4 gain = ildEffect * headShadowEffect * elevationEffect * distanceGain;
+        return simd::clamp(gain, 0.1f, 1.5f);
     }
 
-    void initializeElevationFilters() {
+    /**
+     * 控制率：平滑位置，計算目標增益 / ITD / 濾波器係數，設定到下一次更新前的線性斜坡
+     */
+    void updateControl(float sampleRate) {
+        bool snap = !controlInitialized;
+        float k = snap ? 1.f : POSITION_SMOOTHING;
+        float azimuth[8], elevation[8], distance[8];
+        // 單聲道 CV 依 Rack 慣例同時移動所有輸入
         for (int i = 0; i < 8; i++) {
-            for (int ear = 0; ear < 2; ear++) {
-                float sampleRate = 44100.0f;
-                float elevation = speakers[i].elevation;
-                
-                float centerFreq, gain, q;
-                if (elevation > 0) {
-                    centerFreq = 8000.0f + elevation * 40.0f;
-                    gain = 2.0f;
-                    q = 1.5f;
-                } else {
-                    centerFreq = 7000.0f - abs(elevation) * 30.0f;
-                    gain = 0.3f;
-                    q = 2.0f;
-                }
-                
-                if (elevation > 0) {
-                    elevationFilters[i][ear].setParameters(
-                        dsp::TBiquadFilter<>::PEAK,
-                        centerFreq / sampleRate,
-                        q,
-                        gain
-                    );
-                } else {
-                    elevationFilters[i][ear].setParameters(
-                        dsp::TBiquadFilter<>::LOWPASS,
-                        centerFreq / sampleRate,
-                        q,
-                        gain
-                    );
-                }
-            }
+            float targetAz = wrapAzimuth(params[AZIMUTH_PARAM + i].getValue() + inputs[AZIMUTH_CV_INPUT].getPolyVoltage(i) * 36.f);
+            float targetEl = clamp(params[ELEVATION_PARAM + i].getValue() + inputs[ELEVATION_CV_INPUT].getPolyVoltage(i) * 18.f, -90.f, 90.f);
+            float targetDist = clamp(params[DISTANCE_PARAM + i].getValue() + inputs[DISTANCE_CV_INPUT].getPolyVoltage(i) * 0.4f, 0.f, 4.f);
+
+            // 方位角沿最短方向平滑，跨過 ±180° 不會繞一圈
+            SpeakerPosition& s = speakers[i];
+            s.azimuth = wrapAzimuth(s.azimuth + wrapAzimuth(targetAz - s.azimuth) * k);
+            s.elevation += (targetEl - s.elevation) * k;
+            s.distance += (targetDist - s.distance) * k;
+
+            azimuth[i] = s.azimuth * float(M_PI) / 180.0f;
+            elevation[i] = s.elevation * float(M_PI) / 180.0f;
+            distance[i] = s.distance;
         }
-    }
 
-    void initializeReverbFilters() {
-        for (int i = 0; i < 8; i++) {
+        const float headWidth = 0.18f;
+        const float soundSpeed = 343.0f;
+        const float maxDelay = DELAY_SIZE - 4;
+        const float ramp = snap ? 0.f : 1.f / CONTROL_DIVISION;
+
+        for (int g = 0; g < 2; g++) {
+            float_4 az = float_4::load(&azimuth[g * 4]);
+            float_4 el = float_4::load(&elevation[g * 4]);
+            float_4 dist = float_4::load(&distance[g * 4]);
+
+            // ITD：遠側的耳朵延遲
+            float_4 itd = (headWidth / soundSpeed) * simd::sin(az) * sampleRate;
+            float_4 targetDelay[2] = {
+                simd::clamp(itd, 0.f, maxDelay),
+                simd::clamp(-itd, 0.f, maxDelay)
+            };
+
             for (int ear = 0; ear < 2; ear++) {
-                float sampleRate = 44100.0f;
-                float distance = speakers[i].distance;
-                
-                float reverbGain = 0.1f + distance * 0.4f;
-                
-                reverbFilters[i][ear].setParameters(
-                    dsp::TBiquadFilter<>::HIGHPASS,
-                    3000.0f / sampleRate,
-                    0.7f,
-                    reverbGain
-                );
+                float_4 targetGain = calculateAdvancedHRTF(az, el, dist, ear);
+                if (snap) {
+                    gain[g][ear] = targetGain;
+                    delay[g][ear] = targetDelay[ear];
+                }
+                gainStep[g][ear] = (targetGain - gain[g][ear]) * ramp;
+                delayStep[g][ear] = (targetDelay[ear] - delay[g][ear]) * ramp;
             }
+
+            reverbMix[g] = simd::clamp(dist * 0.3f, 0.f, 1.f);
+
+            float_4 targetInputGain = 1.0f / (1.0f + dist * dist);
+            if (snap) inputGain[g] = targetInputGain;
+            inputGainStep[g] = (targetInputGain - inputGain[g]) * ramp;
         }
-    }
 
-    void initializeDelays() {
-        float sampleRate = 44100.0f;
-        float headWidth = 0.18f;
-        float soundSpeed = 343.0f;
-        
+        // 濾波器係數（tan 只在控制率計算）
         for (int i = 0; i < 8; i++) {
-            float azimuth = speakers[i].azimuth * M_PI / 180.0f;
-            
-            float itdSeconds = (headWidth / soundSpeed) * sin(azimuth);
-            int itdSamples = (int)(itdSeconds * sampleRate);
-            
-            if (itdSamples > 0) {
-                delaySamplesL[i] = itdSamples;
-                delaySamplesR[i] = 0;
+            int g = i / 4, lane = i % 4;
+            const SpeakerPosition& s = speakers[i];
+            dsp::TBiquadFilter<float> calc;
+
+            float cutoffFreq = clamp(20000.0f / (1.0f + s.distance * 3.0f), 1000.0f, 20000.0f);
+            calc.setParameters(dsp::TBiquadFilter<float>::LOWPASS, std::min(cutoffFreq / sampleRate, 0.45f), 0.8f, 1.0f);
+            for (int ear = 0; ear < 2; ear++) distanceFilters[g][ear].setLane(lane, calc);
+
+            if (s.elevation > 0) {
+                float centerFreq = 8000.0f + s.elevation * 40.0f;
+                calc.setParameters(dsp::TBiquadFilter<float>::PEAK, std::min(centerFreq / sampleRate, 0.45f), 1.5f, 2.0f);
             } else {
-                delaySamplesL[i] = 0;
-                delaySamplesR[i] = -itdSamples;
-            }
-            
-            delayPosL[i] = 0;
-            delayPosR[i] = 0;
-            for (int j = 0; j < 128; j++) {
-                delayBufferL[i][j] = 0.0f;
-                delayBufferR[i][j] = 0.0f;
+                float centerFreq = 7000.0f - std::fabs(s.elevation) * 30.0f;
+                calc.setParameters(dsp::TBiquadFilter<float>::LOWPASS, std::min(centerFreq / sampleRate, 0.45f), 2.0f, 0.3f);
             }
+            for (int ear = 0; ear < 2; ear++) elevationFilters[g][ear].setLane(lane, calc);
+
+            calc.setParameters(dsp::TBiquadFilter<float>::HIGHPASS, std::min(3000.0f / sampleRate, 0.45f), 0.7f, 1.0f);
+            for (int ear = 0; ear < 2; ear++) reverbFilters[g][ear].setLane(lane, calc);
         }
+
+        controlInitialized = true;
     }
 
-    float calculateAdvancedHRTF(float azimuth, float elevation, int ear, int speakerIndex) {
-        float gain = 1.0f;
-        
-        float ildEffect = 1.0f;
-        if (ear == 0) { 
-            if (azimuth > 0) { 
-                ildEffect = 1.0f - (azimuth / M_PI) * 0.8f;
-            } else { 
-                ildEffect = 1.0f + (-azimuth / M_PI) * 0.3f;
-            }
-        } else { 
-            if (azimuth < 0) { 
-                ildEffect = 1.0f - (-azimuth / M_PI) * 0.8f;
-            } else { 
-                ildEffect = 1.0f + (azimuth / M_PI) * 0.3f;
+    /**
+     * 4 個聲源各自的分數延遲讀取（三階 Lagrange，延遲 d 讀取 d-1 .. d+2 四點）
+     * 延遲基準加 1 個樣本，d = 0 時仍是因果的
+     */
+    float_4 readDelay(int g, float_4 d) {
+        d += 1.f;
+        float_4 n = simd::floor(d);
+        float_4 t = d - n;
+
+        float_4 taps[4];
+        for (int lane = 0; lane < 4; lane++) {
+            int base = delayPos - (int)n[lane];
+            for (int j = 0; j < 4; j++) {
+                taps[j][lane] = delayLine[g][(base + 1 - j) & (DELAY_SIZE - 1)][lane];
             }
         }
-        
-        float headShadowEffect = 1.0f;
-        if (abs(azimuth) > M_PI / 2) { 
-            headShadowEffect *= 0.6f;
-        }
-        
-        float elevationEffect = 1.0f;
-        if (elevation > 0) {
-            elevationEffect = 1.0f + elevation * 0.8f;
-        } else {
-            elevationEffect = 0.7f - abs(elevation) * 0.4f;
-        }
-        
-        float distance = speakers[speakerIndex].distance;
-        float distanceGain = 1.0f / (1.0f + distance * distance);
-        
-        gain = ildEffect * headShadowEffect * elevationEffect * distanceGain;
-        gain = clamp(gain, 0.1f, 1.5f);
-        
-        return gain;
+
+        float_4 tm1 = t - 1.f, tm2 = t - 2.f, tp1 = t + 1.f;
+        float_4 h0 = -t * tm1 * tm2 * (1.f / 6.f);
+        float_4 h1 = tp1 * tm1 * tm2 * 0.5f;
+        float_4 h2 = -tp1 * t * tm2 * 0.5f;
+        float_4 h3 = tp1 * t * tm1 * (1.f / 6.f);
+        return taps[0] * h0 + taps[1] * h1 + taps[2] * h2 + taps[3] * h3;
     }
 
-    float processDelay(float input, int speaker, int ear) {
-        float output;
-        
-        if (ear == 0) { 
-            delayBufferL[speaker][delayPosL[speaker]] = input;
-            int readPos = (delayPosL[speaker] - delaySamplesL[speaker] + 128) % 128;
-            output = delayBufferL[speaker][readPos];
-            delayPosL[speaker] = (delayPosL[speaker] + 1) % 128;
-        } else { 
-            delayBufferR[speaker][delayPosR[speaker]] = input;
-            int readPos = (delayPosR[speaker] - delaySamplesR[speaker] + 128) % 128;
-            output = delayBufferR[speaker][readPos];
-            delayPosR[speaker] = (delayPosR[speaker] + 1) % 128;
+    float_4 readInputs(int g) {
+        float_4 x = 0.f;
+        for (int lane = 0; lane < 4; lane++) {
+            int i = g * 4 + lane;
+            if (inputs[INPUT_1 + i].isConnected()) x[lane] = inputs[INPUT_1 + i].getVoltage();
         }
-        
-        return output;
+        return x;
+    }
+
+    static float sumLanes(float_4 v) {
+        return v[0] + v[1] + v[2] + v[3];
     }
 
-    float processDistanceFiltering(float input, int speaker, int ear) {
-        return distanceFilters[speaker][ear].process(input);
+    void processClassic(float level) {
+        float_4 out[2] = {0.f, 0.f};
+        delayPos = (delayPos + 1) & (DELAY_SIZE - 1);
+
+        for (int g = 0; g < 2; g++) {
+            delayLine[g][delayPos] = readInputs(g);
+
+            for (int ear = 0; ear < 2; ear++) {
+                float_4 delayed = readDelay(g, delay[g][ear]);
+                delay[g][ear] += delayStep[g][ear];
+
+                delayed = distanceFilters[g][ear].process(delayed);
+                delayed = elevationFilters[g][ear].process(delayed);
+                float_4 reverb = reverbFilters[g][ear].process(delayed);
+                delayed += (reverb - delayed) * reverbMix[g];
+
+                out[ear] += delayed * gain[g][ear];
+                gain[g][ear] += gainStep[g][ear];
+            }
+        }
+
+        outputs[LEFT_OUTPUT].setVoltage(sumLanes(out[0]) * level);
+        outputs[RIGHT_OUTPUT].setVoltage(sumLanes(out[1]) * level);
     }
 
-    float processElevationFiltering(float input, int speaker, int ear) {
-        return elevationFilters[speaker][ear].process(input);
+    /**
+     * 每個樣本最多重新內插一個聲源；分段 FFT 也由卷積器分散到之後的樣本，
+     * 換 HRIR 組時 8 個聲源不會在同一個樣本內一起計算
+     */
+    void refreshOneHRIRFilter() {
+        if (!hrirRefresh) return;
+        for (int k = 0; k < 8; k++) {
+            int i = (hrirRefreshCursor + k) & 7;
+            if (hrirRefresh & (1 << i)) {
+                hrirRefresh &= ~(1 << i);
+                hrirRefreshCursor = (i + 1) & 7;
+                applyHRIRFilter(i);
+                return;
+            }
+        }
     }
 
-    float processReverbFiltering(float input, int speaker, int ear) {
-        return reverbFilters[speaker][ear].process(input);
+    /**
+     * 實測 HRIR：每個輸入經距離衰減後送進分段卷積
+     * 聲源移動時以區塊率標記、逐樣本重新內插 HRIR，卷積器在區塊邊界交叉淡化
+     */
+    void processHRIR(float level) {
+        int generation = hrirGeneration.load(std::memory_order_acquire);
+        if (generation != appliedGeneration) {
+            appliedGeneration = generation;
+            hrirRefresh = 0xFF;
+        } else if (hrirDivider.process()) {
+            // 區塊邊界只標記移動過的聲源，內插與 FFT 分散到這個區塊的各樣本
+            for (int i = 0; i < 8; i++) {
+                const SpeakerPosition& s = speakers[i];
+                const SpeakerPosition& h = hrirPositions[i];
+                if (std::fabs(wrapAzimuth(s.azimuth - h.azimuth)) > HRIR_THRESHOLD || std::fabs(s.elevation - h.elevation) > HRIR_THRESHOLD)
+                    hrirRefresh |= 1 << i;
+            }
+        }
+        refreshOneHRIRFilter();
+
+        float in[8];
+        for (int g = 0; g < 2; g++) {
+            (readInputs(g) * inputGain[g]).store(&in[g * 4]);
+            inputGain[g] += inputGainStep[g];
+        }
+        float out[2];
+        convolver.process(in, out);
+
+        outputs[LEFT_OUTPUT].setVoltage(out[0] * level);
+        outputs[RIGHT_OUTPUT].setVoltage(out[1] * level);
     }
 
     void process(const ProcessArgs& args) override {
         float level = params[LEVEL_PARAM].getValue();
-        float leftOut = 0.0f;
-        float rightOut = 0.0f;
 
-        for (int i = 0; i < 8; i++) {
-            if (inputs[INPUT_1 + i].isConnected()) {
-                float input = inputs[INPUT_1 + i].getVoltage();
-                
-                float delayedLeft = processDelay(input, i, 0);
-                float delayedRight = processDelay(input, i, 1);
-                
-                delayedLeft = processDistanceFiltering(delayedLeft, i, 0);
-                delayedRight = processDistanceFiltering(delayedRight, i, 1);
-                
-                delayedLeft = processElevationFiltering(delayedLeft, i, 0);
-                delayedRight = processElevationFiltering(delayedRight, i, 1);
-                
-                float reverbLeft = processReverbFiltering(delayedLeft, i, 0);
-                float reverbRight = processReverbFiltering(delayedRight, i, 1);
-                
-                float distance = speakers[i].distance;
-                float reverbMix = distance * 0.3f;
-                
-                delayedLeft = delayedLeft * (1.0f - reverbMix) + reverbLeft * reverbMix;
-                delayedRight = delayedRight * (1.0f - reverbMix) + reverbRight * reverbMix;
-                
-                float smoothing = 0.001f;
-                smoothedGains[i][0] = smoothedGains[i][0] * (1.0f - smoothing) + hrtfGains[i][0] * smoothing;
-                smoothedGains[i][1] = smoothedGains[i][1] * (1.0f - smoothing) + hrtfGains[i][1] * smoothing;
-                
-                leftOut += delayedLeft * smoothedGains[i][0] * level;
-                rightOut += delayedRight * smoothedGains[i][1] * level;
-            }
+        if (controlDivider.process() || !controlInitialized) {
+            updateControl(args.sampleRate);
         }
 
-        outputs[LEFT_OUTPUT].setVoltage(leftOut);
-        outputs[RIGHT_OUTPUT].setVoltage(rightOut);
+        bool useHRIR = hrirEnabled.load(std::memory_order_relaxed) && hrirReady.load(std::memory_order_acquire);
+        if (useHRIR != hrirActive) {
+            hrirActive = useHRIR;
+            convolver.reset();
+        }
+        if (useHRIR) {
+            processHRIR(level);
+        } else {
+            processClassic(level);
+        }
     }
 };
 
@@ -394,11 +556,19 @@ struct KENWidget : ModuleWidget {
         addChild(new TechnoEnhancedTextLabel(Vec(0, 1), Vec(box.size.x, 20), "KEN", 14.f, nvgRGB(255, 200, 0), true));
         addChild(new TechnoEnhancedTextLabel(Vec(0, 13), Vec(box.size.x, 20), "MADZINE", 10.f, nvgRGB(255, 200, 0), false));
 
-        addChild(new TechnoEnhancedTextLabel(Vec(15, 43), Vec(30, 10), "LEVEL"));
-        addParam(createParamCentered<StandardBlackKnob>(Vec(30, 70), module, KEN::LEVEL_PARAM));
+        // LEVEL 與三個複音位置 CV（位置本身在右鍵選單調整）
+        addChild(new TechnoEnhancedTextLabel(Vec(0, 32), Vec(30, 10), "LEVEL"));
+        addParam(createParamCentered<StandardBlackKnob>(Vec(15, 55), module, KEN::LEVEL_PARAM));
+        addChild(new TechnoEnhancedTextLabel(Vec(30, 32), Vec(30, 10), "AZ"));
+        addInput(createInputCentered<PJ301MPort>(Vec(45, 55), module, KEN::AZIMUTH_CV_INPUT));
 
-        float inputStartY = 110;
-        float inputSpacing = 28;
+        addChild(new TechnoEnhancedTextLabel(Vec(0, 72), Vec(30, 10), "EL"));
+        addInput(createInputCentered<PJ301MPort>(Vec(15, 95), module, KEN::ELEVATION_CV_INPUT));
+        addChild(new TechnoEnhancedTextLabel(Vec(30, 72), Vec(30, 10), "DIST"));
+        addInput(createInputCentered<PJ301MPort>(Vec(45, 95), module, KEN::DISTANCE_CV_INPUT));
+
+        float inputStartY = 125;
+        float inputSpacing = 26;
 
         for (int i = 0; i < 8; i++) {
             float y = inputStartY + i * inputSpacing;
@@ -428,6 +598,53 @@ struct KENWidget : ModuleWidget {
         KEN* module = dynamic_cast<KEN*>(this->module);
         if (!module) return;
 
+        std::string status;
+        {
+            std::lock_guard<std::mutex> lock(module->hrirMutex);
+            status = module->hrirStatus;
+        }
+        menu->addChild(new MenuSeparator);
+        menu->addChild(createSubmenuItem("Binaural Engine", module->hrirEnabled && module->hrirReady ? "HRIR" : "Classic", [=](Menu* sub) {
+            sub->addChild(createMenuLabel(status));
+            sub->addChild(createMenuItem("Load HRIR folder...", "", [=]() {
+                char* path = osdialog_file(OSDIALOG_OPEN_DIR, NULL, NULL, NULL);
+                if (!path) return;
+                module->loadHRIRAsync(std::string(path));
+                OSDIALOG_FREE(path);
+            }));
+            sub->addChild(createMenuLabel("Stereo WAVs named H<elev>e<azim>a or az<deg>_el<deg>"));
+            sub->addChild(new MenuSeparator);
+            sub->addChild(createCheckMenuItem("Use measured HRIR", string::f("%d samples latency", 2 * KEN::Convolver::BLOCK),
+                [=]() { return module->hrirEnabled.load(); },
+                [=]() { module->hrirEnabled = !module->hrirEnabled; },
+                !module->hrirReady));
+        }));
+
+        // 位置參數（面板上只有 CV 輸入）
+        struct PositionSlider : ui::Slider {
+            PositionSlider(ParamQuantity* q) {
+                quantity = q;
+                box.size.x = 200.f;
+            }
+        };
+        menu->addChild(createSubmenuItem("Speaker Positions", "", [=](Menu* sub) {
+            for (int i = 0; i < 8; i++) {
+                sub->addChild(createSubmenuItem(string::f("Input %d", i + 1), "", [=](Menu* speakerMenu) {
+                    speakerMenu->addChild(new PositionSlider(module->paramQuantities[KEN::AZIMUTH_PARAM + i]));
+                    speakerMenu->addChild(new PositionSlider(module->paramQuantities[KEN::ELEVATION_PARAM + i]));
+                    speakerMenu->addChild(new PositionSlider(module->paramQuantities[KEN::DISTANCE_PARAM + i]));
+                }));
+            }
+            sub->addChild(new MenuSeparator);
+            sub->addChild(createMenuItem("Reset to default layout", "", [=]() {
+                for (int i = 0; i < 8; i++) {
+                    module->paramQuantities[KEN::AZIMUTH_PARAM + i]->reset();
+                    module->paramQuantities[KEN::ELEVATION_PARAM + i]->reset();
+                    module->paramQuantities[KEN::DISTANCE_PARAM + i]->reset();
+                }
+            }));
+        }));
+
         addPanelThemeMenu(menu, module);
     }
 };
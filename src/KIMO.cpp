@@ -1,5 +1,6 @@
 #include "plugin.hpp"
 #include "widgets/Knobs.hpp"
+#include "widgets/CVModulation.hpp"
 #include "widgets/PanelTheme.hpp"
 #include <vector>
 #include <algorithm>
@@ -273,11 +274,15 @@ struct KIMO : Module {
     dsp::SchmittTrigger clockTrigger;
 
     // CV 調變顯示用
-    float fillCvMod = 0.0f;
-    float tuneCvMod = 0.0f;
-    float fmCvMod = 0.0f;
-    float punchCvMod = 0.0f;
-    float decayCvMod = 0.0f;
+    enum CvModId {
+        CVMOD_FILL,
+        CVMOD_TUNE,
+        CVMOD_FM,
+        CVMOD_PUNCH,
+        CVMOD_DECAY,
+        NUM_CVMODS
+    };
+    madzine::widgets::CVModBank<NUM_CVMODS> cvMods;
 
     float globalClockSeconds = 0.5f;
     float secondsSinceLastClock = -1.0f;
@@ -446,9 +451,9 @@ struct KIMO : Module {
         if (inputs[FILL_CV_INPUT].isConnected()) {
             float cv = inputs[FILL_CV_INPUT].getVoltage();
             fillParam += cv * 10.0f;
-            fillCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+            cvMods.publish(CVMOD_FILL, clamp(cv / 10.0f, -1.0f, 1.0f));
         } else {
-            fillCvMod = 0.0f;
+            cvMods.clear(CVMOD_FILL);
         }
         float fillPercentage = clamp(fillParam, 0.0f, 100.0f);
         track.fill = (int)std::round((fillPercentage / 100.0f) * track.length);
@@ -466,9 +471,9 @@ struct KIMO : Module {
             float cv = inputs[DECAY_CV_INPUT].getVoltage();
             decayParam += cv / 10.0f;
             decayParam = clamp(decayParam, 0.01f, 2.0f);
-            decayCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+            cvMods.publish(CVMOD_DECAY, clamp(cv / 10.0f, -1.0f, 1.0f));
         } else {
-            decayCvMod = 0.0f;
+            cvMods.clear(CVMOD_DECAY);
         }
         float shapeParam = params[SHAPE_PARAM].getValue();
         
@@ -480,9 +485,9 @@ struct KIMO : Module {
             float cv = inputs[FM_CV_INPUT].getVoltage();
             fmAmount += cv / 10.0f;
             fmAmount = clamp(fmAmount, 0.0f, 1.0f);
-            fmCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+            cvMods.publish(CVMOD_FM, clamp(cv / 10.0f, -1.0f, 1.0f));
         } else {
-            fmCvMod = 0.0f;
+            cvMods.clear(CVMOD_FM);
         }
 
         float freqParam = std::pow(2.0f, params[TUNE_PARAM].getValue());
@@ -491,9 +496,9 @@ struct KIMO : Module {
             float freqCV = params[TUNE_PARAM].getValue() + cv;
             freqParam = std::pow(2.0f, freqCV);
             freqParam = clamp(freqParam, std::pow(2.0f, std::log2(24.0f)), std::pow(2.0f, std::log2(500.0f)));
-            tuneCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+            cvMods.publish(CVMOD_TUNE, clamp(cv / 10.0f, -1.0f, 1.0f));
         } else {
-            tuneCvMod = 0.0f;
+            cvMods.clear(CVMOD_TUNE);
         }
 
         float punchAmount = params[PUNCH_PARAM].getValue();
@@ -501,9 +506,9 @@ struct KIMO : Module {
             float cv = inputs[PUNCH_CV_INPUT].getVoltage();
             punchAmount += cv / 10.0f;
             punchAmount = clamp(punchAmount, 0.0f, 1.0f);
-            punchCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+            cvMods.publish(CVMOD_PUNCH, clamp(cv / 10.0f, -1.0f, 1.0f));
         } else {
-            punchCvMod = 0.0f;
+            cvMods.clear(CVMOD_PUNCH);
         }
         
         float envelopeFM = envelopeOutput * fmAmount * 20.0f;
@@ -531,6 +536,7 @@ struct KIMOWidget : ModuleWidget {
     TechnoStandardBlackKnob30* fmKnob = nullptr;
     TechnoStandardBlackKnob30* punchKnob = nullptr;
     TechnoStandardBlackKnob30* decayKnob = nullptr;
+    madzine::widgets::CVModRingSync<KIMO::NUM_CVMODS> cvModSync;
 
     KIMOWidget(KIMO* module) {
         setModule(module);
@@ -578,6 +584,12 @@ struct KIMOWidget : ModuleWidget {
         decayKnob = createParamCentered<TechnoStandardBlackKnob30>(Vec(45, 189), module, KIMO::DECAY_PARAM);
         addParam(decayKnob);
 
+        cvModSync.bind(KIMO::CVMOD_FILL, fillKnob);
+        cvModSync.bind(KIMO::CVMOD_TUNE, tuneKnob);
+        cvModSync.bind(KIMO::CVMOD_FM, fmKnob);
+        cvModSync.bind(KIMO::CVMOD_PUNCH, punchKnob);
+        cvModSync.bind(KIMO::CVMOD_DECAY, decayKnob);
+
         // SHAPE (198 -> 206)
         addChild(new TechnoEnhancedTextLabel(Vec(5, 206), Vec(20, 15), "SHAPE"));
         addParam(createParamCentered<TechnoStandardBlackKnob30>(Vec(15, 231), module, KIMO::SHAPE_PARAM));
@@ -623,20 +635,8 @@ struct KIMOWidget : ModuleWidget {
         if (module) {
             panelThemeHelper.step(module);
 
-            // CV 調變顯示更新
-            auto updateKnob = [&](TechnoStandardBlackKnob30* knob, int inputId, float cvMod) {
-                if (knob) {
-                    bool connected = module->inputs[inputId].isConnected();
-                    knob->setModulationEnabled(connected);
-                    if (connected) knob->setModulation(cvMod);
-                }
-            };
-
-            updateKnob(fillKnob, KIMO::FILL_CV_INPUT, module->fillCvMod);
-            updateKnob(tuneKnob, KIMO::TUNE_CV_INPUT, module->tuneCvMod);
-            updateKnob(fmKnob, KIMO::FM_CV_INPUT, module->fmCvMod);
-            updateKnob(punchKnob, KIMO::PUNCH_CV_INPUT, module->punchCvMod);
-            updateKnob(decayKnob, KIMO::DECAY_CV_INPUT, module->decayCvMod);
+            // 更新 CV 調變顯示（僅在數值變化時）
+            cvModSync.sync(module->cvMods);
         }
         ModuleWidget::step();
     }
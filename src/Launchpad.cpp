@@ -1,8 +1,11 @@
 #include "plugin.hpp"
 #include "widgets/Knobs.hpp"
 #include "widgets/PanelTheme.hpp"
+#include "RecordPipeline.hpp"
+#include "ResampleDSP.hpp"
 #include <vector>
 #include <algorithm>
+#include <atomic>
 
 // Industrial color scheme
 namespace LaunchpadColors {
@@ -37,6 +40,9 @@ enum CellState {
 // Fade duration in samples (2ms at 48kHz)
 static const int FADE_SAMPLES = 96;
 
+// Playback render block size (samples rendered ahead per playing cell)
+static const int RENDER_BLOCK = 32;
+
 // Speed conversion functions (non-linear mapping like weiii documenta)
 // 0-0.25 → -8x to 0x (reverse), 0.25-0.5 → 0x to 1x, 0.5-1.0 → 1x to 8x
 inline float knobToSpeed(float knob) {
@@ -67,6 +73,11 @@ struct CellData {
     CellState state = CELL_EMPTY;
     int playPosition = 0;
     int recordPosition = 0;
+    // Stopped take whose tail is still being committed by the recorder
+    bool finishing = false;
+    uint32_t finishSession = 0;
+    // Cleared while finishing: drop the take instead of publishing it
+    bool discard = false;
 
     // Playback speed (1.0 = normal, 0.5 = half speed, 2.0 = double speed, negative = reverse)
     float playbackSpeed = 1.0f;
@@ -78,6 +89,23 @@ struct CellData {
     bool fadingOut = false;      // Currently fading out
     int fadeSamples = 0;         // Samples remaining in fade
 
+    // Block rendering (audio thread)
+    // 播放頭（上面的欄位）位於已渲染區塊的尾端；事件落在區塊中間時，
+    // 以區塊起點的快照倒回並重新推進到目前樣本，事件仍然精確到樣本。
+    struct Playhead {
+        int playPosition = 0;
+        float playbackPhase = 0.0f;
+        float fadeGain = 0.0f;
+        bool fadingIn = false;
+        bool fadingOut = false;
+        int fadeSamples = 0;
+        float speed = 1.0f;
+    };
+    float block[RENDER_BLOCK] = {};
+    int blockRead = 0;
+    int blockCount = 0;
+    Playhead blockStart;
+
     // Waveform cache for display (downsampled)
     std::vector<float> waveformCache;
     bool waveformDirty = true;
@@ -91,22 +119,31 @@ struct CellData {
     }
 
     void clear() {
+        clearTake();
+        waveformCache.clear();
+        loopClocksStr.clear();
+        loopClocksCached = -1;
+    }
+
+    // Clear the take and playback state, leaving the UI-side caches alone
+    // (audio thread; the display rebuilds from waveformDirty / loopClocks)
+    void clearTake() {
         buffer.clear();
         recordedLength = 0;
         loopClocks = 0;
         state = CELL_EMPTY;
         playPosition = 0;
         recordPosition = 0;
+        finishing = false;
+        discard = false;
         playbackSpeed = 1.0f;
         playbackPhase = 0.0f;
         fadeGain = 0.0f;
         fadingIn = false;
         fadingOut = false;
         fadeSamples = 0;
-        waveformCache.clear();
+        dropBlock();
         waveformDirty = true;
-        loopClocksStr.clear();
-        loopClocksCached = -1;
     }
 
     // Start fade in
@@ -150,6 +187,108 @@ struct CellData {
         return !fadingOut && fadeGain <= 0.0f;
     }
 
+    // Render n samples from the current playhead (out == nullptr only advances the playhead)
+    void renderSamples(float* out, int n, float speed, int interpolationMode = RESAMPLE_LINEAR) {
+        bool isReverse = speed < 0.0f;
+        float absSpeed = std::fabs(speed);
+        bool valid = recordedLength > 0 && (int)buffer.size() >= recordedLength;
+        // Crossfade at loop boundaries (only for forward playback at normal-ish speeds)
+        bool loopCrossfade = !isReverse && absSpeed <= 2.0f && recordedLength > FADE_SAMPLES * 2;
+
+        for (int i = 0; i < n; i++) {
+            float sample = 0.0f;
+            if (out && valid && absSpeed != 0.0f) {
+                // Clamp position to valid range
+                int pos = playPosition;
+                if (pos < 0) pos = 0;
+                if (pos >= recordedLength) pos = recordedLength - 1;
+
+                // Reverse playback reads at pos - phase
+                int index = pos;
+                float frac = playbackPhase;
+                if (isReverse && frac > 0.0f) {
+                    index = pos - 1;
+                    frac = 1.0f - frac;
+                }
+                sample = resampleRead(interpolationMode, [this](int i) { return buffer[i]; },
+                                      recordedLength, index, frac, absSpeed);
+
+                if (loopCrossfade) {
+                    int samplesFromEnd = recordedLength - playPosition;
+                    if (samplesFromEnd <= FADE_SAMPLES) {
+                        float fadeOut = (float)samplesFromEnd / FADE_SAMPLES;
+                        int crossfadePos = FADE_SAMPLES - samplesFromEnd;
+                        if (crossfadePos >= 0 && crossfadePos < recordedLength) {
+                            sample = sample * fadeOut + buffer[crossfadePos] * (1.0f - fadeOut);
+                        }
+                    }
+                }
+            }
+
+            // Apply fade envelope (for start/stop fades)
+            float gain = processFade();
+            if (out) out[i] = sample * gain;
+            if (!valid) continue;
+
+            // Advance play position using phase accumulation
+            playbackPhase += absSpeed;
+            int positionDelta = (int)playbackPhase;
+            playbackPhase -= (float)positionDelta;
+
+            if (isReverse) {
+                playPosition -= positionDelta;
+                // Loop backwards
+                while (playPosition < 0) {
+                    playPosition += recordedLength;
+                }
+            } else {
+                playPosition += positionDelta;
+                // Loop forwards
+                if (playPosition >= recordedLength) {
+                    if (recordedLength > FADE_SAMPLES * 2) {
+                        playPosition = FADE_SAMPLES + (playPosition - recordedLength);
+                    } else {
+                        playPosition = playPosition % recordedLength;
+                    }
+                }
+            }
+        }
+    }
+
+    // Next output sample, rendering a new block when the current one is used up
+    float nextSample(int interpolationMode) {
+        if (blockRead >= blockCount) {
+            blockStart = {playPosition, playbackPhase, fadeGain, fadingIn, fadingOut, fadeSamples, playbackSpeed};
+            renderSamples(block, RENDER_BLOCK, playbackSpeed, interpolationMode);
+            blockRead = 0;
+            blockCount = RENDER_BLOCK;
+        }
+        return block[blockRead++];
+    }
+
+    // Rewind the playhead to the sample about to be played (call before changing playback state)
+    void syncPlayhead() {
+        if (blockCount == 0) return;
+        int consumed = blockRead;
+        playPosition = blockStart.playPosition;
+        playbackPhase = blockStart.playbackPhase;
+        fadeGain = blockStart.fadeGain;
+        fadingIn = blockStart.fadingIn;
+        fadingOut = blockStart.fadingOut;
+        fadeSamples = blockStart.fadeSamples;
+        renderSamples(nullptr, consumed, blockStart.speed);
+        dropBlock();
+    }
+
+    void dropBlock() {
+        blockRead = 0;
+        blockCount = 0;
+    }
+
+    bool blockDrained() const {
+        return blockRead >= blockCount;
+    }
+
     const std::string& getLoopClocksStr() {
         if (loopClocksCached != loopClocks) {
             loopClocksStr = std::to_string(loopClocks);
@@ -329,6 +468,8 @@ struct Launchpad : Module {
     int recordingRow = -1;
     int recordingCol = -1;
     int recordStartClock = 0;
+    uint32_t recordSession = 0;
+    int numFinishing = 0;  // Cells waiting for their recorded tail
 
     // Pending fade-out stops (cells that need to complete fade before fully stopping)
     struct PendingStop {
@@ -341,6 +482,41 @@ struct Launchpad : Module {
     // Quantize values: 0=Free, 1=1, 2=8, 3=16, 4=32, 5=64
     const int quantizeValues[6] = {0, 1, 8, 16, 32, 64};
 
+    // Active cell list: the sounding cell of each row (-1 = silent row)
+    // 只在狀態改變時重建，混音只走訪有聲音的列
+    std::atomic<bool> activeDirty{true};
+    int activeCol[8] = {-1, -1, -1, -1, -1, -1, -1, -1};
+    int activeRows[8] = {};
+    int numActiveRows = 0;
+
+    // Grid clicks, holds and drags from the UI thread, applied in process() at an exact sample
+    struct CellClick {
+        enum Action {
+            CLICK,
+            HOLD,
+            MOVE,
+            COPY
+        };
+        Action action = CLICK;
+        int row = 0;
+        int col = 0;
+        int dstRow = 0;  // MOVE / COPY target
+        int dstCol = 0;
+    };
+    dsp::RingBuffer<CellClick, 64> cellClickQueue;
+
+    // Recording: the audio thread appends to a preallocated ring, a background
+    // thread commits into the cell buffer (target = row * 8 + col)
+    RecordPipeline<1> recorder;
+
+    // Variable-speed playback interpolation (context menu)
+    int interpolationMode = RESAMPLE_HERMITE;
+
+    // Row mixer gains (control rate), rows 1-4 / 5-8
+    dsp::ClockDivider mixerDivider;
+    simd::float_4 rowLevel[2], rowGainL[2], rowGainR[2];
+    simd::float_4 rowSendAL[2], rowSendAR[2], rowSendBL[2], rowSendBR[2];
+
     Launchpad() {
         config(PARAMS_LEN, INPUTS_LEN, OUTPUTS_LEN, LIGHTS_LEN);
 
@@ -389,6 +565,33 @@ struct Launchpad : Module {
         configOutput(SEND_B_R_OUTPUT, "Send B Right");
         configOutput(MIX_L_OUTPUT, "Mix Left");
         configOutput(MIX_R_OUTPUT, "Mix Right");
+
+        mixerDivider.setDivision(RENDER_BLOCK);
+        updateRowGains();
+
+        RecordPipeline<1>::Callbacks callbacks;
+        callbacks.begin = [this](int target, int startFrame) {
+            CellData& cell = cells[target / 8][target % 8];
+            // Capacity is reserved in the constructor and moveCell only swaps buffers, so this never allocates
+            std::fill(cell.buffer.begin(), cell.buffer.end(), 0.f);
+            cell.buffer.resize(MAX_BUFFER_SIZE, 0.f);
+            cell.waveformDirty = true;
+        };
+        callbacks.commit = [this](int target, int frame, const float* samples, int frames) {
+            CellData& cell = cells[target / 8][target % 8];
+            if (frame + frames > (int)cell.buffer.size()) return;
+            std::copy(samples, samples + frames, cell.buffer.begin() + frame);
+            cell.waveformDirty = true;
+        };
+        callbacks.end = [this](int target, int totalFrames) {
+            cells[target / 8][target % 8].waveformDirty = true;
+        };
+        recorder.start(callbacks);
+        SincTable::get();  // Build the sinc table here rather than on the audio thread
+    }
+
+    ~Launchpad() {
+        recorder.stop();
     }
 
     void onReset() override {
@@ -400,6 +603,7 @@ struct Launchpad : Module {
         clockCount = 0;
         recordingRow = -1;
         recordingCol = -1;
+        numFinishing = 0;
         for (int i = 0; i < 8; i++) {
             queuedScenes[i] = false;
         }
@@ -408,10 +612,33 @@ struct Launchpad : Module {
         for (int i = 0; i < 64; i++) {
             pendingStops[i].active = false;
         }
+        activeDirty = true;
+    }
+
+    // Queue a grid click from the UI thread
+    void queueCellClick(int row, int col) {
+        if (!cellClickQueue.full()) {
+            cellClickQueue.push({CellClick::CLICK, row, col});
+        }
+    }
+
+    // Queue a hold (clear) from the UI thread
+    void queueCellHold(int row, int col) {
+        if (!cellClickQueue.full()) {
+            cellClickQueue.push({CellClick::HOLD, row, col});
+        }
+    }
+
+    // Queue a drag from the UI thread (shift-drag copies)
+    void queueCellDrag(int row, int col, int dstRow, int dstCol, bool copy) {
+        if (!cellClickQueue.full()) {
+            cellClickQueue.push({copy ? CellClick::COPY : CellClick::MOVE, row, col, dstRow, dstCol});
+        }
     }
 
     // Cell interaction
     void onCellClick(int row, int col) {
+        activeDirty = true;
         CellData& cell = cells[row][col];
 
         if (cell.state == CELL_EMPTY) {
@@ -426,7 +653,7 @@ struct Launchpad : Module {
         } else if (cell.state == CELL_RECORD_QUEUED) {
             // Cancel queued recording
             cell.state = CELL_EMPTY;
-        } else if (cell.state == CELL_RECORDING) {
+        } else if (cell.state == CELL_RECORDING && !cell.finishing) {
             // Stop recording (with quantize)
             int quantize = quantizeValues[(int)params[QUANTIZE_PARAM].getValue()];
             if (quantize == 0) {
@@ -479,30 +706,51 @@ struct Launchpad : Module {
         for (int i = 0; i < 64; i++) {
             if (pendingStops[i].active) {
                 CellData& cell = cells[pendingStops[i].row][pendingStops[i].col];
-                if (cell.isFadeOutComplete()) {
+                // Wait until the rendered fade-out has actually been played
+                if (cell.isFadeOutComplete() && cell.blockDrained()) {
                     cell.state = CELL_HAS_CONTENT;
                     cell.playPosition = 0;
                     cell.fadeGain = 0.0f;
                     pendingStops[i].active = false;
+                    activeDirty = true;
                 }
             }
         }
     }
 
+    // Hold clears the cell (audio thread, via cellClickQueue)
     void onCellHold(int row, int col) {
-        // Clear cell
-        cells[row][col].clear();
+        activeDirty = true;
+        CellData& cell = cells[row][col];
+
+        // A cell being recorded ends its session first; the recorder still
+        // commits the tail into this buffer, so the take is dropped once finished
+        if (row == recordingRow && col == recordingCol) {
+            stopRecording();
+            queuedRecordStop = false;
+        }
+        if (cell.finishing) {
+            cell.discard = true;
+            return;
+        }
+
+        // A fading-out cell must not be brought back by its pending stop
+        cancelPendingStops(row, col);
+        cell.clearTake();
     }
 
     void startRecording(int row, int col) {
+        activeDirty = true;
         // Stop any current recording
         if (recordingRow >= 0) {
             stopRecording();
         }
 
+        // Buffer preparation happens on the recorder's background thread.
+        // A stalled recorder refuses the take; the cell stays as it was
         CellData& cell = cells[row][col];
-        cell.buffer.clear();
-        cell.buffer.resize(MAX_BUFFER_SIZE, 0.f);
+        if (!recorder.begin(row * 8 + col)) return;
+        recordSession = recorder.session();
         cell.recordPosition = 0;
         cell.recordedLength = 0;
         cell.state = CELL_RECORDING;
@@ -515,19 +763,50 @@ struct Launchpad : Module {
 
     void stopRecording() {
         if (recordingRow < 0) return;
+        activeDirty = true;
+
+        recorder.end();
 
+        // The cell stays in CELL_RECORDING until the recorder has committed the
+        // tail into its buffer; processFinishing() then publishes the length
         CellData& cell = cells[recordingRow][recordingCol];
-        cell.recordedLength = cell.recordPosition;
         cell.loopClocks = clockCount - recordStartClock;
         if (cell.loopClocks < 1) cell.loopClocks = 1;
-        cell.state = cell.recordedLength > 0 ? CELL_HAS_CONTENT : CELL_EMPTY;
-        cell.waveformDirty = true;
+        cell.finishing = true;
+        cell.finishSession = recordSession;
+        numFinishing++;
 
         recordingRow = -1;
         recordingCol = -1;
     }
 
+    // Publish stopped takes once the recorder reports them fully committed
+    void processFinishing() {
+        if (numFinishing == 0) return;
+        for (int r = 0; r < 8; r++) {
+            for (int c = 0; c < 8; c++) {
+                CellData& cell = cells[r][c];
+                if (!cell.finishing || !recorder.finished(cell.finishSession)) continue;
+                if (cell.discard) {
+                    cell.clearTake();
+                    numFinishing--;
+                    activeDirty = true;
+                    continue;
+                }
+                // While no newer take has started, committed() is this take's final length
+                int committed = (recorder.session() == cell.finishSession) ? recorder.committed() : cell.recordPosition;
+                cell.recordedLength = std::min(committed, cell.recordPosition);
+                cell.state = cell.recordedLength > 0 ? CELL_HAS_CONTENT : CELL_EMPTY;
+                cell.finishing = false;
+                cell.waveformDirty = true;
+                numFinishing--;
+                activeDirty = true;
+            }
+        }
+    }
+
     void startPlaying(int row, int col) {
+        activeDirty = true;
         // Session mode: stop other cells in the same row (with fade out)
         for (int c = 0; c < 8; c++) {
             if (c != col && (cells[row][c].state == CELL_PLAYING || cells[row][c].state == CELL_QUEUED || cells[row][c].state == CELL_STOP_QUEUED)) {
@@ -546,10 +825,12 @@ struct Launchpad : Module {
         CellData& cell = cells[row][col];
         cell.state = CELL_PLAYING;
         cell.playPosition = 0;
+        cell.dropBlock();
         cell.startFadeIn();  // Start with fade in
     }
 
     void stopAll() {
+        activeDirty = true;
         // Stop all playing and queued cells (respects quantize setting)
         int quantize = quantizeValues[(int)params[QUANTIZE_PARAM].getValue()];
         for (int r = 0; r < 8; r++) {
@@ -576,55 +857,78 @@ struct Launchpad : Module {
 
     // Stop cell at quantize boundary (with fade)
     void stopCellAtQuantize(int row, int col) {
+        activeDirty = true;
         CellData& cell = cells[row][col];
         cell.startFadeOut();
         cell.state = CELL_STOP_QUEUED;  // Ensure state reflects fading out
         addPendingStop(row, col);
     }
 
+    // Drag a take to another cell (audio thread, via cellClickQueue, after the
+    // playheads are synced so no cell is rendered ahead of the change)
     void moveCell(int srcRow, int srcCol, int dstRow, int dstCol) {
         if (srcRow == dstRow && srcCol == dstCol) return;
         CellData& src = cells[srcRow][srcCol];
         CellData& dst = cells[dstRow][dstCol];
 
-        // Stop playing if source is playing
-        if (src.state == CELL_PLAYING || src.state == CELL_STOP_QUEUED) {
-            src.state = CELL_HAS_CONTENT;
-            src.playPosition = 0;
-        }
+        // The recorder still writes into a take that is being recorded or committed
+        if (src.state == CELL_RECORDING || dst.state == CELL_RECORDING) return;
+        activeDirty = true;
+        cancelPendingStops(srcRow, srcCol);
+        cancelPendingStops(dstRow, dstCol);
 
-        // Move data to destination
-        dst.buffer = std::move(src.buffer);
+        // Swap the buffers so the source keeps a full-size allocation for its
+        // next recording; nothing is allocated or freed here
+        std::swap(dst.buffer, src.buffer);
         dst.recordedLength = src.recordedLength;
         dst.loopClocks = src.loopClocks;
-        dst.waveformCache = std::move(src.waveformCache);
         dst.state = (dst.recordedLength > 0) ? CELL_HAS_CONTENT : CELL_EMPTY;
         dst.playPosition = 0;
-
-        // Clear source
-        src.buffer.clear();
-        src.recordedLength = 0;
-        src.loopClocks = 0;
-        src.waveformCache.clear();
-        src.state = CELL_EMPTY;
-        src.playPosition = 0;
+        dst.playbackPhase = 0.0f;
+        dst.fadeGain = 0.0f;
+        dst.fadingIn = false;
+        dst.fadingOut = false;
+        dst.dropBlock();
+        dst.waveformDirty = true;
+
+        src.clearTake();
     }
 
+    // Shift-drag: copy a take into another cell (audio thread, like moveCell)
     void copyCell(int srcRow, int srcCol, int dstRow, int dstCol) {
         if (srcRow == dstRow && srcCol == dstCol) return;
         CellData& src = cells[srcRow][srcCol];
         CellData& dst = cells[dstRow][dstCol];
 
-        // Copy data to destination
-        dst.buffer = src.buffer;  // Copy, not move
+        if (src.state == CELL_RECORDING || dst.state == CELL_RECORDING) return;
+        activeDirty = true;
+        cancelPendingStops(dstRow, dstCol);
+
+        // Every cell buffer has MAX_BUFFER_SIZE capacity, so assign() only copies
+        dst.buffer.assign(src.buffer.begin(), src.buffer.end());
         dst.recordedLength = src.recordedLength;
         dst.loopClocks = src.loopClocks;
-        dst.waveformCache = src.waveformCache;
         dst.state = (dst.recordedLength > 0) ? CELL_HAS_CONTENT : CELL_EMPTY;
         dst.playPosition = 0;
+        dst.playbackPhase = 0.0f;
+        dst.fadeGain = 0.0f;
+        dst.fadingIn = false;
+        dst.fadingOut = false;
+        dst.dropBlock();
+        dst.waveformDirty = true;
+    }
+
+    // Forget fade-out stops of a cell whose content is being replaced
+    void cancelPendingStops(int row, int col) {
+        for (int i = 0; i < 64; i++) {
+            if (pendingStops[i].active && pendingStops[i].row == row && pendingStops[i].col == col) {
+                pendingStops[i].active = false;
+            }
+        }
     }
 
     void triggerScene(int col) {
+        activeDirty = true;
         // Trigger cells in the target column (Ableton Live style)
         // Scene acts as a "snapshot" - cells not in this scene get stopped
         for (int r = 0; r < 8; r++) {
@@ -667,9 +971,100 @@ struct Launchpad : Module {
         }
     }
 
+    // Rewind every rendered-ahead cell to the current sample before an event changes playback
+    void syncPlayheads() {
+        for (int r = 0; r < 8; r++) {
+            for (int c = 0; c < 8; c++) {
+                cells[r][c].syncPlayhead();
+            }
+        }
+    }
+
+    // Rebuild the active cell list (session mode: first playing cell of each row)
+    void rebuildActiveCells() {
+        numActiveRows = 0;
+        for (int r = 0; r < 8; r++) {
+            int col = -1;
+            for (int c = 0; c < 8; c++) {
+                const CellData& cell = cells[r][c];
+                // STOP_QUEUED continues playing until quantize boundary
+                if ((cell.state == CELL_PLAYING || cell.state == CELL_STOP_QUEUED) && cell.recordedLength > 0) {
+                    col = c;
+                    break;
+                }
+            }
+            if (activeCol[r] >= 0 && activeCol[r] != col) {
+                cells[r][activeCol[r]].dropBlock();
+            }
+            activeCol[r] = col;
+            if (col >= 0) {
+                activeRows[numActiveRows++] = r;
+            }
+        }
+    }
+
+    void updateRowGains() {
+        float level[8], gainL[8], gainR[8], sendA[8], sendB[8];
+        for (int r = 0; r < 8; r++) {
+            level[r] = params[LEVEL_1_PARAM + r * 4].getValue();
+            float pan = params[PAN_1_PARAM + r * 4].getValue();
+            float panL = (pan <= 0) ? 1.f : (1.f - pan);
+            float panR = (pan >= 0) ? 1.f : (1.f + pan);
+            gainL[r] = level[r] * panL;
+            gainR[r] = level[r] * panR;
+            sendA[r] = params[SEND_A_1_PARAM + r * 4].getValue();
+            sendB[r] = params[SEND_B_1_PARAM + r * 4].getValue();
+        }
+        for (int h = 0; h < 2; h++) {
+            rowLevel[h] = simd::float_4::load(&level[h * 4]);
+            rowGainL[h] = simd::float_4::load(&gainL[h * 4]);
+            rowGainR[h] = simd::float_4::load(&gainR[h * 4]);
+            simd::float_4 a = simd::float_4::load(&sendA[h * 4]);
+            simd::float_4 b = simd::float_4::load(&sendB[h * 4]);
+            rowSendAL[h] = rowGainL[h] * a;
+            rowSendAR[h] = rowGainR[h] * a;
+            rowSendBL[h] = rowGainL[h] * b;
+            rowSendBR[h] = rowGainR[h] * b;
+        }
+    }
+
+    static float horizontalSum(simd::float_4 v) {
+        return v[0] + v[1] + v[2] + v[3];
+    }
+
     void process(const ProcessArgs& args) override {
+        // Detect all events for this sample first, so rendered-ahead cells can be
+        // rewound to this exact sample before any of them changes playback state
+        bool resetTriggered = resetTrigger.process(inputs[RESET_INPUT].getVoltage(), 0.1f, 1.f);
+        bool clockTriggered = clockTrigger.process(inputs[CLOCK_INPUT].getVoltage(), 0.1f, 1.f);
+        bool stopAllPressed = stopAllTrigger.process(params[STOP_ALL_PARAM].getValue());
+        bool stopAllTriggered = stopAllInputTrigger.process(inputs[STOP_ALL_TRIG_INPUT].getVoltage(), 0.1f, 1.f);
+        bool scenePressed[8], sceneTriggered[8];
+        bool anySceneEvent = false;
+        for (int i = 0; i < 8; i++) {
+            scenePressed[i] = sceneTriggers[i].process(params[SCENE_1_PARAM + i].getValue());
+            sceneTriggered[i] = sceneInputTriggers[i].process(inputs[SCENE_1_TRIG_INPUT + i].getVoltage(), 0.1f, 1.f);
+            anySceneEvent |= scenePressed[i] || sceneTriggered[i];
+        }
+
+        if (resetTriggered || clockTriggered || stopAllPressed || stopAllTriggered || anySceneEvent
+            || !cellClickQueue.empty()) {
+            syncPlayheads();
+        }
+
+        // Apply grid clicks from the UI
+        while (!cellClickQueue.empty()) {
+            CellClick click = cellClickQueue.shift();
+            switch (click.action) {
+                case CellClick::HOLD: onCellHold(click.row, click.col); break;
+                case CellClick::MOVE: moveCell(click.row, click.col, click.dstRow, click.dstCol); break;
+                case CellClick::COPY: copyCell(click.row, click.col, click.dstRow, click.dstCol); break;
+                default: onCellClick(click.row, click.col); break;
+            }
+        }
+
         // Process reset
-        if (resetTrigger.process(inputs[RESET_INPUT].getVoltage(), 0.1f, 1.f)) {
+        if (resetTriggered) {
             clockCount = 0;
             for (int r = 0; r < 8; r++) {
                 for (int c = 0; c < 8; c++) {
@@ -681,8 +1076,6 @@ struct Launchpad : Module {
         }
 
         // Process clock
-        bool clockTriggered = clockTrigger.process(inputs[CLOCK_INPUT].getVoltage(), 0.1f, 1.f);
-
         if (clockTriggered) {
             // Calculate samples per clock for accurate loop timing
             if (samplesSinceLastClock > 0) {
@@ -733,12 +1126,12 @@ struct Launchpad : Module {
         samplesSinceLastClock++;
 
         // Process stop all button (immediate or queue based on quantize)
-        if (stopAllTrigger.process(params[STOP_ALL_PARAM].getValue())) {
+        if (stopAllPressed) {
             stopAll();
         }
 
         // Process stop all input trigger (respects quantize)
-        if (stopAllInputTrigger.process(inputs[STOP_ALL_TRIG_INPUT].getVoltage(), 0.1f, 1.f)) {
+        if (stopAllTriggered) {
             int quantize = quantizeValues[(int)params[QUANTIZE_PARAM].getValue()];
             if (quantize == 0) {
                 stopAll();
@@ -749,14 +1142,14 @@ struct Launchpad : Module {
 
         // Process scene button triggers (immediate)
         for (int i = 0; i < 8; i++) {
-            if (sceneTriggers[i].process(params[SCENE_1_PARAM + i].getValue())) {
+            if (scenePressed[i]) {
                 triggerScene(i);
             }
         }
 
         // Process scene input triggers (respects quantize)
         for (int i = 0; i < 8; i++) {
-            if (sceneInputTriggers[i].process(inputs[SCENE_1_TRIG_INPUT + i].getVoltage(), 0.1f, 1.f)) {
+            if (sceneTriggered[i]) {
                 int quantize = quantizeValues[(int)params[QUANTIZE_PARAM].getValue()];
                 if (quantize == 0) {
                     triggerScene(i);
@@ -772,8 +1165,9 @@ struct Launchpad : Module {
             float inputVoltage = inputs[ROW_1_INPUT + recordingRow].getVoltage();
 
             if (cell.recordPosition < MAX_BUFFER_SIZE) {
-                cell.buffer[cell.recordPosition++] = inputVoltage;
-                cell.waveformDirty = true;
+                if (recorder.write(&inputVoltage)) {
+                    cell.recordPosition++;
+                }
             } else {
                 // Buffer full, stop recording
                 stopRecording();
@@ -782,137 +1176,62 @@ struct Launchpad : Module {
 
         // Process pending fade-out stops
         processPendingStops();
+        processFinishing();
 
-        // Mixing
-        float mixL = 0.f, mixR = 0.f;
-        float sendAL = 0.f, sendAR = 0.f;
-        float sendBL = 0.f, sendBR = 0.f;
-
-        for (int r = 0; r < 8; r++) {
-            float rowOutput = 0.f;
-
-            // Find playing cell in this row
-            for (int c = 0; c < 8; c++) {
-                CellData& cell = cells[r][c];
-                // STOP_QUEUED continues playing until quantize boundary
-                if ((cell.state == CELL_PLAYING || cell.state == CELL_STOP_QUEUED) && cell.recordedLength > 0) {
-                    float speed = cell.playbackSpeed;
-                    bool isReverse = speed < 0.0f;
-                    float absSpeed = std::fabs(speed);
-
-                    // Get sample with interpolation for non-integer positions
-                    int pos = cell.playPosition;
-                    float frac = cell.playbackPhase;
-
-                    // Clamp position to valid range
-                    if (pos < 0) pos = 0;
-                    if (pos >= cell.recordedLength) pos = cell.recordedLength - 1;
-
-                    float sample;
-                    if (absSpeed == 0.0f) {
-                        // Speed 0: output silence
-                        sample = 0.0f;
-                    } else {
-                        // Linear interpolation between samples
-                        int nextPos = isReverse ? pos - 1 : pos + 1;
-                        if (nextPos < 0) nextPos = cell.recordedLength - 1;
-                        if (nextPos >= cell.recordedLength) nextPos = 0;
-
-                        float s1 = cell.buffer[pos];
-                        float s2 = cell.buffer[nextPos];
-                        sample = s1 + frac * (s2 - s1);
-
-                        // Apply crossfade at loop boundaries (only for forward playback at normal-ish speeds)
-                        if (!isReverse && absSpeed <= 2.0f) {
-                            int samplesFromEnd = cell.recordedLength - cell.playPosition;
-                            if (samplesFromEnd <= FADE_SAMPLES && cell.recordedLength > FADE_SAMPLES * 2) {
-                                float fadeOut = (float)samplesFromEnd / FADE_SAMPLES;
-                                float fadeIn = 1.0f - fadeOut;
-                                int crossfadePos = FADE_SAMPLES - samplesFromEnd;
-                                if (crossfadePos >= 0 && crossfadePos < cell.recordedLength) {
-                                    sample = sample * fadeOut + cell.buffer[crossfadePos] * fadeIn;
-                                }
-                            }
-                        }
-                    }
+        if (activeDirty.exchange(false)) {
+            rebuildActiveCells();
+        }
 
-                    // Apply fade envelope (for start/stop fades)
-                    float fadeGain = cell.processFade();
-                    rowOutput = sample * fadeGain;
+        if (mixerDivider.process()) {
+            updateRowGains();
+        }
 
-                    // Advance play position using phase accumulation
-                    cell.playbackPhase += absSpeed;
-                    int positionDelta = (int)cell.playbackPhase;
-                    cell.playbackPhase -= (float)positionDelta;
+        // Playback: only the sounding cell of each active row renders
+        alignas(16) float rowSamples[8] = {};
+        for (int i = 0; i < numActiveRows; i++) {
+            int r = activeRows[i];
+            rowSamples[r] = cells[r][activeCol[r]].nextSample(interpolationMode);
+        }
 
-                    if (isReverse) {
-                        cell.playPosition -= positionDelta;
-                        // Loop backwards
-                        while (cell.playPosition < 0) {
-                            cell.playPosition += cell.recordedLength;
-                        }
-                    } else {
-                        cell.playPosition += positionDelta;
-                        // Loop forwards
-                        if (cell.playPosition >= cell.recordedLength) {
-                            if (cell.recordedLength > FADE_SAMPLES * 2) {
-                                cell.playPosition = FADE_SAMPLES + (cell.playPosition - cell.recordedLength);
-                            } else {
-                                cell.playPosition = cell.playPosition % cell.recordedLength;
-                            }
-                        }
-                    }
-                    break;  // Session mode: only one cell per row
-                }
+        // Row mixer (rows 1-4 / 5-8 as float_4)
+        simd::float_4 mixL = 0.f, mixR = 0.f;
+        simd::float_4 sendAL = 0.f, sendAR = 0.f;
+        simd::float_4 sendBL = 0.f, sendBR = 0.f;
+        for (int h = 0; h < 2; h++) {
+            simd::float_4 in = simd::float_4::load(&rowSamples[h * 4]);
+
+            // Row outputs (level applied)
+            simd::float_4 rowOut = in * rowLevel[h];
+            for (int k = 0; k < 4; k++) {
+                outputs[ROW_1_OUTPUT + h * 4 + k].setVoltage(rowOut[k]);
             }
 
-            // Apply level
-            float level = params[LEVEL_1_PARAM + r * 4].getValue();
-            rowOutput *= level;
-
-            // Apply pan
-            float pan = params[PAN_1_PARAM + r * 4].getValue();
-            float panL = (pan <= 0) ? 1.f : (1.f - pan);
-            float panR = (pan >= 0) ? 1.f : (1.f + pan);
-
-            float rowL = rowOutput * panL;
-            float rowR = rowOutput * panR;
-
-            // Send to outputs
-            outputs[ROW_1_OUTPUT + r].setVoltage(rowOutput);
-
-            // Accumulate sends
-            float sendA = params[SEND_A_1_PARAM + r * 4].getValue();
-            float sendB = params[SEND_B_1_PARAM + r * 4].getValue();
-            sendAL += rowL * sendA;
-            sendAR += rowR * sendA;
-            sendBL += rowL * sendB;
-            sendBR += rowR * sendB;
-
-            // Accumulate mix
-            mixL += rowL;
-            mixR += rowR;
+            mixL += in * rowGainL[h];
+            mixR += in * rowGainR[h];
+            sendAL += in * rowSendAL[h];
+            sendAR += in * rowSendAR[h];
+            sendBL += in * rowSendBL[h];
+            sendBR += in * rowSendBR[h];
         }
 
-        // Add returns to mix
-        mixL += inputs[RETURN_A_L_INPUT].getVoltage() + inputs[RETURN_B_L_INPUT].getVoltage();
-        mixR += inputs[RETURN_A_R_INPUT].getVoltage() + inputs[RETURN_B_R_INPUT].getVoltage();
-
         // Output sends
-        outputs[SEND_A_L_OUTPUT].setVoltage(sendAL);
-        outputs[SEND_A_R_OUTPUT].setVoltage(sendAR);
-        outputs[SEND_B_L_OUTPUT].setVoltage(sendBL);
-        outputs[SEND_B_R_OUTPUT].setVoltage(sendBR);
-
-        // Output mix
-        outputs[MIX_L_OUTPUT].setVoltage(mixL);
-        outputs[MIX_R_OUTPUT].setVoltage(mixR);
+        outputs[SEND_A_L_OUTPUT].setVoltage(horizontalSum(sendAL));
+        outputs[SEND_A_R_OUTPUT].setVoltage(horizontalSum(sendAR));
+        outputs[SEND_B_L_OUTPUT].setVoltage(horizontalSum(sendBL));
+        outputs[SEND_B_R_OUTPUT].setVoltage(horizontalSum(sendBR));
+
+        // Add returns to mix and output
+        outputs[MIX_L_OUTPUT].setVoltage(horizontalSum(mixL)
+            + inputs[RETURN_A_L_INPUT].getVoltage() + inputs[RETURN_B_L_INPUT].getVoltage());
+        outputs[MIX_R_OUTPUT].setVoltage(horizontalSum(mixR)
+            + inputs[RETURN_A_R_INPUT].getVoltage() + inputs[RETURN_B_R_INPUT].getVoltage());
     }
 
     json_t* dataToJson() override {
         json_t* rootJ = json_object();
         json_object_set_new(rootJ, "panelTheme", json_integer(panelTheme));
         json_object_set_new(rootJ, "panelContrast", json_real(panelContrast));
+        json_object_set_new(rootJ, "interpolationMode", json_integer(interpolationMode));
 
         // Save cell data
         json_t* cellsJ = json_array();
@@ -945,6 +1264,8 @@ struct Launchpad : Module {
     void dataFromJson(json_t* rootJ) override {
         json_t* themeJ = json_object_get(rootJ, "panelTheme");
         if (themeJ) panelTheme = json_integer_value(themeJ);
+        json_t* interpolationModeJ = json_object_get(rootJ, "interpolationMode");
+        if (interpolationModeJ) interpolationMode = clamp((int)json_integer_value(interpolationModeJ), 0, RESAMPLE_MODES_LEN - 1);
         json_t* contrastJ = json_object_get(rootJ, "panelContrast");
         if (contrastJ) {
             panelContrast = json_real_value(contrastJ);
@@ -952,6 +1273,13 @@ struct Launchpad : Module {
 
         json_t* cellsJ = json_object_get(rootJ, "cells");
         if (cellsJ) {
+            // Let the recorder finish writing before cell buffers are replaced
+            stopRecording();
+            if (!recorder.flush()) {
+                WARN("Launchpad: recorder did not drain before loading cells");
+            }
+            processFinishing();
+
             int index = 0;
             for (int r = 0; r < 8; r++) {
                 for (int c = 0; c < 8; c++) {
@@ -959,6 +1287,12 @@ struct Launchpad : Module {
                     if (!cellJ) continue;
 
                     CellData& cell = cells[r][c];
+                    // The loaded cell replaces a take the recorder did not drain in time
+                    if (cell.finishing) {
+                        cell.finishing = false;
+                        cell.discard = false;
+                        numFinishing--;
+                    }
 
                     json_t* loopClocksJ = json_object_get(cellJ, "loopClocks");
                     if (loopClocksJ) cell.loopClocks = json_integer_value(loopClocksJ);
@@ -981,6 +1315,7 @@ struct Launchpad : Module {
                 }
             }
         }
+        activeDirty = true;
     }
 };
 
@@ -1048,17 +1383,13 @@ void CellWidget::onDragEnd(const event::DragEnd& e) {
     if (movedToOtherCell && module->cells[row][col].state != CELL_EMPTY) {
         // Drag to another cell - move or copy
         bool copyMode = (APP->window->getMods() & GLFW_MOD_SHIFT);
-        if (copyMode) {
-            module->copyCell(row, col, targetRow, targetCol);
-        } else {
-            module->moveCell(row, col, targetRow, targetCol);
-        }
+        module->queueCellDrag(row, col, targetRow, targetCol, copyMode);
     } else {
         // Click or hold on same cell
         if (pressTime >= HOLD_TIME) {
-            module->onCellHold(row, col);
+            module->queueCellHold(row, col);
         } else {
-            module->onCellClick(row, col);
+            module->queueCellClick(row, col);
         }
     }
 
@@ -1535,6 +1866,18 @@ struct LaunchpadWidget : ModuleWidget {
         if (!module) return;
 
         addPanelThemeMenu(menu, module);
+
+        menu->addChild(new MenuSeparator);
+        menu->addChild(createSubmenuItem("Interpolation", resampleModeName(module->interpolationMode),
+            [=](Menu* menu) {
+                for (int m = 0; m < RESAMPLE_MODES_LEN; m++) {
+                    menu->addChild(createCheckMenuItem(resampleModeName(m), "",
+                        [=]() { return module->interpolationMode == m; },
+                        [=]() { module->interpolationMode = m; }
+                    ));
+                }
+            }
+        ));
     }
 };
 
@@ -1,5 +1,6 @@
 #include "plugin.hpp"
 #include "widgets/Knobs.hpp"
+#include "widgets/CVModulation.hpp"
 #include "widgets/PanelTheme.hpp"
 #include <vector>
 #include <algorithm>
@@ -667,11 +668,16 @@ struct MADDYPlus : Module {
     float secondPhase = 0.0f;  // SwingLFO style second phase
     dsp::PulseGenerator clockPulse;
     float prevSwingPulse = 0.0f;  // For detecting rising edge
+    float resetPulseTimer = 0.0f;  // Manual reset light/pulse duration
 
     // CV display modulation values
-    float clockCvMod = 0.0f;
-    float ch2CvdCvMod = 0.0f;
-    float ch3CvdCvMod = 0.0f;
+    enum CvModId {
+        CVMOD_CLOCK,
+        CVMOD_CH2_CVD,
+        CVMOD_CH3_CVD,
+        NUM_CVMODS
+    };
+    madzine::widgets::CVModBank<NUM_CVMODS> cvMods;
 
     struct TrackState {
         int divMultValue = 0;
@@ -1544,9 +1550,9 @@ json_t* dataToJson() override {
             float cvVoltage = inputs[CLOCK_CV_INPUT].getVoltage();
             float attenuation = params[CLOCK_CV_ATTEN_PARAM].getValue();
             clockCVMod = cvVoltage * attenuation;
-            clockCvMod = clamp(cvVoltage / 10.0f * attenuation, -1.0f, 1.0f);
+            cvMods.publish(CVMOD_CLOCK, clamp(cvVoltage / 10.0f * attenuation, -1.0f, 1.0f));
         } else {
-            clockCvMod = 0.0f;
+            cvMods.clear(CVMOD_CLOCK);
         }
 
         float freq = std::pow(2.0f, freqParam + clockCVMod) * 1.0f;
@@ -1555,8 +1561,6 @@ json_t* dataToJson() override {
         float swing = clamp(swingParam, 0.0f, 1.0f);
 
 
-        static float resetPulseTimer = 0.0f;
-
         if (params[MANUAL_RESET_PARAM].getValue() > 0.5f) {
             onReset();
             params[MANUAL_RESET_PARAM].setValue(0.0f);
@@ -1751,12 +1755,12 @@ json_t* dataToJson() override {
 
         if (!inputs[CH2_CV_INPUT].isConnected()) {
             ch2DelayTimeMs = ch2KnobValue * 1000.0f;
-            ch2CvdCvMod = 0.0f;
+            cvMods.clear(CVMOD_CH2_CVD);
         } else {
             float cv = inputs[CH2_CV_INPUT].getVoltage();
             float ch2CvdCV = clamp(cv, 0.0f, 10.0f);
             ch2DelayTimeMs = (ch2CvdCV / 10.0f) * ch2KnobValue * 1000.0f;
-            ch2CvdCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+            cvMods.publish(CVMOD_CH2_CVD, clamp(cv / 10.0f, -1.0f, 1.0f));
         }
 
         if (ch2DelayTimeMs <= 0.001f) {
@@ -1838,12 +1842,12 @@ json_t* dataToJson() override {
 
         if (!inputs[CH3_CV_INPUT].isConnected()) {
             ch3DelayTimeMs = ch3KnobValue * 1000.0f;
-            ch3CvdCvMod = 0.0f;
+            cvMods.clear(CVMOD_CH3_CVD);
         } else {
             float cv = inputs[CH3_CV_INPUT].getVoltage();
             float ch3CvdCV = clamp(cv, 0.0f, 10.0f);
             ch3DelayTimeMs = (ch3CvdCV / 10.0f) * ch3KnobValue * 1000.0f;
-            ch3CvdCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+            cvMods.publish(CVMOD_CH3_CVD, clamp(cv / 10.0f, -1.0f, 1.0f));
         }
 
         if (ch3DelayTimeMs <= 0.001f) {
@@ -2053,6 +2057,7 @@ struct MADDYPlusWidget : ModuleWidget {
     madzine::widgets::BaseCustomKnob* freqKnob = nullptr;
     madzine::widgets::BaseCustomKnob* ch2CvdKnob = nullptr;
     madzine::widgets::BaseCustomKnob* ch3CvdKnob = nullptr;
+    madzine::widgets::CVModRingSync<MADDYPlus::NUM_CVMODS> cvModSync;
 
     MADDYPlusWidget(MADDYPlus* module) {
         setModule(module);
@@ -2195,6 +2200,10 @@ resetButton->module = module;
         ch3CvdKnob = createParamCentered<madzine::widgets::WhiteKnob>(Vec(ch2OffsetX + 15, 287), module, MADDYPlus::CH3_CVD_ATTEN_PARAM);
         addParam(ch3CvdKnob);
 
+        cvModSync.bind(MADDYPlus::CVMOD_CLOCK, freqKnob);
+        cvModSync.bind(MADDYPlus::CVMOD_CH2_CVD, ch2CvdKnob);
+        cvModSync.bind(MADDYPlus::CVMOD_CH3_CVD, ch3CvdKnob);
+
         addChild(new MADDYPlusEnhancedTextLabel(Vec(ch2OffsetX + 33, 244), Vec(25, 10), "DELAY", 8.f, nvgRGB(255, 255, 255), true));
         addParam(createParamCentered<madzine::widgets::MADDYPlusSnapKnob>(Vec(ch2OffsetX + 45, 267), module, MADDYPlus::CH3_STEP_DELAY_PARAM));
 
@@ -2334,26 +2343,8 @@ resetButton->module = module;
         if (module) {
             panelThemeHelper.step(module);
 
-            // CV display update for FREQ knob
-            if (freqKnob) {
-                bool connected = module->inputs[MADDYPlus::CLOCK_CV_INPUT].isConnected();
-                freqKnob->setModulationEnabled(connected);
-                if (connected) freqKnob->setModulation(module->clockCvMod);
-            }
-
-            // CV display update for CH2 CVD knob
-            if (ch2CvdKnob) {
-                bool connected = module->inputs[MADDYPlus::CH2_CV_INPUT].isConnected();
-                ch2CvdKnob->setModulationEnabled(connected);
-                if (connected) ch2CvdKnob->setModulation(module->ch2CvdCvMod);
-            }
-
-            // CV display update for CH3 CVD knob
-            if (ch3CvdKnob) {
-                bool connected = module->inputs[MADDYPlus::CH3_CV_INPUT].isConnected();
-                ch3CvdKnob->setModulationEnabled(connected);
-                if (connected) ch3CvdKnob->setModulation(module->ch3CvdCvMod);
-            }
+            // CV modulation ring display (only touches knobs whose value changed)
+            cvModSync.sync(module->cvMods);
         }
         ModuleWidget::step();
     }
@@ -499,7 +499,7 @@ inline std::map<std::string, ModuleHelpData> initHelpData() {
         m.entries.push_back({"Sample & Hold CV", {"Sample & Hold chaos signal 0-5V, sampled at Rate × 10 Hz (polyphonic)", "Sample & Hold Chaos 訊號 0-5V，取樣速率 Rate × 10 Hz（Polyphonic）", "サンプル&ホールドカオス信号0-5V、Rate × 10 Hzでサンプル（ポリフォニック）"}});
         data["Facehugger"] = std::move(m);
     }
-    // KEN (11 entries)
+    // KEN (14 entries)
     {
         ModuleHelpData m;
         m.name = "KEN";
@@ -513,6 +513,9 @@ inline std::map<std::string, ModuleHelpData> initHelpData() {
         m.entries.push_back({"6", {"Channel 6 input - FR Lower, Azimuth +45°, Elevation -30°, distance 0.5", "聲道 6 輸入 - FR Lower，Azimuth +45°，Elevation -30°，距離 0.5", "チャンネル6入力 - FR Lower、Azimuth +45°、Elevation -30°、距離 0.5"}});
         m.entries.push_back({"7", {"Channel 7 input - BL Lower, Azimuth -135°, Elevation -30°, distance 2.0", "聲道 7 輸入 - BL Lower，Azimuth -135°，Elevation -30°，距離 2.0", "チャンネル7入力 - BL Lower、Azimuth -135°、Elevation -30°、距離 2.0"}});
         m.entries.push_back({"8", {"Channel 8 input - BR Lower, Azimuth +135°, Elevation -30°, distance 2.0", "聲道 8 輸入 - BR Lower，Azimuth +135°，Elevation -30°，距離 2.0", "チャンネル8入力 - BR Lower、Azimuth +135°、Elevation -30°、距離 2.0"}});
+        m.entries.push_back({"AZ", {"Polyphonic azimuth CV, channel N adds 36° per volt to input N's azimuth (set in the right-click menu under Speaker Positions); a mono cable moves all inputs", "Polyphonic Azimuth CV，第 N 聲道每伏特 36°，加到輸入 N 的 Azimuth（於右鍵選單 Speaker Positions 設定）；單聲道線材移動所有輸入", "ポリフォニック方位角CV、チャンネルNが1Vあたり36°を入力Nの方位角に加算（右クリックメニューのSpeaker Positionsで設定）、モノラルケーブルは全入力を移動"}});
+        m.entries.push_back({"EL", {"Polyphonic elevation CV, channel N moves input N by 18° per volt, result limited to ±90°", "Polyphonic Elevation CV，第 N 聲道每伏特 18° 移動輸入 N，結果限制在 ±90°", "ポリフォニック仰角CV、チャンネルNが1Vあたり18°入力Nを移動、結果は±90°に制限"}});
+        m.entries.push_back({"DIST", {"Polyphonic distance CV, channel N moves input N by 0.4 per volt, result limited to 0-4", "Polyphonic 距離 CV，第 N 聲道每伏特 0.4 移動輸入 N，結果限制在 0-4", "ポリフォニック距離CV、チャンネルNが1Vあたり0.4入力Nを移動、結果は0〜4に制限"}});
         m.entries.push_back({"Left", {"Left ear Binaural output, sum of all 8 channels after HRTF processing", "左耳 Binaural 輸出，所有 8 聲道 HRTF 處理後加總", "左耳Binaural出力、全8チャンネルHRTF処理後の合算"}});
         m.entries.push_back({"Right", {"Right ear Binaural output, sum of all 8 channels after HRTF processing", "右耳 Binaural 輸出，所有 8 聲道 HRTF 處理後加總", "右耳Binaural出力、全8チャンネルHRTF処理後の合算"}});
         data["KEN"] = std::move(m);
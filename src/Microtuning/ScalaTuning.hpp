@@ -0,0 +1,251 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace Microtuning {
+
+// Scala scale (.scl): degrees 1..N in cents above 1/1, the last one is the period
+struct ScalaScale {
+    std::string description;
+    std::vector<double> cents;
+};
+
+// Scala keyboard mapping (.kbm); size 0 = linear mapping
+struct ScalaKeyboardMap {
+    int size = 0;
+    int firstNote = -100000;
+    int lastNote = 100000;
+    int middleNote = 60;
+    int referenceNote = 60;
+    double referenceFreq = 261.6255653;  // C4 = 0V
+    int formalOctave = 0;                // 0 = number of scale notes
+    std::vector<int> mapping;            // -1 = unmapped ('x')
+};
+
+inline std::string scalaTrim(const std::string& s) {
+    size_t a = s.find_first_not_of(" \t\r\n");
+    if (a == std::string::npos) return "";
+    size_t b = s.find_last_not_of(" \t\r\n");
+    return s.substr(a, b - a + 1);
+}
+
+// Next non-comment line; blank lines are skipped unless keepBlank
+inline bool scalaNextLine(std::istringstream& in, std::string& line, bool keepBlank = false) {
+    std::string raw;
+    while (std::getline(in, raw)) {
+        if (!raw.empty() && raw[0] == '!') continue;
+        line = scalaTrim(raw);
+        if (line.empty() && !keepBlank) continue;
+        return true;
+    }
+    return false;
+}
+
+// Pitch line: "701.955" (cents), "3/2" or "2" (ratio); trailing text is ignored
+inline bool scalaParsePitch(const std::string& line, double& cents) {
+    std::string token = line.substr(0, line.find_first_of(" \t"));
+    if (token.empty()) return false;
+    char* end = nullptr;
+    if (token.find('.') != std::string::npos) {
+        cents = std::strtod(token.c_str(), &end);
+        return end != token.c_str();
+    }
+    size_t slash = token.find('/');
+    double num = std::strtod(token.substr(0, slash).c_str(), &end);
+    double den = (slash == std::string::npos) ? 1.0 : std::strtod(token.substr(slash + 1).c_str(), nullptr);
+    if (!(num > 0.0) || !(den > 0.0)) return false;
+    cents = 1200.0 * std::log2(num / den);
+    return true;
+}
+
+inline bool parseScl(const std::string& text, ScalaScale& scale, std::string& error) {
+    std::istringstream in(text);
+    std::string line;
+    if (!scalaNextLine(in, line, true)) {
+        error = "Empty .scl file";
+        return false;
+    }
+    scale.description = line;
+    scale.cents.clear();
+
+    if (!scalaNextLine(in, line)) {
+        error = "Missing note count";
+        return false;
+    }
+    int count = std::atoi(line.c_str());
+    if (count < 1 || count > 4096) {
+        error = "Invalid note count";
+        return false;
+    }
+
+    for (int i = 0; i < count; i++) {
+        double cents;
+        if (!scalaNextLine(in, line) || !scalaParsePitch(line, cents)) {
+            error = "Invalid pitch on degree " + std::to_string(i + 1);
+            return false;
+        }
+        scale.cents.push_back(cents);
+    }
+    if (!(scale.cents.back() > 0.0)) {
+        error = "Period must be above 1/1";
+        return false;
+    }
+    return true;
+}
+
+inline bool parseKbm(const std::string& text, ScalaKeyboardMap& map, std::string& error) {
+    std::istringstream in(text);
+    std::string line;
+    double header[7];
+    for (int i = 0; i < 7; i++) {
+        if (!scalaNextLine(in, line)) {
+            error = "Incomplete .kbm header";
+            return false;
+        }
+        header[i] = std::strtod(line.c_str(), nullptr);
+    }
+    map.size = std::max(0, (int)header[0]);
+    map.firstNote = (int)header[1];
+    map.lastNote = (int)header[2];
+    map.middleNote = (int)header[3];
+    map.referenceNote = (int)header[4];
+    map.referenceFreq = header[5];
+    map.formalOctave = std::max(0, (int)header[6]);
+    if (!(map.referenceFreq > 0.0) || map.size > 4096) {
+        error = "Invalid .kbm header";
+        return false;
+    }
+
+    // Missing entries are unmapped
+    map.mapping.assign(map.size, -1);
+    for (int i = 0; i < map.size && scalaNextLine(in, line); i++) {
+        if (line[0] == 'x' || line[0] == 'X') continue;
+        map.mapping[i] = std::atoi(line.c_str());
+    }
+    return true;
+}
+
+/**
+ * Compiled quantizer table: sorted target pitches (V/oct) and the decision
+ * thresholds between them, padded with +inf to a power of two so the lookup
+ * is a fixed-length branchless binary search.
+ */
+struct ScalaTable {
+    static constexpr int MAX_TARGETS = 8192;
+
+    float targets[MAX_TARGETS];
+    float thresholds[MAX_TARGETS];
+    int count = 0;
+    int searchSize = 1;  // power of two, > count - 1
+
+    // Index of the nearest target
+    int find(float pitch) const {
+        int pos = 0;
+        for (int step = searchSize >> 1; step > 0; step >>= 1) {
+            pos += (thresholds[pos + step - 1] <= pitch) ? step : 0;
+        }
+        return pos;
+    }
+
+    float quantize(float pitch) const {
+        return targets[find(pitch)];
+    }
+};
+
+inline long scalaFloorDiv(long a, long b) {
+    long q = a / b;
+    return (a % b != 0 && ((a < 0) != (b < 0))) ? q - 1 : q;
+}
+
+/**
+ * Expand scale + mapping into every pitch within +/-10.5V
+ */
+inline bool compileScalaTable(const ScalaScale& scale, const ScalaKeyboardMap& map,
+                              ScalaTable& table, std::string& error) {
+    const long notes = (long)scale.cents.size();
+    const double period = scale.cents.back();
+
+    // Linear mapping = one key per pattern, one degree per pattern
+    const bool linear = (map.size == 0);
+    const long patternSize = linear ? 1 : map.size;
+    const long patternDegrees = linear ? 1 : ((map.formalOctave > 0) ? map.formalOctave : notes);
+    auto mappedDegree = [&](long index) { return linear ? 0 : map.mapping[index]; };
+
+    auto degreeCents = [&](long degree) {
+        long p = scalaFloorDiv(degree, notes);
+        long r = degree - p * notes;
+        return p * period + (r == 0 ? 0.0 : scale.cents[r - 1]);
+    };
+    // Absolute degree of a key, or false if unmapped
+    auto keyDegree = [&](long key, long& degree) {
+        long d = key - map.middleNote;
+        long p = scalaFloorDiv(d, patternSize);
+        int mapped = mappedDegree(d - p * patternSize);
+        if (mapped < 0) return false;
+        degree = p * patternDegrees + mapped;
+        return true;
+    };
+
+    long refDegree;
+    if (!keyDegree(map.referenceNote, refDegree)) refDegree = map.referenceNote - map.middleNote;
+    double refVolts = std::log2(map.referenceFreq / 261.6255653) - degreeCents(refDegree) / 1200.0;
+
+    // How far a mapped key can sit from the start of its pattern
+    double spread = period / 1200.0;
+    for (long i = 0; i < patternSize; i++) {
+        if (mappedDegree(i) >= 0) spread = std::max(spread, std::fabs(degreeCents(mappedDegree(i))) / 1200.0 + period / 1200.0);
+    }
+
+    std::vector<float> pitches;
+    const long MAX_KEYS = 200000;
+    for (int dir = -1; dir <= 1; dir += 2) {
+        for (long i = (dir < 0) ? 1 : 0; i < MAX_KEYS; i++) {
+            long key = map.middleNote + dir * i;
+            if (key < map.firstNote || key > map.lastNote) break;
+            // Stop once a whole pattern lies outside the range
+            long pattern = scalaFloorDiv(key - map.middleNote, patternSize);
+            double patternVolts = refVolts + degreeCents(pattern * patternDegrees) / 1200.0;
+            if (dir * patternVolts > 10.5 + spread) break;
+            long degree;
+            if (!keyDegree(key, degree)) continue;
+            double volts = refVolts + degreeCents(degree) / 1200.0;
+            if (std::fabs(volts) <= 10.5) pitches.push_back((float)volts);
+        }
+    }
+
+    std::sort(pitches.begin(), pitches.end());
+    pitches.erase(std::unique(pitches.begin(), pitches.end(),
+                              [](float a, float b) { return std::fabs(a - b) < 1e-6f; }),
+                  pitches.end());
+    if (pitches.empty()) {
+        error = "No mapped pitches in range";
+        return false;
+    }
+
+    // Too dense: keep the window closest to 0V
+    if ((int)pitches.size() > ScalaTable::MAX_TARGETS) {
+        auto center = std::lower_bound(pitches.begin(), pitches.end(), 0.f) - pitches.begin();
+        long first = std::min(std::max(0L, (long)center - ScalaTable::MAX_TARGETS / 2),
+                              (long)pitches.size() - ScalaTable::MAX_TARGETS);
+        pitches = std::vector<float>(pitches.begin() + first, pitches.begin() + first + ScalaTable::MAX_TARGETS);
+    }
+
+    int count = (int)pitches.size();
+    int searchSize = 1;
+    while (searchSize < count) searchSize <<= 1;
+    for (int i = 0; i < count; i++) {
+        table.targets[i] = pitches[i];
+    }
+    for (int i = 0; i < searchSize; i++) {
+        table.thresholds[i] = (i < count - 1) ? 0.5f * (pitches[i] + pitches[i + 1]) : INFINITY;
+    }
+    table.searchSize = searchSize;
+    table.count = count;
+    return true;
+}
+
+} // namespace Microtuning
@@ -1,6 +1,8 @@
 #include "plugin.hpp"
 #include "widgets/Knobs.hpp"
+#include "widgets/CVModulation.hpp"
 #include "widgets/PanelTheme.hpp"
+#include "widgets/ScopeCapture.hpp"
 #include <cmath>
 #include "dsp/resampler.hpp"
 #include <sst/filters/HalfRateFilter.h>
@@ -362,18 +364,12 @@ struct NIGOQ : Module {
     };
 
     // Scope display (exactly like Observer)
-    struct ScopePoint {
-        float min = INFINITY;
-        float max = -INFINITY;
-    };
-
+    // 軌道 0 = FINAL，軌道 1 = MOD
     static constexpr int SCOPE_BUFFER_SIZE = 256; // Same as Observer
-    ScopePoint finalBuffer[SCOPE_BUFFER_SIZE];
-    ScopePoint modBuffer[SCOPE_BUFFER_SIZE];
-    ScopePoint currentFinal;
-    ScopePoint currentMod;
-    int bufferIndex = 0;
-    int frameIndex = 0;
+    static constexpr int SCOPE_FINAL_TRACK = 0;
+    static constexpr int SCOPE_MOD_TRACK = 1;
+    using Frame = madzine::widgets::ScopeFrame<2, SCOPE_BUFFER_SIZE>;
+    madzine::widgets::ScopeCapture<2, SCOPE_BUFFER_SIZE> scope;
 
     VisualDisplay* visualDisplay = nullptr;
 
@@ -382,13 +378,17 @@ struct NIGOQ : Module {
     float panelContrast = madzineDefaultContrast; // -1 = Auto (follow VCV)
 
     // CV display modulation values
-    float modWaveCvMod = 0.0f;
-    float fmAmtCvMod = 0.0f;
-    float foldAmtCvMod = 0.0f;
-    float amAmtCvMod = 0.0f;
-    float harmonicsCvMod = 0.0f;
-    float orderCvMod = 0.0f;
-    float lpfCutoffCvMod = 0.0f;
+    enum CvModId {
+        CVMOD_MOD_WAVE,
+        CVMOD_FM_AMT,
+        CVMOD_FOLD_AMT,
+        CVMOD_AM_AMT,
+        CVMOD_HARMONICS,
+        CVMOD_ORDER,
+        CVMOD_LPF_CUTOFF,
+        NUM_CVMODS
+    };
+    madzine::widgets::CVModBank<NUM_CVMODS> cvMods;
 
     // Oscillators
     float modPhase = 0.f;
@@ -1244,9 +1244,9 @@ struct NIGOQ : Module {
             float cv = inputs[MOD_WAVE_CV].getVoltage();
             float waveCV = cv / 10.f; // Normalize 0-10V to 0-1
             waveMorph = clamp(waveMorph + waveCV, 0.f, 1.f);
-            modWaveCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+            cvMods.publish(CVMOD_MOD_WAVE, clamp(cv / 10.0f, -1.0f, 1.0f));
         } else {
-            modWaveCvMod = 0.0f;
+            cvMods.clear(CVMOD_MOD_WAVE);
         }
 
         //  ===== BLOCK-BASED OVERSAMPLE PROCESSING (Surge XT style) =====
@@ -1296,9 +1296,9 @@ struct NIGOQ : Module {
             float fmCV = cv / 10.f;
             fmModAmount += fmCV * fmAttenuation;
             fmModAmount = clamp(fmModAmount, 0.f, 1.f);
-            fmAmtCvMod = clamp(cv / 10.0f * fmAttenuation, -1.0f, 1.0f);
+            cvMods.publish(CVMOD_FM_AMT, clamp(cv / 10.0f * fmAttenuation, -1.0f, 1.0f));
         } else {
-            fmAmtCvMod = 0.0f;
+            cvMods.clear(CVMOD_FM_AMT);
         }
 
         // Get fold amount
@@ -1308,9 +1308,9 @@ struct NIGOQ : Module {
             float foldCV = cv / 10.f;
             foldAmount += foldCV;
             foldAmount = clamp(foldAmount, 0.f, 1.f);
-            harmonicsCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+            cvMods.publish(CVMOD_HARMONICS, clamp(cv / 10.0f, -1.0f, 1.0f));
         } else {
-            harmonicsCvMod = 0.0f;
+            cvMods.clear(CVMOD_HARMONICS);
         }
 
         // TM amount
@@ -1321,9 +1321,9 @@ struct NIGOQ : Module {
             float tmCV = cv / 10.f;
             tmAmount += tmCV * tmAttenuation;
             tmAmount = clamp(tmAmount, 0.f, 1.f);
-            foldAmtCvMod = clamp(cv / 10.0f * tmAttenuation, -1.0f, 1.0f);
+            cvMods.publish(CVMOD_FOLD_AMT, clamp(cv / 10.0f * tmAttenuation, -1.0f, 1.0f));
         } else {
-            foldAmtCvMod = 0.0f;
+            cvMods.clear(CVMOD_FOLD_AMT);
         }
 
         // Rectify amount
@@ -1333,9 +1333,9 @@ struct NIGOQ : Module {
             float rectifyCV = cv / 10.f;
             rectifyAmount += rectifyCV;
             rectifyAmount = clamp(rectifyAmount, 0.f, 1.f);
-            orderCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+            cvMods.publish(CVMOD_ORDER, clamp(cv / 10.0f, -1.0f, 1.0f));
         } else {
-            orderCvMod = 0.0f;
+            cvMods.clear(CVMOD_ORDER);
         }
 
         // RECT modulation amount
@@ -1346,9 +1346,9 @@ struct NIGOQ : Module {
             float rectModCV = cv / 10.f;
             rectModAmount += rectModCV * rectModAttenuation;
             rectModAmount = clamp(rectModAmount, 0.f, 1.f);
-            amAmtCvMod = clamp(cv / 10.0f * rectModAttenuation, -1.0f, 1.0f);
+            cvMods.publish(CVMOD_AM_AMT, clamp(cv / 10.0f * rectModAttenuation, -1.0f, 1.0f));
         } else {
-            amAmtCvMod = 0.0f;
+            cvMods.clear(CVMOD_AM_AMT);
         }
 
         // LPF cutoff
@@ -1362,9 +1362,9 @@ struct NIGOQ : Module {
             float lpfCV = cv / 10.f;
             float cvAmount = lpfCV * 2.f - 1.f;
             lpfCutoff *= std::pow(2.f, cvAmount * 2.f);
-            lpfCutoffCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+            cvMods.publish(CVMOD_LPF_CUTOFF, clamp(cv / 10.0f, -1.0f, 1.0f));
         } else {
-            lpfCutoffCvMod = 0.0f;
+            cvMods.clear(CVMOD_LPF_CUTOFF);
         }
 
         lpfCutoff = clamp(lpfCutoff, 20.f, args.sampleRate * oversampleRate / 2.f * 0.49f);
@@ -1448,7 +1448,7 @@ struct NIGOQ : Module {
         lights[TRIG_LIGHT].setBrightness(trig);
 
         // Scope recording
-        if (bufferIndex >= SCOPE_BUFFER_SIZE) {
+        if (!scope.isRecording()) {
             bool triggered = false;
 
             if (!trig) {
@@ -1463,35 +1463,23 @@ struct NIGOQ : Module {
                 for (int c = 0; c < 16; c++) {
                     scopeTriggers[c].reset();
                 }
-                bufferIndex = 0;
-                frameIndex = 0;
+                scope.start();
             }
         }
 
-        if (bufferIndex < SCOPE_BUFFER_SIZE) {
+        if (scope.isRecording()) {
             float deltaTime = dsp::exp2_taylor5(-params[SCOPE_TIME].getValue()) / SCOPE_BUFFER_SIZE;
             int frameCount = (int) std::ceil(deltaTime * args.sampleRate);
 
-            float modSample = modOutputFinal / 5.0f - 1.0f;
-            float finalSample = finalOutputFinal / 5.0f;
-            currentFinal.min = std::min(currentFinal.min, finalSample);
-            currentFinal.max = std::max(currentFinal.max, finalSample);
-            currentMod.min = std::min(currentMod.min, modSample);
-            currentMod.max = std::max(currentMod.max, modSample);
-
-            if (++frameIndex >= frameCount) {
-                frameIndex = 0;
-                finalBuffer[bufferIndex] = currentFinal;
-                modBuffer[bufferIndex] = currentMod;
-                currentFinal = ScopePoint();
-                currentMod = ScopePoint();
-                bufferIndex++;
-            }
+            scope.addValue(SCOPE_FINAL_TRACK, finalOutputFinal / 5.0f);
+            scope.addValue(SCOPE_MOD_TRACK, modOutputFinal / 5.0f - 1.0f);
+            scope.step(frameCount, args.sampleRate);
         }
     }
 };
 
 // ===== Dual-track Scope Display Widget =====
+// 畫在 ScopeFramebuffer 內，只有收到新幀時才重畫
 struct VisualDisplay : Widget {
     NIGOQ* module;
 
@@ -1499,6 +1487,12 @@ struct VisualDisplay : Widget {
         box.size = Vec(66, 38.5);
     }
 
+    void step() override {
+        if (module && module->scope.poll())
+            madzine::widgets::markScopeDirty(this);
+        Widget::step();
+    }
+
     void draw(const DrawArgs& args) override {
         if (!module) return;
 
@@ -1522,66 +1516,26 @@ struct VisualDisplay : Widget {
         nvgStrokeWidth(args.vg, 0.5f);
         nvgStroke(args.vg);
 
+        const NIGOQ::Frame& frame = module->scope.frame();
+
+        // Scale signal properly (already normalized to +/-1 in process)
         // Draw PRIN trace (top half, pink)
         float trackHeight = box.size.y / 2.0f;
-        float trackY = 0;
 
         nvgSave(args.vg);
-        Rect b = Rect(Vec(0, trackY), Vec(box.size.x, trackHeight));
+        Rect b = Rect(Vec(0, 0), Vec(box.size.x, trackHeight));
         nvgScissor(args.vg, RECT_ARGS(b));
-        nvgBeginPath(args.vg);
-
-        for (int i = 0; i < NIGOQ::SCOPE_BUFFER_SIZE; i++) {
-            const NIGOQ::ScopePoint& point = module->finalBuffer[i];
-            float value = point.max;
-            if (!std::isfinite(value))
-                value = 0.f;
-
-            Vec p;
-            p.x = (float)i / (NIGOQ::SCOPE_BUFFER_SIZE - 1) * b.size.x;
-            // Scale signal properly (already normalized to +/-1 in process)
-            p.y = b.pos.y + b.size.y * 0.5f * (1.f - value);
-
-            if (i == 0)
-                nvgMoveTo(args.vg, p.x, p.y);
-            else
-                nvgLineTo(args.vg, p.x, p.y);
-        }
-
-        nvgStrokeColor(args.vg, nvgRGB(255, 133, 133)); // Pink
-        nvgStrokeWidth(args.vg, 1.0f);
-        nvgStroke(args.vg);
+        madzine::widgets::drawScopeEnvelope(args.vg, frame, NIGOQ::SCOPE_FINAL_TRACK, b,
+                                            nvgRGB(255, 133, 133), 0.5f, 0.5f, 1.0f); // Pink
         nvgResetScissor(args.vg);
         nvgRestore(args.vg);
 
         // Draw MOD trace (bottom half, cyan)
-        trackY = trackHeight;
-
         nvgSave(args.vg);
-        b = Rect(Vec(0, trackY), Vec(box.size.x, trackHeight));
+        b = Rect(Vec(0, trackHeight), Vec(box.size.x, trackHeight));
         nvgScissor(args.vg, RECT_ARGS(b));
-        nvgBeginPath(args.vg);
-
-        for (int i = 0; i < NIGOQ::SCOPE_BUFFER_SIZE; i++) {
-            const NIGOQ::ScopePoint& point = module->modBuffer[i];
-            float value = point.max;
-            if (!std::isfinite(value))
-                value = 0.f;
-
-            Vec p;
-            p.x = (float)i / (NIGOQ::SCOPE_BUFFER_SIZE - 1) * b.size.x;
-            // Scale signal properly (already normalized to +/-1 in process)
-            p.y = b.pos.y + b.size.y * 0.5f * (1.f - value);
-
-            if (i == 0)
-                nvgMoveTo(args.vg, p.x, p.y);
-            else
-                nvgLineTo(args.vg, p.x, p.y);
-        }
-
-        nvgStrokeColor(args.vg, nvgRGB(133, 200, 255)); // Cyan
-        nvgStrokeWidth(args.vg, 1.0f);
-        nvgStroke(args.vg);
+        madzine::widgets::drawScopeEnvelope(args.vg, frame, NIGOQ::SCOPE_MOD_TRACK, b,
+                                            nvgRGB(133, 200, 255), 0.5f, 0.5f, 1.0f); // Cyan
         nvgResetScissor(args.vg);
         nvgRestore(args.vg);
     }
@@ -1641,6 +1595,7 @@ struct NIGOQWidget : ModuleWidget {
     madzine::widgets::BaseCustomKnob* lpfCutoffKnob = nullptr;
     madzine::widgets::BaseCustomKnob* orderKnob = nullptr;
     madzine::widgets::BaseCustomKnob* harmonicsKnob = nullptr;
+    madzine::widgets::CVModRingSync<NIGOQ::NUM_CVMODS> cvModSync;
 
     NIGOQWidget(NIGOQ* module) {
         setModule(module);
@@ -1711,6 +1666,14 @@ struct NIGOQWidget : ModuleWidget {
         addParam(amAmtKnob);
         addParam(createParamCentered<madzine::widgets::MediumGrayKnob>(Vec(165, 265), module, NIGOQ::BASS));
 
+        cvModSync.bind(NIGOQ::CVMOD_MOD_WAVE, modWaveKnob);
+        cvModSync.bind(NIGOQ::CVMOD_FM_AMT, fmAmtKnob);
+        cvModSync.bind(NIGOQ::CVMOD_FOLD_AMT, foldAmtKnob);
+        cvModSync.bind(NIGOQ::CVMOD_AM_AMT, amAmtKnob);
+        cvModSync.bind(NIGOQ::CVMOD_HARMONICS, harmonicsKnob);
+        cvModSync.bind(NIGOQ::CVMOD_ORDER, orderKnob);
+        cvModSync.bind(NIGOQ::CVMOD_LPF_CUTOFF, lpfCutoffKnob);
+
         // Switch
         addParam(createParamCentered<CKSSThree>(Vec(90, 85), module, NIGOQ::SYNC_MODE));
 
@@ -1760,7 +1723,7 @@ struct NIGOQWidget : ModuleWidget {
         // Add scope display
         VisualDisplay* scopeDisplay = new VisualDisplay(module);
         scopeDisplay->box.pos = Vec(40, 335);
-        addChild(scopeDisplay);
+        addChild(madzine::widgets::createScopeFramebuffer(scopeDisplay, 0));
         if (module) {
             module->visualDisplay = scopeDisplay;
         }
@@ -1789,22 +1752,8 @@ struct NIGOQWidget : ModuleWidget {
         if (module) {
             panelThemeHelper.step(module);
 
-            // CV display updates
-            auto updateKnob = [&](madzine::widgets::BaseCustomKnob* knob, int inputId, float cvMod) {
-                if (knob) {
-                    bool connected = module->inputs[inputId].isConnected();
-                    knob->setModulationEnabled(connected);
-                    if (connected) knob->setModulation(cvMod);
-                }
-            };
-
-            updateKnob(modWaveKnob, NIGOQ::MOD_WAVE_CV, module->modWaveCvMod);
-            updateKnob(fmAmtKnob, NIGOQ::FM_AMT_CV, module->fmAmtCvMod);
-            updateKnob(foldAmtKnob, NIGOQ::FOLD_AMT_CV, module->foldAmtCvMod);
-            updateKnob(amAmtKnob, NIGOQ::AM_AMT_CV, module->amAmtCvMod);
-            updateKnob(lpfCutoffKnob, NIGOQ::LPF_CUTOFF_CV, module->lpfCutoffCvMod);
-            updateKnob(orderKnob, NIGOQ::ORDER_CV, module->orderCvMod);
-            updateKnob(harmonicsKnob, NIGOQ::HARMONICS_CV, module->harmonicsCvMod);
+            // CV modulation ring display (only touches knobs whose value changed)
+            cvModSync.sync(module->cvMods);
         }
         ModuleWidget::step();
     }
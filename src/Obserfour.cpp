@@ -1,6 +1,7 @@
 #include "plugin.hpp"
 #include "widgets/Knobs.hpp"
 #include "widgets/PanelTheme.hpp"
+#include "widgets/ScopeCapture.hpp"
 
 struct Obserfour : Module {
     int panelTheme = madzineDefaultTheme;
@@ -30,17 +31,10 @@ struct Obserfour : Module {
         NUM_LIGHTS
     };
 
-    struct ScopePoint {
-        float min = INFINITY;
-        float max = -INFINITY;
-    };
-
     static constexpr int SCOPE_BUFFER_SIZE = 256;
-    
-    ScopePoint scopeBuffer[8][SCOPE_BUFFER_SIZE];
-    ScopePoint currentPoint[8];
-    int bufferIndex = 0;
-    int frameIndex = 0;
+
+    using Frame = madzine::widgets::ScopeFrame<8, SCOPE_BUFFER_SIZE>;
+    madzine::widgets::ScopeCapture<8, SCOPE_BUFFER_SIZE> scope;
     
     dsp::SchmittTrigger triggers[16];
 
@@ -88,7 +82,7 @@ struct Obserfour : Module {
         bool trig = !params[TRIG_PARAM].getValue();
         lights[TRIG_LIGHT].setBrightness(trig);
 
-        if (bufferIndex >= SCOPE_BUFFER_SIZE) {
+        if (!scope.isRecording()) {
             bool triggered = false;
 
             if (!trig) {
@@ -113,31 +107,19 @@ struct Obserfour : Module {
                 for (int c = 0; c < 16; c++) {
                     triggers[c].reset();
                 }
-                bufferIndex = 0;
-                frameIndex = 0;
+                scope.start();
             }
         }
 
-        if (bufferIndex < SCOPE_BUFFER_SIZE) {
+        if (scope.isRecording()) {
             float deltaTime = dsp::exp2_taylor5(-params[TIME_PARAM].getValue()) / SCOPE_BUFFER_SIZE;
             int frameCount = (int) std::ceil(deltaTime * args.sampleRate);
 
             for (int i = 0; i < 8; i++) {
-                float x = inputs[TRACK1_INPUT + i].getVoltage();
-                currentPoint[i].min = std::min(currentPoint[i].min, x);
-                currentPoint[i].max = std::max(currentPoint[i].max, x);
+                scope.addPort(i, inputs[TRACK1_INPUT + i]);
             }
 
-            if (++frameIndex >= frameCount) {
-                frameIndex = 0;
-                for (int i = 0; i < 8; i++) {
-                    scopeBuffer[i][bufferIndex] = currentPoint[i];
-                }
-                for (int i = 0; i < 8; i++) {
-                    currentPoint[i] = ScopePoint();
-                }
-                bufferIndex++;
-            }
+            scope.step(frameCount, args.sampleRate);
         }
     }
 };
@@ -188,17 +170,17 @@ struct WhiteBackgroundBox : Widget {
     }
 };
 
-struct ObserfourScopeDisplay : LedDisplay {
+// 波形畫在 ScopeFramebuffer 內，只有新幀或接線顏色改變時才重畫
+struct ObserfourScopeDisplay : Widget {
     Obserfour* module;
     ModuleWidget* moduleWidget;
+    madzine::widgets::ScopeTrackColors<8> trackColors;
     
     ObserfourScopeDisplay() {
         box.size = Vec(120, 300);
     }
     
-    void drawWave(const DrawArgs& args, int inputIndex, int displayTrack, NVGcolor color) {
-        if (!module) return;
-        
+    void drawWave(const DrawArgs& args, const Obserfour::Frame& frame, int inputIndex, int displayTrack, NVGcolor color) {
         nvgSave(args.vg);
         
         float trackHeight = box.size.y / 4.0f;
@@ -206,29 +188,7 @@ struct ObserfourScopeDisplay : LedDisplay {
         
         Rect b = Rect(Vec(0, trackY), Vec(box.size.x, trackHeight));
         nvgScissor(args.vg, RECT_ARGS(b));
-        nvgBeginPath(args.vg);
-        
-        for (int i = 0; i < Obserfour::SCOPE_BUFFER_SIZE; i++) {
-            const Obserfour::ScopePoint& point = module->scopeBuffer[inputIndex][i];
-            float max = point.max;
-            if (!std::isfinite(max))
-                max = 0.f;
-
-            Vec p;
-            p.x = (float)i / (Obserfour::SCOPE_BUFFER_SIZE - 1);
-            p.y = (max) * -0.05f + 0.5f;
-            p = b.interpolate(p);
-            
-            if (i == 0)
-                nvgMoveTo(args.vg, p.x, p.y);
-            else
-                nvgLineTo(args.vg, p.x, p.y);
-        }
-        
-        nvgStrokeColor(args.vg, color);
-        nvgStrokeWidth(args.vg, 1.5f);
-        nvgLineCap(args.vg, NVG_ROUND);
-        nvgStroke(args.vg);
+        madzine::widgets::drawScopeEnvelope(args.vg, frame, inputIndex, b, color, 0.5f, 0.05f);
         nvgResetScissor(args.vg);
         nvgRestore(args.vg);
     }
@@ -272,25 +232,36 @@ struct ObserfourScopeDisplay : LedDisplay {
         nvgStroke(args.vg);
     }
     
-    void drawLayer(const DrawArgs& args, int layer) override {
-        if (layer != 1) return;
-        
+    void step() override {
+        if (module && moduleWidget) {
+            bool dirty = module->scope.poll();
+
+            for (int i = 0; i < 8; i++) {
+                PortWidget* inputPort = moduleWidget->getInput(Obserfour::TRACK1_INPUT + i);
+                CableWidget* cable = APP->scene->rack->getTopCable(inputPort);
+                NVGcolor trackColor = cable ? cable->color : nvgRGB(255, 255, 255);
+                dirty |= trackColors.set(i, trackColor);
+            }
+
+            if (dirty)
+                madzine::widgets::markScopeDirty(this);
+        }
+        Widget::step();
+    }
+
+    void draw(const DrawArgs& args) override {
         drawBackground(args);
         
         if (!module || !moduleWidget) return;
+
+        const Obserfour::Frame& frame = module->scope.frame();
         
         for (int i = 0; i < 4; i++) {
             // Draw first input of each track pair
-            PortWidget* inputPort1 = moduleWidget->getInput(Obserfour::TRACK1_INPUT + i);
-            CableWidget* cable1 = APP->scene->rack->getTopCable(inputPort1);
-            NVGcolor trackColor1 = cable1 ? cable1->color : nvgRGB(255, 255, 255);
-            drawWave(args, i, i, trackColor1);
+            drawWave(args, frame, i, i, trackColors.colors[i]);
             
             // Draw second input of each track pair (inputs 5-8) on same display track
-            PortWidget* inputPort2 = moduleWidget->getInput(Obserfour::TRACK5_INPUT + i);
-            CableWidget* cable2 = APP->scene->rack->getTopCable(inputPort2);
-            NVGcolor trackColor2 = cable2 ? cable2->color : nvgRGB(255, 255, 255);
-            drawWave(args, i + 4, i, trackColor2);
+            drawWave(args, frame, i + 4, i, trackColors.colors[i + 4]);
         }
     }
 };
@@ -356,7 +327,7 @@ struct ObserfourWidget : ModuleWidget {
         scopeDisplay->box.size = Vec(120, 300);
         scopeDisplay->module = module;
         scopeDisplay->moduleWidget = this;
-        addChild(scopeDisplay);
+        addChild(madzine::widgets::createScopeFramebuffer(scopeDisplay));
         
         addParam(createParam<madzine::widgets::HiddenTimeKnobObserver>(Vec(0, 30), module, Obserfour::TIME_PARAM));
         
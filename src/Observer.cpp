@@ -1,6 +1,7 @@
 #include "plugin.hpp"
 #include "widgets/Knobs.hpp"
 #include "widgets/PanelTheme.hpp"
+#include "widgets/ScopeCapture.hpp"
 
 struct Observer : Module {
     int panelTheme = madzineDefaultTheme;
@@ -30,18 +31,12 @@ struct Observer : Module {
         NUM_LIGHTS
     };
 
-    struct ScopePoint {
-        float min = INFINITY;
-        float max = -INFINITY;
-    };
-
     static constexpr int SCOPE_BUFFER_SIZE = 256; // Same as VCV Scope
-    
-    ScopePoint scopeBuffer[8][SCOPE_BUFFER_SIZE];
-    ScopePoint currentPoint[8];
-    int bufferIndex = 0;
-    int frameIndex = 0;
-    
+
+    // 所有複音聲部的每欄 min/max，三重緩衝發佈給 Widget
+    using Frame = madzine::widgets::ScopeFrame<8, SCOPE_BUFFER_SIZE>;
+    madzine::widgets::ScopeCapture<8, SCOPE_BUFFER_SIZE> scope;
+
     dsp::SchmittTrigger triggers[16];
 
     Observer() {
@@ -91,7 +86,7 @@ struct Observer : Module {
         lights[TRIG_LIGHT].setBrightness(trig);
 
         // Detect trigger if no longer recording (100% copy from VCV Scope)
-        if (bufferIndex >= SCOPE_BUFFER_SIZE) {
+        if (!scope.isRecording()) {
             bool triggered = false;
 
             // Trigger immediately if trigger detection is disabled
@@ -118,36 +113,22 @@ struct Observer : Module {
                 for (int c = 0; c < 16; c++) {
                     triggers[c].reset();
                 }
-                bufferIndex = 0;
-                frameIndex = 0;
+                scope.start();
             }
         }
 
         // Add point to buffer if recording (100% copy from VCV Scope logic)
-        if (bufferIndex < SCOPE_BUFFER_SIZE) {
+        if (scope.isRecording()) {
             // Compute time
             float deltaTime = dsp::exp2_taylor5(-params[TIME_PARAM].getValue()) / SCOPE_BUFFER_SIZE;
             int frameCount = (int) std::ceil(deltaTime * args.sampleRate);
 
-            // Get input
+            // Get input (all polyphonic channels)
             for (int i = 0; i < 8; i++) {
-                float x = inputs[TRACK1_INPUT + i].getVoltage();
-                currentPoint[i].min = std::min(currentPoint[i].min, x);
-                currentPoint[i].max = std::max(currentPoint[i].max, x);
+                scope.addPort(i, inputs[TRACK1_INPUT + i]);
             }
 
-            if (++frameIndex >= frameCount) {
-                frameIndex = 0;
-                // Push current point
-                for (int i = 0; i < 8; i++) {
-                    scopeBuffer[i][bufferIndex] = currentPoint[i];
-                }
-                // Reset current point
-                for (int i = 0; i < 8; i++) {
-                    currentPoint[i] = ScopePoint();
-                }
-                bufferIndex++;
-            }
+            scope.step(frameCount, args.sampleRate);
         }
     }
 };
@@ -198,48 +179,26 @@ struct WhiteBackgroundBox : Widget {
     }
 };
 
-struct ObserverScopeDisplay : LedDisplay {
+// 波形畫在 ScopeFramebuffer 內，只有新幀或接線顏色改變時才重畫
+struct ObserverScopeDisplay : Widget {
     Observer* module;
     ModuleWidget* moduleWidget;
+    madzine::widgets::ScopeTrackColors<8> trackColors;
     
     ObserverScopeDisplay() {
         box.size = Vec(120, 300); // 8HP width, adjusted height for 8 tracks
     }
     
-    void drawWave(const DrawArgs& args, int track, NVGcolor color) {
-        if (!module) return;
-        
+    void drawWave(const DrawArgs& args, const Observer::Frame& frame, int track, NVGcolor color) {
         nvgSave(args.vg);
-        
+
         // Calculate track area (12.5% height each for 8 tracks)
         float trackHeight = box.size.y / 8.0f;
         float trackY = track * trackHeight;
-        
+
         Rect b = Rect(Vec(0, trackY), Vec(box.size.x, trackHeight));
         nvgScissor(args.vg, RECT_ARGS(b));
-        nvgBeginPath(args.vg);
-        
-        for (int i = 0; i < Observer::SCOPE_BUFFER_SIZE; i++) {
-            const Observer::ScopePoint& point = module->scopeBuffer[track][i];
-            float max = point.max;
-            if (!std::isfinite(max))
-                max = 0.f;
-
-            Vec p;
-            p.x = (float)i / (Observer::SCOPE_BUFFER_SIZE - 1);
-            p.y = (max) * -0.05f + 0.5f; // Scale for ±10V range
-            p = b.interpolate(p);
-            
-            if (i == 0)
-                nvgMoveTo(args.vg, p.x, p.y);
-            else
-                nvgLineTo(args.vg, p.x, p.y);
-        }
-        
-        nvgStrokeColor(args.vg, color);
-        nvgStrokeWidth(args.vg, 1.5f);
-        nvgLineCap(args.vg, NVG_ROUND);
-        nvgStroke(args.vg);
+        madzine::widgets::drawScopeEnvelope(args.vg, frame, track, b, color, 0.5f, 0.05f); // Scale for ±10V range
         nvgResetScissor(args.vg);
         nvgRestore(args.vg);
     }
@@ -288,20 +247,32 @@ struct ObserverScopeDisplay : LedDisplay {
         nvgStroke(args.vg);
     }
     
-    void drawLayer(const DrawArgs& args, int layer) override {
-        if (layer != 1) return;
-        
+    void step() override {
+        if (module && moduleWidget) {
+            bool dirty = module->scope.poll();
+
+            // Get input colors from cable connections, with white as default
+            for (int i = 0; i < 8; i++) {
+                PortWidget* inputPort = moduleWidget->getInput(Observer::TRACK1_INPUT + i);
+                CableWidget* cable = APP->scene->rack->getTopCable(inputPort);
+                NVGcolor trackColor = cable ? cable->color : nvgRGB(255, 255, 255); // White when no cable
+                dirty |= trackColors.set(i, trackColor);
+            }
+
+            if (dirty)
+                madzine::widgets::markScopeDirty(this);
+        }
+        Widget::step();
+    }
+
+    void draw(const DrawArgs& args) override {
         drawBackground(args);
         
         if (!module || !moduleWidget) return;
-        
-        // Get input colors from cable connections, with white as default
+
+        const Observer::Frame& frame = module->scope.frame();
         for (int i = 0; i < 8; i++) {
-            PortWidget* inputPort = moduleWidget->getInput(Observer::TRACK1_INPUT + i);
-            CableWidget* cable = APP->scene->rack->getTopCable(inputPort);
-            NVGcolor trackColor = cable ? cable->color : nvgRGB(255, 255, 255); // White when no cable
-            
-            drawWave(args, i, trackColor);
+            drawWave(args, frame, i, trackColors.colors[i]);
         }
     }
 };
@@ -369,7 +340,7 @@ struct ObserverWidget : ModuleWidget {
         scopeDisplay->box.size = Vec(120, 300); // Adjusted height
         scopeDisplay->module = module;
         scopeDisplay->moduleWidget = this;
-        addChild(scopeDisplay);
+        addChild(madzine::widgets::createScopeFramebuffer(scopeDisplay));
         
         // Hidden time control knob (overlapping entire scope display)
         addParam(createParam<madzine::widgets::HiddenTimeKnobObserver>(Vec(0, 30), module, Observer::TIME_PARAM));
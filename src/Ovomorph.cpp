@@ -1,5 +1,6 @@
 #include "plugin.hpp"
 #include "widgets/Knobs.hpp"
+#include "widgets/CVModulation.hpp"
 #include "widgets/PanelTheme.hpp"
 #include "RipleyDSP.hpp"
 
@@ -158,12 +159,16 @@ struct Ovomorph : Module {
     float shPhase[MAX_POLY] = {};
 
     // CV 調變顯示
-    float roomCvMod = 0.0f;
-    float toneCvMod = 0.0f;
-    float decayCvMod = 0.0f;
-    float mixCvMod = 0.0f;
-    float chaosCvMod = 0.0f;
-    float rateCvMod = 0.0f;
+    enum CvModId {
+        CVMOD_ROOM,
+        CVMOD_TONE,
+        CVMOD_DECAY,
+        CVMOD_MIX,
+        CVMOD_CHAOS,
+        CVMOD_RATE,
+        NUM_CVMODS
+    };
+    madzine::widgets::CVModBank<NUM_CVMODS> cvMods;
 
     Ovomorph() {
         config(NUM_PARAMS, NUM_INPUTS, NUM_OUTPUTS, NUM_LIGHTS);
@@ -237,9 +242,9 @@ struct Ovomorph : Module {
             if (inputs[CHAOS_CV_INPUT].isConnected()) {
                 float cv = inputs[CHAOS_CV_INPUT].getPolyVoltage(c < inputs[CHAOS_CV_INPUT].getChannels() ? c : 0);
                 chaosAmount += cv * 0.1f;
-                if (c == 0) chaosCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+                if (c == 0) cvMods.publish(CVMOD_CHAOS, clamp(cv / 10.0f, -1.0f, 1.0f));
             } else if (c == 0) {
-                chaosCvMod = 0.0f;
+                cvMods.clear(CVMOD_CHAOS);
             }
             chaosAmount = clamp(chaosAmount, 0.0f, 1.0f);
 
@@ -248,9 +253,9 @@ struct Ovomorph : Module {
             if (inputs[RATE_CV_INPUT].isConnected()) {
                 float cv = inputs[RATE_CV_INPUT].getPolyVoltage(c < inputs[RATE_CV_INPUT].getChannels() ? c : 0);
                 chaosRate += cv * 0.2f;
-                if (c == 0) rateCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+                if (c == 0) cvMods.publish(CVMOD_RATE, clamp(cv / 10.0f, -1.0f, 1.0f));
             } else if (c == 0) {
-                rateCvMod = 0.0f;
+                cvMods.clear(CVMOD_RATE);
             }
             chaosRate = clamp(chaosRate, 0.01f, 2.0f);
 
@@ -291,9 +296,9 @@ struct Ovomorph : Module {
             if (inputs[ROOM_CV_INPUT].isConnected()) {
                 float cv = inputs[ROOM_CV_INPUT].getPolyVoltage(c < inputs[ROOM_CV_INPUT].getChannels() ? c : 0);
                 roomSize += cv * 0.1f;
-                if (c == 0) roomCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+                if (c == 0) cvMods.publish(CVMOD_ROOM, clamp(cv / 10.0f, -1.0f, 1.0f));
             } else if (c == 0) {
-                roomCvMod = 0.0f;
+                cvMods.clear(CVMOD_ROOM);
             }
             roomSize = clamp(roomSize, 0.0f, 1.0f);
 
@@ -302,9 +307,9 @@ struct Ovomorph : Module {
             if (inputs[TONE_CV_INPUT].isConnected()) {
                 float cv = inputs[TONE_CV_INPUT].getPolyVoltage(c < inputs[TONE_CV_INPUT].getChannels() ? c : 0);
                 damping += cv * 0.1f;
-                if (c == 0) toneCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+                if (c == 0) cvMods.publish(CVMOD_TONE, clamp(cv / 10.0f, -1.0f, 1.0f));
             } else if (c == 0) {
-                toneCvMod = 0.0f;
+                cvMods.clear(CVMOD_TONE);
             }
             damping = clamp(damping, 0.0f, 1.0f);
 
@@ -313,9 +318,9 @@ struct Ovomorph : Module {
             if (inputs[DECAY_CV_INPUT].isConnected()) {
                 float cv = inputs[DECAY_CV_INPUT].getPolyVoltage(c < inputs[DECAY_CV_INPUT].getChannels() ? c : 0);
                 decay += cv * 0.1f;
-                if (c == 0) decayCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+                if (c == 0) cvMods.publish(CVMOD_DECAY, clamp(cv / 10.0f, -1.0f, 1.0f));
             } else if (c == 0) {
-                decayCvMod = 0.0f;
+                cvMods.clear(CVMOD_DECAY);
             }
             decay = clamp(decay, 0.0f, 1.0f);
 
@@ -335,9 +340,9 @@ struct Ovomorph : Module {
             if (inputs[MIX_CV_INPUT].isConnected()) {
                 float cv = inputs[MIX_CV_INPUT].getPolyVoltage(c < inputs[MIX_CV_INPUT].getChannels() ? c : 0);
                 mix += cv * 0.1f;
-                if (c == 0) mixCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+                if (c == 0) cvMods.publish(CVMOD_MIX, clamp(cv / 10.0f, -1.0f, 1.0f));
             } else if (c == 0) {
-                mixCvMod = 0.0f;
+                cvMods.clear(CVMOD_MIX);
             }
             mix = clamp(mix, 0.0f, 1.0f);
 
@@ -381,6 +386,7 @@ struct OvomorphWidget : ModuleWidget {
     StandardBlackKnob26* mixKnob = nullptr;
     StandardBlackKnob26* chaosKnob = nullptr;
     StandardBlackKnob26* rateKnob = nullptr;
+    madzine::widgets::CVModRingSync<Ovomorph::NUM_CVMODS> cvModSync;
 
     // 自動配線追蹤
     int64_t autoSendLeftCableId = -1;
@@ -434,6 +440,13 @@ struct OvomorphWidget : ModuleWidget {
         rateKnob = createParamCentered<StandardBlackKnob26>(Vec(rightX, 162), module, Ovomorph::RATE_PARAM);
         addParam(rateKnob);
 
+        cvModSync.bind(Ovomorph::CVMOD_ROOM, roomKnob);
+        cvModSync.bind(Ovomorph::CVMOD_TONE, toneKnob);
+        cvModSync.bind(Ovomorph::CVMOD_DECAY, decayKnob);
+        cvModSync.bind(Ovomorph::CVMOD_MIX, mixKnob);
+        cvModSync.bind(Ovomorph::CVMOD_CHAOS, chaosKnob);
+        cvModSync.bind(Ovomorph::CVMOD_RATE, rateKnob);
+
         // CV Row 1 (Y=197, 標籤 Y=173)
         addChild(new OvomorphParamLabel(Vec(0, 173), Vec(30, 15), "ROOM"));
         addInput(createInputCentered<PJ301MPort>(Vec(leftX, 197), module, Ovomorph::ROOM_CV_INPUT));
@@ -479,36 +492,8 @@ struct OvomorphWidget : ModuleWidget {
         if (module) {
             panelThemeHelper.step(module);
 
-            if (decayKnob) {
-                bool connected = module->inputs[Ovomorph::DECAY_CV_INPUT].isConnected();
-                decayKnob->setModulationEnabled(connected);
-                if (connected) decayKnob->setModulation(module->decayCvMod);
-            }
-            if (roomKnob) {
-                bool connected = module->inputs[Ovomorph::ROOM_CV_INPUT].isConnected();
-                roomKnob->setModulationEnabled(connected);
-                if (connected) roomKnob->setModulation(module->roomCvMod);
-            }
-            if (toneKnob) {
-                bool connected = module->inputs[Ovomorph::TONE_CV_INPUT].isConnected();
-                toneKnob->setModulationEnabled(connected);
-                if (connected) toneKnob->setModulation(module->toneCvMod);
-            }
-            if (mixKnob) {
-                bool connected = module->inputs[Ovomorph::MIX_CV_INPUT].isConnected();
-                mixKnob->setModulationEnabled(connected);
-                if (connected) mixKnob->setModulation(module->mixCvMod);
-            }
-            if (chaosKnob) {
-                bool connected = module->inputs[Ovomorph::CHAOS_CV_INPUT].isConnected();
-                chaosKnob->setModulationEnabled(connected);
-                if (connected) chaosKnob->setModulation(module->chaosCvMod);
-            }
-            if (rateKnob) {
-                bool connected = module->inputs[Ovomorph::RATE_CV_INPUT].isConnected();
-                rateKnob->setModulationEnabled(connected);
-                if (connected) rateKnob->setModulation(module->rateCvMod);
-            }
+            // 更新 CV 調變顯示（僅在數值變化時）
+            cvModSync.sync(module->cvMods);
 
             // 自動配線到 YAMANOTE Send/Return
             Module* leftModule = module->leftExpander.module;
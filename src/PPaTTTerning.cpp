@@ -26,6 +26,74 @@ struct DensityParamQuantity : ParamQuantity {
         return string::f("%d knobs, %d steps", primaryKnobs, steps);
     }
 };
+
+/**
+ * 階梯 CV 延遲線：只記錄數值改變的時間點（事件），而非逐樣本存值
+ * 時間以樣本計數（uint32 相減可跨越溢位），延遲長度在任何取樣率下都精確，
+ * 記憶體只和一秒內的變化次數有關。
+ */
+struct SteppedDelayLine {
+    static constexpr int CAPACITY = 4096;  // 一秒內最多保留的變化點
+    static constexpr int MASK = CAPACITY - 1;
+
+    struct Event {
+        uint32_t time;
+        float value;
+    };
+
+    Event events[CAPACITY];
+    int head = 0;              // 最舊事件
+    int count = 0;
+    float floorValue = 0.0f;   // 最舊事件之前的數值
+    float lastValue = 0.0f;
+    uint32_t now = 0;
+
+    void clear() {
+        head = 0;
+        count = 0;
+        floorValue = 0.0f;
+        lastValue = 0.0f;
+    }
+
+    /**
+     * 每個樣本呼叫一次：記錄目前數值並推進時間
+     * @param maxDelaySamples 最長延遲，比它更舊的事件併入 floorValue
+     */
+    void push(float value, uint32_t maxDelaySamples) {
+        now++;
+        while (count > 0 && (now - events[head].time > maxDelaySamples || count == CAPACITY)) {
+            dropOldest();
+        }
+        if (value != lastValue) {
+            events[(head + count) & MASK] = {now, value};
+            count++;
+            lastValue = value;
+        }
+    }
+
+    /**
+     * 讀取 delaySamples 個樣本之前的數值
+     */
+    float read(uint32_t delaySamples) const {
+        // 找最後一個 now - time >= delaySamples 的事件（事件時間遞增，二分搜尋）
+        int lo = 0, hi = count;
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (now - events[(head + mid) & MASK].time >= delaySamples)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        return (lo == 0) ? floorValue : events[(head + lo - 1) & MASK].value;
+    }
+
+private:
+    void dropOldest() {
+        floorValue = events[head].value;
+        head = (head + 1) & MASK;
+        count--;
+    }
+};
 } // namespace
 
 struct PPaTTTerning : Module {
@@ -74,10 +142,8 @@ struct PPaTTTerning : Module {
     float cvHistory[MAX_DELAY];
     int historyIndex = 0, track2Delay = 1;
     
-    static const int CVD_BUFFER_SIZE = 192000;
-    float cvdBuffer[CVD_BUFFER_SIZE];
-    int cvdWriteIndex = 0;
-    float sampleRate = 44100.0f;
+    static constexpr float CVD_MAX_MS = 1000.0f;
+    SteppedDelayLine cvdLine;
     float previousCVDOutput = -999.0f;
     
     PPaTTTerning() {
@@ -123,14 +189,9 @@ struct PPaTTTerning : Module {
         updateOutputDescriptions();
         
         for (int i = 0; i < MAX_DELAY; i++) cvHistory[i] = 0.0f;
-        for (int i = 0; i < CVD_BUFFER_SIZE; i++) cvdBuffer[i] = 0.0f;
         generateMapping();
     }
     
-    void onSampleRateChange() override {
-        sampleRate = APP->engine->getSampleRate();
-    }
-    
     void updateOutputDescriptions() {
         configOutput(CV2_OUTPUT, string::f("CV2 (Delay %d + CVD)", track2Delay));
         configOutput(TRIG2_OUTPUT, string::f("Trigger 2 (Delay %d + CVD)", track2Delay));
@@ -289,9 +350,8 @@ struct PPaTTTerning : Module {
             previousVoltage = -999.0f;
             previousCVDOutput = -999.0f;
             for (int i = 0; i < MAX_DELAY; i++) cvHistory[i] = 0.0f;
-            for (int i = 0; i < CVD_BUFFER_SIZE; i++) cvdBuffer[i] = 0.0f;
+            cvdLine.clear();
             historyIndex = 0;
-            cvdWriteIndex = 0;
         }
         
         if (styleTrigger.process(params[STYLE_PARAM].getValue())) {
@@ -348,25 +408,21 @@ struct PPaTTTerning : Module {
         float knobValue = params[CVD_ATTEN_PARAM].getValue();
         
         if (!inputs[CVD_CV_INPUT].isConnected()) {
-            delayTimeMs = knobValue * 1000.0f;
+            delayTimeMs = knobValue * CVD_MAX_MS;
         } else {
             float cvdCV = clamp(inputs[CVD_CV_INPUT].getVoltage(), 0.0f, 10.0f);
-            delayTimeMs = (cvdCV / 10.0f) * knobValue * 1000.0f;
+            delayTimeMs = (cvdCV / 10.0f) * knobValue * CVD_MAX_MS;
         }
         
+        // 延遲線持續記錄變化點，延遲時間改變時立即讀到正確位置
+        uint32_t maxDelaySamples = (uint32_t)(CVD_MAX_MS * args.sampleRate / 1000.0f);
+        cvdLine.push(shiftRegisterCV, maxDelaySamples);
+        
         if (delayTimeMs <= 0.001f) {
             outputs[CV2_OUTPUT].setVoltage(shiftRegisterCV);
         } else {
-            cvdBuffer[cvdWriteIndex] = shiftRegisterCV;
-            cvdWriteIndex = (cvdWriteIndex + 1) % CVD_BUFFER_SIZE;
-            
-            int delaySamples = (int)(delayTimeMs * sampleRate / 1000.0f);
-            delaySamples = clamp(delaySamples, 0, CVD_BUFFER_SIZE - 1);
-            
-            int readIndex = (cvdWriteIndex - delaySamples + CVD_BUFFER_SIZE) % CVD_BUFFER_SIZE;
-            float delayedCV = cvdBuffer[readIndex];
-            
-            outputs[CV2_OUTPUT].setVoltage(delayedCV);
+            uint32_t delaySamples = std::min((uint32_t)(delayTimeMs * args.sampleRate / 1000.0f), maxDelaySamples);
+            outputs[CV2_OUTPUT].setVoltage(cvdLine.read(delaySamples));
         }
         
         // CVD trigger logic: trigger when delayed CV changes
@@ -1,5 +1,6 @@
 #include "plugin.hpp"
 #include "widgets/Knobs.hpp"
+#include "widgets/CVModulation.hpp"
 #include "widgets/PanelTheme.hpp"
 #include <cmath>
 #include <algorithm>
@@ -502,9 +503,13 @@ public:
     bool muteState = false;
 
     // CV 調變顯示用
-    float freqCvMod = 0.0f;
-    float resonanceCvMod = 0.0f;
-    float fmAmountCvMod = 0.0f;
+    enum CvModId {
+        CVMOD_FREQ,
+        CVMOD_RESONANCE,
+        CVMOD_FM_AMOUNT,
+        NUM_CVMODS
+    };
+    madzine::widgets::CVModBank<NUM_CVMODS> cvMods;
     
     Pinpple() {
         config(PARAMS_LEN, INPUTS_LEN, OUTPUTS_LEN, LIGHTS_LEN);
@@ -554,9 +559,9 @@ public:
         if (inputs[FREQ_CV_INPUT].isConnected()) {
             float freqCVAttenuation = params[FREQ_CV_ATTEN_PARAM].getValue();
             freqCV = inputs[FREQ_CV_INPUT].getVoltage() * freqCVAttenuation;
-            freqCvMod = clamp(freqCV / 10.0f, -1.0f, 1.0f);
+            cvMods.publish(CVMOD_FREQ, clamp(freqCV / 10.0f, -1.0f, 1.0f));
         } else {
-            freqCvMod = 0.0f;
+            cvMods.clear(CVMOD_FREQ);
         }
         float finalFreq = clamp(freqParam + freqCV * 0.1f + randomMod.freqOffset, 0.0f, 1.0f);
         
@@ -565,9 +570,9 @@ public:
         if (inputs[RESONANCE_CV_INPUT].isConnected()) {
             float resonanceCVAttenuation = params[RESONANCE_CV_ATTEN_PARAM].getValue();
             resonanceCV = inputs[RESONANCE_CV_INPUT].getVoltage() / 10.0f * resonanceCVAttenuation;
-            resonanceCvMod = clamp(inputs[RESONANCE_CV_INPUT].getVoltage() * resonanceCVAttenuation / 10.0f, -1.0f, 1.0f);
+            cvMods.publish(CVMOD_RESONANCE, clamp(inputs[RESONANCE_CV_INPUT].getVoltage() * resonanceCVAttenuation / 10.0f, -1.0f, 1.0f));
         } else {
-            resonanceCvMod = 0.0f;
+            cvMods.clear(CVMOD_RESONANCE);
         }
         float finalResonance = clamp(resonanceParam + resonanceCV + randomMod.decayOffset, 0.0f, 1.0f);
         
@@ -577,9 +582,9 @@ public:
         if (inputs[FM_MOD_CV_INPUT].isConnected()) {
             float fmModCVAttenuation = params[FM_MOD_CV_ATTEN_PARAM].getValue();
             fmModCV = inputs[FM_MOD_CV_INPUT].getVoltage() / 10.0f * fmModCVAttenuation;
-            fmAmountCvMod = clamp(inputs[FM_MOD_CV_INPUT].getVoltage() * fmModCVAttenuation / 10.0f, -1.0f, 1.0f);
+            cvMods.publish(CVMOD_FM_AMOUNT, clamp(inputs[FM_MOD_CV_INPUT].getVoltage() * fmModCVAttenuation / 10.0f, -1.0f, 1.0f));
         } else {
-            fmAmountCvMod = 0.0f;
+            cvMods.clear(CVMOD_FM_AMOUNT);
         }
         
         float dynamicFMAmount = clamp(fmAmountParam + fmModCV, 0.0f, 1.0f);
@@ -760,6 +765,7 @@ struct PinppleWidget : ModuleWidget {
     PinppleRandomizedKnob* freqKnob = nullptr;
     PinppleRandomizedKnob* resonanceKnob = nullptr;
     PinppleRandomizedKnob* fmAmountKnob = nullptr;
+    madzine::widgets::CVModRingSync<Pinpple::NUM_CVMODS> cvModSync;
 
     PinppleWidget(Pinpple* module) {
         setModule(module);
@@ -793,6 +799,11 @@ addInput(createInputCentered<PJ301MPort>(Vec(centerX + 15, 179), module, Pinpple
         addChild(new EnhancedTextLabel(Vec(0, 194), Vec(box.size.x, 20), "FM AMT", 8.f, nvgRGB(255, 255, 255), true));
         fmAmountKnob = createParamCentered<PinppleRandomizedKnob>(Vec(centerX, 226), module, Pinpple::FM_AMOUNT_PARAM);
         addParam(fmAmountKnob);
+
+        cvModSync.bind(Pinpple::CVMOD_FREQ, freqKnob);
+        cvModSync.bind(Pinpple::CVMOD_RESONANCE, resonanceKnob);
+        cvModSync.bind(Pinpple::CVMOD_FM_AMOUNT, fmAmountKnob);
+
         
       
         addInput(createInputCentered<PJ301MPort>(Vec(centerX + 15, 265), module, Pinpple::FM_INPUT));
@@ -850,18 +861,8 @@ addInput(createInputCentered<PJ301MPort>(Vec(centerX + 15, 179), module, Pinpple
         if (module) {
             panelThemeHelper.step(module);
 
-            // 更新 CV 調變顯示
-            auto updateKnob = [&](PinppleRandomizedKnob* knob, int inputId, float cvMod) {
-                if (knob) {
-                    bool connected = module->inputs[inputId].isConnected();
-                    knob->setModulationEnabled(connected);
-                    if (connected) knob->setModulation(cvMod);
-                }
-            };
-
-            updateKnob(freqKnob, Pinpple::FREQ_CV_INPUT, module->freqCvMod);
-            updateKnob(resonanceKnob, Pinpple::RESONANCE_CV_INPUT, module->resonanceCvMod);
-            updateKnob(fmAmountKnob, Pinpple::FM_MOD_CV_INPUT, module->fmAmountCvMod);
+            // 更新 CV 調變顯示（僅在數值變化時）
+            cvModSync.sync(module->cvMods);
         }
         ModuleWidget::step();
     }
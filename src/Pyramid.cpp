@@ -1,5 +1,7 @@
 #include "plugin.hpp"
+#include "PyramidDSP.hpp"
 #include "widgets/Knobs.hpp"
+#include "widgets/CVModulation.hpp"
 #include "widgets/PanelTheme.hpp"
 
 struct Pyramid : Module {
@@ -41,9 +43,7 @@ struct Pyramid : Module {
         LIGHTS_LEN
     };
 
-    struct SpeakerPosition {
-        float x, y, z;
-    };
+    using SpeakerPosition = PyramidSpeakerPosition;
 
     SpeakerPosition speakers[8] = {
         {-1.0f, -1.0f,  1.0f},  // FL Upper (was BL Upper)
@@ -56,22 +56,30 @@ struct Pyramid : Module {
         { 1.0f,  1.0f, -1.0f}   // BR Lower (was FR Lower)
     };
 
-    dsp::TBiquadFilter<> filter1;
-    dsp::TBiquadFilter<> filter2;
+    PyramidCascadeBiquad<float> filter;
+    PyramidFilterCoeffCache filterCache;
 
     // CV 調變顯示用
-    float xCvMod = 0.0f;
-    float yCvMod = 0.0f;
-    float zCvMod = 0.0f;
-    float filterCvMod = 0.0f;
+    enum CvModId {
+        CVMOD_X,
+        CVMOD_Y,
+        CVMOD_Z,
+        CVMOD_FILTER,
+        NUM_CVMODS
+    };
+    madzine::widgets::CVModBank<NUM_CVMODS> cvMods;
+
+    // 位置、VBAP 增益與濾波係數以控制率更新，音訊率做線性插值
+    static constexpr int CONTROL_DIVISION = 16;
+    dsp::ClockDivider controlDivider;
+    VBAPGainRamp vbapRamp;
 
     bool sendPreLevel = false;
-    int lastFilterMode = 0;
-    float lastFilterValue = 0.f;
     float smoothedFilter = 0.f;
 
     Pyramid() {
         config(PARAMS_LEN, INPUTS_LEN, OUTPUTS_LEN, LIGHTS_LEN);
+        controlDivider.setDivision(CONTROL_DIVISION);
         
         configParam(X_PARAM, -1.f, 1.f, 0.f, "X Position", "", 0.f, 1.f);
         configParam(Y_PARAM, -1.f, 1.f, 0.f, "Y Position", "", 0.f, 1.f);
@@ -122,107 +130,77 @@ struct Pyramid : Module {
         }
     }
 
-    float distance3D(float x1, float y1, float z1, float x2, float y2, float z2) {
-        float dx = x2 - x1;
-        float dy = y2 - y1;
-        float dz = z2 - z1;
-        return std::sqrt(dx*dx + dy*dy + dz*dz);
-    }
-
-    void calculateVBAP(float sourceX, float sourceY, float sourceZ, float gains[8]) {
-        for (int i = 0; i < 8; i++) {
-            float distance = distance3D(sourceX, sourceY, sourceZ, 
-                                      speakers[i].x, speakers[i].y, speakers[i].z);
-            
-            distance = std::max(distance, 0.001f);
-            
-            float gain = 1.0f / (1.0f + distance + distance * distance * 2.0f);
-            
-            float fadeOut = 1.0f;
-            
-            if (sourceX <= -0.8f && speakers[i].x > 0) {
-                fadeOut *= std::max(0.0f, (sourceX + 1.0f) / 0.2f);
-            }
-            if (sourceX >= 0.8f && speakers[i].x < 0) {
-                fadeOut *= std::max(0.0f, (1.0f - sourceX) / 0.2f);
-            }
-            
-            if (sourceY <= -0.8f && speakers[i].y > 0) {
-                fadeOut *= std::max(0.0f, (sourceY + 1.0f) / 0.2f);
-            }
-            if (sourceY >= 0.8f && speakers[i].y < 0) {
-                fadeOut *= std::max(0.0f, (1.0f - sourceY) / 0.2f);
-            }
-            
-            if (sourceZ <= -0.8f && speakers[i].z > 0) {
-                fadeOut *= std::max(0.0f, (sourceZ + 1.0f) / 0.2f);
-            }
-            if (sourceZ >= 0.8f && speakers[i].z < 0) {
-                fadeOut *= std::max(0.0f, (1.0f - sourceZ) / 0.2f);
-            }
-            
-            gains[i] = gain * fadeOut;
-        }
-        
-        float totalGain = 0.0f;
-        for (int i = 0; i < 8; i++) {
-            totalGain += gains[i] * gains[i];
-        }
-        
-        if (totalGain > 0.0f) {
-            float normalizeFactor = 1.0f / std::sqrt(totalGain);
-            for (int i = 0; i < 8; i++) {
-                gains[i] *= normalizeFactor;
-            }
-        }
-    }
-
-    void process(const ProcessArgs& args) override {
-        float audioIn = inputs[AUDIO_INPUT].getVoltage();
-        
+    /**
+     * 控制率：讀取位置參數與 CV，位置改變時重新計算 VBAP 目標增益
+     */
+    void updatePosition() {
         float x = params[X_PARAM].getValue();
         float y = params[Y_PARAM].getValue();
         float z = params[Z_PARAM].getValue();
-        float level = params[LEVEL_PARAM].getValue();
-        float filter = params[FILTER_PARAM].getValue();
-        float send = params[SEND_PARAM].getValue();
         
         if (inputs[X_CV_INPUT].isConnected()) {
             float cv = inputs[X_CV_INPUT].getVoltage();
             x += cv * 0.2f;
             x = clamp(x, -1.f, 1.f);
-            xCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+            cvMods.publish(CVMOD_X, clamp(cv / 10.0f, -1.0f, 1.0f));
         } else {
-            xCvMod = 0.0f;
+            cvMods.clear(CVMOD_X);
         }
         if (inputs[Y_CV_INPUT].isConnected()) {
             float cv = inputs[Y_CV_INPUT].getVoltage();
             y += cv * 0.2f;
             y = clamp(y, -1.f, 1.f);
-            yCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+            cvMods.publish(CVMOD_Y, clamp(cv / 10.0f, -1.0f, 1.0f));
         } else {
-            yCvMod = 0.0f;
+            cvMods.clear(CVMOD_Y);
         }
         if (inputs[Z_CV_INPUT].isConnected()) {
             float cv = inputs[Z_CV_INPUT].getVoltage();
             z += cv * 0.2f;
             z = clamp(z, -1.f, 1.f);
-            zCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+            cvMods.publish(CVMOD_Z, clamp(cv / 10.0f, -1.0f, 1.0f));
         } else {
-            zCvMod = 0.0f;
+            cvMods.clear(CVMOD_Z);
         }
 
+        vbapRamp.update(speakers, x, y, z, CONTROL_DIVISION);
+    }
+
+    /**
+     * 控制率：讀取濾波旋鈕與 CV，平滑後更新係數（量化值未變時沿用快取）
+     */
+    void updateFilter(float sampleRate) {
+        float value = params[FILTER_PARAM].getValue();
+
         if (inputs[FILTER_CV_INPUT].isConnected()) {
             float cv = inputs[FILTER_CV_INPUT].getVoltage();
-            filter += cv * 0.2f;
-            filter = clamp(filter, -1.f, 1.f);
-            filterCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+            value += cv * 0.2f;
+            value = clamp(value, -1.f, 1.f);
+            cvMods.publish(CVMOD_FILTER, clamp(cv / 10.0f, -1.0f, 1.0f));
         } else {
-            filterCvMod = 0.0f;
+            cvMods.clear(CVMOD_FILTER);
         }
 
-        float filterSmooth = 0.002f;
-        smoothedFilter = smoothedFilter * (1.0f - filterSmooth) + filter * filterSmooth;
+        // 等效於每樣本 0.002 的一階平滑
+        const float smooth = 1.f - std::pow(1.f - 0.002f, (float)CONTROL_DIVISION);
+        smoothedFilter += (value - smoothedFilter) * smooth;
+
+        if (filterCache.update(smoothedFilter, sampleRate)) {
+            filter.reset();
+        }
+        filter.setCoeffs(filterCache.coeffs);
+    }
+
+    void process(const ProcessArgs& args) override {
+        float audioIn = inputs[AUDIO_INPUT].getVoltage();
+        
+        float level = params[LEVEL_PARAM].getValue();
+        float send = params[SEND_PARAM].getValue();
+        
+        if (controlDivider.process() || !vbapRamp.initialized) {
+            updatePosition();
+            updateFilter(args.sampleRate);
+        }
 
         audioIn *= level;
         
@@ -233,28 +211,8 @@ struct Pyramid : Module {
             sendOut = audioIn * send;
         }
         
-        if (filter < -0.001f) {
-            if (lastFilterMode != -1) {
-                filter1.reset();
-                filter2.reset();
-                lastFilterMode = -1;
-            }
-            float freq = rescale(filter, -1.f, 0.f, 20.f, 22000.f);
-            filter1.setParameters(dsp::TBiquadFilter<>::LOWPASS, freq / args.sampleRate, 0.707f, 1.f);
-            filter2.setParameters(dsp::TBiquadFilter<>::LOWPASS, freq / args.sampleRate, 0.707f, 1.f);
-            audioIn = filter2.process(filter1.process(audioIn));
-        } else if (filter > 0.001f) {
-            if (lastFilterMode != 1) {
-                filter1.reset();
-                filter2.reset();
-                lastFilterMode = 1;
-            }
-            float freq = rescale(filter, 0.f, 1.f, 10.f, 8000.f);
-            filter1.setParameters(dsp::TBiquadFilter<>::HIGHPASS, freq / args.sampleRate, 0.707f, 1.f);
-            filter2.setParameters(dsp::TBiquadFilter<>::HIGHPASS, freq / args.sampleRate, 0.707f, 1.f);
-            audioIn = filter2.process(filter1.process(audioIn));
-        } else {
-            lastFilterMode = 0;
+        if (filterCache.mode != 0) {
+            audioIn = filter.process(audioIn);
         }
         
         outputs[SEND_OUTPUT].setVoltage(sendOut);
@@ -262,19 +220,14 @@ struct Pyramid : Module {
         float returnL = inputs[RETURN_L_INPUT].getVoltage();
         float returnR = inputs[RETURN_R_INPUT].getVoltage();
         
-        float gains[8];
-        calculateVBAP(x, y, z, gains);
+        vbapRamp.step();
+        simd::float_4 signalVec = simd::float_4(returnL, returnR, returnL, returnR) + audioIn;
+        simd::float_4 outLo = signalVec * vbapRamp.gainLo;
+        simd::float_4 outHi = signalVec * vbapRamp.gainHi;
         
-        for (int i = 0; i < 8; i++) {
-            float outputVoltage = audioIn * gains[i];
-            
-            if (i % 2 == 0) {
-                outputVoltage += returnL * gains[i];
-            } else {
-                outputVoltage += returnR * gains[i];
-            }
-            
-            outputs[FL_UPPER_OUTPUT + i].setVoltage(outputVoltage);
+        for (int i = 0; i < 4; i++) {
+            outputs[FL_UPPER_OUTPUT + i].setVoltage(outLo[i]);
+            outputs[FL_UPPER_OUTPUT + 4 + i].setVoltage(outHi[i]);
         }
     }
 };
@@ -588,6 +541,7 @@ struct PyramidWidget : ModuleWidget {
     StandardBlackKnob26* yKnob = nullptr;
     StandardBlackKnob26* zKnob = nullptr;
     StandardBlackKnob26* filterKnob = nullptr;
+    madzine::widgets::CVModRingSync<Pyramid::NUM_CVMODS> cvModSync;
 
     PyramidWidget(Pyramid* module) {
         setModule(module);
@@ -634,6 +588,12 @@ struct PyramidWidget : ModuleWidget {
         addChild(new TechnoEnhancedTextLabel(Vec(65, 290), Vec(50, 10), "FILTER", 8.f, nvgRGB(255, 255, 255), true));
         filterKnob = createParamCentered<StandardBlackKnob26>(Vec(75, 312), module, Pyramid::FILTER_PARAM);
         addParam(filterKnob);
+
+        cvModSync.bind(Pyramid::CVMOD_X, xKnob);
+        cvModSync.bind(Pyramid::CVMOD_Y, yKnob);
+        cvModSync.bind(Pyramid::CVMOD_Z, zKnob);
+        cvModSync.bind(Pyramid::CVMOD_FILTER, filterKnob);
+
         addInput(createInputCentered<PJ301MPort>(Vec(102, 312), module, Pyramid::FILTER_CV_INPUT));
 
         addInput(createInputCentered<PJ301MPort>(Vec(44, 240), module, Pyramid::X_CV_INPUT));
@@ -659,19 +619,8 @@ struct PyramidWidget : ModuleWidget {
         if (module) {
             panelThemeHelper.step(module);
 
-            // CV 調變顯示更新
-            auto updateKnob = [&](StandardBlackKnob26* knob, int inputId, float cvMod) {
-                if (knob) {
-                    bool connected = module->inputs[inputId].isConnected();
-                    knob->setModulationEnabled(connected);
-                    if (connected) knob->setModulation(cvMod);
-                }
-            };
-
-            updateKnob(xKnob, Pyramid::X_CV_INPUT, module->xCvMod);
-            updateKnob(yKnob, Pyramid::Y_CV_INPUT, module->yCvMod);
-            updateKnob(zKnob, Pyramid::Z_CV_INPUT, module->zCvMod);
-            updateKnob(filterKnob, Pyramid::FILTER_CV_INPUT, module->filterCvMod);
+            // 更新 CV 調變顯示（僅在數值變化時）
+            cvModSync.sync(module->cvMods);
         }
         ModuleWidget::step();
     }
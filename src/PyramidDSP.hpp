@@ -0,0 +1,237 @@
+#pragma once
+#include "plugin.hpp"
+
+// ============================================================
+// PyramidDSP - Pyramid / DECAPyramid 共用的 3D 聲像運算
+// ============================================================
+
+struct PyramidSpeakerPosition {
+    float x, y, z;
+};
+
+/**
+ * 距離衰減式 VBAP：計算聲源對 8 個喇叭的增益（已做功率正規化）
+ */
+inline void pyramidVBAP(const PyramidSpeakerPosition speakers[8],
+                        float sourceX, float sourceY, float sourceZ, float gains[8]) {
+    for (int i = 0; i < 8; i++) {
+        float dx = speakers[i].x - sourceX;
+        float dy = speakers[i].y - sourceY;
+        float dz = speakers[i].z - sourceZ;
+        float distance = std::sqrt(dx*dx + dy*dy + dz*dz);
+
+        distance = std::max(distance, 0.001f);
+
+        float gain = 1.0f / (1.0f + distance + distance * distance * 2.0f);
+
+        float fadeOut = 1.0f;
+
+        if (sourceX <= -0.8f && speakers[i].x > 0) {
+            fadeOut *= std::max(0.0f, (sourceX + 1.0f) / 0.2f);
+        }
+        if (sourceX >= 0.8f && speakers[i].x < 0) {
+            fadeOut *= std::max(0.0f, (1.0f - sourceX) / 0.2f);
+        }
+
+        if (sourceY <= -0.8f && speakers[i].y > 0) {
+            fadeOut *= std::max(0.0f, (sourceY + 1.0f) / 0.2f);
+        }
+        if (sourceY >= 0.8f && speakers[i].y < 0) {
+            fadeOut *= std::max(0.0f, (1.0f - sourceY) / 0.2f);
+        }
+
+        if (sourceZ <= -0.8f && speakers[i].z > 0) {
+            fadeOut *= std::max(0.0f, (sourceZ + 1.0f) / 0.2f);
+        }
+        if (sourceZ >= 0.8f && speakers[i].z < 0) {
+            fadeOut *= std::max(0.0f, (1.0f - sourceZ) / 0.2f);
+        }
+
+        gains[i] = gain * fadeOut;
+    }
+
+    float totalGain = 0.0f;
+    for (int i = 0; i < 8; i++) {
+        totalGain += gains[i] * gains[i];
+    }
+
+    if (totalGain > 0.0f) {
+        float normalizeFactor = 1.0f / std::sqrt(totalGain);
+        for (int i = 0; i < 8; i++) {
+            gains[i] *= normalizeFactor;
+        }
+    }
+}
+
+/**
+ * 8 喇叭增益的線性插值器
+ * 位置只在控制率更新，音訊率以 2 個 float_4 逐樣本逼近目標增益，避免拉鏈雜音。
+ * lo = 喇叭 1-4，hi = 喇叭 5-8
+ */
+struct VBAPGainRamp {
+    simd::float_4 gainLo = 0.0f;
+    simd::float_4 gainHi = 0.0f;
+    simd::float_4 targetLo = 0.0f;
+    simd::float_4 targetHi = 0.0f;
+    simd::float_4 stepLo = 0.0f;
+    simd::float_4 stepHi = 0.0f;
+    int remaining = 0;
+
+    float lastX = 0.0f, lastY = 0.0f, lastZ = 0.0f;
+    bool initialized = false;
+
+    /**
+     * 控制率呼叫：位置改變時重新計算目標增益，並在 rampSamples 內滑向目標
+     */
+    void update(const PyramidSpeakerPosition speakers[8], float x, float y, float z, int rampSamples) {
+        if (initialized && x == lastX && y == lastY && z == lastZ) return;
+        lastX = x;
+        lastY = y;
+        lastZ = z;
+
+        float gains[8];
+        pyramidVBAP(speakers, x, y, z, gains);
+        targetLo = simd::float_4::load(&gains[0]);
+        targetHi = simd::float_4::load(&gains[4]);
+
+        if (!initialized || rampSamples <= 1) {
+            gainLo = targetLo;
+            gainHi = targetHi;
+            remaining = 0;
+            initialized = true;
+            return;
+        }
+        float inv = 1.0f / rampSamples;
+        stepLo = (targetLo - gainLo) * inv;
+        stepHi = (targetHi - gainHi) * inv;
+        remaining = rampSamples;
+    }
+
+    /**
+     * 音訊率呼叫：前進一個樣本
+     */
+    void step() {
+        if (remaining <= 0) return;
+        if (--remaining == 0) {
+            gainLo = targetLo;
+            gainHi = targetHi;
+        } else {
+            gainLo += stepLo;
+            gainHi += stepHi;
+        }
+    }
+};
+
+/**
+ * 濾波旋鈕係數快取
+ * 旋鈕值 -1 ~ +1：負值為低通 20Hz-22kHz，正值為高通 10Hz-8kHz，中央旁通。
+ * 以量化後的旋鈕值為鍵，鍵與取樣率都沒變時不重新計算（省下 tan）。
+ */
+struct PyramidFilterCoeffs {
+    float b0 = 1.f, b1 = 0.f, b2 = 0.f, a1 = 0.f, a2 = 0.f;
+};
+
+struct PyramidFilterCoeffCache {
+    static constexpr int KEY_STEPS = 4096;
+
+    PyramidFilterCoeffs coeffs;
+    int mode = 0;  // -1 = 低通, 0 = 旁通, 1 = 高通
+    int key = 0;
+    float sampleRate = 0.f;
+
+    /**
+     * @return 模式改變時回傳 true，呼叫端需重置濾波器狀態
+     */
+    bool update(float value, float sr) {
+        int newMode = (value < -0.001f) ? -1 : ((value > 0.001f) ? 1 : 0);
+        int newKey = (int)std::round(value * KEY_STEPS);
+        bool modeChanged = (newMode != mode);
+        if (!modeChanged && newKey == key && sr == sampleRate) return false;
+
+        mode = newMode;
+        key = newKey;
+        sampleRate = sr;
+
+        if (mode == 0) {
+            coeffs = PyramidFilterCoeffs();
+            return modeChanged;
+        }
+
+        float quantized = (float)key / KEY_STEPS;
+        float freq = (mode < 0)
+            ? rescale(quantized, -1.f, 0.f, 20.f, 22000.f)
+            : rescale(quantized, 0.f, 1.f, 10.f, 8000.f);
+
+        // 與 dsp::TBiquadFilter 的 LOWPASS / HIGHPASS 相同公式，Q = 0.707
+        const float Q = 0.707f;
+        float K = std::tan(float(M_PI) * freq / sr);
+        float norm = 1.f / (1.f + K / Q + K * K);
+        if (mode < 0) {
+            coeffs.b0 = K * K * norm;
+            coeffs.b1 = 2.f * coeffs.b0;
+        } else {
+            coeffs.b0 = norm;
+            coeffs.b1 = -2.f * coeffs.b0;
+        }
+        coeffs.b2 = coeffs.b0;
+        coeffs.a1 = 2.f * (K * K - 1.f) * norm;
+        coeffs.a2 = (1.f - K / Q + K * K) * norm;
+        return modeChanged;
+    }
+};
+
+/**
+ * 兩級串接、係數相同的 biquad
+ * T = float_4 時每個 lane 可有獨立係數（例如 Return A/B 的 L/R 打包成一組）
+ */
+template <typename T>
+struct PyramidCascadeBiquad {
+    T b0 = 1.f, b1 = 0.f, b2 = 0.f, a1 = 0.f, a2 = 0.f;
+    T x1[2] = {}, x2[2] = {}, y1[2] = {}, y2[2] = {};
+
+    void setCoeffs(const PyramidFilterCoeffs& c) {
+        b0 = c.b0;
+        b1 = c.b1;
+        b2 = c.b2;
+        a1 = c.a1;
+        a2 = c.a2;
+    }
+
+    void setLaneCoeffs(int lane, const PyramidFilterCoeffs& c) {
+        b0[lane] = c.b0;
+        b1[lane] = c.b1;
+        b2[lane] = c.b2;
+        a1[lane] = c.a1;
+        a2[lane] = c.a2;
+    }
+
+    void reset() {
+        for (int s = 0; s < 2; s++) {
+            x1[s] = 0.f;
+            x2[s] = 0.f;
+            y1[s] = 0.f;
+            y2[s] = 0.f;
+        }
+    }
+
+    void resetLane(int lane) {
+        for (int s = 0; s < 2; s++) {
+            x1[s][lane] = 0.f;
+            x2[s][lane] = 0.f;
+            y1[s][lane] = 0.f;
+            y2[s][lane] = 0.f;
+        }
+    }
+
+    T process(T in) {
+        for (int s = 0; s < 2; s++) {
+            T out = b0 * in + b1 * x1[s] + b2 * x2[s] - a1 * y1[s] - a2 * y2[s];
+            x2[s] = x1[s];
+            x1[s] = in;
+            y2[s] = y1[s];
+            y1[s] = out;
+            in = out;
+        }
+        return in;
+    }
+};
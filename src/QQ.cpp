@@ -1,6 +1,8 @@
 #include "plugin.hpp"
 #include "widgets/Knobs.hpp"
+#include "widgets/CVModulation.hpp"
 #include "widgets/PanelTheme.hpp"
+#include "widgets/ScopeCapture.hpp"
 
 struct QQ : Module {
     int panelTheme = madzineDefaultTheme;
@@ -50,27 +52,28 @@ struct QQ : Module {
         float lastEnvOutput = 0.f;  // For retrigger mode
     };
 
-    struct ScopePoint {
-        float value = 0.f;
-    };
-
     TrackState tracks[3];
 
     // CV 調變顯示用
-    float track1DecayCvMod = 0.0f;
-    float track2DecayCvMod = 0.0f;
-    float track3DecayCvMod = 0.0f;
+    enum CvModId {
+        CVMOD_TRACK1_DECAY,
+        CVMOD_TRACK2_DECAY,
+        CVMOD_TRACK3_DECAY,
+        NUM_CVMODS
+    };
+    madzine::widgets::CVModBank<NUM_CVMODS> cvMods;
 
     bool retriggerEnabled = false;  // Retrigger option
     int shapeMode[3] = {0, 0, 0}; // 0 = S-Drum, 1 = Extreme Curve
     static constexpr int SCOPE_BUFFER_SIZE = 128;
     
-    ScopePoint scopeBuffer[3][SCOPE_BUFFER_SIZE];
-    int scopeBufferIndex = 0;
-    int scopeFrameIndex = 0;
+    // 捲動式示波器：每欄記錄包絡輸出的 min/max
+    using Frame = madzine::widgets::ScopeFrame<3, SCOPE_BUFFER_SIZE>;
+    madzine::widgets::ScopeCapture<3, SCOPE_BUFFER_SIZE> scope;
 
     QQ() {
         config(NUM_PARAMS, NUM_INPUTS, NUM_OUTPUTS, NUM_LIGHTS);
+        scope.rolling = true;
         
         configParam(TRACK1_DECAY_TIME_PARAM, 0.01f, 2.f, 1.f, "Track 1 Decay Time", "s");
         configParam(TRACK1_SHAPE_PARAM, 0.f, 0.99f, 0.5f, "Track 1 Shape");
@@ -230,9 +233,9 @@ struct QQ : Module {
                     float attenuation = params[TRACK1_DECAY_CV_ATTEN_PARAM].getValue();
                     decayTime += cv / 10.f * 2.f * attenuation; // CV range with attenuator
                     decayTime = clamp(decayTime, 0.01f, 2.f);
-                    track1DecayCvMod = clamp(cv / 10.0f * attenuation, -1.0f, 1.0f);
+                    cvMods.publish(CVMOD_TRACK1_DECAY, clamp(cv / 10.0f * attenuation, -1.0f, 1.0f));
                 } else {
-                    track1DecayCvMod = 0.0f;
+                    cvMods.clear(CVMOD_TRACK1_DECAY);
                 }
                 shapeParam = params[TRACK1_SHAPE_PARAM].getValue();
             } else if (i == 1) {
@@ -243,9 +246,9 @@ struct QQ : Module {
                     float attenuation = params[TRACK2_DECAY_CV_ATTEN_PARAM].getValue();
                     decayTime += cv / 10.f * 2.f * attenuation; // CV range with attenuator
                     decayTime = clamp(decayTime, 0.01f, 2.f);
-                    track2DecayCvMod = clamp(cv / 10.0f * attenuation, -1.0f, 1.0f);
+                    cvMods.publish(CVMOD_TRACK2_DECAY, clamp(cv / 10.0f * attenuation, -1.0f, 1.0f));
                 } else {
-                    track2DecayCvMod = 0.0f;
+                    cvMods.clear(CVMOD_TRACK2_DECAY);
                 }
                 shapeParam = params[TRACK2_SHAPE_PARAM].getValue();
             } else {
@@ -256,9 +259,9 @@ struct QQ : Module {
                     float attenuation = params[TRACK3_DECAY_CV_ATTEN_PARAM].getValue();
                     decayTime += cv / 10.f * 2.f * attenuation; // CV range with attenuator
                     decayTime = clamp(decayTime, 0.01f, 2.f);
-                    track3DecayCvMod = clamp(cv / 10.0f * attenuation, -1.0f, 1.0f);
+                    cvMods.publish(CVMOD_TRACK3_DECAY, clamp(cv / 10.0f * attenuation, -1.0f, 1.0f));
                 } else {
-                    track3DecayCvMod = 0.0f;
+                    cvMods.clear(CVMOD_TRACK3_DECAY);
                 }
                 shapeParam = params[TRACK3_SHAPE_PARAM].getValue();
             }
@@ -306,13 +309,10 @@ struct QQ : Module {
         // Update scope buffer
         float deltaTime = dsp::exp2_taylor5(-params[SCOPE_TIME_PARAM].getValue()) / SCOPE_BUFFER_SIZE;
         int frameCount = (int)std::ceil(deltaTime * args.sampleRate);
-        if (++scopeFrameIndex >= frameCount) {
-            scopeFrameIndex = 0;
-            for (int i = 0; i < 3; i++) {
-                scopeBuffer[i][scopeBufferIndex].value = outputs[TRACK1_ENV_OUTPUT + i].getVoltage();
-            }
-            scopeBufferIndex = (scopeBufferIndex + 1) % SCOPE_BUFFER_SIZE;
+        for (int i = 0; i < 3; i++) {
+            scope.addPort(i, outputs[TRACK1_ENV_OUTPUT + i]);
         }
+        scope.step(frameCount, args.sampleRate);
     }
 };
 
@@ -410,17 +410,17 @@ struct CVConnectionLine : Widget {
 
 // HiddenAttenuatorKnob 現在從 widgets/Knobs.hpp 引入
 
-struct QQScopeDisplay : LedDisplay {
+// 波形畫在 ScopeFramebuffer 內，只有新幀或接線顏色改變時才重畫
+struct QQScopeDisplay : Widget {
     QQ* module;
     ModuleWidget* moduleWidget;
+    madzine::widgets::ScopeTrackColors<3> trackColors;
     
     QQScopeDisplay() {
         box.size = Vec(60, 51);
     }
     
-    void drawWave(const DrawArgs& args, int track, NVGcolor color) {
-        if (!module) return;
-        
+    void drawWave(const DrawArgs& args, const QQ::Frame& frame, int track, NVGcolor color) {
         nvgSave(args.vg);
         
         // Calculate track area (31% height each, with gaps)
@@ -430,27 +430,7 @@ struct QQScopeDisplay : LedDisplay {
         
         Rect b = Rect(Vec(0, trackY), Vec(box.size.x, trackHeight));
         nvgScissor(args.vg, RECT_ARGS(b));
-        nvgBeginPath(args.vg);
-        
-        for (int i = 0; i < QQ::SCOPE_BUFFER_SIZE; i++) {
-            float value = module->scopeBuffer[track][(i + module->scopeBufferIndex) % QQ::SCOPE_BUFFER_SIZE].value;
-            value = clamp(value, 0.f, 10.f);
-            
-            Vec p;
-            p.x = (float)i / (QQ::SCOPE_BUFFER_SIZE - 1);
-            p.y = 1.f - (value / 10.f); // Invert for proper display
-            p = b.interpolate(p);
-            
-            if (i == 0)
-                nvgMoveTo(args.vg, p.x, p.y);
-            else
-                nvgLineTo(args.vg, p.x, p.y);
-        }
-        
-        nvgStrokeColor(args.vg, color);
-        nvgStrokeWidth(args.vg, 1.5f);
-        nvgLineCap(args.vg, NVG_ROUND);
-        nvgStroke(args.vg);
+        madzine::widgets::drawScopeEnvelope(args.vg, frame, track, b, color, 1.f, 0.1f); // 0-10V
         nvgResetScissor(args.vg);
         nvgRestore(args.vg);
     }
@@ -500,20 +480,32 @@ struct QQScopeDisplay : LedDisplay {
         nvgStroke(args.vg);
     }
     
-    void drawLayer(const DrawArgs& args, int layer) override {
-        if (layer != 1) return;
-        
+    void step() override {
+        if (module && moduleWidget) {
+            bool dirty = module->scope.poll();
+
+            // Get input colors from cable connections
+            for (int i = 0; i < 3; i++) {
+                PortWidget* inputPort = moduleWidget->getInput(QQ::TRACK1_TRIG_INPUT + i);
+                CableWidget* cable = APP->scene->rack->getTopCable(inputPort);
+                NVGcolor trackColor = cable ? cable->color : nvgRGB(255, 255, 255);
+                dirty |= trackColors.set(i, trackColor);
+            }
+
+            if (dirty)
+                madzine::widgets::markScopeDirty(this);
+        }
+        Widget::step();
+    }
+
+    void draw(const DrawArgs& args) override {
         drawBackground(args);
         
         if (!module || !moduleWidget) return;
-        
-        // Get input colors from cable connections
+
+        const QQ::Frame& frame = module->scope.frame();
         for (int i = 0; i < 3; i++) {
-            PortWidget* inputPort = moduleWidget->getInput(QQ::TRACK1_TRIG_INPUT + i);
-            CableWidget* cable = APP->scene->rack->getTopCable(inputPort);
-            NVGcolor trackColor = cable ? cable->color : nvgRGB(255, 255, 255);
-            
-            drawWave(args, i, trackColor);
+            drawWave(args, frame, i, trackColors.colors[i]);
         }
     }
 };
@@ -523,6 +515,7 @@ struct QQWidget : ModuleWidget {
     StandardBlackKnob* track1DecayKnob = nullptr;
     StandardBlackKnob* track2DecayKnob = nullptr;
     StandardBlackKnob* track3DecayKnob = nullptr;
+    madzine::widgets::CVModRingSync<QQ::NUM_CVMODS> cvModSync;
 
     QQWidget(QQ* module) {
         setModule(module);
@@ -585,6 +578,11 @@ struct QQWidget : ModuleWidget {
         addChild(new EnhancedTextLabel(Vec(5, 215), Vec(20, 20), "DECAY", 8.f, nvgRGB(255, 255, 255), true));
         track3DecayKnob = createParamCentered<StandardBlackKnob>(Vec(15, 245), module, QQ::TRACK3_DECAY_TIME_PARAM);
         addParam(track3DecayKnob);
+
+        cvModSync.bind(QQ::CVMOD_TRACK1_DECAY, track1DecayKnob);
+        cvModSync.bind(QQ::CVMOD_TRACK2_DECAY, track2DecayKnob);
+        cvModSync.bind(QQ::CVMOD_TRACK3_DECAY, track3DecayKnob);
+
         
         // Track 3 Decay CV input
         addInput(createInputCentered<PJ301MPort>(Vec(centerX + 15, 223), module, QQ::TRACK3_DECAY_CV_INPUT));
@@ -600,7 +598,7 @@ struct QQWidget : ModuleWidget {
         scopeDisplay->box.pos = Vec(0, 279);
         scopeDisplay->module = module;
         scopeDisplay->moduleWidget = this;
-        addChild(scopeDisplay);
+        addChild(madzine::widgets::createScopeFramebuffer(scopeDisplay));
         
         // Hidden time control knob (overlapping scope display)
         addParam(createParam<HiddenTimeKnobQQ>(Vec(0, 279), module, QQ::SCOPE_TIME_PARAM));
@@ -618,18 +616,8 @@ struct QQWidget : ModuleWidget {
         if (module) {
             panelThemeHelper.step(module);
 
-            // CV 調變顯示更新
-            auto updateKnob = [&](StandardBlackKnob* knob, int inputId, float cvMod) {
-                if (knob) {
-                    bool connected = module->inputs[inputId].isConnected();
-                    knob->setModulationEnabled(connected);
-                    if (connected) knob->setModulation(cvMod);
-                }
-            };
-
-            updateKnob(track1DecayKnob, QQ::TRACK1_DECAY_CV_INPUT, module->track1DecayCvMod);
-            updateKnob(track2DecayKnob, QQ::TRACK2_DECAY_CV_INPUT, module->track2DecayCvMod);
-            updateKnob(track3DecayKnob, QQ::TRACK3_DECAY_CV_INPUT, module->track3DecayCvMod);
+            // 更新 CV 調變顯示（僅在數值變化時）
+            cvModSync.sync(module->cvMods);
         }
         ModuleWidget::step();
     }
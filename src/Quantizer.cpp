@@ -1,9 +1,17 @@
 #include "plugin.hpp"
 #include "widgets/Knobs.hpp"
+#include "widgets/CVModulation.hpp"
 #include "widgets/PanelTheme.hpp"
 #include "Microtuning/MicrotunePresets.hpp"
+#include "Microtuning/ScalaTuning.hpp"
+#include <osdialog.h>
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <thread>
 
 using namespace Microtuning;
+using simd::float_4;
 
 // ============================================================================
 // Helper Widgets
@@ -94,8 +102,41 @@ struct Quantizer : Module {
     int currentPreset = 0;
 
     // CV 調變顯示用
-    float scaleCvMod = 0.0f;
-    float offsetCvMod = 0.0f;
+    enum CvModId {
+        CVMOD_SCALE,
+        CVMOD_OFFSET,
+        NUM_CVMODS
+    };
+    madzine::widgets::CVModBank<NUM_CVMODS> cvMods;
+
+    // ===== Scala 調音 (.scl / .kbm) =====
+    // 背景執行緒把音階展開成排序好的門檻表，編譯到非使用中的一份後切換 scalaSlot；
+    // 音訊執行緒只做固定長度的二分搜尋
+    ScalaTable scalaTables[2];
+    std::atomic<int> scalaSlot{0};
+    std::atomic<bool> scalaReady{false};   // 已有編譯成功的表
+    std::atomic<bool> scalaEnabled{false}; // 使用者開關
+    std::thread scalaWorker;
+    std::mutex scalaMutex;                 // 保護以下字串（UI / 背景執行緒）
+    std::string sclText, kbmText;
+    std::string sclName, kbmName;
+    std::string scalaStatus = "No scale loaded";
+
+    // ===== 量化核心：預先計算的每格輸出表 + 每聲部快取 =====
+    static const int TABLE_DIVISION = 64;
+    dsp::ClockDivider tableDivider;
+    // 48 格各自的量化結果（2 八度區塊內），輸出 = 區塊 * 2V + 表值
+    float slotVolts[48] = {};      // 一般：半音 + 該音的 Microtune
+    float slotAscVolts[48] = {};   // 方向性：上行音分
+    float slotDescVolts[48] = {};  // 方向性：下行音分
+    int slotSemitone[48] = {};     // ranges[] 的半音（-12..36）
+    bool tablesBuilt = false;
+    bool tablesDirectional = false;
+    // 每聲部上次的 (輸入 + offset) * scale 與輸出；數值不變時整組跳過
+    float_4 lastPitch[3][MAX_POLY / 4];
+    float_4 lastOut[3][MAX_POLY / 4];
+    int8_t lastNoteIdx[3][MAX_POLY];  // 顯示用，-1 = 無
+    int lastScalaSlot = -1;           // -1 = 一般模式
 
     // Note names for 2 octaves
     static constexpr const char* NOTE_NAMES[24] = {
@@ -123,10 +164,145 @@ struct Quantizer : Module {
         configOutput(PITCH_OUTPUT_2, "Pitch 2");
         configOutput(PITCH_OUTPUT_3, "Pitch 3");
         configBypass(PITCH_INPUT, PITCH_OUTPUT);
+        tableDivider.setDivision(TABLE_DIVISION);
         onReset();
     }
 
+    /**
+     * 讓所有聲部的快取失效（下一個樣本全部重算）
+     */
+    void invalidateCache() {
+        for (int t = 0; t < 3; t++) {
+            for (int g = 0; g < MAX_POLY / 4; g++) {
+                lastPitch[t][g] = NAN;
+                lastOut[t][g] = 0.f;
+            }
+            for (int c = 0; c < MAX_POLY; c++)
+                lastNoteIdx[t][c] = -1;
+        }
+    }
+
+    /**
+     * 控制率：由 ranges[] 與 Microtune / 方向性音分重建每格輸出表，內容改變時快取失效
+     */
+    void rebuildTables() {
+        bool changed = !tablesBuilt || tablesDirectional != hasDirectional;
+        tablesDirectional = hasDirectional;
+        for (int i = 0; i < 48; i++) {
+            int qNote24 = ranges[i];
+            int noteIdx24 = eucMod(qNote24, 24);
+            int noteIdx12 = eucMod(qNote24, 12);
+            float base = (float)qNote24 / 12.f;
+            float v = base + params[MICROTUNE_PARAM + noteIdx24].getValue() / 1200.f;
+            float asc = base + ascCents[noteIdx12] / 1200.f;
+            float desc = base + descCents[noteIdx12] / 1200.f;
+            if (v != slotVolts[i] || asc != slotAscVolts[i] || desc != slotDescVolts[i] || qNote24 != slotSemitone[i]) {
+                slotVolts[i] = v;
+                slotAscVolts[i] = asc;
+                slotDescVolts[i] = desc;
+                slotSemitone[i] = qNote24;
+                changed = true;
+            }
+        }
+        tablesBuilt = true;
+        if (changed) invalidateCache();
+    }
+
+    ~Quantizer() {
+        if (scalaWorker.joinable()) scalaWorker.join();
+    }
+
+    /**
+     * 在背景執行緒編譯目前的 .scl / .kbm 內容
+     */
+    void compileScalaAsync() {
+        if (scalaWorker.joinable()) scalaWorker.join();
+        std::string scl, kbm;
+        {
+            std::lock_guard<std::mutex> lock(scalaMutex);
+            scl = sclText;
+            kbm = kbmText;
+        }
+        scalaWorker = std::thread([this, scl, kbm]() {
+            ScalaScale scale;
+            ScalaKeyboardMap map;
+            std::string error;
+            int next = 1 - scalaSlot.load();
+            bool ok = parseScl(scl, scale, error)
+                && (kbm.empty() || parseKbm(kbm, map, error))
+                && compileScalaTable(scale, map, scalaTables[next], error);
+
+            std::lock_guard<std::mutex> lock(scalaMutex);
+            if (ok) {
+                scalaSlot.store(next, std::memory_order_release);
+                scalaReady = true;
+                scalaStatus = string::f("%s: %d notes, %d pitches",
+                                        scale.description.empty() ? sclName.c_str() : scale.description.c_str(),
+                                        (int)scale.cents.size(), scalaTables[next].count);
+            } else {
+                scalaStatus = "Error: " + error;
+            }
+        });
+    }
+
+    static bool readTextFile(const std::string& path, std::string& text) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) return false;
+        std::ostringstream ss;
+        ss << file.rdbuf();
+        text = ss.str();
+        return true;
+    }
+
+    void loadScalaFile(const std::string& path, bool keyboardMap) {
+        std::string text;
+        if (!readTextFile(path, text)) {
+            WARN("Quantizer: Could not open %s", path.c_str());
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(scalaMutex);
+            if (keyboardMap) {
+                kbmText = text;
+                kbmName = system::getFilename(path);
+            } else {
+                sclText = text;
+                sclName = system::getFilename(path);
+            }
+            if (sclText.empty()) return;  // 只載入 .kbm：等 .scl 載入後再編譯
+        }
+        if (!keyboardMap) scalaEnabled = true;
+        compileScalaAsync();
+    }
+
+    void clearKeyboardMap() {
+        {
+            std::lock_guard<std::mutex> lock(scalaMutex);
+            kbmText.clear();
+            kbmName.clear();
+            if (sclText.empty()) return;
+        }
+        compileScalaAsync();
+    }
+
+    /**
+     * 卸除 Scala 調音（重設 / 載入沒有 Scala 資料的存檔）
+     * 先等進行中的編譯結束，避免它在清除後又把 scalaReady 設回 true
+     */
+    void clearScala() {
+        if (scalaWorker.joinable()) scalaWorker.join();
+        scalaEnabled = false;
+        scalaReady = false;
+        std::lock_guard<std::mutex> lock(scalaMutex);
+        sclText.clear();
+        kbmText.clear();
+        sclName.clear();
+        kbmName.clear();
+        scalaStatus = "No scale loaded";
+    }
+
     void onReset() override {
+        clearScala();
         for (int i = 0; i < 24; i++)
             enabledNotes[i] = true;
         for (int i = 0; i < 12; i++)
@@ -138,6 +314,8 @@ struct Quantizer : Module {
             }
         hasDirectional = false;
         updateRanges();
+        tablesBuilt = false;
+        invalidateCache();
     }
 
     void onRandomize() override {
@@ -147,62 +325,107 @@ struct Quantizer : Module {
     }
 
     void process(const ProcessArgs& args) override {
-        bool playing[24] = {};
         float scale = params[SCALE_PARAM].getValue();
         if (inputs[SCALE_CV_INPUT].isConnected()) {
             float cv = inputs[SCALE_CV_INPUT].getVoltage();
             scale += cv * 0.2f;  // ±1V = ±0.2 scale
-            scaleCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+            cvMods.publish(CVMOD_SCALE, clamp(cv / 10.0f, -1.0f, 1.0f));
         } else {
-            scaleCvMod = 0.0f;
+            cvMods.clear(CVMOD_SCALE);
         }
         float offset = params[OFFSET_PARAM].getValue();
         if (inputs[OFFSET_CV_INPUT].isConnected()) {
             float cv = inputs[OFFSET_CV_INPUT].getVoltage();
             offset += cv;
-            offsetCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+            cvMods.publish(CVMOD_OFFSET, clamp(cv / 10.0f, -1.0f, 1.0f));
         } else {
-            offsetCvMod = 0.0f;
+            cvMods.clear(CVMOD_OFFSET);
+        }
+
+        bool scalaActive = scalaEnabled.load(std::memory_order_relaxed) && scalaReady.load(std::memory_order_acquire);
+        int scalaIndex = scalaActive ? scalaSlot.load(std::memory_order_acquire) : -1;
+        if (scalaIndex != lastScalaSlot) {
+            lastScalaSlot = scalaIndex;
+            invalidateCache();
+        }
+
+        bool controlTick = tableDivider.process() || !tablesBuilt;
+        if (controlTick) {
+            rebuildTables();
         }
 
         for (int t = 0; t < 3; t++) {
-            int ch = std::max(inputs[PITCH_INPUT + t].getChannels(), 1);
-            for (int c = 0; c < ch; c++) {
-                float pitch = inputs[PITCH_INPUT + t].getVoltage(c);
-                pitch = (pitch + offset) * scale;
-
-                // Map to 48 slots (2 octaves × 24 half-semitone slots)
-                // pitch * 12 = semitones, * 2 = half-semitone slots
-                int slot = std::floor(pitch * 24);
-                int twoOctaveBlock = eucDiv(slot, 48);
-                slot = eucMod(slot, 48);
-
-                // ranges[] stores note index within 2 octaves (0-23)
-                int qNote24 = ranges[slot];  // 0-23 within the 2-octave block
-                int qNoteSemitone = twoOctaveBlock * 24 + qNote24;  // absolute semitone
-
-                int noteIdx24 = eucMod(qNote24, 24);
-                int noteIdx12 = eucMod(qNote24, 12);
-                playing[noteIdx24] = true;
-
-                // Direction detection & microtune
-                float mt;
-                if (hasDirectional) {
-                    float diff = (float)qNoteSemitone - lastNote[t][c];
-                    if (diff > 0.5f) ascending[t][c] = true;
-                    else if (diff < -0.5f) ascending[t][c] = false;
-                    mt = ascending[t][c] ? ascCents[noteIdx12] : descCents[noteIdx12];
-                } else {
-                    mt = params[MICROTUNE_PARAM + noteIdx24].getValue();
+            Input& in = inputs[PITCH_INPUT + t];
+            Output& out = outputs[PITCH_OUTPUT + t];
+            int ch = std::max(in.getChannels(), 1);
+
+            for (int c = 0; c < ch; c += 4) {
+                int g = c / 4;
+                float_4 pitch = (in.getVoltageSimd<float_4>(c) + offset) * scale;
+
+                // 只重算輸入有變化的聲部
+                int changed = simd::movemask(pitch != lastPitch[t][g]);
+                if (changed) {
+                    float_4 result = lastOut[t][g];
+
+                    if (scalaActive) {
+                        const ScalaTable& table = scalaTables[scalaIndex];
+                        for (int k = 0; k < 4; k++) {
+                            if (changed & (1 << k)) result[k] = table.quantize(pitch[k]);
+                        }
+                    } else {
+                        // Map to 48 slots (2 octaves × 24 half-semitone slots)
+                        // pitch * 12 = semitones, * 2 = half-semitone slots
+                        float_4 slotF = simd::floor(pitch * 24.f);
+                        float_4 blockF = simd::floor(slotF / 48.f);
+                        float_4 slotInBlock = slotF - blockF * 48.f;
+
+                        for (int k = 0; k < 4; k++) {
+                            if (!(changed & (1 << k)) || c + k >= ch) continue;
+                            int slot = clamp((int)slotInBlock[k], 0, 47);
+                            float blockVolts = blockF[k] * 2.f;
+                            lastNoteIdx[t][c + k] = (int8_t)eucMod(slotSemitone[slot], 24);
+
+                            // Direction detection & microtune
+                            float qNoteSemitone = blockF[k] * 24.f + (float)slotSemitone[slot];
+                            if (hasDirectional) {
+                                float diff = qNoteSemitone - lastNote[t][c + k];
+                                if (diff > 0.5f) ascending[t][c + k] = true;
+                                else if (diff < -0.5f) ascending[t][c + k] = false;
+                                result[k] = blockVolts + (ascending[t][c + k] ? slotAscVolts[slot] : slotDescVolts[slot]);
+                            } else {
+                                result[k] = blockVolts + slotVolts[slot];
+                            }
+                            lastNote[t][c + k] = qNoteSemitone;
+                        }
+                    }
+
+                    // 超出聲部數的通道不快取，聲部數增加時重新計算
+                    for (int k = 0; k < 4; k++) {
+                        if (c + k >= ch) pitch[k] = NAN;
+                    }
+                    lastPitch[t][g] = pitch;
+                    lastOut[t][g] = result;
                 }
-                lastNote[t][c] = (float)qNoteSemitone;
 
-                // Output: 1V/octave = 12 semitones per volt
-                outputs[PITCH_OUTPUT + t].setVoltage((float)qNoteSemitone / 12.f + mt / 1200.f, c);
+                out.setVoltageSimd(lastOut[t][g], c);
+            }
+            out.setChannels(ch);
+        }
+
+        // 音符顯示只在控制率更新
+        if (controlTick) {
+            bool playing[24] = {};
+            if (!scalaActive) {
+                for (int t = 0; t < 3; t++) {
+                    int ch = std::max(inputs[PITCH_INPUT + t].getChannels(), 1);
+                    for (int c = 0; c < ch; c++) {
+                        if (lastNoteIdx[t][c] >= 0) playing[lastNoteIdx[t][c]] = true;
+                    }
+                }
             }
-            outputs[PITCH_OUTPUT + t].setChannels(ch);
+            std::memcpy(playingNotes, playing, sizeof(playing));
         }
-        std::memcpy(playingNotes, playing, sizeof(playing));
     }
 
     void updateRanges() {
@@ -274,6 +497,18 @@ struct Quantizer : Module {
         }
         json_object_set_new(rootJ, "ascCents", ascJ);
         json_object_set_new(rootJ, "descCents", descJ);
+
+        // 音階檔內容直接存進 patch，換電腦也能載入
+        std::lock_guard<std::mutex> lock(scalaMutex);
+        if (!sclText.empty()) {
+            json_object_set_new(rootJ, "scalaEnabled", json_boolean(scalaEnabled));
+            json_object_set_new(rootJ, "sclText", json_string(sclText.c_str()));
+            json_object_set_new(rootJ, "sclName", json_string(sclName.c_str()));
+            if (!kbmText.empty()) {
+                json_object_set_new(rootJ, "kbmText", json_string(kbmText.c_str()));
+                json_object_set_new(rootJ, "kbmName", json_string(kbmName.c_str()));
+            }
+        }
         return rootJ;
     }
 
@@ -322,6 +557,26 @@ struct Quantizer : Module {
                 if (json_t* n = json_array_get(descJ, i)) descCents[i] = json_real_value(n);
         }
 
+        json_t* sclJ = json_object_get(rootJ, "sclText");
+        if (sclJ) {
+            {
+                std::lock_guard<std::mutex> lock(scalaMutex);
+                sclText = json_string_value(sclJ);
+                json_t* sclNameJ = json_object_get(rootJ, "sclName");
+                sclName = sclNameJ ? json_string_value(sclNameJ) : "";
+                json_t* kbmJ = json_object_get(rootJ, "kbmText");
+                kbmText = kbmJ ? json_string_value(kbmJ) : "";
+                json_t* kbmNameJ = json_object_get(rootJ, "kbmName");
+                kbmName = kbmNameJ ? json_string_value(kbmNameJ) : "";
+            }
+            json_t* enabledJ = json_object_get(rootJ, "scalaEnabled");
+            scalaEnabled = enabledJ ? json_boolean_value(enabledJ) : true;
+            compileScalaAsync();
+        } else {
+            // 存檔沒有 Scala 資料：不能沿用先前載入的音階
+            clearScala();
+        }
+
         updateRanges();
     }
 };
@@ -508,6 +763,7 @@ struct QuantizerWidget : ModuleWidget {
     PanelThemeHelper panelThemeHelper;
     madzine::widgets::MediumGrayKnob* scaleKnob = nullptr;
     madzine::widgets::MediumGrayKnob* offsetKnob = nullptr;
+    madzine::widgets::CVModRingSync<Quantizer::NUM_CVMODS> cvModSync;
 
     QuantizerWidget(Quantizer* module) {
         setModule(module);
@@ -530,6 +786,8 @@ struct QuantizerWidget : ModuleWidget {
         offsetKnob = createParamCentered<madzine::widgets::MediumGrayKnob>(Vec(45, 52), module, Quantizer::OFFSET_PARAM);
         addParam(offsetKnob);
         addInput(createInputCentered<PJ301MPort>(Vec(45, 76), module, Quantizer::OFFSET_CV_INPUT));
+        cvModSync.bind(Quantizer::CVMOD_SCALE, scaleKnob);
+        cvModSync.bind(Quantizer::CVMOD_OFFSET, offsetKnob);
 
         // Note rows (Y: 88-328, 24 rows, ~10px each)
         // Order: B2, A#2, A2, ... C2, B1, A#1, ... C1 (top to bottom)
@@ -571,17 +829,8 @@ struct QuantizerWidget : ModuleWidget {
         if (auto* m = dynamic_cast<Quantizer*>(module)) {
             panelThemeHelper.step(m);
 
-            // 更新 CV 調變顯示
-            auto updateKnob = [&](madzine::widgets::MediumGrayKnob* knob, int inputId, float cvMod) {
-                if (knob) {
-                    bool connected = m->inputs[inputId].isConnected();
-                    knob->setModulationEnabled(connected);
-                    if (connected) knob->setModulation(cvMod);
-                }
-            };
-
-            updateKnob(scaleKnob, Quantizer::SCALE_CV_INPUT, m->scaleCvMod);
-            updateKnob(offsetKnob, Quantizer::OFFSET_CV_INPUT, m->offsetCvMod);
+            // 更新 CV 調變顯示（僅在數值變化時）
+            cvModSync.sync(m->cvMods);
         }
         ModuleWidget::step();
     }
@@ -631,6 +880,37 @@ struct QuantizerWidget : ModuleWidget {
                 sub->addChild(createMenuItem(dirNames[i], "", [=]() { m->applyDirectional(i); m->currentPreset = 100 + i; }));
         }));
 
+        // Scala Tuning
+        std::string sclName, kbmName, status;
+        {
+            std::lock_guard<std::mutex> lock(m->scalaMutex);
+            sclName = m->sclName;
+            kbmName = m->kbmName;
+            status = m->scalaStatus;
+        }
+        menu->addChild(createSubmenuItem("Scala Tuning", m->scalaEnabled && m->scalaReady ? "On" : "", [=](Menu* sub) {
+            sub->addChild(createMenuLabel(status));
+            sub->addChild(createMenuItem("Load .scl scale...", sclName, [=]() {
+                char* path = osdialog_file(OSDIALOG_OPEN, NULL, NULL, osdialog_filters_parse("Scala scale:scl"));
+                if (!path) return;
+                m->loadScalaFile(std::string(path), false);
+                OSDIALOG_FREE(path);
+            }));
+            sub->addChild(createMenuItem("Load .kbm keyboard mapping...", kbmName, [=]() {
+                char* path = osdialog_file(OSDIALOG_OPEN, NULL, NULL, osdialog_filters_parse("Scala keyboard mapping:kbm"));
+                if (!path) return;
+                m->loadScalaFile(std::string(path), true);
+                OSDIALOG_FREE(path);
+            }));
+            if (!kbmName.empty())
+                sub->addChild(createMenuItem("Clear keyboard mapping", "", [=]() { m->clearKeyboardMap(); }));
+            sub->addChild(new MenuSeparator);
+            sub->addChild(createCheckMenuItem("Use Scala tuning", "",
+                [=]() { return m->scalaEnabled.load(); },
+                [=]() { m->scalaEnabled = !m->scalaEnabled; },
+                !m->scalaReady));
+        }));
+
         addPanelThemeMenu(menu, m);
     }
 };
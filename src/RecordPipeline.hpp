@@ -0,0 +1,314 @@
+#pragma once
+#include "plugin.hpp"
+#include "BackgroundWorker.hpp"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <vector>
+
+// ============================================================
+// RecordPipeline - Launchpad / weiiidocumenta 共用的背景錄音管線
+// ============================================================
+
+/**
+ * 音訊執行緒只把樣本追加到預先配置的無鎖環形緩衝（SPSC），
+ * 共用的 BackgroundWorker 把整段樣本搬進目的儲存並更新峰值索引。
+ * 開始 / 停止錄音只是在事件佇列放一筆記錄，與緩衝大小無關，永遠是常數時間。
+ *
+ * 事件記錄的是當時已寫入的樣本數，背景端依此切分，
+ * 因此開始 / 停止精確落在觸發的那個樣本上。
+ *
+ * 事件佇列永遠為開啟中的錄音段保留一格：begin() 在空位不足時拒絕，
+ * 因此結束該錄音段的 end() / release() 不會因佇列已滿而遺失。
+ */
+template <int CHANNELS>
+struct RecordPipeline : madzine::BackgroundTask {
+    static constexpr uint32_t CAPACITY = 1 << 16;  // 樣本框數（48kHz 約 1.3 秒）
+    static constexpr uint32_t MASK = CAPACITY - 1;
+    static constexpr size_t EVENT_SLOTS = 32;
+
+    /** 背景執行緒回呼，target 為呼叫端自訂的目的編號 */
+    struct Callbacks {
+        // 新錄音開始：準備目的儲存（可配置記憶體）
+        std::function<void(int target, int startFrame)> begin;
+        // 一段連續樣本（交錯排列）寫入目的儲存的 frame 位置
+        std::function<void(int target, int frame, const float* samples, int frames)> commit;
+        // 錄音結束，totalFrames 為目的儲存中的總長度
+        std::function<void(int target, int totalFrames)> end;
+        // 釋放目的儲存（清除錄音時）
+        std::function<void(int target)> release;
+    };
+
+    enum EventType {
+        EVENT_BEGIN,
+        EVENT_END,
+        EVENT_RELEASE
+    };
+
+    struct Event {
+        EventType type = EVENT_BEGIN;
+        int target = -1;
+        int startFrame = 0;
+        uint32_t position = 0;  // 事件發生時已寫入的樣本框數
+    };
+
+    std::vector<float> ring;
+    std::atomic<uint32_t> writeIndex{0};
+    std::atomic<uint32_t> readIndex{0};
+    dsp::RingBuffer<Event, EVENT_SLOTS> events;
+
+    // 已寫入目的儲存的長度（背景執行緒更新；音訊執行緒請用 committed()）
+    std::atomic<int> committedFrames{0};
+    // begin / release 的送出與套用次數，兩者相同時 committedFrames 才屬於目前的錄音段
+    uint32_t postedResets = 0;
+    int postedFrames = 0;
+    std::atomic<uint32_t> appliedResets{0};
+    // 尚未搬完的錄音段數（begin 時 +1，背景端處理完 end 時 -1）
+    std::atomic<int> openSessions{0};
+    // 錄音段編號：音訊端 begin 時遞增，背景端搬完一段時遞增
+    uint32_t postedSessions = 0;
+    std::atomic<uint32_t> finishedSessions{0};
+    // 音訊端：已 begin 尚未 end / release 的錄音段（佇列為它保留一格）
+    bool postedOpen = false;
+    int postedTarget = -1;
+
+    Callbacks callbacks;
+    std::atomic<bool> running{false};
+
+    RecordPipeline() {
+        ring.resize(CAPACITY * CHANNELS, 0.0f);
+    }
+
+    ~RecordPipeline() {
+        stop();
+    }
+
+    void start(const Callbacks& cb) {
+        callbacks = cb;
+        running = true;
+        madzine::BackgroundWorker::instance().add(this);
+    }
+
+    void stop() {
+        if (!running.exchange(false)) return;
+        madzine::BackgroundWorker::instance().remove(this);
+        // 已從共用執行緒移除，剩餘樣本在呼叫端搬完
+        pump();
+    }
+
+    // ---- 音訊執行緒 ----
+
+    /**
+     * 開始錄到 target，startFrame 為目的儲存的起始位置（接續錄音時不為 0）
+     * 佇列放不下這筆事件與它保留的結束事件時回傳 false（背景端卡住），不開始錄音
+     */
+    bool begin(int target, int startFrame = 0) {
+        if (freeEvents() < 2) return false;
+        Event e;
+        e.type = EVENT_BEGIN;
+        e.target = target;
+        e.startFrame = startFrame;
+        e.position = writeIndex.load(std::memory_order_relaxed);
+        postedResets++;
+        postedFrames = startFrame;
+        postedSessions++;
+        openSessions++;
+        postedOpen = true;
+        postedTarget = target;
+        events.push(e);
+        return true;
+    }
+
+    /** 最近一次 begin() 的錄音段編號 */
+    uint32_t session() const {
+        return postedSessions;
+    }
+
+    /**
+     * 指定錄音段是否已完整搬進目的儲存（含 end() 之前的尾端樣本）
+     */
+    bool finished(uint32_t id) const {
+        return (int32_t)(finishedSessions.load(std::memory_order_acquire) - id) >= 0;
+    }
+
+    /**
+     * 結束目前的錄音段；使用 begin() 保留的空位，一定送得出去
+     * 沒有開啟中的錄音段時不送出事件
+     */
+    void end() {
+        if (!postedOpen) return;
+        Event e;
+        e.type = EVENT_END;
+        e.position = writeIndex.load(std::memory_order_relaxed);
+        postedOpen = false;
+        events.push(e);
+    }
+
+    /**
+     * 請背景端釋放 target 的目的儲存（呼叫前音訊執行緒必須已停止讀取該儲存）
+     * 釋放開啟中的錄音段時使用保留的空位，一定成功；
+     * 其他情況佇列已滿時回傳 false，呼叫端下一個 block 再送
+     */
+    bool release(int target) {
+        bool closesSession = postedOpen && target == postedTarget;
+        if (!closesSession && freeEvents() < (postedOpen ? 2u : 1u)) return false;
+        Event e;
+        e.type = EVENT_RELEASE;
+        e.target = target;
+        e.position = writeIndex.load(std::memory_order_relaxed);
+        postedResets++;
+        postedFrames = 0;
+        if (closesSession) postedOpen = false;
+        events.push(e);
+        return true;
+    }
+
+    /**
+     * 目前錄音段已搬進目的儲存的長度；背景端尚未處理最新的 begin / release 時，
+     * 回傳該事件的起點（不會回傳舊錄音段的長度）
+     */
+    int committed() const {
+        if (appliedResets.load(std::memory_order_acquire) != postedResets) return postedFrames;
+        return committedFrames.load(std::memory_order_acquire);
+    }
+
+    /**
+     * 追加一個樣本框；環形緩衝已滿（背景端落後超過 CAPACITY）時回傳 false
+     */
+    bool write(const float* frame) {
+        uint32_t w = writeIndex.load(std::memory_order_relaxed);
+        if (w - readIndex.load(std::memory_order_acquire) >= CAPACITY) return false;
+        float* dst = &ring[(w & MASK) * CHANNELS];
+        for (int c = 0; c < CHANNELS; c++) {
+            dst[c] = frame[c];
+        }
+        writeIndex.store(w + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * 所有已開始的錄音是否都已搬進目的儲存
+     */
+    bool idle() const {
+        return openSessions.load(std::memory_order_acquire) == 0;
+    }
+
+    /**
+     * 結束目前的錄音並等背景端搬完（載入資料前呼叫，避免舊樣本覆寫新資料）
+     * 背景端卡住時最多等 timeoutMs，逾時回傳 false
+     */
+    bool flush(int timeoutMs = 500) {
+        end();
+        return wait(timeoutMs);
+    }
+
+    /**
+     * 只等背景端搬完已結束的錄音段，不送出事件（呼叫端已在音訊執行緒 end()）
+     */
+    bool wait(int timeoutMs = 500) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+        while (running && !idle()) {
+            if (std::chrono::steady_clock::now() >= deadline) return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return idle();
+    }
+
+    // 共用背景執行緒呼叫；錄音中回傳 true 讓下一輪提早輪詢
+    bool service() override {
+        pump();
+        return !idle();
+    }
+
+private:
+    size_t freeEvents() const {
+        return EVENT_SLOTS - events.size();
+    }
+
+    // ---- 背景執行緒 ----
+
+    int target = -1;
+    int targetFrame = 0;
+    Event pending;
+    bool hasPending = false;
+
+    void pump() {
+        uint32_t r = readIndex.load(std::memory_order_relaxed);
+        uint32_t w = writeIndex.load(std::memory_order_acquire);
+
+        while (true) {
+            if (!hasPending && !events.empty()) {
+                pending = events.shift();
+                hasPending = true;
+            }
+
+            // 事件所在位置之前的樣本先搬完
+            uint32_t limit = w;
+            if (hasPending && (pending.position - r) <= (w - r)) {
+                limit = pending.position;
+            }
+
+            if (limit != r) {
+                uint32_t frames = limit - r;
+                uint32_t offset = r & MASK;
+                uint32_t first = std::min(frames, CAPACITY - offset);
+                commitSpan(&ring[offset * CHANNELS], first);
+                if (frames > first) {
+                    commitSpan(&ring[0], frames - first);
+                }
+                r = limit;
+                readIndex.store(r, std::memory_order_release);
+                continue;
+            }
+
+            if (hasPending && pending.position == r) {
+                applyEvent(pending);
+                hasPending = false;
+                continue;
+            }
+            break;
+        }
+    }
+
+    void commitSpan(const float* samples, uint32_t frames) {
+        if (target < 0) return;  // 不在錄音段中的樣本直接丟棄
+        if (callbacks.commit) {
+            callbacks.commit(target, targetFrame, samples, (int)frames);
+        }
+        targetFrame += frames;
+        committedFrames.store(targetFrame, std::memory_order_release);
+    }
+
+    void applyEvent(const Event& e) {
+        if (e.type == EVENT_BEGIN) {
+            finishTarget();
+            target = e.target;
+            targetFrame = e.startFrame;
+            committedFrames.store(targetFrame, std::memory_order_release);
+            if (callbacks.begin) {
+                callbacks.begin(target, targetFrame);
+            }
+            appliedResets++;
+        } else if (e.type == EVENT_END) {
+            finishTarget();
+        } else {
+            if (e.target == target) finishTarget();
+            if (callbacks.release) {
+                callbacks.release(e.target);
+            }
+            committedFrames.store(0, std::memory_order_release);
+            appliedResets++;
+        }
+    }
+
+    void finishTarget() {
+        if (target < 0) return;
+        if (callbacks.end) {
+            callbacks.end(target, targetFrame);
+        }
+        target = -1;
+        openSessions--;
+        finishedSessions.fetch_add(1, std::memory_order_release);
+    }
+};
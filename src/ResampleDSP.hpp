@@ -0,0 +1,139 @@
+#pragma once
+#include "plugin.hpp"
+#include <vector>
+
+// ============================================================
+// ResampleDSP - weiiidocumenta / Launchpad 共用的變速播放插值
+// ============================================================
+
+enum ResampleMode {
+    RESAMPLE_LINEAR,
+    RESAMPLE_HERMITE,
+    RESAMPLE_SINC,
+    RESAMPLE_MODES_LEN
+};
+
+inline const char* resampleModeName(int mode) {
+    static const char* names[RESAMPLE_MODES_LEN] = {"Linear", "Hermite", "Sinc"};
+    return names[clamp(mode, 0, RESAMPLE_MODES_LEN - 1)];
+}
+
+/**
+ * 多相位窗函數 sinc 表
+ * 依播放速度分成 4 個頻帶（≤1x、≤2x、≤4x、≤8x），截止頻率隨速度降低、
+ * 點數隨之加倍，高速播放時先濾掉會摺疊的高頻。
+ * 每個相位的係數連續排列並正規化為 DC 增益 1。
+ */
+struct SincTable {
+    static constexpr int BANDS = 4;
+    static constexpr int BASE_TAPS = 8;
+    static constexpr int PHASES = 256;
+
+    std::vector<float> coeffs[BANDS];
+
+    SincTable() {
+        for (int band = 0; band < BANDS; band++) {
+            int taps = BASE_TAPS << band;
+            int half = taps / 2;
+            float cutoff = 0.9f / (float)(1 << band);
+            coeffs[band].resize(PHASES * taps);
+
+            for (int p = 0; p < PHASES; p++) {
+                float t = (float)p / PHASES;
+                float* row = &coeffs[band][p * taps];
+                float sum = 0.0f;
+                for (int k = 0; k < taps; k++) {
+                    // 第 k 個係數對應樣本 index - half + 1 + k
+                    float d = (float)(k - half + 1) - t;
+                    float x = float(M_PI) * cutoff * d;
+                    float sinc = (std::abs(x) < 1e-6f) ? 1.0f : std::sin(x) / x;
+                    float w = d / half;
+                    float window = (std::abs(w) >= 1.0f) ? 0.0f
+                        : 0.42f + 0.5f * std::cos(float(M_PI) * w) + 0.08f * std::cos(2.0f * float(M_PI) * w);
+                    row[k] = sinc * window;
+                    sum += row[k];
+                }
+                for (int k = 0; k < taps; k++) {
+                    row[k] /= sum;
+                }
+            }
+        }
+    }
+
+    static const SincTable& get() {
+        static const SincTable table;
+        return table;
+    }
+
+    static int bandForSpeed(float absSpeed) {
+        if (absSpeed <= 1.0f) return 0;
+        if (absSpeed <= 2.0f) return 1;
+        if (absSpeed <= 4.0f) return 2;
+        return 3;
+    }
+};
+
+/**
+ * 從 first 開始讀 count 個樣本，超出 [0, length) 時繞回另一端
+ * 只在區段邊界做加減，不使用取餘數
+ */
+template <typename Fetch>
+inline void gatherWrapped(Fetch&& fetch, int length, int first, int count, float* dst) {
+    int i = first;
+    while (i < 0) i += length;
+    while (i >= length) i -= length;
+    if (i + count <= length) {
+        for (int k = 0; k < count; k++) {
+            dst[k] = fetch(i + k);
+        }
+        return;
+    }
+    for (int k = 0; k < count; k++) {
+        dst[k] = fetch(i);
+        if (++i == length) i = 0;
+    }
+}
+
+inline float hermite4(float xm1, float x0, float x1, float x2, float t) {
+    float c1 = 0.5f * (x1 - xm1);
+    float c2 = xm1 - 2.5f * x0 + 2.0f * x1 - 0.5f * x2;
+    float c3 = 0.5f * (x2 - xm1) + 1.5f * (x0 - x1);
+    return ((c3 * t + c2) * t + c1) * t + x0;
+}
+
+/**
+ * 讀取位置 index + frac（0 <= frac < 1）的插值結果，樣本在 [0, length) 內循環
+ * @param fetch 回傳 [0, length) 內第 i 個樣本
+ * @param absSpeed 播放速度絕對值，sinc 模式用來選擇頻帶
+ */
+template <typename Fetch>
+inline float resampleRead(int mode, Fetch&& fetch, int length, int index, float frac, float absSpeed) {
+    if (length <= 0) return 0.0f;
+
+    if (mode == RESAMPLE_LINEAR) {
+        float x[2];
+        gatherWrapped(fetch, length, index, 2, x);
+        return x[0] + frac * (x[1] - x[0]);
+    }
+
+    if (mode == RESAMPLE_HERMITE) {
+        float x[4];
+        gatherWrapped(fetch, length, index - 1, 4, x);
+        return hermite4(x[0], x[1], x[2], x[3], frac);
+    }
+
+    const SincTable& table = SincTable::get();
+    int band = SincTable::bandForSpeed(absSpeed);
+    int taps = SincTable::BASE_TAPS << band;
+    int phase = std::min((int)(frac * SincTable::PHASES), SincTable::PHASES - 1);
+    const float* row = &table.coeffs[band][phase * taps];
+
+    float x[SincTable::BASE_TAPS << (SincTable::BANDS - 1)];
+    gatherWrapped(fetch, length, index - taps / 2 + 1, taps, x);
+
+    simd::float_4 acc = 0.0f;
+    for (int k = 0; k < taps; k += 4) {
+        acc += simd::float_4::load(&x[k]) * simd::float_4::load(&row[k]);
+    }
+    return acc[0] + acc[1] + acc[2] + acc[3];
+}
@@ -1,5 +1,8 @@
 #pragma once
 #include "plugin.hpp"
+#include "BackgroundWorker.hpp"
+#include <atomic>
+#include <vector>
 
 // ============================================================
 // ChaosGenerator - Lorenz Attractor 混沌系統
@@ -189,29 +192,64 @@ struct ReverbProcessor {
 };
 
 // ============================================================
-// GrainProcessor - 16 Grains 粒子處理器
+// GrainWindowTable - 預先計算的 Hann 視窗
+// ============================================================
+struct GrainWindowTable {
+    static constexpr int SIZE = 1024;
+    float table[SIZE + 1];
+
+    GrainWindowTable() {
+        for (int i = 0; i <= SIZE; i++) {
+            table[i] = 0.5f * (1.0f - std::cos(2.0f * (float)M_PI * i / SIZE));
+        }
+    }
+
+    static const GrainWindowTable& get() {
+        static const GrainWindowTable instance;
+        return instance;
+    }
+
+    // phase: 0 ~ 1
+    float lookup(float phase) const {
+        float index = phase * SIZE;
+        int i = (int)index;
+        float frac = index - i;
+        return table[i] + (table[i + 1] - table[i]) * frac;
+    }
+};
+
+// ============================================================
+// GrainProcessor - 64 Grains 粒子處理器
 // 從 EllenRipley.cpp 提取
+// Grain 以 structure-of-arrays 儲存，每次以 float_4 處理 4 個 grain；
+// 讀取使用 4 點 Hermite 內插，視窗查表取代逐樣本 cos()。
 // ============================================================
 struct GrainProcessor {
-    static constexpr int GRAIN_BUFFER_SIZE = 8192;
+    static constexpr int GRAIN_BUFFER_SIZE = 8192;  // 2 的次方，以位元遮罩取代取餘數
+    static constexpr int GRAIN_BUFFER_MASK = GRAIN_BUFFER_SIZE - 1;
     float grainBuffer[GRAIN_BUFFER_SIZE];
     int grainWriteIndex = 0;
 
-    struct Grain {
-        bool active = false;
-        float position = 0.0f;
-        float size = 0.0f;
-        float envelope = 0.0f;
-        float direction = 1.0f;
-        float pitch = 1.0f;
-    };
-
-    static constexpr int MAX_GRAINS = 16;
-    Grain grains[MAX_GRAINS];
+    static constexpr int MAX_GRAINS = 64;
+    alignas(16) float grainActive[MAX_GRAINS];     // 1.0 = active, 0.0 = free
+    alignas(16) float grainPosition[MAX_GRAINS];   // 讀取位置（含小數）
+    alignas(16) float grainIncrement[MAX_GRAINS];  // direction * pitch
+    alignas(16) float grainEnvPhase[MAX_GRAINS];   // 0 ~ 1
+    alignas(16) float grainEnvIncrement[MAX_GRAINS];
+    int grainGroups = 0;  // 需處理的 4-grain 組數（最高使用中 grain 所在組 + 1）
 
     float phase = 0.0f;
+    uint32_t rngState = 1;
 
-    GrainProcessor() { reset(); }
+    GrainProcessor() {
+        seed(random::u32());
+        reset();
+    }
+
+    // 同一聲道的左右處理器需給不同種子，否則兩邊 grain 完全同步
+    void seed(uint32_t s) {
+        rngState = s | 1u;  // xorshift 狀態不可為 0
+    }
 
     void reset() {
         for (int i = 0; i < GRAIN_BUFFER_SIZE; i++) {
@@ -220,16 +258,72 @@ struct GrainProcessor {
         grainWriteIndex = 0;
 
         for (int i = 0; i < MAX_GRAINS; i++) {
-            grains[i].active = false;
+            grainActive[i] = 0.0f;
+            grainPosition[i] = 0.0f;
+            grainIncrement[i] = 1.0f;
+            grainEnvPhase[i] = 0.0f;
+            grainEnvIncrement[i] = 0.0f;
         }
+        grainGroups = 0;
         phase = 0.0f;
     }
 
+    // xorshift32，觸發路徑不呼叫共用的 random::uniform()
+    float nextRandom() {
+        rngState ^= rngState << 13;
+        rngState ^= rngState >> 17;
+        rngState ^= rngState << 5;
+        return (rngState >> 8) * (1.0f / 16777216.0f);
+    }
+
+    float readHermite(float position) const {
+        int i = (int)position;
+        float t = position - i;
+        float y0 = grainBuffer[(i - 1) & GRAIN_BUFFER_MASK];
+        float y1 = grainBuffer[i & GRAIN_BUFFER_MASK];
+        float y2 = grainBuffer[(i + 1) & GRAIN_BUFFER_MASK];
+        float y3 = grainBuffer[(i + 2) & GRAIN_BUFFER_MASK];
+        float c1 = 0.5f * (y2 - y0);
+        float c2 = y0 - 2.5f * y1 + 2.0f * y2 - 0.5f * y3;
+        float c3 = 0.5f * (y3 - y0) + 1.5f * (y1 - y2);
+        return ((c3 * t + c2) * t + c1) * t + y1;
+    }
+
+    void triggerGrain(float grainSamples, float position, float densityValue,
+                      bool chaosEnabled, float chaosOutput) {
+        for (int i = 0; i < MAX_GRAINS; i++) {
+            if (grainActive[i] != 0.0f) continue;
+
+            float direction = 1.0f;
+            float pitch = 1.0f;
+            float pos = position;
+            if (chaosEnabled) {
+                pos += chaosOutput * 20.0f;
+                if (nextRandom() < 0.3f) {
+                    direction = -1.0f;
+                }
+                if (densityValue > 0.7f && nextRandom() < 0.2f) {
+                    pitch = nextRandom() < 0.5f ? 0.5f : 2.0f;
+                }
+            }
+
+            pos = clamp(pos, 0.0f, 1.0f);
+            grainActive[i] = 1.0f;
+            grainPosition[i] = std::min(pos * GRAIN_BUFFER_SIZE, (float)GRAIN_BUFFER_SIZE - 1.0f);
+            grainIncrement[i] = direction * pitch;
+            grainEnvPhase[i] = 0.0f;
+            grainEnvIncrement[i] = 1.0f / grainSamples;
+            grainGroups = std::max(grainGroups, i / 4 + 1);
+            break;
+        }
+    }
+
     float process(float input, float grainSize, float density, float position,
                   bool chaosEnabled, float chaosOutput, float sampleRate) {
+        using simd::float_4;
 
         grainBuffer[grainWriteIndex] = input;
-        grainWriteIndex = (grainWriteIndex + 1) % GRAIN_BUFFER_SIZE;
+        grainWriteIndex = (grainWriteIndex + 1) & GRAIN_BUFFER_MASK;
 
         float grainSizeMs = grainSize * 99.0f + 1.0f;
         float grainSamples = (grainSizeMs / 1000.0f) * sampleRate;
@@ -245,77 +339,218 @@ struct GrainProcessor {
 
         if (phase >= 1.0f) {
             phase -= 1.0f;
+            triggerGrain(grainSamples, position, densityValue, chaosEnabled, chaosOutput);
+        }
 
-            for (int i = 0; i < MAX_GRAINS; i++) {
-                if (!grains[i].active) {
-                    grains[i].active = true;
-                    grains[i].size = grainSamples;
-                    grains[i].envelope = 0.0f;
-
-                    float pos = position;
-                    if (chaosEnabled) {
-                        pos += chaosOutput * 20.0f;
-                        if (random::uniform() < 0.3f) {
-                            grains[i].direction = -1.0f;
-                        } else {
-                            grains[i].direction = 1.0f;
-                        }
-
-                        if (densityValue > 0.7f && random::uniform() < 0.2f) {
-                            grains[i].pitch = random::uniform() < 0.5f ? 0.5f : 2.0f;
-                        } else {
-                            grains[i].pitch = 1.0f;
-                        }
-                    } else {
-                        grains[i].direction = 1.0f;
-                        grains[i].pitch = 1.0f;
-                    }
-
-                    pos = clamp(pos, 0.0f, 1.0f);
-                    grains[i].position = pos * GRAIN_BUFFER_SIZE;
-                    break;
+        const GrainWindowTable& window = GrainWindowTable::get();
+        const float_4 bufferSize(GRAIN_BUFFER_SIZE);
+        float_4 sum = 0.0f;
+        float_4 count = 0.0f;
+        int lastActiveGroup = -1;
+
+        for (int g = 0; g < grainGroups; g++) {
+            int base = g * 4;
+            float_4 active = float_4::load(&grainActive[base]);
+            if (simd::movemask(active != 0.0f) == 0) continue;
+
+            // 查表與內插讀取需逐 grain 取址，其餘運算以 float_4 進行
+            alignas(16) float env[4];
+            alignas(16) float sample[4];
+            for (int k = 0; k < 4; k++) {
+                int i = base + k;
+                if (grainActive[i] != 0.0f) {
+                    env[k] = window.lookup(grainEnvPhase[i]);
+                    sample[k] = readHermite(grainPosition[i]);
+                } else {
+                    env[k] = 0.0f;
+                    sample[k] = 0.0f;
                 }
             }
+            sum += float_4::load(sample) * float_4::load(env);
+            count += active;
+
+            float_4 pos = float_4::load(&grainPosition[base]) + float_4::load(&grainIncrement[base]);
+            pos = simd::ifelse(pos >= bufferSize, pos - bufferSize, pos);
+            pos = simd::ifelse(pos < 0.0f, pos + bufferSize, pos);
+            pos.store(&grainPosition[base]);
+
+            float_4 envPhase = float_4::load(&grainEnvPhase[base]) + float_4::load(&grainEnvIncrement[base]);
+            envPhase.store(&grainEnvPhase[base]);
+            active = simd::ifelse(envPhase >= 1.0f, float_4(0.0f), active);
+            active.store(&grainActive[base]);
+
+            if (simd::movemask(active != 0.0f) != 0) lastActiveGroup = g;
         }
+        grainGroups = lastActiveGroup + 1;
 
-        float output = 0.0f;
-        int activeGrains = 0;
+        float output = sum[0] + sum[1] + sum[2] + sum[3];
+        int activeGrains = (int)(count[0] + count[1] + count[2] + count[3]);
 
-        for (int i = 0; i < MAX_GRAINS; i++) {
-            if (grains[i].active) {
-                float envPhase = grains[i].envelope / grains[i].size;
+        if (activeGrains > 0) {
+            output /= std::sqrt((float)activeGrains);
+        }
 
-                if (envPhase >= 1.0f) {
-                    grains[i].active = false;
-                    continue;
-                }
+        return output;
+    }
+};
 
-                float env = 0.5f * (1.0f - cos(envPhase * 2.0f * M_PI));
+// ============================================================
+// RipleyDelayLine - 立體聲延遲線
+// 長度依取樣率 × 最大延遲時間配置，不再固定 96000 samples
+// ============================================================
+struct RipleyDelayLine {
+    static constexpr float MAX_DELAY_SECONDS = 2.0f;
+
+    std::vector<float> left;
+    std::vector<float> right;
+    int size = 0;
+    int writeIndex = 0;
+
+    explicit RipleyDelayLine(float sampleRate) {
+        size = (int)std::ceil(sampleRate * MAX_DELAY_SECONDS) + 1;
+        left.assign(size, 0.0f);
+        right.assign(size, 0.0f);
+    }
 
-                int readPos = (int)grains[i].position;
-                readPos = ((readPos % GRAIN_BUFFER_SIZE) + GRAIN_BUFFER_SIZE) % GRAIN_BUFFER_SIZE;
+    void reset() {
+        std::fill(left.begin(), left.end(), 0.0f);
+        std::fill(right.begin(), right.end(), 0.0f);
+        writeIndex = 0;
+    }
 
-                float sample = grainBuffer[readPos];
-                output += sample * env;
+    int readIndex(int delaySamples) const {
+        int index = writeIndex - delaySamples;
+        return index < 0 ? index + size : index;
+    }
 
-                grains[i].position += grains[i].direction * grains[i].pitch;
+    void write(float l, float r) {
+        left[writeIndex] = l;
+        right[writeIndex] = r;
+        if (++writeIndex >= size) writeIndex = 0;
+    }
+};
 
-                while (grains[i].position >= GRAIN_BUFFER_SIZE) {
-                    grains[i].position -= GRAIN_BUFFER_SIZE;
-                }
-                while (grains[i].position < 0) {
-                    grains[i].position += GRAIN_BUFFER_SIZE;
-                }
+// ============================================================
+// LazyChannelPool - 多聲道狀態按需配置
+// 音訊執行緒只交換指標並設定請求旗標；配置與釋放由所有實例共用的
+// BackgroundWorker 輪詢完成，音訊執行緒不做任何喚醒。
+// TChannel 需提供 TChannel(float sampleRate) 建構子與 sampleRate 成員。
+// ============================================================
+template <typename TChannel, int MAX_CHANNELS = 16>
+struct LazyChannelPool : madzine::BackgroundTask {
+    std::atomic<TChannel*> active[MAX_CHANNELS];
+    std::atomic<TChannel*> retired[MAX_CHANNELS];
+    std::atomic<int> wantedChannels{1};
+    std::atomic<float> wantedSampleRate{0.0f};
+    std::atomic<bool> dirty{false};
+
+    // 僅音訊執行緒使用
+    int audioChannels = 0;
+    float audioSampleRate = 0.0f;
+    int sweepCounter = 0;
+
+    explicit LazyChannelPool(float sampleRate) {
+        for (int c = 0; c < MAX_CHANNELS; c++) {
+            active[c].store(nullptr);
+            retired[c].store(nullptr);
+        }
+        // 第一個聲道同步配置，單聲道使用不需等待背景執行緒
+        active[0].store(new TChannel(sampleRate));
+        wantedSampleRate.store(sampleRate);
+        audioSampleRate = sampleRate;
+        audioChannels = 1;
+        madzine::BackgroundWorker::instance().add(this);
+    }
 
-                grains[i].envelope += 1.0f;
-                activeGrains++;
-            }
+    ~LazyChannelPool() {
+        madzine::BackgroundWorker::instance().remove(this);
+        for (int c = 0; c < MAX_CHANNELS; c++) {
+            delete active[c].exchange(nullptr);
+            delete retired[c].exchange(nullptr);
         }
+    }
 
-        if (activeGrains > 0) {
-            output /= sqrt(activeGrains);
+    /**
+     * 音訊執行緒：宣告目前使用的聲道數與取樣率
+     * 變化時釋放多餘聲道並設定請求旗標
+     */
+    void update(int channels, float sampleRate) {
+        bool changed = false;
+        if (channels != audioChannels) {
+            audioChannels = channels;
+            wantedChannels.store(channels);
+            changed = true;
         }
+        if (sampleRate != audioSampleRate) {
+            audioSampleRate = sampleRate;
+            wantedSampleRate.store(sampleRate);
+            changed = true;
+        }
+        // 定期回收：背景執行緒可能在聲道數下降前剛裝上新聲道
+        bool sweep = ++sweepCounter >= 4096;
+        if (sweep) sweepCounter = 0;
+        if (!changed && !sweep) return;
+
+        bool retiredAny = false;
+        for (int c = audioChannels; c < MAX_CHANNELS; c++) {
+            retiredAny |= retire(c);
+        }
+        if (changed || retiredAny) {
+            dirty.store(true);
+        }
+    }
 
-        return output;
+    /**
+     * 音訊執行緒：取得聲道狀態，尚未配置時回傳 nullptr
+     */
+    TChannel* get(int c) {
+        TChannel* ch = active[c].load();
+        if (ch && ch->sampleRate != audioSampleRate) {
+            // 取樣率改變，舊緩衝長度不符，交給背景執行緒重新配置
+            retire(c);
+            dirty.store(true);
+            return nullptr;
+        }
+        return ch;
+    }
+
+    /**
+     * 對所有已配置聲道執行 fn（非音訊執行緒，需持有 engine 鎖，例如 onReset）
+     */
+    template <typename F>
+    void forEach(F fn) {
+        for (int c = 0; c < MAX_CHANNELS; c++) {
+            if (TChannel* ch = active[c].load()) fn(*ch);
+        }
+    }
+
+private:
+    bool retire(int c) {
+        if (!active[c].load()) return false;
+        // 上一個回收尚未被背景執行緒處理時，保留此聲道到下一輪
+        if (retired[c].load()) return false;
+        retired[c].store(active[c].exchange(nullptr));
+        return true;
+    }
+
+    // 共用背景執行緒：僅在音訊執行緒提出請求時配置 / 釋放
+    bool service() override {
+        if (!dirty.exchange(false)) return false;
+
+        for (int c = 0; c < MAX_CHANNELS; c++) {
+            delete retired[c].exchange(nullptr);
+        }
+
+        int channels = wantedChannels.load();
+        float sampleRate = wantedSampleRate.load();
+        for (int c = 0; c < channels && c < MAX_CHANNELS; c++) {
+            if (active[c].load()) continue;
+            TChannel* ch = new TChannel(sampleRate);
+            TChannel* expected = nullptr;
+            if (!active[c].compare_exchange_strong(expected, ch)) {
+                delete ch;
+            }
+        }
+        return false;
     }
 };
@@ -1,5 +1,6 @@
 #include "plugin.hpp"
 #include "widgets/Knobs.hpp"
+#include "widgets/CVModulation.hpp"
 #include "widgets/PanelTheme.hpp"
 #include "RipleyDSP.hpp"
 
@@ -147,12 +148,16 @@ struct Runner : Module {
         NUM_LIGHTS
     };
 
-    static constexpr int DELAY_BUFFER_SIZE = 96000;
     static constexpr int MAX_POLY = 16;
 
-    float leftDelayBuffer[MAX_POLY][DELAY_BUFFER_SIZE];
-    float rightDelayBuffer[MAX_POLY][DELAY_BUFFER_SIZE];
-    int delayWriteIndex[MAX_POLY];
+    // 每個聲道的延遲線，依實際聲道數與引擎取樣率按需配置
+    struct Channel {
+        float sampleRate;
+        RipleyDelayLine delay;
+
+        explicit Channel(float sr) : sampleRate(sr), delay(sr) {}
+    };
+    LazyChannelPool<Channel, MAX_POLY> channelPool{APP->engine->getSampleRate()};
 
     ChaosGenerator chaosGen[MAX_POLY];
 
@@ -161,12 +166,16 @@ struct Runner : Module {
     float shPhase[MAX_POLY] = {};
 
     // CV 調變顯示
-    float timeLCvMod = 0.0f;
-    float timeRCvMod = 0.0f;
-    float feedbackCvMod = 0.0f;
-    float mixCvMod = 0.0f;
-    float chaosCvMod = 0.0f;
-    float rateCvMod = 0.0f;
+    enum CvModId {
+        CVMOD_TIME_L,
+        CVMOD_TIME_R,
+        CVMOD_FEEDBACK,
+        CVMOD_MIX,
+        CVMOD_CHAOS,
+        CVMOD_RATE,
+        NUM_CVMODS
+    };
+    madzine::widgets::CVModBank<NUM_CVMODS> cvMods;
 
     Runner() {
         config(NUM_PARAMS, NUM_INPUTS, NUM_OUTPUTS, NUM_LIGHTS);
@@ -191,26 +200,13 @@ struct Runner : Module {
         configOutput(RIGHT_OUTPUT, "Right Audio");
         configOutput(CHAOS_OUTPUT, "Chaos CV");
         configOutput(SH_OUTPUT, "Sample & Hold CV");
-
-        // Initialize buffers
-        for (int c = 0; c < MAX_POLY; c++) {
-            for (int i = 0; i < DELAY_BUFFER_SIZE; i++) {
-                leftDelayBuffer[c][i] = 0.0f;
-                rightDelayBuffer[c][i] = 0.0f;
-            }
-            delayWriteIndex[c] = 0;
-        }
     }
 
     void onReset() override {
         for (int c = 0; c < MAX_POLY; c++) {
             chaosGen[c].reset();
-            for (int i = 0; i < DELAY_BUFFER_SIZE; i++) {
-                leftDelayBuffer[c][i] = 0.0f;
-                rightDelayBuffer[c][i] = 0.0f;
-            }
-            delayWriteIndex[c] = 0;
         }
+        channelPool.forEach([](Channel& ch) { ch.delay.reset(); });
     }
 
     json_t* dataToJson() override {
@@ -243,15 +239,17 @@ struct Runner : Module {
         outputs[CHAOS_OUTPUT].setChannels(channels);
         outputs[SH_OUTPUT].setChannels(channels);
 
+        channelPool.update(channels, args.sampleRate);
+
         for (int c = 0; c < channels; c++) {
             // Chaos 參數 + CV
             float chaosAmount = params[CHAOS_PARAM].getValue();
             if (inputs[CHAOS_CV_INPUT].isConnected()) {
                 float cv = inputs[CHAOS_CV_INPUT].getPolyVoltage(c < inputs[CHAOS_CV_INPUT].getChannels() ? c : 0);
                 chaosAmount += cv * 0.1f;
-                if (c == 0) chaosCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+                if (c == 0) cvMods.publish(CVMOD_CHAOS, clamp(cv / 10.0f, -1.0f, 1.0f));
             } else if (c == 0) {
-                chaosCvMod = 0.0f;
+                cvMods.clear(CVMOD_CHAOS);
             }
             chaosAmount = clamp(chaosAmount, 0.0f, 1.0f);
 
@@ -260,9 +258,9 @@ struct Runner : Module {
             if (inputs[RATE_CV_INPUT].isConnected()) {
                 float cv = inputs[RATE_CV_INPUT].getPolyVoltage(c < inputs[RATE_CV_INPUT].getChannels() ? c : 0);
                 chaosRate += cv * 0.2f;
-                if (c == 0) rateCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+                if (c == 0) cvMods.publish(CVMOD_RATE, clamp(cv / 10.0f, -1.0f, 1.0f));
             } else if (c == 0) {
-                rateCvMod = 0.0f;
+                cvMods.clear(CVMOD_RATE);
             }
             chaosRate = clamp(chaosRate, 0.01f, 2.0f);
 
@@ -303,9 +301,9 @@ struct Runner : Module {
             if (inputs[TIME_L_CV_INPUT].isConnected()) {
                 float cv = inputs[TIME_L_CV_INPUT].getPolyVoltage(c < inputs[TIME_L_CV_INPUT].getChannels() ? c : 0);
                 timeL += cv * 0.2f;
-                if (c == 0) timeLCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+                if (c == 0) cvMods.publish(CVMOD_TIME_L, clamp(cv / 10.0f, -1.0f, 1.0f));
             } else if (c == 0) {
-                timeLCvMod = 0.0f;
+                cvMods.clear(CVMOD_TIME_L);
             }
             if (chaosEnabled) {
                 timeL += chaosRaw * 0.1f;
@@ -317,9 +315,9 @@ struct Runner : Module {
             if (inputs[TIME_R_CV_INPUT].isConnected()) {
                 float cv = inputs[TIME_R_CV_INPUT].getPolyVoltage(c < inputs[TIME_R_CV_INPUT].getChannels() ? c : 0);
                 timeR += cv * 0.2f;
-                if (c == 0) timeRCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+                if (c == 0) cvMods.publish(CVMOD_TIME_R, clamp(cv / 10.0f, -1.0f, 1.0f));
             } else if (c == 0) {
-                timeRCvMod = 0.0f;
+                cvMods.clear(CVMOD_TIME_R);
             }
             if (chaosEnabled) {
                 timeR += chaosRaw * 0.1f;
@@ -331,41 +329,41 @@ struct Runner : Module {
             if (inputs[FEEDBACK_CV_INPUT].isConnected()) {
                 float cv = inputs[FEEDBACK_CV_INPUT].getPolyVoltage(c < inputs[FEEDBACK_CV_INPUT].getChannels() ? c : 0);
                 feedback += cv * 0.1f;
-                if (c == 0) feedbackCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+                if (c == 0) cvMods.publish(CVMOD_FEEDBACK, clamp(cv / 10.0f, -1.0f, 1.0f));
             } else if (c == 0) {
-                feedbackCvMod = 0.0f;
+                cvMods.clear(CVMOD_FEEDBACK);
             }
             if (chaosEnabled) {
                 feedback += chaosRaw * 0.1f;
             }
             feedback = clamp(feedback, 0.0f, 0.95f);
 
-            // 計算延遲樣本數
-            int delaySamplesL = (int)(timeL * args.sampleRate);
-            delaySamplesL = clamp(delaySamplesL, 1, DELAY_BUFFER_SIZE - 1);
-            int delaySamplesR = (int)(timeR * args.sampleRate);
-            delaySamplesR = clamp(delaySamplesR, 1, DELAY_BUFFER_SIZE - 1);
+            // 延遲線尚未配置（聲道剛增加）時只輸出乾訊號
+            float leftDelayed = 0.0f;
+            float rightDelayed = 0.0f;
+            if (Channel* ch = channelPool.get(c)) {
+                RipleyDelayLine& delay = ch->delay;
 
-            // 讀取延遲訊號
-            int readIndexL = (delayWriteIndex[c] - delaySamplesL + DELAY_BUFFER_SIZE) % DELAY_BUFFER_SIZE;
-            int readIndexR = (delayWriteIndex[c] - delaySamplesR + DELAY_BUFFER_SIZE) % DELAY_BUFFER_SIZE;
+                // 計算延遲樣本數
+                int delaySamplesL = clamp((int)(timeL * args.sampleRate), 1, delay.size - 1);
+                int delaySamplesR = clamp((int)(timeR * args.sampleRate), 1, delay.size - 1);
 
-            float leftDelayed = leftDelayBuffer[c][readIndexL];
-            float rightDelayed = rightDelayBuffer[c][readIndexR];
+                // 讀取延遲訊號
+                leftDelayed = delay.left[delay.readIndex(delaySamplesL)];
+                rightDelayed = delay.right[delay.readIndex(delaySamplesR)];
 
-            // 寫入延遲緩衝
-            leftDelayBuffer[c][delayWriteIndex[c]] = leftInput + leftDelayed * feedback;
-            rightDelayBuffer[c][delayWriteIndex[c]] = rightInput + rightDelayed * feedback;
-            delayWriteIndex[c] = (delayWriteIndex[c] + 1) % DELAY_BUFFER_SIZE;
+                // 寫入延遲緩衝
+                delay.write(leftInput + leftDelayed * feedback, rightInput + rightDelayed * feedback);
+            }
 
             // Wet/Dry Mix + CV
             float mix = params[MIX_PARAM].getValue();
             if (inputs[MIX_CV_INPUT].isConnected()) {
                 float cv = inputs[MIX_CV_INPUT].getPolyVoltage(c < inputs[MIX_CV_INPUT].getChannels() ? c : 0);
                 mix += cv * 0.1f;
-                if (c == 0) mixCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+                if (c == 0) cvMods.publish(CVMOD_MIX, clamp(cv / 10.0f, -1.0f, 1.0f));
             } else if (c == 0) {
-                mixCvMod = 0.0f;
+                cvMods.clear(CVMOD_MIX);
             }
             mix = clamp(mix, 0.0f, 1.0f);
 
@@ -408,6 +406,7 @@ struct RunnerWidget : ModuleWidget {
     StandardBlackKnob26* mixKnob = nullptr;
     StandardBlackKnob26* chaosKnob = nullptr;
     StandardBlackKnob26* rateKnob = nullptr;
+    madzine::widgets::CVModRingSync<Runner::NUM_CVMODS> cvModSync;
 
     // 自動配線追蹤
     int64_t autoSendLeftCableId = -1;
@@ -461,6 +460,13 @@ struct RunnerWidget : ModuleWidget {
         rateKnob = createParamCentered<StandardBlackKnob26>(Vec(rightX, 162), module, Runner::RATE_PARAM);
         addParam(rateKnob);
 
+        cvModSync.bind(Runner::CVMOD_TIME_L, timeKnob);
+        cvModSync.bind(Runner::CVMOD_TIME_R, timeRKnob);
+        cvModSync.bind(Runner::CVMOD_FEEDBACK, feedbackKnob);
+        cvModSync.bind(Runner::CVMOD_MIX, mixKnob);
+        cvModSync.bind(Runner::CVMOD_CHAOS, chaosKnob);
+        cvModSync.bind(Runner::CVMOD_RATE, rateKnob);
+
         // CV Row 1 (Y=197, 標籤 Y=173)
         addChild(new RunnerParamLabel(Vec(0, 173), Vec(30, 15), "TIME L"));
         addInput(createInputCentered<PJ301MPort>(Vec(leftX, 197), module, Runner::TIME_L_CV_INPUT));
@@ -506,36 +512,8 @@ struct RunnerWidget : ModuleWidget {
         if (module) {
             panelThemeHelper.step(module);
 
-            if (timeKnob) {
-                bool connected = module->inputs[Runner::TIME_L_CV_INPUT].isConnected();
-                timeKnob->setModulationEnabled(connected);
-                if (connected) timeKnob->setModulation(module->timeLCvMod);
-            }
-            if (timeRKnob) {
-                bool connected = module->inputs[Runner::TIME_R_CV_INPUT].isConnected();
-                timeRKnob->setModulationEnabled(connected);
-                if (connected) timeRKnob->setModulation(module->timeRCvMod);
-            }
-            if (feedbackKnob) {
-                bool connected = module->inputs[Runner::FEEDBACK_CV_INPUT].isConnected();
-                feedbackKnob->setModulationEnabled(connected);
-                if (connected) feedbackKnob->setModulation(module->feedbackCvMod);
-            }
-            if (mixKnob) {
-                bool connected = module->inputs[Runner::MIX_CV_INPUT].isConnected();
-                mixKnob->setModulationEnabled(connected);
-                if (connected) mixKnob->setModulation(module->mixCvMod);
-            }
-            if (chaosKnob) {
-                bool connected = module->inputs[Runner::CHAOS_CV_INPUT].isConnected();
-                chaosKnob->setModulationEnabled(connected);
-                if (connected) chaosKnob->setModulation(module->chaosCvMod);
-            }
-            if (rateKnob) {
-                bool connected = module->inputs[Runner::RATE_CV_INPUT].isConnected();
-                rateKnob->setModulationEnabled(connected);
-                if (connected) rateKnob->setModulation(module->rateCvMod);
-            }
+            // CV 調變顯示（僅在數值變化時更新旋鈕）
+            cvModSync.sync(module->cvMods);
 
             // 自動配線到 YAMANOTE Send/Return
             Module* leftModule = module->leftExpander.module;
@@ -91,34 +91,74 @@ struct Runshow : Module {
     int eighth_notes = 0;   // 8分音符計數
     int sixteenth_notes = 0; // 16分音符計數
 
-    std::chrono::steady_clock::time_point startTime;
-    std::chrono::steady_clock::time_point lastUpdateTime;
-    float elapsedSeconds = 0.f;
+    // ===== 取樣計數 transport =====
+    // 所有計時器、小節波形與顯示都由樣本數推導，與音訊串流同步；
+    // 離線算圖或引擎停頓時也不會漂移。牆上時鐘只作參考（右鍵選單顯示）。
+    int64_t transportSamples = 0;       // 目前取樣率下 running 期間經過的樣本數
+    double transportBaseSeconds = 0.0;  // 取樣率改變前已累積的秒數
+    float transportSampleRate = 44100.f;
+    double elapsedSeconds = 0.0;        // 顯示用，每個樣本由 transport 更新
+
+    // 不論 running 與否都前進的樣本計數（波形輸出用，停止時 reset 觸發的波形仍會跑完）
+    int64_t engineSamples = 0;
+
+    // 牆上時鐘參考
+    std::chrono::steady_clock::time_point wallStartTime;
+    double wallAccumulatedSeconds = 0.0;
+
+    double transportSeconds() const {
+        return transportBaseSeconds + (double)transportSamples / transportSampleRate;
+    }
+
+    double wallClockSeconds() const {
+        double seconds = wallAccumulatedSeconds;
+        if (running) {
+            seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStartTime).count();
+        }
+        return seconds;
+    }
+
+    /**
+     * 一次波形輸出：起點與長度都以樣本計
+     */
+    struct TransportPulse {
+        bool active = false;
+        int64_t startSample = 0;
+        int64_t lengthSamples = 0;
+
+        void trigger(int64_t now, double durationSeconds, float sampleRate) {
+            startSample = now;
+            lengthSamples = (int64_t)std::llround(durationSeconds * sampleRate);
+            active = lengthSamples > 0;
+        }
+
+        void stop() {
+            active = false;
+        }
+
+        // 目前相位 0-1；結束時關閉並回傳 -1
+        float phase(int64_t now) {
+            if (!active) return -1.f;
+            int64_t position = now - startSample;
+            if (position >= lengthSamples) {
+                active = false;
+                return -1.f;
+            }
+            return (float)((double)position / (double)lengthSamples);
+        }
+    };
 
     // Waveform generators for timer outputs
-    float timer30MinPhase = 0.f;
-    float timer15MinPhase = 0.f;
-    bool timer30MinActive = false;
-    bool timer15MinActive = false;
-    float timer30MinDuration = 0.f;
-    float timer15MinDuration = 0.f;
+    TransportPulse timer30MinPulse;
+    TransportPulse timer15MinPulse;
+    double lastTimer30Min = 0.0;  // 上一次 5 分鐘觸發的 transport 時間
+    double lastTimer15Min = 0.0;  // 上一次 1 分鐘觸發的 transport 時間
 
     // Waveform generators for bar outputs
-    float bar1Phase = 0.f;
-    float bar2Phase = 0.f;
-    float bar3Phase = 0.f;
-    float bar4Phase = 0.f;
-    bool bar1Active = false;
-    bool bar2Active = false;
-    bool bar3Active = false;
-    bool bar4Active = false;
-    float bar1Duration = 0.f;
-    float bar2Duration = 0.f;
-    float bar3Duration = 0.f;
-    float bar4Duration = 0.f;
+    TransportPulse barPulses[4];
 
     int lastBarInCycle = -1;  // Track bar transitions
-    float lastClockTime = 0.f;  // Track timing between clocks
+    double lastClockTime = 0.0;  // Track timing between clocks (transport seconds)
     float clockInterval = 0.1f; // Time between clocks in seconds (default 100ms)
 
     // Waveform generation function with smooth morphing
@@ -215,11 +255,20 @@ struct Runshow : Module {
         bool startStopTriggered = startStopTrigger.process(inputs[START_STOP_INPUT].getVoltage()) ||
                                   startStopButtonTrigger.process(params[START_STOP_PARAM].getValue());
 
+        if (args.sampleRate != transportSampleRate) {
+            // 取樣率改變：先把已經過的時間折算成秒
+            transportBaseSeconds = transportSeconds();
+            transportSamples = 0;
+            transportSampleRate = args.sampleRate;
+        }
+
         if (startStopTriggered) {
             running = !running;
+            // 牆上時鐘只在啟動 / 停止時讀取
             if (running) {
-                startTime = std::chrono::steady_clock::now();
-                lastUpdateTime = startTime;
+                wallStartTime = std::chrono::steady_clock::now();
+            } else {
+                wallAccumulatedSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStartTime).count();
             }
         }
 
@@ -229,48 +278,38 @@ struct Runshow : Module {
             quarter_notes = 0;
             eighth_notes = 0;
             sixteenth_notes = 0;
-            elapsedSeconds = 0.f;
-            startTime = std::chrono::steady_clock::now();
-            lastUpdateTime = startTime;
+            transportSamples = 0;
+            transportBaseSeconds = 0.0;
+            elapsedSeconds = 0.0;
+            wallStartTime = std::chrono::steady_clock::now();
+            wallAccumulatedSeconds = 0.0;
+            lastTimer30Min = 0.0;
+            lastTimer15Min = 0.0;
+            lastClockTime = 0.0;
             lastBarInCycle = -1;
 
             lights[BEAT_LIGHT].setBrightness(0.f);
 
             // Trigger only timer outputs (5min and 1min) when reset
             float pulseWidthPercent = params[TIMER_30MIN_PARAM].getValue();
-
-            // Trigger 5min timer
-            float timer30MinFullDuration = 5.f * 60.f;
-            timer30MinDuration = (pulseWidthPercent / 100.0f) * timer30MinFullDuration;
-            timer30MinActive = true;
-            timer30MinPhase = 0.f;
-
-            // Trigger 1min timer
-            float timer15MinFullDuration = 1.f * 60.f;
-            timer15MinDuration = (pulseWidthPercent / 100.0f) * timer15MinFullDuration;
-            timer15MinActive = true;
-            timer15MinPhase = 0.f;
+            timer30MinPulse.trigger(engineSamples, (pulseWidthPercent / 100.0f) * 5.f * 60.f, args.sampleRate);
+            timer15MinPulse.trigger(engineSamples, (pulseWidthPercent / 100.0f) * 1.f * 60.f, args.sampleRate);
 
             // Reset bar states (bars are triggered by clock, not reset)
-            bar1Active = false;
-            bar2Active = false;
-            bar3Active = false;
-            bar4Active = false;
-            bar1Phase = 0.f;
-            bar2Phase = 0.f;
-            bar3Phase = 0.f;
-            bar4Phase = 0.f;
+            for (int b = 0; b < 4; b++) {
+                barPulses[b].stop();
+            }
         }
 
         if (running) {
-            auto currentTime = std::chrono::steady_clock::now();
-            elapsedSeconds = std::chrono::duration<float>(currentTime - startTime).count();
+            transportSamples++;
+            elapsedSeconds = transportSeconds();
 
             if (clockTrigger.process(inputs[CLOCK_INPUT].getVoltage())) {
                 // Track time between clocks for pulse width calculation
-                float currentTime = elapsedSeconds;
-                if (lastClockTime > 0.f && currentTime > lastClockTime) {
-                    clockInterval = currentTime - lastClockTime;
+                double currentTime = elapsedSeconds;
+                if (lastClockTime > 0.0 && currentTime > lastClockTime) {
+                    clockInterval = (float)(currentTime - lastClockTime);
                 }
                 lastClockTime = currentTime;
 
@@ -317,142 +356,54 @@ struct Runshow : Module {
                 // Trigger waveform when transitioning to a new bar
                 if (currentBarInCycle != lastBarInCycle) {
                     float pulseWidthPercent = params[TIMER_30MIN_PARAM].getValue();
+                    const float barClocks[4] = {bar0Clocks, bar1Clocks, bar2Clocks, bar3Clocks};
 
-                    // Reset all bar states
-                    bar1Active = false;
-                    bar2Active = false;
-                    bar3Active = false;
-                    bar4Active = false;
-
-                    // Activate current bar and set duration
-                    switch(currentBarInCycle) {
-                        case 0: {
-                            float barDuration = bar0Clocks * clockInterval;
-                            bar1Duration = (pulseWidthPercent / 100.0f) * barDuration;
-                            bar1Active = true;
-                            bar1Phase = 0.f;
-                            break;
-                        }
-                        case 1: {
-                            float barDuration = bar1Clocks * clockInterval;
-                            bar2Duration = (pulseWidthPercent / 100.0f) * barDuration;
-                            bar2Active = true;
-                            bar2Phase = 0.f;
-                            break;
-                        }
-                        case 2: {
-                            float barDuration = bar2Clocks * clockInterval;
-                            bar3Duration = (pulseWidthPercent / 100.0f) * barDuration;
-                            bar3Active = true;
-                            bar3Phase = 0.f;
-                            break;
-                        }
-                        case 3: {
-                            float barDuration = bar3Clocks * clockInterval;
-                            bar4Duration = (pulseWidthPercent / 100.0f) * barDuration;
-                            bar4Active = true;
-                            bar4Phase = 0.f;
-                            break;
-                        }
+                    // Reset all bar states, then activate the current bar
+                    for (int b = 0; b < 4; b++) {
+                        barPulses[b].stop();
                     }
+                    float barDuration = barClocks[currentBarInCycle] * clockInterval;
+                    barPulses[currentBarInCycle].trigger(engineSamples, (pulseWidthPercent / 100.0f) * barDuration, args.sampleRate);
+
                     lastBarInCycle = currentBarInCycle;
                     currentBar++;
                 }
             }
 
-            // 時間計時器觸發邏輯
-            static float lastTimer30Min = 0.f;
-            static float lastTimer15Min = 0.f;
-
+            // 時間計時器觸發邏輯（以 transport 時間比較，不會累積誤差）
             float pulseWidthPercent = params[TIMER_30MIN_PARAM].getValue();
 
             // 30分鐘計時器：每5分鐘觸發波形
-            float timer30MinInterval = 5.f * 60.f; // 5分鐘
-            if (elapsedSeconds >= lastTimer30Min + timer30MinInterval && elapsedSeconds < 30.f * 60.f) {
-                float timer30MinFullDuration = 5.f * 60.f; // 5分鐘總時長
-                timer30MinDuration = (pulseWidthPercent / 100.0f) * timer30MinFullDuration;
-                timer30MinActive = true;
-                timer30MinPhase = 0.f;
+            const double timer30MinInterval = 5.0 * 60.0; // 5分鐘
+            if (elapsedSeconds >= lastTimer30Min + timer30MinInterval && elapsedSeconds < 30.0 * 60.0) {
+                timer30MinPulse.trigger(engineSamples, (pulseWidthPercent / 100.0f) * 5.f * 60.f, args.sampleRate);
                 lastTimer30Min += timer30MinInterval;
             }
 
             // 15分鐘計時器：每1分鐘觸發波形
-            float timer15MinInterval = 1.f * 60.f; // 1分鐘
-            if (elapsedSeconds >= lastTimer15Min + timer15MinInterval && elapsedSeconds < 15.f * 60.f) {
-                float timer15MinFullDuration = 1.f * 60.f; // 1分鐘總時長
-                timer15MinDuration = (pulseWidthPercent / 100.0f) * timer15MinFullDuration;
-                timer15MinActive = true;
-                timer15MinPhase = 0.f;
+            const double timer15MinInterval = 1.0 * 60.0; // 1分鐘
+            if (elapsedSeconds >= lastTimer15Min + timer15MinInterval && elapsedSeconds < 15.0 * 60.0) {
+                timer15MinPulse.trigger(engineSamples, (pulseWidthPercent / 100.0f) * 1.f * 60.f, args.sampleRate);
                 lastTimer15Min += timer15MinInterval;
             }
-
-            // Reset timer counters when reset is triggered (inside running block)
-            if (resetTriggered) {
-                lastTimer30Min = 0.f;
-                lastTimer15Min = 0.f;
-                lastClockTime = 0.f; // Reset clock timing
-            }
-        }
-
-        // Update waveform phases (outside running block so reset triggers work)
-        // Update timer waveforms
-        if (timer30MinActive && timer30MinDuration > 0.f) {
-            timer30MinPhase += args.sampleTime / timer30MinDuration;
-            if (timer30MinPhase >= 1.f) {
-                timer30MinActive = false;
-                timer30MinPhase = 0.f;
-            }
-        }
-        if (timer15MinActive && timer15MinDuration > 0.f) {
-            timer15MinPhase += args.sampleTime / timer15MinDuration;
-            if (timer15MinPhase >= 1.f) {
-                timer15MinActive = false;
-                timer15MinPhase = 0.f;
-            }
-        }
-
-        // Update bar waveforms
-        if (bar1Active && bar1Duration > 0.f) {
-            bar1Phase += args.sampleTime / bar1Duration;
-            if (bar1Phase >= 1.f) {
-                bar1Active = false;
-                bar1Phase = 0.f;
-            }
-        }
-        if (bar2Active && bar2Duration > 0.f) {
-            bar2Phase += args.sampleTime / bar2Duration;
-            if (bar2Phase >= 1.f) {
-                bar2Active = false;
-                bar2Phase = 0.f;
-            }
-        }
-        if (bar3Active && bar3Duration > 0.f) {
-            bar3Phase += args.sampleTime / bar3Duration;
-            if (bar3Phase >= 1.f) {
-                bar3Active = false;
-                bar3Phase = 0.f;
-            }
-        }
-        if (bar4Active && bar4Duration > 0.f) {
-            bar4Phase += args.sampleTime / bar4Duration;
-            if (bar4Phase >= 1.f) {
-                bar4Active = false;
-                bar4Phase = 0.f;
-            }
         }
 
-        // 設定所有輸出
+        // 設定所有輸出（波形在 running 區塊外前進，停止時 reset 觸發的波形仍會跑完）
         float waveShape = params[TIMER_15MIN_PARAM].getValue();
 
         // Generate morphed waveforms for timer outputs
-        outputs[TIMER_30MIN_OUTPUT].setVoltage(timer30MinActive ? generateWaveform(timer30MinPhase, waveShape) : 0.f);
-        outputs[TIMER_15MIN_OUTPUT].setVoltage(timer15MinActive ? generateWaveform(timer15MinPhase, waveShape) : 0.f);
+        float timer30MinPhase = timer30MinPulse.phase(engineSamples);
+        float timer15MinPhase = timer15MinPulse.phase(engineSamples);
+        outputs[TIMER_30MIN_OUTPUT].setVoltage(timer30MinPhase >= 0.f ? generateWaveform(timer30MinPhase, waveShape) : 0.f);
+        outputs[TIMER_15MIN_OUTPUT].setVoltage(timer15MinPhase >= 0.f ? generateWaveform(timer15MinPhase, waveShape) : 0.f);
 
         // Generate morphed waveforms for bar outputs
-        outputs[BAR_1_OUTPUT].setVoltage(bar1Active ? generateWaveform(bar1Phase, waveShape) : 0.f);
-        outputs[BAR_2_OUTPUT].setVoltage(bar2Active ? generateWaveform(bar2Phase, waveShape) : 0.f);
-        outputs[BAR_3_OUTPUT].setVoltage(bar3Active ? generateWaveform(bar3Phase, waveShape) : 0.f);
-        outputs[BAR_4_OUTPUT].setVoltage(bar4Active ? generateWaveform(bar4Phase, waveShape) : 0.f);
+        for (int b = 0; b < 4; b++) {
+            float barPhase = barPulses[b].phase(engineSamples);
+            outputs[BAR_1_OUTPUT + b].setVoltage(barPhase >= 0.f ? generateWaveform(barPhase, waveShape) : 0.f);
+        }
+
+        engineSamples++;
 
         // Beat light decay
         float lightDecay = 5.f * args.sampleTime;
@@ -467,7 +418,7 @@ struct Runshow : Module {
         json_object_set_new(rootJ, "quarter_notes", json_integer(quarter_notes));
         json_object_set_new(rootJ, "eighth_notes", json_integer(eighth_notes));
         json_object_set_new(rootJ, "sixteenth_notes", json_integer(sixteenth_notes));
-        json_object_set_new(rootJ, "elapsedSeconds", json_real(elapsedSeconds));
+        json_object_set_new(rootJ, "elapsedSeconds", json_real(transportSeconds()));
         json_object_set_new(rootJ, "panelTheme", json_integer(panelTheme));
         json_object_set_new(rootJ, "panelContrast", json_real(panelContrast));
         return rootJ;
@@ -499,8 +450,16 @@ struct Runshow : Module {
             sixteenth_notes = json_integer_value(sixteenth_notesJ);
 
         json_t* elapsedSecondsJ = json_object_get(rootJ, "elapsedSeconds");
-        if (elapsedSecondsJ)
-            elapsedSeconds = json_real_value(elapsedSecondsJ);
+        if (elapsedSecondsJ) {
+            // 從存檔的時間接續 transport，計時器從下一個整分 / 整 5 分繼續
+            transportBaseSeconds = std::max(0.0, json_number_value(elapsedSecondsJ));
+            transportSamples = 0;
+            elapsedSeconds = transportBaseSeconds;
+            lastTimer30Min = std::floor(transportBaseSeconds / 300.0) * 300.0;
+            lastTimer15Min = std::floor(transportBaseSeconds / 60.0) * 60.0;
+            wallAccumulatedSeconds = transportBaseSeconds;
+            wallStartTime = std::chrono::steady_clock::now();
+        }
 
         json_t* themeJ = json_object_get(rootJ, "panelTheme");
         if (themeJ) {
@@ -540,9 +499,10 @@ struct TimeCodeDisplay : LedDisplay {
         if (!module) return;
 
         // Update time string
-        int minutes = (int)(module->elapsedSeconds / 60.0f) % 1000; // Limit to 0-999 (百位)
-        int seconds = (int)module->elapsedSeconds % 60;
-        int milliseconds = (int)((module->elapsedSeconds - floor(module->elapsedSeconds)) * 100);
+        double elapsed = module->elapsedSeconds;
+        int minutes = (int)(elapsed / 60.0) % 1000; // Limit to 0-999 (百位)
+        int seconds = (int)elapsed % 60;
+        int milliseconds = (int)((elapsed - std::floor(elapsed)) * 100);
         timeString = string::f("%d:%02d:%02d", minutes, seconds, milliseconds);
 
         // Update bar string (Bar:Beat:Tick)
@@ -707,11 +667,11 @@ struct FourProgressBars : LedDisplay {
 
             if (i == 0) {
                 // First bar: timer with adjustable max (1-60 minutes)
-                float totalMinutes = module->elapsedSeconds / 60.0f;
+                float totalMinutes = (float)(module->elapsedSeconds / 60.0);
                 fillHeight = box.size.y * std::min(totalMinutes / maxMinutes, 1.0f);
             } else if (i == 1) {
                 // Second bar: 1-minute timer (15 minutes total)
-                float totalMinutes = module->elapsedSeconds / 60.0f;
+                float totalMinutes = (float)(module->elapsedSeconds / 60.0);
                 fillHeight = box.size.y * std::min(totalMinutes / 15.0f, 1.0f);
             } else {
                 // Bars 2-5 represent the 4-bar cycle, each with adjustable length
@@ -990,6 +950,13 @@ struct RunshowWidget : ModuleWidget {
         if (!module) return;
 
         addPanelThemeMenu(menu, module);
+
+        // 牆上時鐘參考（transport 以樣本計時，這裡只顯示兩者差距）
+        double wall = module->wallClockSeconds();
+        double drift = module->transportSeconds() - wall;
+        menu->addChild(new MenuSeparator);
+        menu->addChild(createMenuLabel(string::f("Wall clock: %d:%02d (drift %+.2f s)",
+                                                 (int)(wall / 60.0), (int)wall % 60, drift)));
     }
 };
 
@@ -1,5 +1,6 @@
 #include "plugin.hpp"
 #include "widgets/Knobs.hpp"
+#include "widgets/CVModulation.hpp"
 #include "widgets/PanelTheme.hpp"
 #include <cmath>
 
@@ -240,7 +241,7 @@ struct SHINJUKU : Module {
     bool soloState[SHINJUKU_TRACKS] = {false};
     dsp::SchmittTrigger muteTrigger[SHINJUKU_TRACKS];
     dsp::SchmittTrigger soloTrigger[SHINJUKU_TRACKS];
-    float levelCvModulation[SHINJUKU_TRACKS] = {0.0f};
+    madzine::widgets::CVModBank<SHINJUKU_TRACKS> levelCvMods;  // 每軌 Level 旋鈕的 CV 調變顯示
     float vuLevelL[SHINJUKU_TRACKS] = {-60.0f};
     float vuLevelR[SHINJUKU_TRACKS] = {-60.0f};
 
@@ -349,6 +350,15 @@ struct SHINJUKU : Module {
             mod = mod->rightExpander.module;
         }
 
+        // Level CV 調變顯示（靜音軌道在下方會被跳過，故在通道迴圈外發佈）
+        for (int t = 0; t < SHINJUKU_TRACKS; t++) {
+            if (inputs[LEVEL_CV_INPUT + t].isConnected()) {
+                levelCvMods.publish(t, clamp(inputs[LEVEL_CV_INPUT + t].getVoltage() / 10.0f, -1.0f, 1.0f));
+            } else {
+                levelCvMods.clear(t);
+            }
+        }
+
         for (int c = 0; c < maxChannels; c++) {
             float mixL = 0.0f;
             float mixR = 0.0f;
@@ -404,9 +414,6 @@ struct SHINJUKU : Module {
                 if (inputs[LEVEL_CV_INPUT + t].isConnected()) {
                     float cv = clamp(inputs[LEVEL_CV_INPUT + t].getPolyVoltage(c) / 10.0f, -1.0f, 1.0f);
                     level = clamp(level + cv, 0.0f, 2.0f);
-                    if (c == 0) levelCvModulation[t] = cv;
-                } else {
-                    if (c == 0) levelCvModulation[t] = 0.0f;
                 }
 
                 float duck = 1.0f;
@@ -624,6 +631,7 @@ struct ShinjukuEQLabel : TransparentWidget {
 struct SHINJUKUWidget : ModuleWidget {
     PanelThemeHelper panelThemeHelper;
     TechnoStandardBlackKnob* levelKnobs[SHINJUKU_TRACKS] = {nullptr};
+    madzine::widgets::CVModRingSync<SHINJUKU_TRACKS> levelCvModSync;
 
     // Chain 自動接線（模組移開後保持連接）
     int64_t autoChainLeftCableId = -1;
@@ -675,6 +683,7 @@ struct SHINJUKUWidget : ModuleWidget {
             addChild(new ShinjukuTextLabel(Vec(trackX - 5, 89), Vec(trackWidth + 10, 10), "LEVEL", 8.f, nvgRGB(255, 255, 255)));
             levelKnobs[t] = createParamCentered<TechnoStandardBlackKnob>(Vec(centerX, 123), module, SHINJUKU::LEVEL_PARAM + t);
             addParam(levelKnobs[t]);
+            levelCvModSync.bind(t, levelKnobs[t]);
             addInput(createInputCentered<PJ301MPort>(Vec(centerX, 161), module, SHINJUKU::LEVEL_CV_INPUT + t));
 
             // DUCK
@@ -724,16 +733,8 @@ struct SHINJUKUWidget : ModuleWidget {
         if (module) {
             panelThemeHelper.step(module);
 
-            // Level 旋鈕 CV 調變顯示
-            for (int t = 0; t < SHINJUKU_TRACKS; t++) {
-                if (levelKnobs[t]) {
-                    bool cvConnected = module->inputs[SHINJUKU::LEVEL_CV_INPUT + t].isConnected();
-                    levelKnobs[t]->setModulationEnabled(cvConnected);
-                    if (cvConnected) {
-                        levelKnobs[t]->setModulation(module->levelCvModulation[t]);
-                    }
-                }
-            }
+            // Level 旋鈕 CV 調變顯示（僅在數值變化時）
+            levelCvModSync.sync(module->levelCvMods);
 
             // Chain 自動接線（模組移開後保持連接，用戶可手動刪除）
             // 先驗證現有的自動 cable（被手動刪除時清除 ID）
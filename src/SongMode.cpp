@@ -1,10 +1,229 @@
 #include "plugin.hpp"
 #include "widgets/Knobs.hpp"
 #include "widgets/PanelTheme.hpp"
+#include <atomic>
+#include <cctype>
 #include <vector>
 #include <string>
 #include <sstream>
 
+using simd::float_4;
+
+// ============================================================
+// 編曲引擎：序列字串在 UI 執行緒編譯成步驟表，音訊執行緒只走訪步驟表
+// ============================================================
+
+// 段落切換的淡入曲線
+enum SongFadeCurve {
+    SONG_FADE_EQUAL_POWER,
+    SONG_FADE_LINEAR,
+    SONG_FADE_SCURVE,
+    SONG_FADE_CUT,
+    SONG_FADE_CURVES_LEN,
+    SONG_FADE_DEFAULT = 0xFF  // 沿用模組預設曲線
+};
+
+/**
+ * 編譯後的一個段落
+ */
+struct SongStep {
+    int8_t input = 0;                   // 0-7
+    uint8_t curve = SONG_FADE_DEFAULT;  // 淡入這個段落的曲線
+    uint16_t length = 0;                // 時鐘數，0 = 使用該輸入的 LENGTH 旋鈕
+};
+
+/**
+ * 編譯後的步驟表（固定大小，發佈後不再配置記憶體）
+ */
+struct SongArrangement {
+    static constexpr int MAX_STEPS = 4096;
+
+    SongStep steps[MAX_STEPS];
+    int count = 0;
+    bool truncated = false;  // 展開後超過 MAX_STEPS
+};
+
+/**
+ * 序列語法
+ *   1-8        輸入編號，可連寫："12345678"
+ *   a-b        範圍："1-4" = 1 2 3 4
+ *   ( ... )    段落群組，可巢狀
+ *   xN         重複前一個項目 N 次："(12)x4"
+ *   :N         前一個項目中未指定長度的段落長度為 N 個時鐘（1-64）
+ *   e l s c    前一個項目的淡入曲線：等功率 / 線性 / S 曲線 / 直接切換
+ * 空白、逗號、Tab 為分隔字元，其他字元略過。
+ * 例："(12)x4 3:16 (45)x2s"
+ *
+ * extended = false 為舊版語法（舊存檔）：只認數字與遞增範圍，
+ * 遞減範圍 "8-1" 不產生段落，字母與括號一律略過。
+ */
+struct SongSequenceCompiler {
+    const std::string& text;
+    bool extended;
+    size_t pos = 0;
+    std::vector<SongStep> out;
+    bool truncated = false;
+
+    SongSequenceCompiler(const std::string& text, bool extended) : text(text), extended(extended) {}
+
+    void compile(SongArrangement& arrangement) {
+        pos = 0;
+        out.clear();
+        truncated = false;
+        if (extended) {
+            parseSequence(0);
+        } else {
+            parseLegacy();
+        }
+
+        // 空序列預設為 1-8
+        if (out.empty()) {
+            for (int i = 0; i < 8; i++) {
+                SongStep step;
+                step.input = i;
+                out.push_back(step);
+            }
+        }
+
+        arrangement.count = (int)out.size();
+        arrangement.truncated = truncated;
+        std::copy(out.begin(), out.end(), arrangement.steps);
+    }
+
+private:
+    static bool isSeparator(char c) {
+        return c == ' ' || c == ',' || c == '\t' || c == '\n' || c == '\r';
+    }
+
+    static bool isInputDigit(char c) {
+        return c >= '1' && c <= '8';
+    }
+
+    bool push(int input) {
+        if ((int)out.size() >= SongArrangement::MAX_STEPS) {
+            truncated = true;
+            return false;
+        }
+        SongStep step;
+        step.input = input;
+        out.push_back(step);
+        return true;
+    }
+
+    int parseNumber() {
+        int value = 0;
+        int digits = 0;
+        while (pos < text.length() && std::isdigit((unsigned char)text[pos]) && digits < 4) {
+            value = value * 10 + (text[pos] - '0');
+            pos++;
+            digits++;
+        }
+        return digits > 0 ? value : -1;
+    }
+
+    void parseLegacy() {
+        while (pos < text.length()) {
+            char c = text[pos];
+            if (isInputDigit(c)) {
+                int num = c - '0';
+                if (pos + 2 < text.length() && text[pos + 1] == '-' && isInputDigit(text[pos + 2])) {
+                    int endNum = text[pos + 2] - '0';
+                    for (int j = num; j <= endNum; j++) {
+                        push(j - 1);
+                    }
+                    pos += 3;
+                    continue;
+                }
+                push(num - 1);
+            }
+            pos++;
+        }
+    }
+
+    void parseSequence(int depth) {
+        while (pos < text.length()) {
+            char c = text[pos];
+
+            if (isSeparator(c)) {
+                pos++;
+                continue;
+            }
+
+            if (c == ')') {
+                pos++;
+                if (depth > 0) return;
+                continue;  // 多餘的右括號略過
+            }
+
+            size_t first = out.size();
+
+            if (c == '(') {
+                pos++;
+                parseSequence(depth + 1);  // 未閉合的括號在字串結尾自動閉合
+            } else if (isInputDigit(c)) {
+                int num = c - '0';
+                if (pos + 2 < text.length() && text[pos + 1] == '-' && isInputDigit(text[pos + 2])) {
+                    int endNum = text[pos + 2] - '0';
+                    int step = (endNum >= num) ? 1 : -1;
+                    for (int j = num; ; j += step) {
+                        push(j - 1);
+                        if (j == endNum) break;
+                    }
+                    pos += 3;
+                } else {
+                    push(num - 1);
+                    pos++;
+                }
+            } else {
+                pos++;
+                continue;
+            }
+
+            parseModifiers(first);
+        }
+    }
+
+    void parseModifiers(size_t first) {
+        while (pos < text.length()) {
+            char c = (char)std::tolower((unsigned char)text[pos]);
+
+            if (c == 'x' || c == '*') {
+                pos++;
+                int repeats = parseNumber();
+                if (repeats < 1) continue;
+                size_t blockEnd = out.size();
+                for (int r = 1; r < repeats && !truncated; r++) {
+                    for (size_t i = first; i < blockEnd; i++) {
+                        if ((int)out.size() >= SongArrangement::MAX_STEPS) {
+                            truncated = true;
+                            break;
+                        }
+                        out.push_back(out[i]);
+                    }
+                }
+            } else if (c == ':') {
+                pos++;
+                int length = parseNumber();
+                if (length < 1) continue;
+                for (size_t i = first; i < out.size(); i++) {
+                    if (out[i].length == 0) out[i].length = (uint16_t)clamp(length, 1, 64);
+                }
+            } else if (c == 'e' || c == 'l' || c == 's' || c == 'c') {
+                pos++;
+                uint8_t curve = (c == 'e') ? SONG_FADE_EQUAL_POWER
+                              : (c == 'l') ? SONG_FADE_LINEAR
+                              : (c == 's') ? SONG_FADE_SCURVE
+                              : SONG_FADE_CUT;
+                for (size_t i = first; i < out.size(); i++) {
+                    if (out[i].curve == SONG_FADE_DEFAULT) out[i].curve = curve;
+                }
+            } else {
+                return;
+            }
+        }
+    }
+};
+
 // Text label widget
 struct SongModeLabel : TransparentWidget {
     std::string text;
@@ -179,7 +398,14 @@ struct SongMode : Module {
 
     // Sequence data
     std::string sequenceText = "12345678";
-    std::vector<int> sequence;  // Parsed sequence (0-7 indices)
+    // 雙緩衝步驟表：UI 執行緒編譯到非使用中的一份，再切換 activeArrangement。
+    // 音訊執行緒在 audioArrangement 確認已改讀新的一份後，UI 端才能再覆寫另一份
+    SongArrangement arrangements[2];
+    std::atomic<int> activeArrangement{0};
+    std::atomic<int> audioArrangement{0};
+    bool compilePending = false;  // 尚未確認時延到 widget step() 重試（UI 執行緒）
+    bool extendedSyntax = true;   // 舊存檔載入為 false，維持舊版語法
+    int defaultFadeCurve = SONG_FADE_EQUAL_POWER;
 
     // Playback state
     int currentSequenceIndex = 0;  // Current position in sequence
@@ -202,6 +428,7 @@ struct SongMode : Module {
     float fadeProgress = 0.f;  // 0.0 = old input, 1.0 = new input
     float fadeDuration = 0.f;  // in seconds
     float fadeElapsed = 0.f;   // elapsed time in fade
+    int fadeCurve = SONG_FADE_EQUAL_POWER;
 
     SongMode() {
         config(PARAMS_LEN, INPUTS_LEN, OUTPUTS_LEN, LIGHTS_LEN);
@@ -236,59 +463,71 @@ struct SongMode : Module {
         configParam(FADE_TIME_PARAM, 0.f, 1000.f, 100.f, "Fade Time", " ms");
 
         // Parse default sequence
-        parseSequence();
+        parseSequence(true);
     }
 
-    void parseSequence() {
-        sequence.clear();
-
-        // Parse character by character - no separator needed
-        // Supports: "12345678", "1 2 3", "1,2,3", "1-4" (range)
-        size_t i = 0;
-        while (i < sequenceText.length()) {
-            char c = sequenceText[i];
-
-            // Skip separators (space, comma, tab)
-            if (c == ' ' || c == ',' || c == '\t') {
-                i++;
-                continue;
-            }
+    /**
+     * 編譯 sequenceText 並發佈（UI 執行緒）
+     * 音訊執行緒還沒確認上一次的切換時，另一份可能仍在讀取，標記 compilePending 之後再試。
+     * audioStopped：建構 / dataFromJson 期間 process() 不會執行，可直接覆寫
+     */
+    void parseSequence(bool audioStopped = false) {
+        int active = activeArrangement.load(std::memory_order_acquire);
+        if (audioStopped) {
+            audioArrangement.store(active, std::memory_order_release);
+        } else if (audioArrangement.load(std::memory_order_acquire) != active) {
+            compilePending = true;
+            return;
+        }
+        int next = 1 - active;
+        SongSequenceCompiler(sequenceText, extendedSyntax).compile(arrangements[next]);
+        activeArrangement.store(next, std::memory_order_release);
+        compilePending = false;
+    }
 
-            // Check for digit
-            if (c >= '1' && c <= '8') {
-                int num = c - '0';
+    const SongArrangement& arrangement() const {
+        return arrangements[activeArrangement.load(std::memory_order_acquire)];
+    }
 
-                // Check if next char is '-' for range
-                if (i + 2 < sequenceText.length() && sequenceText[i + 1] == '-') {
-                    char endChar = sequenceText[i + 2];
-                    if (endChar >= '1' && endChar <= '8') {
-                        int endNum = endChar - '0';
-                        for (int j = num; j <= endNum; j++) {
-                            sequence.push_back(j - 1);
-                        }
-                        i += 3;
-                        continue;
-                    }
-                }
+    int stepLength(const SongStep& step) {
+        return step.length > 0 ? step.length : (int)params[LENGTH_1_PARAM + step.input].getValue();
+    }
 
-                // Single digit
-                sequence.push_back(num - 1);
-            }
-            i++;
-        }
+    int stepCurve(const SongStep& step) const {
+        return step.curve == SONG_FADE_DEFAULT ? defaultFadeCurve : step.curve;
+    }
 
-        // Default to all 8 if empty
-        if (sequence.empty()) {
-            for (int i = 0; i < 8; i++) {
-                sequence.push_back(i);
+    /**
+     * 淡入進度 p（0-1）對應的舊 / 新輸入增益
+     */
+    static void fadeGains(int curve, float p, float& gainOld, float& gainNew) {
+        switch (curve) {
+            case SONG_FADE_LINEAR:
+                gainOld = 1.f - p;
+                gainNew = p;
+                break;
+            case SONG_FADE_SCURVE: {
+                float t = p * p * (3.f - 2.f * p);
+                gainOld = 1.f - t;
+                gainNew = t;
+                break;
             }
+            case SONG_FADE_CUT:
+                gainOld = 0.f;
+                gainNew = 1.f;
+                break;
+            default:
+                gainOld = std::cos(p * float(M_PI) * 0.5f);
+                gainNew = std::sin(p * float(M_PI) * 0.5f);
+                break;
         }
     }
 
     void onReset() override {
         currentSequenceIndex = 0;
         currentClockCount = 0;
-        activeInput = sequence.empty() ? 0 : sequence[0];
+        activeInput = arrangement().steps[0].input;
+        fading = false;
         for (int i = 0; i < 8; i++) {
             learning[i] = false;
             learnClockCount[i] = 0;
@@ -300,6 +539,8 @@ struct SongMode : Module {
         json_object_set_new(rootJ, "panelTheme", json_integer(panelTheme));
         json_object_set_new(rootJ, "panelContrast", json_real(panelContrast));
         json_object_set_new(rootJ, "sequenceText", json_string(sequenceText.c_str()));
+        json_object_set_new(rootJ, "defaultFadeCurve", json_integer(defaultFadeCurve));
+        json_object_set_new(rootJ, "sequenceSyntax", json_integer(extendedSyntax ? 2 : 1));
         return rootJ;
     }
 
@@ -312,14 +553,26 @@ struct SongMode : Module {
         if (contrastJ) {
             panelContrast = json_real_value(contrastJ);
         }
+        // 舊版存檔沒有語法版本：遞減範圍與字母維持舊的意義
+        json_t* syntaxJ = json_object_get(rootJ, "sequenceSyntax");
+        extendedSyntax = syntaxJ ? json_integer_value(syntaxJ) >= 2 : false;
         json_t* seqJ = json_object_get(rootJ, "sequenceText");
         if (seqJ) {
             sequenceText = json_string_value(seqJ);
-            parseSequence();
         }
+        parseSequence(true);
+        // 舊版存檔沒有此欄位：保持原本的線性淡入
+        json_t* curveJ = json_object_get(rootJ, "defaultFadeCurve");
+        defaultFadeCurve = curveJ ? clamp((int)json_integer_value(curveJ), 0, SONG_FADE_CURVES_LEN - 1) : SONG_FADE_LINEAR;
     }
 
     void process(const ProcessArgs& args) override {
+        // 確認目前讀取的步驟表；確認之後舊的一份才交還給 UI 端覆寫
+        int arrangementIndex = activeArrangement.load(std::memory_order_acquire);
+        if (audioArrangement.load(std::memory_order_relaxed) != arrangementIndex) {
+            audioArrangement.store(arrangementIndex, std::memory_order_release);
+        }
+
         // Process reset
         if (resetTrigger.process(inputs[RESET_INPUT].getVoltage(), 0.1f, 1.f)) {
             onReset();
@@ -360,9 +613,14 @@ struct SongMode : Module {
             }
 
             // Advance playback
-            if (!sequence.empty()) {
+            const SongArrangement& arr = arrangement();
+            if (currentSequenceIndex >= arr.count) {
+                currentSequenceIndex = 0;  // 步驟表在播放中被改短
+            }
+            if (arr.count > 0) {
                 currentClockCount++;
-                int currentLength = (int)params[LENGTH_1_PARAM + activeInput].getValue();
+                const SongStep& current = arr.steps[currentSequenceIndex];
+                int currentLength = stepLength(current);
 
                 // Check if we should start fading (N clocks before end)
                 if (fadeClocks > 0 && fadeTimeMs > 0 && !fading) {
@@ -370,14 +628,15 @@ struct SongMode : Module {
                     if (currentClockCount >= fadeStartClock && currentClockCount < currentLength) {
                         // Start fade - prepare next input
                         int nextIndex = currentSequenceIndex + 1;
-                        if (nextIndex >= (int)sequence.size()) {
+                        if (nextIndex >= arr.count) {
                             nextIndex = 0;
                         }
-                        int nextInput = sequence[nextIndex];
-                        if (nextInput != activeInput) {
+                        const SongStep& next = arr.steps[nextIndex];
+                        if (next.input != activeInput && stepCurve(next) != SONG_FADE_CUT) {
                             fading = true;
                             previousInput = activeInput;
                             fadeElapsed = 0.f;
+                            fadeCurve = stepCurve(next);
                         }
                     }
                 }
@@ -386,17 +645,19 @@ struct SongMode : Module {
                     // Move to next in sequence
                     currentClockCount = 0;
                     currentSequenceIndex++;
-                    if (currentSequenceIndex >= (int)sequence.size()) {
+                    if (currentSequenceIndex >= arr.count) {
                         currentSequenceIndex = 0;
                     }
-                    int newInput = sequence[currentSequenceIndex];
+                    const SongStep& next = arr.steps[currentSequenceIndex];
+                    int newInput = next.input;
 
                     // If not already fading, start immediate fade or switch
                     if (!fading && newInput != activeInput) {
-                        if (fadeTimeMs > 0) {
+                        if (fadeTimeMs > 0 && stepCurve(next) != SONG_FADE_CUT) {
                             fading = true;
                             previousInput = activeInput;
                             fadeElapsed = 0.f;
+                            fadeCurve = stepCurve(next);
                         }
                     }
                     activeInput = newInput;
@@ -435,32 +696,33 @@ struct SongMode : Module {
         }
 
         // Route inputs to output with crossfade
+        Input& newPort = inputs[IN_1_INPUT + activeInput];
+        Input& oldPort = inputs[IN_1_INPUT + previousInput];
+        bool crossfade = fading && oldPort.isConnected();
+
         int numChannels = 1;
-        if (inputs[IN_1_INPUT + activeInput].isConnected()) {
-            numChannels = inputs[IN_1_INPUT + activeInput].getChannels();
+        if (newPort.isConnected()) {
+            numChannels = newPort.getChannels();
         }
-        if (fading && inputs[IN_1_INPUT + previousInput].isConnected()) {
-            numChannels = std::max(numChannels, inputs[IN_1_INPUT + previousInput].getChannels());
+        if (crossfade) {
+            numChannels = std::max(numChannels, oldPort.getChannels());
         }
 
         outputs[OUT_OUTPUT].setChannels(numChannels);
 
-        for (int c = 0; c < numChannels; c++) {
-            float newVoltage = 0.f;
-            float oldVoltage = 0.f;
-
-            if (inputs[IN_1_INPUT + activeInput].isConnected()) {
-                newVoltage = inputs[IN_1_INPUT + activeInput].getVoltage(c);
-            }
+        // 增益每個樣本只算一次，所有聲部以 float_4 套用
+        float gainOld = 0.f, gainNew = 1.f;
+        if (crossfade) {
+            fadeGains(fadeCurve, fadeProgress, gainOld, gainNew);
+        }
 
-            if (fading && inputs[IN_1_INPUT + previousInput].isConnected()) {
-                oldVoltage = inputs[IN_1_INPUT + previousInput].getVoltage(c);
-                // Linear crossfade
-                float outVoltage = oldVoltage * (1.f - fadeProgress) + newVoltage * fadeProgress;
-                outputs[OUT_OUTPUT].setVoltage(outVoltage, c);
-            } else {
-                outputs[OUT_OUTPUT].setVoltage(newVoltage, c);
+        for (int c = 0; c < numChannels; c += 4) {
+            float_4 newVoltage = newPort.isConnected() ? newPort.getVoltageSimd<float_4>(c) : float_4(0.f);
+            float_4 outVoltage = newVoltage;
+            if (crossfade) {
+                outVoltage = oldPort.getVoltageSimd<float_4>(c) * gainOld + newVoltage * gainNew;
             }
+            outputs[OUT_OUTPUT].setVoltageSimd(outVoltage, c);
         }
     }
 };
@@ -575,6 +837,10 @@ struct SongModeWidget : ModuleWidget {
             if (textField && textField->getText() != module->sequenceText) {
                 textField->setText(module->sequenceText);
             }
+            // Retry a compile the audio thread had not acknowledged yet
+            if (module->compilePending) {
+                module->parseSequence();
+            }
         }
         ModuleWidget::step();
     }
@@ -583,6 +849,43 @@ struct SongModeWidget : ModuleWidget {
         SongMode* module = dynamic_cast<SongMode*>(this->module);
         if (!module) return;
 
+        menu->addChild(new MenuSeparator());
+
+        const SongArrangement& arr = module->arrangement();
+        menu->addChild(createMenuLabel(string::f("Arrangement: %d steps%s", arr.count,
+                                                 arr.truncated ? " (truncated)" : "")));
+
+        menu->addChild(createSubmenuItem("Default Fade Curve", "",
+            [=](Menu* menu) {
+                const char* names[SONG_FADE_CURVES_LEN] = {"Equal Power", "Linear", "S-Curve", "Cut"};
+                for (int i = 0; i < SONG_FADE_CURVES_LEN; i++) {
+                    menu->addChild(createCheckMenuItem(names[i], "",
+                        [=]() { return module->defaultFadeCurve == i; },
+                        [=]() { module->defaultFadeCurve = i; }
+                    ));
+                }
+            }
+        ));
+
+        menu->addChild(createSubmenuItem("Sequence Syntax", "",
+            [=](Menu* menu) {
+                // Patches saved before the extended syntax load with it off
+                menu->addChild(createCheckMenuItem("Extended syntax", "",
+                    [=]() { return module->extendedSyntax; },
+                    [=]() {
+                        module->extendedSyntax = !module->extendedSyntax;
+                        module->parseSequence();
+                    }
+                ));
+                menu->addChild(new MenuSeparator());
+                menu->addChild(createMenuLabel("1-8: input, a-b: range"));
+                menu->addChild(createMenuLabel("( ... ): group, xN: repeat"));
+                menu->addChild(createMenuLabel(":N: length in clocks"));
+                menu->addChild(createMenuLabel("e / l / s / c: fade curve"));
+                menu->addChild(createMenuLabel("e.g. (12)x4 3:16 (45)x2s"));
+            }
+        ));
+
         addPanelThemeMenu(menu, module);
     }
 };
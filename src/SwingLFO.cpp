@@ -1,7 +1,10 @@
 #include "plugin.hpp"
 #include "widgets/Knobs.hpp"
+#include "widgets/CVModulation.hpp"
 #include "widgets/PanelTheme.hpp"
 
+using simd::float_4;
+
 struct SwingLFO : Module {
     int panelTheme = madzineDefaultTheme;
     float panelContrast = madzineDefaultContrast; // -1 = Auto (follow VCV) // 0 = Sashimi, 1 = Boring
@@ -34,20 +37,19 @@ struct SwingLFO : Module {
         LIGHTS_LEN
     };
 
-    enum WaveformType {
-        SAW = 0,
-        PULSE = 1
+    // 每 4 個聲部一組 float_4，最多 16 聲部
+    float_4 phase[4] = {};
+    float_4 prevResetTrigger[4] = {};
+
+    // CV 調變顯示用（第 1 聲部）
+    enum CvModId {
+        CVMOD_FREQ,
+        CVMOD_SWING,
+        CVMOD_SHAPE,
+        CVMOD_MIX,
+        NUM_CVMODS
     };
-
-    float phase = 0.0f;
-    float secondPhase = 0.0f;
-    float prevResetTrigger = 0.0f;
-
-    // CV 調變顯示用
-    float freqCvMod = 0.0f;
-    float swingCvMod = 0.0f;
-    float shapeCvMod = 0.0f;
-    float mixCvMod = 0.0f;
+    madzine::widgets::CVModBank<NUM_CVMODS> cvMods;
 
     SwingLFO() {
         config(PARAMS_LEN, INPUTS_LEN, OUTPUTS_LEN, LIGHTS_LEN);
@@ -90,117 +92,141 @@ struct SwingLFO : Module {
         }
     }
 
-    float getWaveform(float phase, int waveType, float shape) {
-        switch (waveType) {
-            case SAW: {
-                if (shape < 0.5f) {
-                    // Shape 0-0.5: 往下斜坡 -> 三角波
-                    float rampWave = 1.0f - phase;  // 下降斜坡 (1 -> 0)
-                    float triWave = (phase < 0.5f) ? (2.0f * phase) : (2.0f - 2.0f * phase);  // 三角波
-                    float mix = shape * 2.0f;
-                    return (rampWave * (1.0f - mix) + triWave * mix) * 10.0f;
-                } else {
-                    // Shape 0.5-1: 三角波 -> 往上鋸齒
-                    float triWave = (phase < 0.5f) ? (2.0f * phase) : (2.0f - 2.0f * phase);  // 三角波
-                    float sawWave = phase;  // 上升鋸齒 (0 -> 1)
-                    float mix = (shape - 0.5f) * 2.0f;
-                    return (triWave * (1.0f - mix) + sawWave * mix) * 10.0f;
-                }
-            }
-            case PULSE: {
-                float pulseWidth = 0.01f + shape * 0.29f;
-                return (phase < pulseWidth) ? 10.0f : 0.0f;
-            }
-            default:
-                return 0.0f;
-        }
+    /**
+     * PolyBLEP：單位階躍的修正量（t = 距離不連續點的相位，dt = 每樣本相位增量）
+     * 對應 NIGOQ 的 polyBLEP，此處為 4 聲部並行版本
+     */
+    static float_4 polyBLEP(float_4 t, float_4 dt) {
+        float_4 x0 = t / dt;
+        float_4 before = x0 + x0 - x0 * x0 - 1.0f;
+        float_4 x1 = (t - 1.0f) / dt;
+        float_4 after = x1 * x1 + x1 + x1 + 1.0f;
+        return simd::ifelse(t < dt, before, simd::ifelse(t > 1.0f - dt, after, float_4(0.0f)));
+    }
+
+    /**
+     * PolyBLAMP：斜率轉折的修正量（三次多項式，與 polyBLEP 同尺度）
+     */
+    static float_4 polyBLAMP(float_4 t, float_4 dt) {
+        float_4 x0 = t / dt - 1.0f;
+        float_4 before = -1.0f / 3.0f * x0 * x0 * x0;
+        float_4 x1 = (t - 1.0f) / dt + 1.0f;
+        float_4 after = 1.0f / 3.0f * x1 * x1 * x1;
+        return simd::ifelse(t < dt, before, simd::ifelse(t > 1.0f - dt, after, float_4(0.0f)));
+    }
+
+    static float_4 wrapPhase(float_4 p) {
+        return p - simd::floor(p);
+    }
+
+    /**
+     * SAW 輸出：Shape 0-0.5 由下降斜坡到三角波，0.5-1 由三角波到上升鋸齒（0-10V）
+     * 斜坡 / 鋸齒在相位 0 的跳躍以 polyBLEP 修正，三角波在 0 與 0.5 的轉折以 polyBLAMP 修正
+     */
+    static float_4 sawWave(float_4 p, float_4 dt, float_4 shape) {
+        float_4 lowHalf = shape < 0.5f;
+        float_4 m = simd::ifelse(lowHalf, shape * 2.0f, (shape - 0.5f) * 2.0f);
+        // 三種波形的權重
+        float_4 rampAmount = simd::ifelse(lowHalf, 1.0f - m, float_4(0.0f));
+        float_4 sawAmount = simd::ifelse(lowHalf, float_4(0.0f), m);
+        float_4 triAmount = 1.0f - rampAmount - sawAmount;
+
+        float_4 ramp = 1.0f - p;
+        float_4 tri = simd::ifelse(p < 0.5f, 2.0f * p, 2.0f - 2.0f * p);
+        float_4 out = rampAmount * ramp + triAmount * tri + sawAmount * p;
+
+        // 相位 0 的跳躍：斜坡 0 -> 1，鋸齒 1 -> 0
+        out -= 0.5f * (sawAmount - rampAmount) * polyBLEP(p, dt);
+        // 三角波斜率 -2 -> +2（相位 0）與 +2 -> -2（相位 0.5）
+        float_4 halfPhase = wrapPhase(p + 0.5f);
+        out += 2.0f * triAmount * dt * (polyBLAMP(p, dt) - polyBLAMP(halfPhase, dt));
+        return out * 10.0f;
+    }
+
+    /**
+     * PULSE 輸出：脈寬 1%-30%（0-10V），上升與下降沿都以 polyBLEP 修正
+     */
+    static float_4 pulseWave(float_4 p, float_4 dt, float_4 shape) {
+        float_4 pulseWidth = 0.01f + shape * 0.29f;
+        float_4 out = simd::ifelse(p < pulseWidth, float_4(1.0f), float_4(0.0f));
+        out += 0.5f * polyBLEP(p, dt);
+        out -= 0.5f * polyBLEP(wrapPhase(p - pulseWidth), dt);
+        return out * 10.0f;
     }
 
     void process(const ProcessArgs& args) override {
-        float freqParam = params[FREQ_PARAM].getValue();
-        float freqCVAttenuation = params[FREQ_CV_ATTEN_PARAM].getValue();
-        float freqCV = 0.0f;
-        if (inputs[FREQ_CV_INPUT].isConnected()) {
-            freqCV = inputs[FREQ_CV_INPUT].getVoltage() * freqCVAttenuation;
-            freqCvMod = clamp(freqCV / 10.0f, -1.0f, 1.0f);
-        } else {
-            freqCvMod = 0.0f;
+        int channels = 1;
+        for (int i = 0; i < INPUTS_LEN; i++) {
+            channels = std::max(channels, inputs[i].getChannels());
         }
-        float freq = std::pow(2.0f, freqParam + freqCV) * 1.0f;
 
+        float freqParam = params[FREQ_PARAM].getValue();
+        float freqCVAttenuation = params[FREQ_CV_ATTEN_PARAM].getValue();
         float swingParam = params[SWING_PARAM].getValue();
-        float swingCV = 0.0f;
-        if (inputs[SWING_CV_INPUT].isConnected()) {
-            float swingCVAttenuation = params[SWING_CV_ATTEN_PARAM].getValue();
-            swingCV = inputs[SWING_CV_INPUT].getVoltage() / 10.0f * swingCVAttenuation;
-            swingCvMod = clamp(swingCV * 2.0f, -1.0f, 1.0f);
-        } else {
-            swingCvMod = 0.0f;
-        }
-        float swing = swingParam + swingCV;
-        swing = clamp(swing, 0.0f, 1.0f);
-
+        float swingCVAttenuation = params[SWING_CV_ATTEN_PARAM].getValue();
         float shapeParam = params[SHAPE_PARAM].getValue();
-        float shapeCV = 0.0f;
-        if (inputs[SHAPE_CV_INPUT].isConnected()) {
-            float shapeCVAttenuation = params[SHAPE_CV_ATTEN_PARAM].getValue();
-            shapeCV = inputs[SHAPE_CV_INPUT].getVoltage() / 10.0f * shapeCVAttenuation;
-            shapeCvMod = clamp(shapeCV * 2.0f, -1.0f, 1.0f);
-        } else {
-            shapeCvMod = 0.0f;
-        }
-        float shape = shapeParam + shapeCV;
-        shape = clamp(shape, 0.0f, 1.0f);
-
+        float shapeCVAttenuation = params[SHAPE_CV_ATTEN_PARAM].getValue();
         float mixParam = params[MIX_PARAM].getValue();
-        float mixCV = 0.0f;
-        if (inputs[MIX_CV_INPUT].isConnected()) {
-            float mixCVAttenuation = params[MIX_CV_ATTEN_PARAM].getValue();
-            mixCV = inputs[MIX_CV_INPUT].getVoltage() / 10.0f * mixCVAttenuation;
-            mixCvMod = clamp(mixCV * 2.0f, -1.0f, 1.0f);
-        } else {
-            mixCvMod = 0.0f;
-        }
-        float mix = mixParam + mixCV;
-        mix = clamp(mix, 0.0f, 1.0f);
-        
-        float phaseOffset = (180.0f - swing * 90.0f) * M_PI / 180.0f;
-        
-        float resetTrigger = 0.0f;
-        if (inputs[RESET_INPUT].isConnected()) {
-            resetTrigger = inputs[RESET_INPUT].getVoltage();
-            if (resetTrigger >= 2.0f && prevResetTrigger < 2.0f) {
-                phase = 0.0f;
-                secondPhase = phaseOffset / (2.0f * M_PI);
-                while (secondPhase >= 1.0f)
-                    secondPhase -= 1.0f;
+        float mixCVAttenuation = params[MIX_CV_ATTEN_PARAM].getValue();
+
+        bool sawConnected = outputs[SAW_OUTPUT].isConnected();
+        bool pulseConnected = outputs[PULSE_OUTPUT].isConnected();
+
+        for (int c = 0; c < channels; c += 4) {
+            int g = c / 4;
+
+            float_4 freqCV = inputs[FREQ_CV_INPUT].getPolyVoltageSimd<float_4>(c) * freqCVAttenuation;
+            float_4 freq = dsp::exp2_taylor5(freqParam + freqCV);
+
+            float_4 swingCV = inputs[SWING_CV_INPUT].getPolyVoltageSimd<float_4>(c) / 10.0f * swingCVAttenuation;
+            float_4 swing = simd::clamp(swingParam + swingCV, 0.0f, 1.0f);
+
+            float_4 shapeCV = inputs[SHAPE_CV_INPUT].getPolyVoltageSimd<float_4>(c) / 10.0f * shapeCVAttenuation;
+            float_4 shape = simd::clamp(shapeParam + shapeCV, 0.0f, 1.0f);
+
+            float_4 mixCV = inputs[MIX_CV_INPUT].getPolyVoltageSimd<float_4>(c) / 10.0f * mixCVAttenuation;
+            float_4 mix = simd::clamp(mixParam + mixCV, 0.0f, 1.0f);
+
+            if (c == 0) {
+                auto publishCvMod = [&](int id, int inputId, float mod) {
+                    if (inputs[inputId].isConnected()) cvMods.publish(id, clamp(mod, -1.0f, 1.0f));
+                    else cvMods.clear(id);
+                };
+                publishCvMod(CVMOD_FREQ, FREQ_CV_INPUT, freqCV[0] / 10.0f);
+                publishCvMod(CVMOD_SWING, SWING_CV_INPUT, swingCV[0] * 2.0f);
+                publishCvMod(CVMOD_SHAPE, SHAPE_CV_INPUT, shapeCV[0] * 2.0f);
+                publishCvMod(CVMOD_MIX, MIX_CV_INPUT, mixCV[0] * 2.0f);
+            }
+
+            // Reset：2V 上升沿把該聲部相位歸零（單聲部 Reset 套用到所有聲部）
+            float_4 resetTrigger = inputs[RESET_INPUT].getPolyVoltageSimd<float_4>(c);
+            float_4 resetRise = (resetTrigger >= 2.0f) & (prevResetTrigger[g] < 2.0f);
+            prevResetTrigger[g] = resetTrigger;
+            phase[g] = simd::ifelse(resetRise, float_4(0.0f), phase[g]);
+
+            // 相位增量上限 0.5，避免 CV 推到極高頻時一次跨過多個週期
+            float_4 deltaPhase = simd::fmin(freq * args.sampleTime, 0.5f);
+            phase[g] += deltaPhase;
+            phase[g] = simd::ifelse(phase[g] >= 1.0f, phase[g] - 1.0f, phase[g]);
+
+            // 第二相位：偏移 180° - swing * 90°
+            float_4 secondPhase = wrapPhase(phase[g] + (0.5f - swing * 0.25f));
+
+            if (sawConnected) {
+                float_4 mainSaw = sawWave(phase[g], deltaPhase, shape);
+                float_4 secondSaw = sawWave(secondPhase, deltaPhase, shape);
+                outputs[SAW_OUTPUT].setVoltageSimd(mainSaw * (1.0f - mix) + secondSaw * mix, c);
+            }
+
+            if (pulseConnected) {
+                float_4 mainPulse = pulseWave(phase[g], deltaPhase, shape);
+                float_4 secondPulse = pulseWave(secondPhase, deltaPhase, shape);
+                outputs[PULSE_OUTPUT].setVoltageSimd(mainPulse * (1.0f - mix) + secondPulse * mix, c);
             }
-            prevResetTrigger = resetTrigger;
-        }
-        
-        float deltaPhase = freq * args.sampleTime;
-        phase += deltaPhase;
-        if (phase >= 1.0f) {
-            phase -= 1.0f;
-        }
-        
-        secondPhase = phase + (phaseOffset / (2.0f * M_PI));
-        while (secondPhase >= 1.0f)
-            secondPhase -= 1.0f;
-        
-        if (outputs[SAW_OUTPUT].isConnected()) {
-            float mainSaw = getWaveform(phase, SAW, shape);
-            float secondSaw = getWaveform(secondPhase, SAW, shape);
-            float mixedSaw = mainSaw * (1.0f - mix) + secondSaw * mix;
-            outputs[SAW_OUTPUT].setVoltage(mixedSaw);
-        }
-        
-        if (outputs[PULSE_OUTPUT].isConnected()) {
-            float mainPulse = getWaveform(phase, PULSE, shape);
-            float secondPulse = getWaveform(secondPhase, PULSE, shape);
-            float mixedPulse = mainPulse * (1.0f - mix) + secondPulse * mix;
-            outputs[PULSE_OUTPUT].setVoltage(mixedPulse);
         }
+
+        outputs[SAW_OUTPUT].setChannels(channels);
+        outputs[PULSE_OUTPUT].setChannels(channels);
     }
 };
 
@@ -264,6 +290,7 @@ struct SwingLFOWidget : ModuleWidget {
     madzine::widgets::StandardBlackKnob26* swingKnob = nullptr;
     madzine::widgets::StandardBlackKnob26* shapeKnob = nullptr;
     madzine::widgets::StandardBlackKnob26* mixKnob = nullptr;
+    madzine::widgets::CVModRingSync<SwingLFO::NUM_CVMODS> cvModSync;
 
     SwingLFOWidget(SwingLFO* module) {
         setModule(module);
@@ -279,6 +306,7 @@ struct SwingLFOWidget : ModuleWidget {
         addChild(new EnhancedTextLabel(Vec(0, 26), Vec(box.size.x, 20), "FREQ", 8.f, nvgRGB(255, 255, 255), true));
         freqKnob = createParamCentered<madzine::widgets::StandardBlackKnob26>(Vec(centerX + 15, 59), module, SwingLFO::FREQ_PARAM);
         addParam(freqKnob);
+        cvModSync.bind(SwingLFO::CVMOD_FREQ, freqKnob);
         
         addChild(new EnhancedTextLabel(Vec(5, 40), Vec(20, 20), "RST", 8.f, nvgRGB(255, 255, 255), true));
         addInput(createInputCentered<PJ301MPort>(Vec(centerX - 15, 65), module, SwingLFO::RESET_INPUT));
@@ -289,6 +317,7 @@ struct SwingLFOWidget : ModuleWidget {
         addChild(new EnhancedTextLabel(Vec(0, 105), Vec(box.size.x, 20), "SWING", 8.f, nvgRGB(255, 255, 255), true));
         swingKnob = createParamCentered<madzine::widgets::StandardBlackKnob26>(Vec(centerX, 136), module, SwingLFO::SWING_PARAM);
         addParam(swingKnob);
+        cvModSync.bind(SwingLFO::CVMOD_SWING, swingKnob);
 
         addParam(createParamCentered<madzine::widgets::MicrotuneKnob>(Vec(centerX - 15, 166), module, SwingLFO::SWING_CV_ATTEN_PARAM));
         addInput(createInputCentered<PJ301MPort>(Vec(centerX + 15, 166), module, SwingLFO::SWING_CV_INPUT));
@@ -296,6 +325,7 @@ struct SwingLFOWidget : ModuleWidget {
         addChild(new EnhancedTextLabel(Vec(0, 182), Vec(box.size.x, 20), "SHAPE", 8.f, nvgRGB(255, 255, 255), true));
         shapeKnob = createParamCentered<madzine::widgets::StandardBlackKnob26>(Vec(centerX, 214), module, SwingLFO::SHAPE_PARAM);
         addParam(shapeKnob);
+        cvModSync.bind(SwingLFO::CVMOD_SHAPE, shapeKnob);
 
         addParam(createParamCentered<madzine::widgets::MicrotuneKnob>(Vec(centerX - 15, 244), module, SwingLFO::SHAPE_CV_ATTEN_PARAM));
         addInput(createInputCentered<PJ301MPort>(Vec(centerX + 15, 244), module, SwingLFO::SHAPE_CV_INPUT));
@@ -303,6 +333,7 @@ struct SwingLFOWidget : ModuleWidget {
         addChild(new EnhancedTextLabel(Vec(0, 257), Vec(box.size.x, 20), "MIX", 8.f, nvgRGB(255, 255, 255), true));
         mixKnob = createParamCentered<madzine::widgets::StandardBlackKnob26>(Vec(centerX, 289), module, SwingLFO::MIX_PARAM);
         addParam(mixKnob);
+        cvModSync.bind(SwingLFO::CVMOD_MIX, mixKnob);
 
         addParam(createParamCentered<madzine::widgets::MicrotuneKnob>(Vec(centerX - 15, 317), module, SwingLFO::MIX_CV_ATTEN_PARAM));
         addInput(createInputCentered<PJ301MPort>(Vec(centerX + 15, 317), module, SwingLFO::MIX_CV_INPUT));
@@ -321,27 +352,8 @@ struct SwingLFOWidget : ModuleWidget {
         if (module) {
             panelThemeHelper.step(module);
 
-            // 更新 CV 調變顯示
-            if (freqKnob) {
-                bool connected = module->inputs[SwingLFO::FREQ_CV_INPUT].isConnected();
-                freqKnob->setModulationEnabled(connected);
-                if (connected) freqKnob->setModulation(module->freqCvMod);
-            }
-            if (swingKnob) {
-                bool connected = module->inputs[SwingLFO::SWING_CV_INPUT].isConnected();
-                swingKnob->setModulationEnabled(connected);
-                if (connected) swingKnob->setModulation(module->swingCvMod);
-            }
-            if (shapeKnob) {
-                bool connected = module->inputs[SwingLFO::SHAPE_CV_INPUT].isConnected();
-                shapeKnob->setModulationEnabled(connected);
-                if (connected) shapeKnob->setModulation(module->shapeCvMod);
-            }
-            if (mixKnob) {
-                bool connected = module->inputs[SwingLFO::MIX_CV_INPUT].isConnected();
-                mixKnob->setModulationEnabled(connected);
-                if (connected) mixKnob->setModulation(module->mixCvMod);
-            }
+            // 更新 CV 調變顯示（僅在數值變化時）
+            cvModSync.sync(module->cvMods);
         }
         ModuleWidget::step();
     }
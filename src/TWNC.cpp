@@ -1,5 +1,6 @@
 #include "plugin.hpp"
 #include "widgets/Knobs.hpp"
+#include "widgets/CVModulation.hpp"
 #include "widgets/PanelTheme.hpp"
 #include <vector>
 #include <algorithm>
@@ -421,10 +422,14 @@ struct TWNC : Module {
     dsp::PulseGenerator track2FlashPulse;
 
     // CV 調變顯示用
-    float drumFreqCvMod = 0.0f;
-    float drumDecayCvMod = 0.0f;
-    float hatsFreqCvMod = 0.0f;
-    float hatsDecayCvMod = 0.0f;
+    enum CvModId {
+        CVMOD_DRUM_FREQ,
+        CVMOD_DRUM_DECAY,
+        CVMOD_HATS_FREQ,
+        CVMOD_HATS_DECAY,
+        NUM_CVMODS
+    };
+    madzine::widgets::CVModBank<NUM_CVMODS> cvMods;
     
     OversampledSineVCO sineVCO;
     OversampledSineVCO sineVCO2;
@@ -757,9 +762,9 @@ struct TWNC : Module {
                     float cv = inputs[DRUM_DECAY_CV_INPUT].getVoltage();
                     decayParam += cv / 10.0f;
                     decayParam = clamp(decayParam, 0.01f, 2.0f);
-                    drumDecayCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+                    cvMods.publish(CVMOD_DRUM_DECAY, clamp(cv / 10.0f, -1.0f, 1.0f));
                 } else {
-                    drumDecayCvMod = 0.0f;
+                    cvMods.clear(CVMOD_DRUM_DECAY);
                 }
                 float shapeParam = params[TRACK1_SHAPE_PARAM].getValue();
                 
@@ -784,9 +789,9 @@ struct TWNC : Module {
                 if (inputs[DRUM_FREQ_CV_INPUT].isConnected()) {
                     float cv = inputs[DRUM_FREQ_CV_INPUT].getVoltage();
                     freqParam += cv;
-                    drumFreqCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+                    cvMods.publish(CVMOD_DRUM_FREQ, clamp(cv / 10.0f, -1.0f, 1.0f));
                 } else {
-                    drumFreqCvMod = 0.0f;
+                    cvMods.clear(CVMOD_DRUM_FREQ);
                 }
                 freqParam = std::pow(2.0f, freqParam);
                 
@@ -816,9 +821,9 @@ struct TWNC : Module {
                     float cv = inputs[HATS_DECAY_CV_INPUT].getVoltage();
                     decayParam += cv / 10.0f;
                     decayParam = clamp(decayParam, 0.01f, 2.0f);
-                    hatsDecayCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+                    cvMods.publish(CVMOD_HATS_DECAY, clamp(cv / 10.0f, -1.0f, 1.0f));
                 } else {
-                    hatsDecayCvMod = 0.0f;
+                    cvMods.clear(CVMOD_HATS_DECAY);
                 }
                 float shapeParam = params[TRACK2_SHAPE_PARAM].getValue();
                 
@@ -844,9 +849,9 @@ struct TWNC : Module {
                 if (inputs[HATS_FREQ_CV_INPUT].isConnected()) {
                     float cv = inputs[HATS_FREQ_CV_INPUT].getVoltage();
                     freqParam += cv;
-                    hatsFreqCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+                    cvMods.publish(CVMOD_HATS_FREQ, clamp(cv / 10.0f, -1.0f, 1.0f));
                 } else {
-                    hatsFreqCvMod = 0.0f;
+                    cvMods.clear(CVMOD_HATS_FREQ);
                 }
                 freqParam = std::pow(2.0f, freqParam);
                 float audioOutput = sineVCO2.process(freqParam, noiseBlend);
@@ -875,6 +880,7 @@ struct TWNCWidget : ModuleWidget {
     TechnoStandardBlackKnob30* drumDecayKnob = nullptr;
     TechnoStandardBlackKnob30* hatsFreqKnob = nullptr;
     TechnoStandardBlackKnob30* hatsDecayKnob = nullptr;
+    madzine::widgets::CVModRingSync<TWNC::NUM_CVMODS> cvModSync;
 
     TWNCWidget(TWNC* module) {
         setModule(module);
@@ -950,6 +956,12 @@ struct TWNCWidget : ModuleWidget {
         addChild(new TechnoEnhancedTextLabel(Vec(30, track2Y + 56), Vec(30, 10), "DECAY", 8.f, nvgRGB(255, 255, 255), true));
         hatsDecayKnob = createParamCentered<TechnoStandardBlackKnob30>(Vec(45, track2Y + 80), module, TWNC::TRACK2_DECAY_PARAM);
         addParam(hatsDecayKnob);
+
+        cvModSync.bind(TWNC::CVMOD_DRUM_FREQ, drumFreqKnob);
+        cvModSync.bind(TWNC::CVMOD_DRUM_DECAY, drumDecayKnob);
+        cvModSync.bind(TWNC::CVMOD_HATS_FREQ, hatsFreqKnob);
+        cvModSync.bind(TWNC::CVMOD_HATS_DECAY, hatsDecayKnob);
+
         
         addChild(new TechnoEnhancedTextLabel(Vec(60, track2Y + 56), Vec(30, 10), "SHAPE", 8.f, nvgRGB(255, 255, 255), true));
         addParam(createParamCentered<TechnoStandardBlackKnob30>(Vec(75, track2Y + 80), module, TWNC::TRACK2_SHAPE_PARAM));
@@ -991,19 +1003,8 @@ struct TWNCWidget : ModuleWidget {
         if (module) {
             panelThemeHelper.step(module);
 
-            // 更新 CV 調變顯示
-            auto updateKnob = [&](TechnoStandardBlackKnob30* knob, int inputId, float cvMod) {
-                if (knob) {
-                    bool connected = module->inputs[inputId].isConnected();
-                    knob->setModulationEnabled(connected);
-                    if (connected) knob->setModulation(cvMod);
-                }
-            };
-
-            updateKnob(drumFreqKnob, TWNC::DRUM_FREQ_CV_INPUT, module->drumFreqCvMod);
-            updateKnob(drumDecayKnob, TWNC::DRUM_DECAY_CV_INPUT, module->drumDecayCvMod);
-            updateKnob(hatsFreqKnob, TWNC::HATS_FREQ_CV_INPUT, module->hatsFreqCvMod);
-            updateKnob(hatsDecayKnob, TWNC::HATS_DECAY_CV_INPUT, module->hatsDecayCvMod);
+            // 更新 CV 調變顯示（僅在數值變化時）
+            cvModSync.sync(module->cvMods);
         }
         ModuleWidget::step();
     }
@@ -1,8 +1,10 @@
 #include "plugin.hpp"
 #include "widgets/Knobs.hpp"
+#include "widgets/CVModulation.hpp"
 #include "widgets/PanelTheme.hpp"
 #include <vector>
 #include <algorithm>
+#include <cstring>
 
 struct TechnoEnhancedTextLabel : TransparentWidget {
     std::string text;
@@ -61,23 +63,78 @@ struct WhiteBackgroundBox : Widget {
     }
 };
 
+// ===== 快速近似（取代每樣本的 std::sin / std::tanh / std::pow） =====
+
+/**
+ * sin(2π * phase)，phase 在 [0, 1)
+ * 先折到 [-1, 1] 的四分之一週期，再用 9 階奇多項式，誤差約 4e-6
+ */
+inline float fastSinCycle(float phase) {
+    float q = phase * 4.0f;
+    float u = (q < 1.0f) ? q : (q < 3.0f) ? (2.0f - q) : (q - 4.0f);
+    float u2 = u * u;
+    return u * (1.5707963f + u2 * (-0.64596409f + u2 * (0.079692626f + u2 * (-0.0046817541f + u2 * 0.00016044118f))));
+}
+
+/**
+ * tanh 的 [7/6] Padé 近似，誤差約 1e-4，|x| > 4.97 直接飽和
+ */
+inline float fastTanh(float x) {
+    if (x > 4.97f) return 1.0f;
+    if (x < -4.97f) return -1.0f;
+    float x2 = x * x;
+    return x * (135135.0f + x2 * (17325.0f + x2 * (378.0f + x2)))
+             / (135135.0f + x2 * (62370.0f + x2 * (3150.0f + x2 * 28.0f)));
+}
+
+/**
+ * log2 近似：取浮點指數，尾數 [1, 2) 用三次多項式，誤差約 1.3e-3
+ */
+inline float fastLog2(float x) {
+    int32_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    float exponent = (float)(((bits >> 23) & 0xff) - 127);
+    bits = (bits & 0x007fffff) | 0x3f800000;
+    float m;
+    std::memcpy(&m, &bits, sizeof(m));
+    float t = m - 1.0f;
+    return exponent + t * (1.4234902f + t * (-0.58775347f + t * 0.16557608f));
+}
+
+/**
+ * x^y（x > 0），包絡曲線用
+ */
+inline float fastPow(float x, float y) {
+    if (x <= 0.0f) return 0.0f;
+    return dsp::exp2_taylor5(y * fastLog2(x));
+}
+
 struct BasicBandpassFilter {
     float x1 = 0.0f, x2 = 0.0f, x3 = 0.0f;
     float y1 = 0.0f, y2 = 0.0f, y3 = 0.0f;
     float sampleRate = 44100.0f;
     float lastFreq = 1000.0f;
     float lastQ = 0.5f;
+
+    // 係數只在頻率 / Q / 取樣率改變時重算
+    float b0 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f;
+    float a3 = 0.0f, b3 = 0.0f, blend = 0.0f;
+    bool coefficientsValid = false;
     
     void setSampleRate(float sr) {
         sampleRate = sr;
+        coefficientsValid = false;
     }
     
     void setFrequency(float freq, float q = 0.5f) {
-        lastFreq = clamp(freq, 20.0f, sampleRate * 0.45f);
+        freq = clamp(freq, 20.0f, sampleRate * 0.45f);
+        if (coefficientsValid && freq == lastFreq && q == lastQ) return;
+        lastFreq = freq;
         lastQ = q;
+        updateCoefficients();
     }
-    
-    float process(float input) {
+
+    void updateCoefficients() {
         float omega = 2.0f * M_PI * lastFreq / sampleRate;
         float sin_omega = std::sin(omega);
         float cos_omega = std::cos(omega);
@@ -87,24 +144,33 @@ struct BasicBandpassFilter {
         
         float alpha = sin_omega / (2.0f * q);
         float norm = 1.0f / (1.0f + alpha);
-        float b0 = alpha * norm;
-        float b2 = -alpha * norm;
-        float a1 = -2.0f * cos_omega * norm;
-        float a2 = (1.0f - alpha) * norm;
-        
-        float output = b0 * input + b2 * x2 - a1 * y1 - a2 * y2;
-        
+        b0 = alpha * norm;
+        b2 = -alpha * norm;
+        a1 = -2.0f * cos_omega * norm;
+        a2 = (1.0f - alpha) * norm;
+
         if (q > 1.5f) {
             float pole3_cutoff = lastFreq * 1.2f;
             float omega3 = 2.0f * M_PI * pole3_cutoff / sampleRate;
-            float a3 = -std::cos(omega3);
-            float b3 = (1.0f - std::cos(omega3)) / 2.0f;
-            
+            a3 = -std::cos(omega3);
+            b3 = (1.0f - std::cos(omega3)) / 2.0f;
+            blend = (q - 1.5f) / 1.5f;
+        } else {
+            blend = 0.0f;
+        }
+        coefficientsValid = true;
+    }
+    
+    float process(float input) {
+        if (!coefficientsValid) updateCoefficients();
+
+        float output = b0 * input + b2 * x2 - a1 * y1 - a2 * y2;
+        
+        if (blend > 0.0f) {
             float stage3 = b3 * output + b3 * x3 - a3 * y3;
             x3 = output;
             y3 = stage3;
             
-            float blend = (q - 1.5f) / 1.5f;
             output = output * (1.0f - blend) + stage3 * blend;
         }
         
@@ -124,13 +190,22 @@ struct BasicBandpassFilter {
 struct BasicSineVCO {
     float phase = 0.0f;
     float sampleRate = 44100.0f;
+    float saturation = 1.0f;
+    float saturationNorm = 1.0f;  // 1 / tanh(saturation)
     
     void setSampleRate(float sr) {
         sampleRate = sr;
     }
+
+    // 控制率呼叫：飽和量改變時才重算正規化
+    void setSaturation(float sat) {
+        if (sat == saturation) return;
+        saturation = sat;
+        saturationNorm = (sat > 1.0f) ? 1.0f / std::tanh(sat) : 1.0f;
+    }
     
-    float process(float freq_hz, float fm_cv, float saturation = 1.0f) {
-        float modulated_freq = freq_hz * std::pow(2.0f, fm_cv);
+    float process(float freq_hz, float fm_cv) {
+        float modulated_freq = (fm_cv != 0.0f) ? freq_hz * dsp::exp2_taylor5(fm_cv) : freq_hz;
         modulated_freq = clamp(modulated_freq, 1.0f, sampleRate * 0.45f);
         
         float delta_phase = modulated_freq / sampleRate;
@@ -140,10 +215,10 @@ struct BasicSineVCO {
             phase -= 1.0f;
         }
         
-        float sine_wave = std::sin(2.0f * M_PI * phase);
+        float sine_wave = fastSinCycle(phase);
         
         if (saturation > 1.0f) {
-            sine_wave = std::tanh(sine_wave * saturation) / std::tanh(saturation);
+            sine_wave = fastTanh(sine_wave * saturation) * saturationNorm;
         }
         
         return sine_wave * 5.0f;
@@ -200,11 +275,31 @@ struct TWNC2 : Module {
     BasicBandpassFilter hatsFilter;
 
     // CV 調變顯示用
-    float kickFreqCvMod = 0.0f;
-    float kickFmCvMod = 0.0f;
-    float kickPunchCvMod = 0.0f;
-    float snareNoiseMixCvMod = 0.0f;
-    float hatsDecayCvMod = 0.0f;
+    enum CvModId {
+        CVMOD_KICK_FREQ,
+        CVMOD_KICK_FM,
+        CVMOD_KICK_PUNCH,
+        CVMOD_SNARE_NOISE_MIX,
+        CVMOD_HATS_DECAY,
+        NUM_CVMODS
+    };
+    madzine::widgets::CVModBank<NUM_CVMODS> cvMods;
+
+    // 控制率參數（每 CONTROL_DIVISION 個樣本更新一次）
+    static constexpr int CONTROL_DIVISION = 16;
+    dsp::ClockDivider controlDivider;
+    float duckAmount = 0.0f;
+    float kickVolume = 1.0f;
+    float kickFmAmount = 0.0f;
+    float kickFreq = 24.0f;
+    float snareVolume = 1.0f;
+    float snareBaseFreq = 100.0f;
+    float snareNoiseTone = 0.0f;
+    float snareNoiseMix = 0.0f;
+    float hatsVolume = 1.0f;
+    float hatsBaseFreq = 1000.0f;
+    float hatsNoiseAmount = 0.0f;
+    float hatsVcaDecay = 2.0f;
     
     struct HatsOscillator {
         float phases[6] = {0.0f};
@@ -298,6 +393,9 @@ struct TWNC2 : Module {
         hatsFilter.setSampleRate(44100.0f);
         hatsOsc.setSampleRate(44100.0f);
         hatsDelay.setSampleRate(44100.0f);
+
+        controlDivider.setDivision(CONTROL_DIVISION);
+        updateControls(0.0f);
     }
 
     void onSampleRateChange() override {
@@ -331,135 +429,151 @@ struct TWNC2 : Module {
         }
     }
 
-    void process(const ProcessArgs& args) override {
-        float kickEnvCV = clamp(inputs[KICK_ENV_INPUT].getVoltage() / 10.0f, 0.0f, 1.0f);
-        float kickAccentCV = clamp(inputs[KICK_ACCENT_INPUT].getVoltage() / 10.0f, 0.0f, 1.0f);
-        float duckAmount = params[DUCK_PARAM].getValue();
-        float sidechainCV = 1.0f - (kickAccentCV * duckAmount * 3.0f);
-        
-        float kickVolumeParam = params[KICK_VOLUME_PARAM].getValue();
+    /**
+     * 控制率：旋鈕、CV 與由它們推導的頻率 / 曲線 / 濾波器係數
+     */
+    void updateControls(float snareEnvCV) {
+        duckAmount = params[DUCK_PARAM].getValue();
+
+        kickVolume = params[KICK_VOLUME_PARAM].getValue();
         float kickPunchAmount = params[KICK_PUNCH_PARAM].getValue();
         if (inputs[KICK_PUNCH_CV_INPUT].isConnected()) {
             float cv = inputs[KICK_PUNCH_CV_INPUT].getVoltage();
             kickPunchAmount += cv / 10.0f;
             kickPunchAmount = clamp(kickPunchAmount, 0.0f, 1.0f);
-            kickPunchCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+            cvMods.publish(CVMOD_KICK_PUNCH, clamp(cv / 10.0f, -1.0f, 1.0f));
         } else {
-            kickPunchCvMod = 0.0f;
+            cvMods.clear(CVMOD_KICK_PUNCH);
         }
+        kickVCO.setSaturation(1.0f + (kickPunchAmount * 4.0f));
 
-        float kickFmAmount = params[KICK_FM_AMT_PARAM].getValue() * 20.0f;
+        kickFmAmount = params[KICK_FM_AMT_PARAM].getValue() * 20.0f;
         if (inputs[KICK_FM_CV_INPUT].isConnected()) {
             float cv = inputs[KICK_FM_CV_INPUT].getVoltage();
             kickFmAmount += (cv / 10.0f) * 20.0f;
             kickFmAmount = clamp(kickFmAmount, 0.0f, 20.0f);
-            kickFmCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+            cvMods.publish(CVMOD_KICK_FM, clamp(cv / 10.0f, -1.0f, 1.0f));
         } else {
-            kickFmCvMod = 0.0f;
+            cvMods.clear(CVMOD_KICK_FM);
         }
 
-        float kickFreqParam = std::pow(2.0f, params[KICK_FREQ_PARAM].getValue());
+        float kickFreqPitch = params[KICK_FREQ_PARAM].getValue();
         if (inputs[KICK_FREQ_CV_INPUT].isConnected()) {
             float cv = inputs[KICK_FREQ_CV_INPUT].getVoltage();
-            float freqCV = params[KICK_FREQ_PARAM].getValue() + cv;
-            kickFreqParam = std::pow(2.0f, freqCV);
-            kickFreqParam = clamp(kickFreqParam, std::pow(2.0f, std::log2(24.0f)), std::pow(2.0f, std::log2(500.0f)));
-            kickFreqCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+            kickFreqPitch = clamp(kickFreqPitch + cv, std::log2(24.0f), std::log2(500.0f));
+            cvMods.publish(CVMOD_KICK_FREQ, clamp(cv / 10.0f, -1.0f, 1.0f));
         } else {
-            kickFreqCvMod = 0.0f;
+            cvMods.clear(CVMOD_KICK_FREQ);
         }
-        
-        float kickFmCV = kickEnvCV * kickEnvCV;
-        float kickVcaCV = std::sqrt(kickEnvCV);
-        
-        float kickEnvelopeFM = kickFmCV * kickFmAmount;
-        float kickSaturation = 1.0f + (kickPunchAmount * 4.0f);
-        float kickAudioOutput = kickVCO.process(kickFreqParam, kickEnvelopeFM, kickSaturation);
-        float kickFinalOutput = kickAudioOutput * kickVcaCV * kickAccentCV * kickVolumeParam * 0.8f;
-        
-        float snareEnvCV = clamp(inputs[SNARE_ENV_INPUT].getVoltage() / 10.0f, 0.0f, 1.0f);
-        
-        float snareVolumeParam = params[SNARE_VOLUME_PARAM].getValue();
-        float snareNoiseTone = params[SNARE_NOISE_TONE_PARAM].getValue();
-        float snareNoiseMix = params[SNARE_NOISE_MIX_PARAM].getValue();
+        kickFreq = dsp::exp2_taylor5(kickFreqPitch);
+
+        snareVolume = params[SNARE_VOLUME_PARAM].getValue();
+        snareNoiseTone = params[SNARE_NOISE_TONE_PARAM].getValue();
+        snareNoiseMix = params[SNARE_NOISE_MIX_PARAM].getValue();
         if (inputs[SNARE_NOISE_MIX_CV_INPUT].isConnected()) {
             float cv = inputs[SNARE_NOISE_MIX_CV_INPUT].getVoltage();
             snareNoiseMix += cv / 10.0f;
             snareNoiseMix = clamp(snareNoiseMix, 0.0f, 1.0f);
-            snareNoiseMixCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+            cvMods.publish(CVMOD_SNARE_NOISE_MIX, clamp(cv / 10.0f, -1.0f, 1.0f));
         } else {
-            snareNoiseMixCvMod = 0.0f;
+            cvMods.clear(CVMOD_SNARE_NOISE_MIX);
         }
-        
-        float snareBaseFreq = std::pow(2.0f, params[SNARE_FREQ_PARAM].getValue());
-        float snareVcaCV = std::sqrt(snareEnvCV);
-        
-        float snareBodyOutput = snareVCO.process(snareBaseFreq, 0.0f) * 0.75f;
-        
-        float snareNoiseRaw = (std::rand() / static_cast<float>(RAND_MAX)) * 2.0f - 1.0f;
+        snareBaseFreq = dsp::exp2_taylor5(params[SNARE_FREQ_PARAM].getValue());
+
         float baseFilterFreq = snareBaseFreq * 5.0f;
         float noiseFilterFreq = baseFilterFreq + (snareNoiseTone * 5000.0f) + (snareEnvCV * 2000.0f);
-        
         snareNoiseFilter.setFrequency(noiseFilterFreq, 0.5f);
-        float snareNoiseFiltered = snareNoiseFilter.process(snareNoiseRaw) * 4.0f;
-        
-        float snareMixedOutput = (snareBodyOutput * (1.0f - snareNoiseMix)) + (snareNoiseFiltered * snareNoiseMix);
+
+        hatsVolume = params[HATS_VOLUME_PARAM].getValue();
+        float hatsTone = params[HATS_TONE_PARAM].getValue();
+        float hatsDecay = params[HATS_DECAY_PARAM].getValue();
+        if (inputs[HATS_DECAY_CV_INPUT].isConnected()) {
+            float cv = inputs[HATS_DECAY_CV_INPUT].getVoltage();
+            hatsDecay += cv / 10.0f;
+            hatsDecay = clamp(hatsDecay, 0.0f, 1.0f);
+            cvMods.publish(CVMOD_HATS_DECAY, clamp(cv / 10.0f, -1.0f, 1.0f));
+        } else {
+            cvMods.clear(CVMOD_HATS_DECAY);
+        }
+        hatsBaseFreq = 1000.0f + (hatsTone * 4500.0f);
+        hatsFilter.setFrequency(hatsBaseFreq + (hatsTone * 4000.0f), 0.5f);
+        hatsNoiseAmount = hatsDecay * 0.8f;
+        hatsVcaDecay = 2.0f - (hatsDecay * 1.5f);
+    }
+
+    void process(const ProcessArgs& args) override {
+        float kickEnvCV = clamp(inputs[KICK_ENV_INPUT].getVoltage() / 10.0f, 0.0f, 1.0f);
+        float kickAccentCV = clamp(inputs[KICK_ACCENT_INPUT].getVoltage() / 10.0f, 0.0f, 1.0f);
+        float snareEnvCV = clamp(inputs[SNARE_ENV_INPUT].getVoltage() / 10.0f, 0.0f, 1.0f);
+        float hatsEnvCV = clamp(inputs[HATS_ENV_INPUT].getVoltage() / 10.0f, 0.0f, 1.0f);
+
+        if (controlDivider.process()) {
+            updateControls(snareEnvCV);
+        }
+
+        float sidechainCV = 1.0f - (kickAccentCV * duckAmount * 3.0f);
         float sidechain = 0.02f + (sidechainCV * 0.98f);
-        float snareFinalOutput = snareMixedOutput * snareVcaCV * snareVolumeParam * sidechain * 4.0f;
-        
         float bitRange = 1024.0f;
+
+        // 包絡為 0 的聲部輸出必為 0：整個聲部（振盪器、濾波器）暫停，不耗 CPU
+        float kickQuantized = 0.0f;
+        if (kickEnvCV > 0.0f && kickAccentCV > 0.0f) {
+            float kickFmCV = kickEnvCV * kickEnvCV;
+            float kickVcaCV = std::sqrt(kickEnvCV);
+
+            float kickEnvelopeFM = kickFmCV * kickFmAmount;
+            float kickAudioOutput = kickVCO.process(kickFreq, kickEnvelopeFM);
+            float kickFinalOutput = kickAudioOutput * kickVcaCV * kickAccentCV * kickVolume * 0.8f;
+            kickQuantized = std::round(kickFinalOutput * bitRange) / bitRange;
+        }
+
+        float snareQuantized = 0.0f;
+        if (snareEnvCV > 0.0f) {
+            float snareVcaCV = std::sqrt(snareEnvCV);
+
+            float snareBodyOutput = snareVCO.process(snareBaseFreq, 0.0f) * 0.75f;
+
+            float snareNoiseRaw = random::uniform() * 2.0f - 1.0f;
+            float snareNoiseFiltered = snareNoiseFilter.process(snareNoiseRaw) * 4.0f;
+
+            float snareMixedOutput = (snareBodyOutput * (1.0f - snareNoiseMix)) + (snareNoiseFiltered * snareNoiseMix);
+            float snareFinalOutput = snareMixedOutput * snareVcaCV * snareVolume * sidechain * 4.0f;
+            snareQuantized = std::round(snareFinalOutput * bitRange) / bitRange;
+        }
         
         auto processLimiter = [](float input) -> float {
             const float threshold = 5.0f;  // 降低閾值
             if (input > threshold) {
-                return threshold + std::tanh((input - threshold) * 0.5f) * 2.0f;  // 軟限制
+                return threshold + fastTanh((input - threshold) * 0.5f) * 2.0f;  // 軟限制
             } else if (input < -threshold) {
-                return -threshold + std::tanh((input + threshold) * 0.5f) * 2.0f;
+                return -threshold + fastTanh((input + threshold) * 0.5f) * 2.0f;
             }
             return input;
         };
         
-        float kickQuantized = std::round(kickFinalOutput * bitRange) / bitRange;
-        float snareQuantized = std::round(snareFinalOutput * bitRange) / bitRange;
-        
         outputs[KICK_OUTPUT].setVoltage(kickQuantized);
         outputs[SNARE_OUTPUT].setVoltage(snareQuantized);
         
-        float hatsEnvCV = clamp(inputs[HATS_ENV_INPUT].getVoltage() / 10.0f, 0.0f, 1.0f);
-        
-        float hatsVolumeParam = params[HATS_VOLUME_PARAM].getValue();
-        float hatsTone = params[HATS_TONE_PARAM].getValue();
         float hatsSpread = 20.0f;
-        float hatsDecay = params[HATS_DECAY_PARAM].getValue();
-        if (inputs[HATS_DECAY_CV_INPUT].isConnected()) {
-            float cv = inputs[HATS_DECAY_CV_INPUT].getVoltage();
-            hatsDecay += cv / 10.0f;
-            hatsDecay = clamp(hatsDecay, 0.0f, 1.0f);
-            hatsDecayCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
-        } else {
-            hatsDecayCvMod = 0.0f;
+        float hatsQuantized = 0.0f;
+        if (hatsEnvCV > 0.0f) {
+            float hatsSquareWave = hatsOsc.process(hatsBaseFreq);
+            float hatsFiltered = hatsFilter.process(hatsSquareWave);
+
+            float hatsMixed = hatsFiltered;
+            if (hatsNoiseAmount > 0.0f) {
+                float hatsNoiseRaw = random::uniform() * 2.0f - 1.0f;
+                float hatsNoiseFiltered = snareNoiseFilter.process(hatsNoiseRaw);
+                hatsMixed += hatsNoiseFiltered * hatsNoiseAmount;
+            }
+
+            float hatsVcaCV = fastPow(hatsEnvCV, hatsVcaDecay);
+
+            float hatsReducedSidechain = 0.8f + (sidechainCV * 0.2f);
+            float hatsFinalOutput = hatsMixed * hatsVcaCV * hatsVolume * hatsReducedSidechain * 0.7f;
+            hatsQuantized = std::round(hatsFinalOutput * bitRange) / bitRange;
         }
-        
-        float hatsBaseFreq = 1000.0f + (hatsTone * 4500.0f);
-        float hatsSquareWave = hatsOsc.process(hatsBaseFreq);
-        
-        float hatsFilterFreq = hatsBaseFreq + (hatsTone * 4000.0f);
-        hatsFilter.setFrequency(hatsFilterFreq, 0.5f);
-        float hatsFiltered = hatsFilter.process(hatsSquareWave);
-        
-        float hatsNoiseRaw = (std::rand() / static_cast<float>(RAND_MAX)) * 2.0f - 1.0f;
-        float hatsNoiseFiltered = snareNoiseFilter.process(hatsNoiseRaw);
-        float hatsNoiseAmount = hatsDecay * 0.8f;
-        
-        float hatsMixed = hatsFiltered + (hatsNoiseFiltered * hatsNoiseAmount);
-        
-        float hatsVcaDecay = 2.0f - (hatsDecay * 1.5f);
-        float hatsVcaCV = std::pow(hatsEnvCV, hatsVcaDecay);
-        
-        float hatsReducedSidechain = 0.8f + (sidechainCV * 0.2f);
-        float hatsFinalOutput = hatsMixed * hatsVcaCV * hatsVolumeParam * hatsReducedSidechain * 0.7f;
-        
-        float hatsQuantized = std::round(hatsFinalOutput * bitRange) / bitRange;
+        // 延遲線持續推進，右聲道的延遲尾巴才會完整
         float hatsDelayed = hatsDelay.process(hatsQuantized, hatsSpread);
         
         outputs[HATS_OUTPUT1].setVoltage(hatsQuantized);
@@ -485,6 +599,7 @@ struct TWNC2Widget : ModuleWidget {
     madzine::widgets::TechnoStandardBlackKnob30* kickPunchKnob = nullptr;
     madzine::widgets::TechnoStandardBlackKnob30* snareNoiseMixKnob = nullptr;
     madzine::widgets::TechnoStandardBlackKnob30* hatsDecayKnob = nullptr;
+    madzine::widgets::CVModRingSync<TWNC2::NUM_CVMODS> cvModSync;
 
     TWNC2Widget(TWNC2* module) {
         setModule(module);
@@ -566,6 +681,12 @@ struct TWNC2Widget : ModuleWidget {
         addChild(new TechnoEnhancedTextLabel(Vec(5, track3Y + 48), Vec(30, 10), "DECAY", 8.f, nvgRGB(255, 255, 255), true));
         hatsDecayKnob = createParamCentered<madzine::widgets::TechnoStandardBlackKnob30>(Vec(20, track3Y + 71), module, TWNC2::HATS_DECAY_PARAM);
         addParam(hatsDecayKnob);
+
+        cvModSync.bind(TWNC2::CVMOD_KICK_FREQ, kickFreqKnob);
+        cvModSync.bind(TWNC2::CVMOD_KICK_FM, kickFmKnob);
+        cvModSync.bind(TWNC2::CVMOD_KICK_PUNCH, kickPunchKnob);
+        cvModSync.bind(TWNC2::CVMOD_SNARE_NOISE_MIX, snareNoiseMixKnob);
+        cvModSync.bind(TWNC2::CVMOD_HATS_DECAY, hatsDecayKnob);
         
         addChild(new TechnoEnhancedTextLabel(Vec(45, track3Y + 48), Vec(30, 10), "DECAY", 8.f, nvgRGB(255, 255, 255), true));
         addInput(createInputCentered<PJ301MPort>(Vec(60, track3Y + 71), module, TWNC2::HATS_DECAY_CV_INPUT));
@@ -599,20 +720,8 @@ struct TWNC2Widget : ModuleWidget {
         if (module) {
             panelThemeHelper.step(module);
 
-            // 更新 CV 調變顯示
-            auto updateKnob = [&](madzine::widgets::TechnoStandardBlackKnob30* knob, int inputId, float cvMod) {
-                if (knob) {
-                    bool connected = module->inputs[inputId].isConnected();
-                    knob->setModulationEnabled(connected);
-                    if (connected) knob->setModulation(cvMod);
-                }
-            };
-
-            updateKnob(kickFreqKnob, TWNC2::KICK_FREQ_CV_INPUT, module->kickFreqCvMod);
-            updateKnob(kickFmKnob, TWNC2::KICK_FM_CV_INPUT, module->kickFmCvMod);
-            updateKnob(kickPunchKnob, TWNC2::KICK_PUNCH_CV_INPUT, module->kickPunchCvMod);
-            updateKnob(snareNoiseMixKnob, TWNC2::SNARE_NOISE_MIX_CV_INPUT, module->snareNoiseMixCvMod);
-            updateKnob(hatsDecayKnob, TWNC2::HATS_DECAY_CV_INPUT, module->hatsDecayCvMod);
+            // 更新 CV 調變顯示（僅在數值變化時）
+            cvModSync.sync(module->cvMods);
         }
         ModuleWidget::step();
     }
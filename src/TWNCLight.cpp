@@ -1,5 +1,6 @@
 #include "plugin.hpp"
 #include "widgets/Knobs.hpp"
+#include "widgets/CVModulation.hpp"
 #include "widgets/PanelTheme.hpp"
 #include <vector>
 #include <algorithm>
@@ -208,8 +209,12 @@ struct TWNCLight : Module {
     dsp::SchmittTrigger clockTrigger;
 
     // CV 調變顯示用
-    float drumDecayCvMod = 0.0f;
-    float hatsDecayCvMod = 0.0f;
+    enum CvModId {
+        CVMOD_DRUM_DECAY,
+        CVMOD_HATS_DECAY,
+        NUM_CVMODS
+    };
+    madzine::widgets::CVModBank<NUM_CVMODS> cvMods;
 
     // Hats delay state (moved from static locals in process() to avoid multi-instance interference)
     int hatsDelayCounter = 0;
@@ -549,9 +554,9 @@ struct TWNCLight : Module {
                     float cv = inputs[DRUM_DECAY_CV_INPUT].getVoltage();
                     decayParam += cv / 10.0f;
                     decayParam = clamp(decayParam, 0.01f, 2.0f);
-                    drumDecayCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+                    cvMods.publish(CVMOD_DRUM_DECAY, clamp(cv / 10.0f, -1.0f, 1.0f));
                 } else {
-                    drumDecayCvMod = 0.0f;
+                    cvMods.clear(CVMOD_DRUM_DECAY);
                 }
                 float shapeParam = params[TRACK1_SHAPE_PARAM].getValue();
                 
@@ -571,9 +576,9 @@ struct TWNCLight : Module {
                     float cv = inputs[HATS_DECAY_CV_INPUT].getVoltage();
                     decayParam += cv / 10.0f;
                     decayParam = clamp(decayParam, 0.01f, 2.0f);
-                    hatsDecayCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+                    cvMods.publish(CVMOD_HATS_DECAY, clamp(cv / 10.0f, -1.0f, 1.0f));
                 } else {
-                    hatsDecayCvMod = 0.0f;
+                    cvMods.clear(CVMOD_HATS_DECAY);
                 }
                 float shapeParam = params[TRACK2_SHAPE_PARAM].getValue();
                 
@@ -591,6 +596,7 @@ struct TWNCLightWidget : ModuleWidget {
     PanelThemeHelper panelThemeHelper;
     madzine::widgets::StandardBlackKnob26* drumDecayKnob = nullptr;
     madzine::widgets::StandardBlackKnob26* hatsDecayKnob = nullptr;
+    madzine::widgets::CVModRingSync<TWNCLight::NUM_CVMODS> cvModSync;
 
     TWNCLightWidget(TWNCLight* module) {
         setModule(module);
@@ -644,6 +650,10 @@ struct TWNCLightWidget : ModuleWidget {
         addChild(new TWNCLightEnhancedTextLabel(Vec(35, hatsY + 48), Vec(20, 10), "DECAY", 8.f, nvgRGB(255, 255, 255), true));
         hatsDecayKnob = createParamCentered<madzine::widgets::StandardBlackKnob26>(Vec(45, hatsY + 69), module, TWNCLight::TRACK2_DECAY_PARAM);
         addParam(hatsDecayKnob);
+
+        cvModSync.bind(TWNCLight::CVMOD_DRUM_DECAY, drumDecayKnob);
+        cvModSync.bind(TWNCLight::CVMOD_HATS_DECAY, hatsDecayKnob);
+
         
         addChild(new TWNCLightEnhancedTextLabel(Vec(5, hatsY + 84), Vec(20, 10), "SHAPE", 8.f, nvgRGB(255, 255, 255), true));
         addParam(createParamCentered<madzine::widgets::StandardBlackKnob26>(Vec(15, hatsY + 105), module, TWNCLight::TRACK2_SHAPE_PARAM));
@@ -664,17 +674,8 @@ struct TWNCLightWidget : ModuleWidget {
         if (module) {
             panelThemeHelper.step(module);
 
-            // 更新 CV 調變顯示
-            auto updateKnob = [&](madzine::widgets::StandardBlackKnob26* knob, int inputId, float cvMod) {
-                if (knob) {
-                    bool connected = module->inputs[inputId].isConnected();
-                    knob->setModulationEnabled(connected);
-                    if (connected) knob->setModulation(cvMod);
-                }
-            };
-
-            updateKnob(drumDecayKnob, TWNCLight::DRUM_DECAY_CV_INPUT, module->drumDecayCvMod);
-            updateKnob(hatsDecayKnob, TWNCLight::HATS_DECAY_CV_INPUT, module->hatsDecayCvMod);
+            // 更新 CV 調變顯示（僅在數值變化時）
+            cvModSync.sync(module->cvMods);
         }
         ModuleWidget::step();
     }
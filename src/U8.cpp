@@ -1,5 +1,6 @@
 #include "plugin.hpp"
 #include "widgets/Knobs.hpp"
+#include "widgets/CVModulation.hpp"
 #include "widgets/PanelTheme.hpp"
 
 struct TechnoEnhancedTextLabel : TransparentWidget {
@@ -225,7 +226,11 @@ struct U8 : Module {
     dsp::SchmittTrigger soloTrigger;
 
     // CV 調變顯示用
-    float levelCvModulation = 0.0f;
+    enum CvModId {
+        CVMOD_LEVEL,
+        NUM_CVMODS
+    };
+    madzine::widgets::CVModBank<NUM_CVMODS> cvMods;
 
     // VU Meter 電平值（dB，範圍 -60 到 +6）
     float vuLevelL = -60.0f;
@@ -389,9 +394,9 @@ struct U8 : Module {
         if (inputs[LEVEL_CV_INPUT].isConnected()) {
             // ±5V = 滿範圍，所以除以 5 而非 10
             float cvNorm = clamp(inputs[LEVEL_CV_INPUT].getVoltage() / 10.0f, -1.0f, 1.0f);
-            levelCvModulation = cvNorm;
+            cvMods.publish(CVMOD_LEVEL, cvNorm);
         } else {
-            levelCvModulation = 0.0f;
+            cvMods.clear(CVMOD_LEVEL);
         }
 
         // Process left output channels
@@ -601,6 +606,7 @@ struct HorizontalVUMeter : TransparentWidget {
 struct U8Widget : ModuleWidget {
     PanelThemeHelper panelThemeHelper;
     TechnoStandardBlackKnob* levelKnob = nullptr;
+    madzine::widgets::CVModRingSync<U8::NUM_CVMODS> cvModSync;
     HorizontalVUMeter* vuMeterL = nullptr;
     HorizontalVUMeter* vuMeterR = nullptr;
 
@@ -626,6 +632,7 @@ struct U8Widget : ModuleWidget {
         addChild(new TechnoEnhancedTextLabel(Vec(-5, 89), Vec(box.size.x + 10, 10), "LEVEL", 8.f, nvgRGB(255, 255, 255), true));
         levelKnob = createParamCentered<TechnoStandardBlackKnob>(Vec(box.size.x / 2, 123), module, U8::LEVEL_PARAM);
         addParam(levelKnob);
+        cvModSync.bind(U8::CVMOD_LEVEL, levelKnob);
         addInput(createInputCentered<PJ301MPort>(Vec(box.size.x / 2, 161), module, U8::LEVEL_CV_INPUT));
 
         addChild(new TechnoEnhancedTextLabel(Vec(-5, 182), Vec(box.size.x + 10, 10), "DUCK", 8.f, nvgRGB(255, 255, 255), true));
@@ -665,14 +672,8 @@ struct U8Widget : ModuleWidget {
         if (module) {
             panelThemeHelper.step(module);
 
-            // 更新 Level 旋鈕的 CV 調變顯示
-            if (levelKnob) {
-                bool cvConnected = module->inputs[U8::LEVEL_CV_INPUT].isConnected();
-                levelKnob->setModulationEnabled(cvConnected);
-                if (cvConnected) {
-                    levelKnob->setModulation(module->levelCvModulation);
-                }
-            }
+            // 更新 Level 旋鈕的 CV 調變顯示（僅在數值變化時）
+            cvModSync.sync(module->cvMods);
 
             // 自動 cable 創建（模組移開後保持連接，用戶可手動刪除）
             // 驗證自動 cable 是否仍然有效（可能被用戶刪除）
@@ -1,5 +1,6 @@
 #include "plugin.hpp"
 #include "widgets/Knobs.hpp"
+#include "widgets/CVModulation.hpp"
 #include "widgets/PanelTheme.hpp"
 #include "WorldRhythm/PatternGenerator.hpp"
 #include "WorldRhythm/HumanizeEngine.hpp"
@@ -790,6 +791,9 @@ struct UniRhythm : Module {
     // Global step counter for bar tracking (moved from static to member for proper reset)
     int globalStep = 0;
 
+    // Synth sample rate is set on the first process() call of this instance
+    bool sampleRateInitialized = false;
+
     // PPQN setting (1, 2, or 4 pulses per quarter note)
     // 4 PPQN = 16th note clock (default), 2 PPQN = 8th note clock, 1 PPQN = quarter note clock
     int ppqn = 4;
@@ -814,6 +818,14 @@ struct UniRhythm : Module {
     };
     std::vector<DelayedTrigger> delayedTriggers;
 
+    // Control-rate scheduling: role controls are sampled once per division
+    // (or immediately on clock/regenerate), only triggers and audio run per sample
+    static constexpr int CONTROL_RATE_DIVISION = 32;
+    dsp::ClockDivider controlDivider;
+    float roleDecayMults[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+    float roleMixes[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    float controlSpread = 0.0f;
+
     // Change detection (per role)
     int lastStyles[4] = {-1, -1, -1, -1};
     float lastDensities[4] = {-1.f, -1.f, -1.f, -1.f};
@@ -824,9 +836,10 @@ struct UniRhythm : Module {
     float lastSwing = 0.5f;
 
     // CV display modulation values
-    // [role][cvType]: 0=Style, 1=Density, 2=Freq, 3=Decay
-    float roleCvMod[4][4] = {{0.0f}};
-    float restCvMod = 0.0f;
+    // Role slots are role * 4 + cvType (0=Style, 1=Density, 2=Freq, 3=Decay), followed by REST
+    static constexpr int CVMOD_REST = 16;
+    static constexpr int NUM_CVMODS = 17;
+    madzine::widgets::CVModBank<NUM_CVMODS> cvMods;
 
     // External audio VCA envelopes (per voice)
     struct VCAEnvelope {
@@ -974,6 +987,7 @@ struct UniRhythm : Module {
 
     UniRhythm() {
         config(PARAMS_LEN, INPUTS_LEN, OUTPUTS_LEN, LIGHTS_LEN);
+        controlDivider.setDivision(CONTROL_RATE_DIVISION);
 
         // Per-role parameters
         const char* roleNames[4] = {"Timeline", "Foundation", "Groove", "Lead"};
@@ -1892,51 +1906,8 @@ struct UniRhythm : Module {
         fillActive = true;
     }
 
-    void process(const ProcessArgs& args) override {
-        // Set sample rate on first process
-        static bool initialized = false;
-        if (!initialized) {
-            drumSynth.setSampleRate(args.sampleRate);
-            initialized = true;
-        }
-
-        // Process delayed triggers (for swing/groove timing and Flam, Drag, Buzz, Ruff articulations)
-        for (auto it = delayedTriggers.begin(); it != delayedTriggers.end(); ) {
-            it->samplesRemaining -= 1.0f;
-            if (it->samplesRemaining <= 0) {
-                // Calculate VCA decay for this role
-                int baseParam = it->role * 5;
-                float decayMult = params[TIMELINE_DECAY_PARAM + baseParam].getValue();
-                if (inputs[TIMELINE_DECAY_CV_INPUT + it->role * 4].isConnected()) {
-                    decayMult += inputs[TIMELINE_DECAY_CV_INPUT + it->role * 4].getVoltage() * 0.18f;
-                    decayMult = clamp(decayMult, 0.2f, 2.0f);
-                }
-                float vcaDecayMs = 200.0f * decayMult;
-
-                if (!it->isSubNote) {
-                    // Main trigger - apply articulation
-                    triggerWithArticulation(it->voice, it->velocity, it->isAccent, args.sampleRate,
-                                           it->role, it->isStrongBeat);
-                    // Trigger VCA for external audio
-                    externalVCA[it->voice].trigger(vcaDecayMs, args.sampleRate, it->velocity);
-                } else {
-                    // Articulation sub-note - direct trigger (no further articulation)
-                    drumSynth.triggerVoice(it->voice, it->velocity);
-                    gatePulses[it->role].trigger(0.001f);  // Use role index for merged gate
-                    currentVelocities[it->voice] = it->velocity;
-                    currentAccents[it->voice] = it->isAccent;
-                    // Trigger VCA for external audio (sub-notes also trigger VCA)
-                    externalVCA[it->voice].trigger(vcaDecayMs, args.sampleRate, it->velocity);
-                    if (it->isAccent) {
-                        accentPulses[it->voice].trigger(0.001f);
-                    }
-                }
-                it = delayedTriggers.erase(it);
-            } else {
-                ++it;
-            }
-        }
-
+    // Sample all role controls, CV and change detection (control rate)
+    void processRoleControls(bool forceRegen) {
         // Cache role params for Random Exclusive feature (restore after randomize)
         for (int role = 0; role < 4; role++) {
             int baseParam = role * 5;
@@ -1952,9 +1923,9 @@ struct UniRhythm : Module {
             float cv = inputs[REST_CV_INPUT].getVoltage();
             restAmount += cv * 0.1f;
             restAmount = clamp(restAmount, 0.0f, 1.0f);
-            restCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+            cvMods.publish(CVMOD_REST, clamp(cv / 10.0f, -1.0f, 1.0f));
         } else {
-            restCvMod = 0.0f;
+            cvMods.clear(CVMOD_REST);
         }
         // Note: Swing is read in regenerate functions, not here - changes don't trigger regeneration
 
@@ -1973,8 +1944,7 @@ struct UniRhythm : Module {
             }
         }
 
-        if (regenerateTrigger.process(inputs[REGENERATE_INPUT].getVoltage()) ||
-            regenerateButtonTrigger.process(params[REGENERATE_PARAM].getValue())) {
+        if (forceRegen) {
             globalRegenNeeded = true;
         }
 
@@ -1990,9 +1960,9 @@ struct UniRhythm : Module {
             float styleCV = 0.0f;
             if (inputs[TIMELINE_STYLE_CV_INPUT + r * 4].isConnected()) {
                 styleCV = inputs[TIMELINE_STYLE_CV_INPUT + r * 4].getVoltage();
-                roleCvMod[r][0] = clamp(styleCV / 10.0f, -1.0f, 1.0f);
+                cvMods.publish(r * 4 + 0, clamp(styleCV / 10.0f, -1.0f, 1.0f));
             } else {
-                roleCvMod[r][0] = 0.0f;
+                cvMods.clear(r * 4 + 0);
             }
             int styleIndex = static_cast<int>(params[TIMELINE_STYLE_PARAM + baseParam].getValue() + styleCV);
             styleIndex = clamp(styleIndex, 0, 9);
@@ -2001,25 +1971,30 @@ struct UniRhythm : Module {
             if (inputs[TIMELINE_DENSITY_CV_INPUT + r * 4].isConnected()) {
                 float cv = inputs[TIMELINE_DENSITY_CV_INPUT + r * 4].getVoltage();
                 densityCV = cv * 0.1f;
-                roleCvMod[r][1] = clamp(cv / 10.0f, -1.0f, 1.0f);
+                cvMods.publish(r * 4 + 1, clamp(cv / 10.0f, -1.0f, 1.0f));
             } else {
-                roleCvMod[r][1] = 0.0f;
+                cvMods.clear(r * 4 + 1);
             }
             float density = clamp(params[TIMELINE_DENSITY_PARAM + baseParam].getValue() + densityCV, 0.0f, 0.9f);
 
             // Calculate FREQ and DECAY cvMod values
             if (inputs[TIMELINE_FREQ_CV_INPUT + r * 4].isConnected()) {
                 float cv = inputs[TIMELINE_FREQ_CV_INPUT + r * 4].getVoltage();
-                roleCvMod[r][2] = clamp(cv / 10.0f, -1.0f, 1.0f);
+                cvMods.publish(r * 4 + 2, clamp(cv / 10.0f, -1.0f, 1.0f));
             } else {
-                roleCvMod[r][2] = 0.0f;
+                cvMods.clear(r * 4 + 2);
             }
+            float decayMult = params[TIMELINE_DECAY_PARAM + baseParam].getValue();
             if (inputs[TIMELINE_DECAY_CV_INPUT + r * 4].isConnected()) {
                 float cv = inputs[TIMELINE_DECAY_CV_INPUT + r * 4].getVoltage();
-                roleCvMod[r][3] = clamp(cv / 10.0f, -1.0f, 1.0f);
+                decayMult = clamp(decayMult + cv * 0.18f, 0.2f, 2.0f);
+                cvMods.publish(r * 4 + 3, clamp(cv / 10.0f, -1.0f, 1.0f));
             } else {
-                roleCvMod[r][3] = 0.0f;
+                cvMods.clear(r * 4 + 3);
             }
+            // VCA decay multiplier used by the trigger path
+            roleDecayMults[r] = decayMult;
+            roleMixes[r] = params[TIMELINE_MIX_PARAM + r].getValue();
 
             int length = static_cast<int>(params[TIMELINE_LENGTH_PARAM + baseParam].getValue());
 
@@ -2048,6 +2023,56 @@ struct UniRhythm : Module {
             reapplyRest(restAmount);
         }
 
+        controlSpread = params[SPREAD_PARAM].getValue();
+    }
+
+    void process(const ProcessArgs& args) override {
+        // Set sample rate on first process
+        if (!sampleRateInitialized) {
+            drumSynth.setSampleRate(args.sampleRate);
+            sampleRateInitialized = true;
+        }
+
+        // Process delayed triggers (for swing/groove timing and Flam, Drag, Buzz, Ruff articulations)
+        for (auto it = delayedTriggers.begin(); it != delayedTriggers.end(); ) {
+            it->samplesRemaining -= 1.0f;
+            if (it->samplesRemaining <= 0) {
+                // Calculate VCA decay for this role
+                float vcaDecayMs = 200.0f * roleDecayMults[it->role];
+
+                if (!it->isSubNote) {
+                    // Main trigger - apply articulation
+                    triggerWithArticulation(it->voice, it->velocity, it->isAccent, args.sampleRate,
+                                           it->role, it->isStrongBeat);
+                    // Trigger VCA for external audio
+                    externalVCA[it->voice].trigger(vcaDecayMs, args.sampleRate, it->velocity);
+                } else {
+                    // Articulation sub-note - direct trigger (no further articulation)
+                    drumSynth.triggerVoice(it->voice, it->velocity);
+                    gatePulses[it->role].trigger(0.001f);  // Use role index for merged gate
+                    currentVelocities[it->voice] = it->velocity;
+                    currentAccents[it->voice] = it->isAccent;
+                    // Trigger VCA for external audio (sub-notes also trigger VCA)
+                    externalVCA[it->voice].trigger(vcaDecayMs, args.sampleRate, it->velocity);
+                    if (it->isAccent) {
+                        accentPulses[it->voice].trigger(0.001f);
+                    }
+                }
+                it = delayedTriggers.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        // Triggers stay at audio rate; role controls are refreshed at control rate,
+        // or immediately when a clock/regenerate edge needs up-to-date values
+        bool regenTriggered = regenerateTrigger.process(inputs[REGENERATE_INPUT].getVoltage()) ||
+                              regenerateButtonTrigger.process(params[REGENERATE_PARAM].getValue());
+        bool clockTriggered = clockTrigger.process(inputs[CLOCK_INPUT].getVoltage());
+        if (controlDivider.process() || regenTriggered || clockTriggered) {
+            processRoleControls(regenTriggered);
+        }
+
         // Process reset (input or button)
         bool resetTriggered = resetTrigger.process(inputs[RESET_INPUT].getVoltage()) ||
                               resetButtonTrigger.process(params[RESET_BUTTON_PARAM].getValue());
@@ -2068,7 +2093,7 @@ struct UniRhythm : Module {
         // ppqn=4: every clock = 1 step (16th note input)
         // ppqn=2: every clock = 2 steps (8th note input)
         // ppqn=1: every clock = 4 steps (quarter note input)
-        if (clockTrigger.process(inputs[CLOCK_INPUT].getVoltage())) {
+        if (clockTriggered) {
             clockPulse.trigger(0.001f);
 
             // Calculate steps per clock based on PPQN
@@ -2158,12 +2183,7 @@ struct UniRhythm : Module {
                     float totalDelaySamples = (totalDelayMs / 1000.0f) * args.sampleRate;
 
                     // Pre-calculate decay multiplier for VCA envelopes (used by both voices)
-                    int baseParam = r * 5;  // 5 params per role (SPREAD is separate)
-                    float decayMult = params[TIMELINE_DECAY_PARAM + baseParam].getValue();
-                    if (inputs[TIMELINE_DECAY_CV_INPUT + r * 4].isConnected()) {
-                        decayMult += inputs[TIMELINE_DECAY_CV_INPUT + r * 4].getVoltage() * 0.18f;
-                        decayMult = clamp(decayMult, 0.2f, 2.0f);
-                    }
+                    float decayMult = roleDecayMults[r];
 
                     // Determine if this is a strong beat (positions 0, 4, 8, 12 in 16-step)
                     // Used by both primary and secondary voices
@@ -2243,7 +2263,7 @@ struct UniRhythm : Module {
         float mixL = 0.0f;
         float mixR = 0.0f;
 
-        float spread = params[SPREAD_PARAM].getValue();
+        float spread = controlSpread;
 
         // Role-based stereo panning (based on mixing research)
         // Role indices: 0=Timeline, 1=Foundation, 2=Groove, 3=Lead
@@ -2257,7 +2277,7 @@ struct UniRhythm : Module {
 
         for (int r = 0; r < 4; r++) {
             int voiceBase = r * 2;
-            float mix = params[TIMELINE_MIX_PARAM + r].getValue();  // 0.0 = internal, 1.0 = external
+            float mix = roleMixes[r];  // 0.0 = internal, 1.0 = external
             currentMix[r] = mix;
 
             // Get pan positions for this role (use average of v1/v2 pan for merged output)
@@ -2724,6 +2744,7 @@ struct UniRhythmWidget : ModuleWidget {
     madzine::widgets::BaseCustomKnob* restKnob = nullptr;
     // [role][cvType]: 0=Style, 1=Density, 2=Freq, 3=Decay
     madzine::widgets::BaseCustomKnob* roleKnobs[4][4] = {{nullptr}};
+    madzine::widgets::CVModRingSync<UniRhythm::NUM_CVMODS> cvModSync;
 
     UniRhythmWidget(UniRhythm* module) {
         setModule(module);
@@ -2892,6 +2913,13 @@ struct UniRhythmWidget : ModuleWidget {
                      UniRhythm::TIMELINE_MIX_PARAM + role));
         }
 
+        cvModSync.bind(UniRhythm::CVMOD_REST, restKnob);
+        for (int r = 0; r < 4; r++) {
+            for (int k = 0; k < 4; k++) {
+                cvModSync.bind(r * 4 + k, roleKnobs[r][k]);
+            }
+        }
+
         // Vertical separators between roles
         for (int r = 0; r < 3; r++) {
             float sepX = (r + 1) * roleSpacing;
@@ -2981,25 +3009,8 @@ struct UniRhythmWidget : ModuleWidget {
         if (module) {
             panelThemeHelper.step(module);
 
-            // CV display updates
-            auto updateKnob = [&](madzine::widgets::BaseCustomKnob* knob, int inputId, float cvMod) {
-                if (knob) {
-                    bool connected = module->inputs[inputId].isConnected();
-                    knob->setModulationEnabled(connected);
-                    if (connected) knob->setModulation(cvMod);
-                }
-            };
-
-            // REST knob
-            updateKnob(restKnob, UniRhythm::REST_CV_INPUT, module->restCvMod);
-
-            // Role knobs (4 roles × 4 CVs)
-            for (int r = 0; r < 4; r++) {
-                updateKnob(roleKnobs[r][0], UniRhythm::TIMELINE_STYLE_CV_INPUT + r * 4, module->roleCvMod[r][0]);
-                updateKnob(roleKnobs[r][1], UniRhythm::TIMELINE_DENSITY_CV_INPUT + r * 4, module->roleCvMod[r][1]);
-                updateKnob(roleKnobs[r][2], UniRhythm::TIMELINE_FREQ_CV_INPUT + r * 4, module->roleCvMod[r][2]);
-                updateKnob(roleKnobs[r][3], UniRhythm::TIMELINE_DECAY_CV_INPUT + r * 4, module->roleCvMod[r][3]);
-            }
+            // CV display updates (only knobs whose modulation changed are touched)
+            cvModSync.sync(module->cvMods);
         }
         ModuleWidget::step();
     }
@@ -1,5 +1,6 @@
 #include "plugin.hpp"
 #include "widgets/Knobs.hpp"
+#include "widgets/CVModulation.hpp"
 #include "widgets/PanelTheme.hpp"
 #include "WorldRhythm/PatternGenerator.hpp"
 #include "WorldRhythm/HumanizeEngine.hpp"
@@ -606,6 +607,9 @@ struct UniversalRhythm : Module {
     // Global step counter for bar tracking (moved from static to member for proper reset)
     int globalStep = 0;
 
+    // Synth sample rate is set on the first process() call of this instance
+    bool sampleRateInitialized = false;
+
     // PPQN setting (1, 2, or 4 pulses per quarter note)
     // 4 PPQN = 16th note clock (default), 2 PPQN = 8th note clock, 1 PPQN = quarter note clock
     int ppqn = 4;
@@ -640,9 +644,10 @@ struct UniversalRhythm : Module {
     float lastSwing = 0.5f;
 
     // CV display modulation values
-    // [role][cvType]: 0=Style, 1=Density, 2=Freq, 3=Decay
-    float roleCvMod[4][4] = {{0.0f}};
-    float restCvMod = 0.0f;
+    // Role slots are role * 4 + cvType (0=Style, 1=Density, 2=Freq, 3=Decay), followed by REST
+    static constexpr int CVMOD_REST = 16;
+    static constexpr int NUM_CVMODS = 17;
+    madzine::widgets::CVModBank<NUM_CVMODS> cvMods;
 
     // External audio VCA envelopes (per voice)
     struct VCAEnvelope {
@@ -1691,10 +1696,9 @@ struct UniversalRhythm : Module {
 
     void process(const ProcessArgs& args) override {
         // Set sample rate on first process
-        static bool initialized = false;
-        if (!initialized) {
+        if (!sampleRateInitialized) {
             drumSynth.setSampleRate(args.sampleRate);
-            initialized = true;
+            sampleRateInitialized = true;
         }
 
         // Process delayed triggers (for swing/groove timing and Flam, Drag, Buzz, Ruff articulations)
@@ -1749,9 +1753,9 @@ struct UniversalRhythm : Module {
             float cv = inputs[REST_CV_INPUT].getVoltage();
             restAmount += cv * 0.1f;
             restAmount = clamp(restAmount, 0.0f, 1.0f);
-            restCvMod = clamp(cv / 10.0f, -1.0f, 1.0f);
+            cvMods.publish(CVMOD_REST, clamp(cv / 10.0f, -1.0f, 1.0f));
         } else {
-            restCvMod = 0.0f;
+            cvMods.clear(CVMOD_REST);
         }
         // Note: Swing is read in regenerate functions, not here - changes don't trigger regeneration
 
@@ -1787,9 +1791,9 @@ struct UniversalRhythm : Module {
             float styleCV = 0.0f;
             if (inputs[TIMELINE_STYLE_CV_INPUT + r * 4].isConnected()) {
                 styleCV = inputs[TIMELINE_STYLE_CV_INPUT + r * 4].getVoltage();
-                roleCvMod[r][0] = clamp(styleCV / 10.0f, -1.0f, 1.0f);
+                cvMods.publish(r * 4 + 0, clamp(styleCV / 10.0f, -1.0f, 1.0f));
             } else {
-                roleCvMod[r][0] = 0.0f;
+                cvMods.clear(r * 4 + 0);
             }
             int styleIndex = static_cast<int>(params[TIMELINE_STYLE_PARAM + baseParam].getValue() + styleCV);
             styleIndex = clamp(styleIndex, 0, 9);
@@ -1798,24 +1802,24 @@ struct UniversalRhythm : Module {
             if (inputs[TIMELINE_DENSITY_CV_INPUT + r * 4].isConnected()) {
                 float cv = inputs[TIMELINE_DENSITY_CV_INPUT + r * 4].getVoltage();
                 densityCV = cv * 0.1f;
-                roleCvMod[r][1] = clamp(cv / 10.0f, -1.0f, 1.0f);
+                cvMods.publish(r * 4 + 1, clamp(cv / 10.0f, -1.0f, 1.0f));
             } else {
-                roleCvMod[r][1] = 0.0f;
+                cvMods.clear(r * 4 + 1);
             }
             float density = clamp(params[TIMELINE_DENSITY_PARAM + baseParam].getValue() + densityCV, 0.0f, 0.9f);
 
             // Calculate FREQ and DECAY cvMod values
             if (inputs[TIMELINE_FREQ_CV_INPUT + r * 4].isConnected()) {
                 float cv = inputs[TIMELINE_FREQ_CV_INPUT + r * 4].getVoltage();
-                roleCvMod[r][2] = clamp(cv / 10.0f, -1.0f, 1.0f);
+                cvMods.publish(r * 4 + 2, clamp(cv / 10.0f, -1.0f, 1.0f));
             } else {
-                roleCvMod[r][2] = 0.0f;
+                cvMods.clear(r * 4 + 2);
             }
             if (inputs[TIMELINE_DECAY_CV_INPUT + r * 4].isConnected()) {
                 float cv = inputs[TIMELINE_DECAY_CV_INPUT + r * 4].getVoltage();
-                roleCvMod[r][3] = clamp(cv / 10.0f, -1.0f, 1.0f);
+                cvMods.publish(r * 4 + 3, clamp(cv / 10.0f, -1.0f, 1.0f));
             } else {
-                roleCvMod[r][3] = 0.0f;
+                cvMods.clear(r * 4 + 3);
             }
 
             int length = static_cast<int>(params[TIMELINE_LENGTH_PARAM + baseParam].getValue());
@@ -2519,6 +2523,7 @@ struct UniversalRhythmWidget : ModuleWidget {
     madzine::widgets::BaseCustomKnob* restKnob = nullptr;
     // [role][cvType]: 0=Style, 1=Density, 2=Freq, 3=Decay
     madzine::widgets::BaseCustomKnob* roleKnobs[4][4] = {{nullptr}};
+    madzine::widgets::CVModRingSync<UniversalRhythm::NUM_CVMODS> cvModSync;
 
     UniversalRhythmWidget(UniversalRhythm* module) {
         setModule(module);
@@ -2693,6 +2698,13 @@ struct UniversalRhythmWidget : ModuleWidget {
                      UniversalRhythm::TIMELINE_AUDIO_INPUT_2 + role * 2));
         }
 
+        cvModSync.bind(UniversalRhythm::CVMOD_REST, restKnob);
+        for (int r = 0; r < 4; r++) {
+            for (int k = 0; k < 4; k++) {
+                cvModSync.bind(r * 4 + k, roleKnobs[r][k]);
+            }
+        }
+
         // Vertical separators between roles
         for (int r = 0; r < 3; r++) {
             float sepX = (r + 1) * roleSpacing;
@@ -2760,25 +2772,8 @@ struct UniversalRhythmWidget : ModuleWidget {
         if (module) {
             panelThemeHelper.step(module);
 
-            // CV display updates
-            auto updateKnob = [&](madzine::widgets::BaseCustomKnob* knob, int inputId, float cvMod) {
-                if (knob) {
-                    bool connected = module->inputs[inputId].isConnected();
-                    knob->setModulationEnabled(connected);
-                    if (connected) knob->setModulation(cvMod);
-                }
-            };
-
-            // REST knob
-            updateKnob(restKnob, UniversalRhythm::REST_CV_INPUT, module->restCvMod);
-
-            // Role knobs (4 roles × 4 CVs)
-            for (int r = 0; r < 4; r++) {
-                updateKnob(roleKnobs[r][0], UniversalRhythm::TIMELINE_STYLE_CV_INPUT + r * 4, module->roleCvMod[r][0]);
-                updateKnob(roleKnobs[r][1], UniversalRhythm::TIMELINE_DENSITY_CV_INPUT + r * 4, module->roleCvMod[r][1]);
-                updateKnob(roleKnobs[r][2], UniversalRhythm::TIMELINE_FREQ_CV_INPUT + r * 4, module->roleCvMod[r][2]);
-                updateKnob(roleKnobs[r][3], UniversalRhythm::TIMELINE_DECAY_CV_INPUT + r * 4, module->roleCvMod[r][3]);
-            }
+            // CV display updates (only knobs whose modulation changed are touched)
+            cvModSync.sync(module->cvMods);
         }
         ModuleWidget::step();
     }
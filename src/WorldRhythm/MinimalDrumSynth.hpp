@@ -47,6 +47,7 @@ private:
 
     // VCA 包絡狀態
     float envValue = 0.0f;
+    float decayCoef = 0.0f;   // 每樣本衰減係數，actualDecay 或取樣率改變時更新
     bool triggered = false;
 
     // 參數
@@ -67,7 +68,9 @@ private:
 
 public:
     void setSampleRate(float sr) {
+        if (sr == sampleRate) return;
         sampleRate = sr;
+        updateDecayCoef();
     }
 
     void setMode(SynthMode m) {
@@ -116,6 +119,7 @@ public:
         // 使用平方根讓變化更自然，係數調整為 1.5 倍影響
         float velScale = 0.1f + 0.9f * std::pow(velocity, 1.5f);
         actualDecay = decay * velScale;
+        updateDecayCoef();
     }
 
     float getActualDecay() const { return actualDecay; }
@@ -157,14 +161,17 @@ public:
         }
 
         // VCA 包絡（指數衰減，使用 actualDecay）
-        float decaySamples = (actualDecay / 1000.0f) * sampleRate;
-        float decayCoef = std::exp(-1.0f / decaySamples);
         envValue *= decayCoef;
 
         return output * envValue;
     }
 
 private:
+    void updateDecayCoef() {
+        float decaySamples = (actualDecay / 1000.0f) * sampleRate;
+        decayCoef = std::exp(-1.0f / decaySamples);
+    }
+
     /**
      * v0.19: 更新 BPF 係數（僅在參數變化時呼叫）
      */
@@ -1,5 +1,6 @@
 #include "plugin.hpp"
 #include "widgets/Knobs.hpp"
+#include "widgets/CVModulation.hpp"
 #include "widgets/PanelTheme.hpp"
 #include <cmath>
 #include <osdialog.h>
@@ -149,14 +150,18 @@ struct theKICK : Module {
     int processPosition = BLOCK_SIZE + 1;
 
     // --- CV modulation display ---
-    float pitchCvMod = 0.f;
-    float sweepCvMod = 0.f;
-    float bendCvMod = 0.f;
-    float decayCvMod = 0.f;
-    float foldCvMod = 0.f;
-    float sampleCvMod = 0.f;
-    float fbCvMod = 0.f;
-    float toneCvMod = 0.f;
+    enum CvModId {
+        CVMOD_PITCH,
+        CVMOD_SWEEP,
+        CVMOD_BEND,
+        CVMOD_DECAY,
+        CVMOD_FOLD,
+        CVMOD_SAMPLE,
+        CVMOD_FB,
+        CVMOD_TONE,
+        NUM_CVMODS
+    };
+    madzine::widgets::CVModBank<NUM_CVMODS> cvMods;
 
     // --- Cached params for processSingleSample ---
     struct ProcessState {
@@ -517,57 +522,57 @@ struct theKICK : Module {
         if (inputs[PITCH_CV_INPUT].isConnected()) {
             float cv = inputs[PITCH_CV_INPUT].getVoltage();
             pitch *= std::pow(2.f, cv);
-            pitchCvMod = clamp(cv / 5.f, -1.f, 1.f);
-        } else { pitchCvMod = 0.f; }
+            cvMods.publish(CVMOD_PITCH, clamp(cv / 5.f, -1.f, 1.f));
+        } else { cvMods.clear(CVMOD_PITCH); }
 
         if (inputs[SWEEP_CV_INPUT].isConnected()) {
             float cv = inputs[SWEEP_CV_INPUT].getVoltage();
             sweep += cv * 50.f;
             sweep = clamp(sweep, 0.f, 1000.f);
-            sweepCvMod = clamp(cv / 5.f, -1.f, 1.f);
-        } else { sweepCvMod = 0.f; }
+            cvMods.publish(CVMOD_SWEEP, clamp(cv / 5.f, -1.f, 1.f));
+        } else { cvMods.clear(CVMOD_SWEEP); }
 
         if (inputs[BEND_CV_INPUT].isConnected()) {
             float cv = inputs[BEND_CV_INPUT].getVoltage();
             bend += cv * 0.35f;
             bend = clamp(bend, 0.5f, 4.f);
-            bendCvMod = clamp(cv / 5.f, -1.f, 1.f);
-        } else { bendCvMod = 0.f; }
+            cvMods.publish(CVMOD_BEND, clamp(cv / 5.f, -1.f, 1.f));
+        } else { cvMods.clear(CVMOD_BEND); }
 
         if (inputs[DECAY_CV_INPUT].isConnected()) {
             float cv = inputs[DECAY_CV_INPUT].getVoltage();
             decayMs += cv * 100.f;
             decayMs = clamp(decayMs, 10.f, 2000.f);
-            decayCvMod = clamp(cv / 5.f, -1.f, 1.f);
-        } else { decayCvMod = 0.f; }
+            cvMods.publish(CVMOD_DECAY, clamp(cv / 5.f, -1.f, 1.f));
+        } else { cvMods.clear(CVMOD_DECAY); }
 
         if (inputs[FOLD_CV_INPUT].isConnected()) {
             float cv = inputs[FOLD_CV_INPUT].getVoltage();
             fold += cv;
             fold = clamp(fold, 0.f, 10.f);
-            foldCvMod = clamp(cv / 5.f, -1.f, 1.f);
-        } else { foldCvMod = 0.f; }
+            cvMods.publish(CVMOD_FOLD, clamp(cv / 5.f, -1.f, 1.f));
+        } else { cvMods.clear(CVMOD_FOLD); }
 
         if (inputs[SAMPLE_CV_INPUT].isConnected()) {
             float cv = inputs[SAMPLE_CV_INPUT].getVoltage();
             sampleMix += cv;
             sampleMix = clamp(sampleMix, 0.f, 10.f);
-            sampleCvMod = clamp(cv / 5.f, -1.f, 1.f);
-        } else { sampleCvMod = 0.f; }
+            cvMods.publish(CVMOD_SAMPLE, clamp(cv / 5.f, -1.f, 1.f));
+        } else { cvMods.clear(CVMOD_SAMPLE); }
 
         if (inputs[FB_CV_INPUT].isConnected()) {
             float cv = inputs[FB_CV_INPUT].getVoltage();
             fb += cv * 0.1f;
             fb = clamp(fb, 0.f, 1.f);
-            fbCvMod = clamp(cv / 5.f, -1.f, 1.f);
-        } else { fbCvMod = 0.f; }
+            cvMods.publish(CVMOD_FB, clamp(cv / 5.f, -1.f, 1.f));
+        } else { cvMods.clear(CVMOD_FB); }
 
         if (inputs[TONE_CV_INPUT].isConnected()) {
             float cv = inputs[TONE_CV_INPUT].getVoltage();
             toneKnob += cv;
             toneKnob = clamp(toneKnob, 0.f, 10.f);
-            toneCvMod = clamp(cv / 5.f, -1.f, 1.f);
-        } else { toneCvMod = 0.f; }
+            cvMods.publish(CVMOD_TONE, clamp(cv / 5.f, -1.f, 1.f));
+        } else { cvMods.clear(CVMOD_TONE); }
 
         // Tone knob to frequency: 0=40Hz, 10=20kHz (logarithmic)
         float toneCutoff = 40.f * std::pow(500.f, toneKnob / 10.f);
@@ -1025,6 +1030,7 @@ struct theKICKWidget : ModuleWidget {
     theKICKFMKnob* sampleKnob = nullptr;
     madzine::widgets::WhiteKnob* fbKnob = nullptr;
     madzine::widgets::WhiteKnob* toneKnob = nullptr;
+    madzine::widgets::CVModRingSync<theKICK::NUM_CVMODS> cvModSync;
 
     theKICKWidget(theKICK* module) {
         setModule(module);
@@ -1143,6 +1149,15 @@ struct theKICKWidget : ModuleWidget {
         addParam(foldKnob);
         addInput(createInputCentered<PJ301MPort>(Vec(col4R, row4Y + cvOffset), module, theKICK::FOLD_CV_INPUT));
 
+        cvModSync.bind(theKICK::CVMOD_PITCH, pitchKnob);
+        cvModSync.bind(theKICK::CVMOD_SWEEP, sweepKnob);
+        cvModSync.bind(theKICK::CVMOD_BEND, bendKnob);
+        cvModSync.bind(theKICK::CVMOD_DECAY, decayKnob);
+        cvModSync.bind(theKICK::CVMOD_FOLD, foldKnob);
+        cvModSync.bind(theKICK::CVMOD_SAMPLE, sampleKnob);
+        cvModSync.bind(theKICK::CVMOD_FB, fbKnob);
+        cvModSync.bind(theKICK::CVMOD_TONE, toneKnob);
+
         // --- I/O in white area (3 ports: TRIG left, ACCENT center, OUT right) ---
         float ioLeft = 22.f;
         float ioCenter = box.size.x / 2.f;
@@ -1188,21 +1203,8 @@ struct theKICKWidget : ModuleWidget {
         if (module) {
             panelThemeHelper.step(module);
 
-            // CV modulation ring display
-            auto updateKnobMod = [](auto* knob, bool connected, float mod) {
-                if (!knob) return;
-                knob->setModulationEnabled(connected);
-                if (connected) knob->setModulation(mod);
-            };
-
-            updateKnobMod(pitchKnob, module->inputs[theKICK::PITCH_CV_INPUT].isConnected(), module->pitchCvMod);
-            updateKnobMod(sweepKnob, module->inputs[theKICK::SWEEP_CV_INPUT].isConnected(), module->sweepCvMod);
-            updateKnobMod(bendKnob, module->inputs[theKICK::BEND_CV_INPUT].isConnected(), module->bendCvMod);
-            updateKnobMod(decayKnob, module->inputs[theKICK::DECAY_CV_INPUT].isConnected(), module->decayCvMod);
-            updateKnobMod(foldKnob, module->inputs[theKICK::FOLD_CV_INPUT].isConnected(), module->foldCvMod);
-            updateKnobMod(sampleKnob, module->inputs[theKICK::SAMPLE_CV_INPUT].isConnected(), module->sampleCvMod);
-            updateKnobMod(fbKnob, module->inputs[theKICK::FB_CV_INPUT].isConnected(), module->fbCvMod);
-            updateKnobMod(toneKnob, module->inputs[theKICK::TONE_CV_INPUT].isConnected(), module->toneCvMod);
+            // CV modulation ring display (only touches knobs whose value changed)
+            cvModSync.sync(module->cvMods);
         }
         ModuleWidget::step();
     }
@@ -1,10 +1,16 @@
 #include "plugin.hpp"
 #include "widgets/Knobs.hpp"
+#include "widgets/CVModulation.hpp"
 #include "widgets/PanelTheme.hpp"
+#include "BackgroundWorker.hpp"
+#include "RecordPipeline.hpp"
+#include "ResampleDSP.hpp"
 #include <cmath>
 #include <ctime>
 #include <cstring>
 #include <vector>
+#include <atomic>
+#include <mutex>
 #include <algorithm>
 #include <random>
 #include <sst/filters/HalfRateFilter.h>
@@ -18,8 +24,30 @@
 
 // 音訊層結構
 struct AudioLayer {
-    std::vector<float> bufferL;
-    std::vector<float> bufferR;
+    // 錄音以固定大小的區塊儲存：錄音時按需配置，清除時釋放，從未錄音的實例幾乎不佔記憶體
+    // 區塊表大小固定，配置新區塊不會搬動既有資料，音訊執行緒可以無鎖讀取
+    static constexpr int CHUNK_SHIFT = 18;             // 每區塊 262144 樣本框（48kHz 約 5.5 秒）
+    static constexpr int CHUNK_SIZE = 1 << CHUNK_SHIFT;
+    static constexpr int CHUNK_MASK = CHUNK_SIZE - 1;
+    static constexpr int MAX_CHUNKS = 2048;
+    static constexpr int MAX_FRAMES = MAX_CHUNKS * CHUNK_SIZE;  // 約 5.3 億樣本框
+
+    // 峰值索引：每 PEAK_BLOCK 個樣本一組 min/max，供波形顯示使用
+    // 由背景錄音執行緒（或載入時）更新，顯示時不必掃描整段錄音
+    static constexpr int PEAK_BLOCK = 256;
+    static constexpr int PEAKS_PER_CHUNK = CHUNK_SIZE / PEAK_BLOCK;
+
+    struct Chunk {
+        float samples[2][CHUNK_SIZE];
+        float peakMin[2][PEAKS_PER_CHUNK];
+        float peakMax[2][PEAKS_PER_CHUNK];
+    };
+
+    std::atomic<Chunk*> chunks[MAX_CHUNKS] = {};
+    std::atomic<int> allocatedChunks{0};
+    // UI 端讀取（顯示、存檔）與釋放區塊互斥；音訊執行緒不使用
+    std::mutex storageMutex;
+
     int playbackPosition = 0;
     float playbackPhase = 0.0f;   // 用於慢速播放的亞樣本相位 (0.0-1.0)
     int recordedLength = 0;       // 實際錄音長度
@@ -32,15 +60,125 @@ struct AudioLayer {
     int pendingSliceIndex = -1;   // Slice to switch to after fade out
     int pendingPlaybackPosition = 0; // Position to start at after fade out
 
-    AudioLayer() {
-        // 預設 60 秒 @ 48kHz
-        bufferL.resize(60 * 48000, 0.0f);
-        bufferR.resize(60 * 48000, 0.0f);
+    ~AudioLayer() {
+        releaseStorage();
+    }
+
+    // 已配置的樣本框數
+    int capacity() const {
+        return allocatedChunks.load(std::memory_order_acquire) * CHUNK_SIZE;
+    }
+
+    // 確保 [0, frames) 都已配置（新區塊為靜音），超過上限時回傳 false
+    bool reserve(int frames) {
+        if (frames > MAX_FRAMES) return false;
+        int needed = (frames + CHUNK_MASK) >> CHUNK_SHIFT;
+        for (int c = allocatedChunks.load(std::memory_order_acquire); c < needed; c++) {
+            if (!chunks[c].load(std::memory_order_acquire)) {
+                Chunk* fresh = new Chunk();
+                Chunk* expected = nullptr;
+                if (!chunks[c].compare_exchange_strong(expected, fresh, std::memory_order_acq_rel))
+                    delete fresh;
+            }
+            allocatedChunks.store(c + 1, std::memory_order_release);
+        }
+        return true;
+    }
+
+    // 釋放所有區塊；呼叫時音訊執行緒不可再讀取（recordedLength 已歸零）
+    void releaseStorage() {
+        std::lock_guard<std::mutex> lock(storageMutex);
+        allocatedChunks.store(0, std::memory_order_release);
+        for (int c = 0; c < MAX_CHUNKS; c++) {
+            delete chunks[c].exchange(nullptr, std::memory_order_acq_rel);
+        }
+    }
+
+    // ---- 音訊執行緒 / 背景錄音執行緒：i 必須在已配置範圍內 ----
+
+    float sample(int channel, int i) const {
+        return chunks[i >> CHUNK_SHIFT].load(std::memory_order_acquire)->samples[channel][i & CHUNK_MASK];
+    }
+
+    void write(int i, float left, float right) {
+        Chunk* chunk = chunks[i >> CHUNK_SHIFT].load(std::memory_order_acquire);
+        chunk->samples[0][i & CHUNK_MASK] = left;
+        chunk->samples[1][i & CHUNK_MASK] = right;
+    }
+
+    // ---- UI 執行緒（持有 storageMutex）：尚未配置或已釋放的區塊視為靜音 ----
+
+    float peekSample(int channel, int i) const {
+        Chunk* chunk = chunks[i >> CHUNK_SHIFT].load(std::memory_order_acquire);
+        return chunk ? chunk->samples[channel][i & CHUNK_MASK] : 0.0f;
+    }
+
+    // 複製一段連續樣本（存檔用）
+    void readRange(int channel, int from, int frames, float* dst) const {
+        while (frames > 0) {
+            int n = std::min(frames, CHUNK_SIZE - (from & CHUNK_MASK));
+            Chunk* chunk = chunks[from >> CHUNK_SHIFT].load(std::memory_order_acquire);
+            if (chunk)
+                std::memcpy(dst, &chunk->samples[channel][from & CHUNK_MASK], n * sizeof(float));
+            else
+                std::fill(dst, dst + n, 0.0f);
+            from += n;
+            dst += n;
+            frames -= n;
+        }
+    }
+
+    // 寫入一段連續樣本（載入用，範圍必須已 reserve）
+    void writeRange(int channel, int from, int frames, const float* src) {
+        while (frames > 0) {
+            int n = std::min(frames, CHUNK_SIZE - (from & CHUNK_MASK));
+            Chunk* chunk = chunks[from >> CHUNK_SHIFT].load(std::memory_order_acquire);
+            std::memcpy(&chunk->samples[channel][from & CHUNK_MASK], src, n * sizeof(float));
+            from += n;
+            src += n;
+            frames -= n;
+        }
+    }
+
+    // 峰值區塊 [firstBlock, lastBlock] 的 min/max
+    void peakRange(int channel, int firstBlock, int lastBlock, float& lo, float& hi) const {
+        lo = INFINITY;
+        hi = -INFINITY;
+        for (int b = firstBlock; b <= lastBlock; b++) {
+            Chunk* chunk = chunks[b / PEAKS_PER_CHUNK].load(std::memory_order_acquire);
+            if (!chunk) {
+                lo = std::min(lo, 0.0f);
+                hi = std::max(hi, 0.0f);
+                continue;
+            }
+            lo = std::min(lo, chunk->peakMin[channel][b % PEAKS_PER_CHUNK]);
+            hi = std::max(hi, chunk->peakMax[channel][b % PEAKS_PER_CHUNK]);
+        }
     }
 
+    // 重新計算涵蓋 [from, to) 的峰值區塊（區塊開頭到 to 之間的樣本都必須已寫入）
+    void updatePeaks(int from, int to) {
+        to = std::min(to, capacity());
+        if (to <= from) return;
+        for (int b = from / PEAK_BLOCK; b <= (to - 1) / PEAK_BLOCK; b++) {
+            Chunk* chunk = chunks[b / PEAKS_PER_CHUNK].load(std::memory_order_acquire);
+            int start = (b % PEAKS_PER_CHUNK) * PEAK_BLOCK;
+            int end = start + std::min(PEAK_BLOCK, to - b * PEAK_BLOCK);
+            for (int ch = 0; ch < 2; ch++) {
+                const float* x = chunk->samples[ch];
+                float lo = x[start], hi = lo;
+                for (int i = start + 1; i < end; i++) {
+                    lo = std::min(lo, x[i]);
+                    hi = std::max(hi, x[i]);
+                }
+                chunk->peakMin[ch][b % PEAKS_PER_CHUNK] = lo;
+                chunk->peakMax[ch][b % PEAKS_PER_CHUNK] = hi;
+            }
+        }
+    }
+
+    // 重設播放狀態（儲存區塊由呼叫端決定何時釋放）
     void clear() {
-        std::fill(bufferL.begin(), bufferL.end(), 0.0f);
-        std::fill(bufferR.begin(), bufferR.end(), 0.0f);
         playbackPosition = 0;
         playbackPhase = 0.0f;
         recordedLength = 0;
@@ -257,6 +395,35 @@ struct WeiiiDocumenta : Module {
     bool isLooping = false;  // Loop mode
     int recordPosition = 0;
 
+    // 背景錄音管線：音訊執行緒只寫入環形緩衝，由背景執行緒搬進 layer 並更新峰值
+    RecordPipeline<2> recorder;
+    // 事件佇列已滿而沒送出的釋放要求，下一個 block 重送
+    bool releasePending = false;
+    // UI 執行緒要求音訊執行緒停止錄音（loadWave 前）
+    std::atomic<bool> stopRecordRequest{false};
+
+    // 最長錄音時間（分鐘，右鍵選單設定）
+    int maxRecordMinutes = 10;
+
+    // 超過此長度（48kHz 約 10 秒）的錄音不再以 base64 寫進 patch JSON，
+    // 改由 onSave() 存成 patch storage 目錄下的 WAV，避免每次自動存檔產生數百 MB 的 JSON。
+    // 只有 onSave() 剛寫好 sidecar 的那次 dataToJson 才省略樣本；預設集、複製、
+    // 復原記錄等不經 onSave() 的路徑仍以 base64 內嵌，資料不會遺失
+    static constexpr int INLINE_MAX_FRAMES = 480000;
+    static constexpr const char* SIDECAR_FILE = "recording.wav";
+    int sidecarSavedLength = -1;  // onSave() 寫入的長度，dataToJson 取用後失效
+    int sidecarFrames = 0;        // 待從 sidecar 載入的長度
+    bool addedToEngine = false;   // onAdd() 之後才能讀 patch storage
+
+    // 變速播放插值模式（右鍵選單設定）與上一個樣本的播放速度（sinc 模式選頻帶用）
+    int interpolationMode = RESAMPLE_HERMITE;
+    float lastPlaybackSpeed = 1.0f;
+
+    int maxRecordFrames(float sampleRate) const {
+        double frames = maxRecordMinutes * 60.0 * sampleRate;
+        return (int)std::min(frames, (double)AudioLayer::MAX_FRAMES);
+    }
+
     // Clear button hold timer
     float clearButtonHoldTimer = 0.0f;
     bool clearButtonPressed = false;
@@ -267,6 +434,20 @@ struct WeiiiDocumenta : Module {
     float lastThreshold = 1.0f;  // 追蹤上一次的 threshold 值以偵測變化
     float lastMinSliceTime = 0.05f;  // 追蹤上一次的最小切片時間
 
+    // 切片重新掃描：音訊執行緒只送出要求，由共用背景執行緒掃描整段錄音後交回結果
+    struct SliceScanTask : madzine::BackgroundTask {
+        WeiiiDocumenta* module = nullptr;
+        bool service() override { return module->serviceSliceScan(); }
+    };
+    SliceScanTask sliceScanTask;
+    std::atomic<uint32_t> scanRequest{0};   // 音訊執行緒遞增：送出新要求，同時作廢進行中的掃描
+    std::atomic<float> scanThreshold{0.0f};
+    std::atomic<int> scanMinSamples{0};
+    std::atomic<int> scanLength{0};         // 0 表示只作廢，不掃描
+    std::atomic<uint32_t> scanReady{0};     // scannedSlices 對應的要求編號，0 表示音訊執行緒已取走
+    std::vector<Slice> scannedSlices;       // 背景執行緒寫入，scanReady 非 0 時歸音訊執行緒交換
+    uint32_t scanServed = 0;                // 背景執行緒：最後處理的要求編號
+
     // 漸變系統
     std::vector<ParameterMorpher> morphers;
     ParameterMorpher::State morphState = ParameterMorpher::IDLE;
@@ -313,13 +494,17 @@ struct WeiiiDocumenta : Module {
     float sampleHoldCV = 0.0f;         // S&H CV輸出（±10V with AMT）
 
     // CV 調變顯示用
-    float thresholdCvMod = 0.0f;
-    float scanCvMod = 0.0f;
-    float feedbackCvMod = 0.0f;
-    float speedCvMod = 0.0f;
-    float polyCvMod = 0.0f;
-    float shAmountCvMod = 0.0f;
-    float shRateCvMod = 0.0f;
+    enum CvModId {
+        CVMOD_THRESHOLD,
+        CVMOD_SCAN,
+        CVMOD_FEEDBACK,
+        CVMOD_SPEED,
+        CVMOD_POLY,
+        CVMOD_SH_AMOUNT,
+        CVMOD_SH_RATE,
+        NUM_CVMODS
+    };
+    madzine::widgets::CVModBank<NUM_CVMODS> cvMods;
 
     // ===== Parameter smoothing to prevent zipper noise =====
     struct SmoothedParam {
@@ -369,11 +554,56 @@ struct WeiiiDocumenta : Module {
 
     std::vector<Voice> voices;        // 當前所有 voice
     int numVoices = 1;                // Voice 數量（1-8）
+
+    // 每個 voice 的聲像增益表（已含 1/numVoices），只在 voice 數量改變時重算
+    // voice 1-4 / 5-8 各一組 float_4；未使用的 voice 增益為 0
+    simd::float_4 voicePanLL[2], voicePanRL[2], voicePanRR[2], voicePanLR[2];
+    int voicePanCount = 0;
+
+    void updateVoicePans() {
+        float gLL[8] = {}, gRL[8] = {}, gRR[8] = {}, gLR[8] = {};
+        float norm = 1.0f / (float)numVoices;
+        for (int i = 0; i < numVoices; i++) {
+            // Per-voice equal-power auto panning (preserve stereo width)
+            float pan = (numVoices == 1) ? 0.0f : -1.0f + 2.0f * (float)i / (float)(numVoices - 1);
+            float gainL = std::cos((pan + 1.f) * 0.25f * M_PI);
+            float gainR = std::sin((pan + 1.f) * 0.25f * M_PI);
+            gLL[i] = gainL * norm;
+            gRL[i] = (1.0f - gainR) * norm;
+            gRR[i] = gainR * norm;
+            gLR[i] = (1.0f - gainL) * norm;
+        }
+        for (int g = 0; g < 2; g++) {
+            voicePanLL[g] = simd::float_4::load(&gLL[g * 4]);
+            voicePanRL[g] = simd::float_4::load(&gRL[g * 4]);
+            voicePanRR[g] = simd::float_4::load(&gRR[g * 4]);
+            voicePanLR[g] = simd::float_4::load(&gLR[g * 4]);
+        }
+        voicePanCount = numVoices;
+    }
     std::default_random_engine randomEngine; // 隨機數生成器
 
     WeiiiDocumenta() {
         config(PARAMS_LEN, INPUTS_LEN, OUTPUTS_LEN, LIGHTS_LEN);
 
+        RecordPipeline<2>::Callbacks recordCallbacks;
+        recordCallbacks.commit = [this](int target, int frame, const float* samples, int frames) {
+            // 儲存區塊在這裡（背景執行緒）按需配置
+            int n = std::min(frames, AudioLayer::MAX_FRAMES - frame);
+            if (n <= 0 || !layer.reserve(frame + n)) return;
+            for (int i = 0; i < n; i++) {
+                layer.write(frame + i, samples[i * 2], samples[i * 2 + 1]);
+            }
+            layer.updatePeaks(frame, frame + n);
+        };
+        recordCallbacks.release = [this](int target) {
+            layer.releaseStorage();
+        };
+        recorder.start(recordCallbacks);
+        sliceScanTask.module = this;
+        madzine::BackgroundWorker::instance().add(&sliceScanTask);
+        SincTable::get();  // 先建好 sinc 表，避免在音訊執行緒第一次使用時才計算
+
         // Initialize random engine with time-based seed (safely handle potential failure)
         try {
             std::time_t t = std::time(nullptr);
@@ -475,6 +705,19 @@ struct WeiiiDocumenta : Module {
         smoothedFeedbackDelay.reset(0.5f);
     }
 
+    // 讀取 layer 在 position + phase（phase 可為負）的立體聲插值樣本
+    void readLayer(int position, float phase, float absSpeed, float& outL, float& outR) {
+        if (phase < 0.0f) {
+            position -= 1;
+            phase += 1.0f;
+        }
+        int length = layer.recordedLength;
+        outL = resampleRead(interpolationMode, [this](int i) { return layer.sample(0, i); },
+                            length, position, phase, absSpeed);
+        outR = resampleRead(interpolationMode, [this](int i) { return layer.sample(1, i); },
+                            length, position, phase, absSpeed);
+    }
+
     // 處理單一樣本（在 oversample 速率下執行）
     std::pair<float, float> processSingleSample(float inputL, float inputR, float sampleRate, float sampleTime) {
         // 播放和混音（在 oversample 速率下執行）
@@ -512,20 +755,18 @@ struct WeiiiDocumenta : Module {
                     }
                 }
 
-                float floatPos = (float)layer.playbackPosition + layer.playbackPhase;
-                int pos0 = (int)floatPos % layer.recordedLength;
-                int pos1 = (pos0 + 1) % layer.recordedLength;
-                float frac = floatPos - (int)floatPos;
-
-                // 線性插值
-                outputL = layer.bufferL[pos0] * (1.0f - frac) + layer.bufferL[pos1] * frac;
-                outputR = layer.bufferR[pos0] * (1.0f - frac) + layer.bufferR[pos1] * frac;
+                readLayer(layer.playbackPosition, layer.playbackPhase, std::abs(lastPlaybackSpeed),
+                          outputL, outputR);
 
                 // Apply fade envelope
                 outputL *= layer.fadeEnvelope;
                 outputR *= layer.fadeEnvelope;
             } else {
                 // Multiple voices - mix them together
+                if (voicePanCount != numVoices) updateVoicePans();
+                alignas(16) float voicesL[8] = {};
+                alignas(16) float voicesR[8] = {};
+
                 for (int i = 0; i < numVoices; i++) {
                     // Update fade envelope for this voice
                     if (voices[i].fadingOut) {
@@ -549,26 +790,24 @@ struct WeiiiDocumenta : Module {
                         }
                     }
 
-                    float floatPos = (float)voices[i].playbackPosition + voices[i].playbackPhase;
-                    int pos0 = (int)floatPos % layer.recordedLength;
-                    int pos1 = (pos0 + 1) % layer.recordedLength;
-                    float frac = floatPos - (int)floatPos;
-
-                    // 線性插值 with fade envelope
-                    float voiceL = (layer.bufferL[pos0] * (1.0f - frac) + layer.bufferL[pos1] * frac) * voices[i].fadeEnvelope;
-                    float voiceR = (layer.bufferR[pos0] * (1.0f - frac) + layer.bufferR[pos1] * frac) * voices[i].fadeEnvelope;
-
-                    // Per-voice equal-power auto panning (preserve stereo width)
-                    float pan = (numVoices == 1) ? 0.0f : -1.0f + 2.0f * (float)i / (float)(numVoices - 1);
-                    float gainL = std::cos((pan + 1.f) * 0.25f * M_PI);
-                    float gainR = std::sin((pan + 1.f) * 0.25f * M_PI);
-                    outputL += voiceL * gainL + voiceR * (1.0f - gainR);
-                    outputR += voiceR * gainR + voiceL * (1.0f - gainL);
+                    // 插值 with fade envelope
+                    float voiceL, voiceR;
+                    readLayer(voices[i].playbackPosition, voices[i].playbackPhase,
+                              std::abs(lastPlaybackSpeed) * voices[i].speedMultiplier, voiceL, voiceR);
+                    voicesL[i] = voiceL * voices[i].fadeEnvelope;
+                    voicesR[i] = voiceR * voices[i].fadeEnvelope;
                 }
 
-                // Divide by numVoices to prevent clipping
-                outputL /= (float)numVoices;
-                outputR /= (float)numVoices;
+                // 聲像混音（增益表已除以 numVoices 以避免削波）
+                simd::float_4 mixL = 0.0f, mixR = 0.0f;
+                for (int g = 0; g < (numVoices + 3) / 4; g++) {
+                    simd::float_4 vl = simd::float_4::load(&voicesL[g * 4]);
+                    simd::float_4 vr = simd::float_4::load(&voicesR[g * 4]);
+                    mixL += vl * voicePanLL[g] + vr * voicePanRL[g];
+                    mixR += vr * voicePanRR[g] + vl * voicePanLR[g];
+                }
+                outputL = mixL[0] + mixL[1] + mixL[2] + mixL[3];
+                outputR = mixR[0] + mixR[1] + mixR[2] + mixR[3];
             }
         }
 
@@ -587,6 +826,42 @@ struct WeiiiDocumenta : Module {
         return {clamp(outputL, -10.0f, 10.0f), clamp(outputR, -10.0f, 10.0f)};
     }
 
+    ~WeiiiDocumenta() {
+        madzine::BackgroundWorker::instance().remove(&sliceScanTask);
+        recorder.stop();
+    }
+
+    // 錄音停止：背景端搬完剩餘樣本後 recordedLength 即為實際長度，並結束最後一個切片
+    void stopRecording() {
+        isRecording = false;
+        recorder.end();
+        if (!slices.empty() && slices.back().active) {
+            slices.back().endSample = recordPosition;
+        }
+    }
+
+    /**
+     * 替換 layer 內容前停止錄音並等背景端搬完，避免剩餘樣本覆寫載入的資料
+     * fromUi = true（loadWave）時音訊執行緒仍在執行，交給它在樣本邊界停止；
+     * dataFromJson 期間 engine 已鎖定，直接停止
+     */
+    void haltRecording(bool fromUi) {
+        if (fromUi) {
+            stopRecordRequest.store(true);
+            // 模組被旁通時 process() 不會執行，最多等 500 ms 後直接停止
+            for (int i = 0; i < 500 && stopRecordRequest.load(std::memory_order_acquire); i++) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            stopRecordRequest.store(false);
+        }
+        if (isRecording) {
+            stopRecording();
+        }
+        if (!recorder.wait()) {
+            WARN("weiiidocumenta: recorder did not drain before loading");
+        }
+    }
+
     void process(const ProcessArgs& args) override {
         // ===== 更新 smoothed parameter 目標值 =====
         smoothedScan.setTarget(params[SCAN_PARAM].getValue());
@@ -597,9 +872,9 @@ struct WeiiiDocumenta : Module {
             float cv = inputs[THRESHOLD_CV_INPUT].getVoltage();
             float atten = params[THRESHOLD_CV_ATTEN_PARAM].getValue();
             thresholdValue = clamp(thresholdValue + cv * atten, 0.0f, 10.0f);
-            thresholdCvMod = clamp(cv / 10.0f * atten, -1.0f, 1.0f);
+            cvMods.publish(CVMOD_THRESHOLD, clamp(cv / 10.0f * atten, -1.0f, 1.0f));
         } else {
-            thresholdCvMod = 0.0f;
+            cvMods.clear(CVMOD_THRESHOLD);
         }
         smoothedThreshold.setTarget(thresholdValue);
 
@@ -611,9 +886,9 @@ struct WeiiiDocumenta : Module {
             float cv = inputs[FEEDBACK_AMOUNT_CV_INPUT].getVoltage();
             float feedbackAtten = params[FEEDBACK_AMOUNT_CV_ATTEN_PARAM].getValue();
             feedbackValue = clamp(feedbackValue + (cv / 10.0f) * feedbackAtten, 0.0f, 1.0f);
-            feedbackCvMod = clamp(cv / 10.0f * feedbackAtten, -1.0f, 1.0f);
+            cvMods.publish(CVMOD_FEEDBACK, clamp(cv / 10.0f * feedbackAtten, -1.0f, 1.0f));
         } else {
-            feedbackCvMod = 0.0f;
+            cvMods.clear(CVMOD_FEEDBACK);
         }
         smoothedFeedbackAmount.setTarget(feedbackValue);
 
@@ -622,21 +897,28 @@ struct WeiiiDocumenta : Module {
         if (inputs[REC_TRIGGER_INPUT].isConnected()) {
             recTriggerSignal += inputs[REC_TRIGGER_INPUT].getVoltage();
         }
+        if (releasePending) {
+            releasePending = !recorder.release(0);
+        }
         if (recTrigger.process(recTriggerSignal)) {
-            isRecording = !isRecording;
-            if (isRecording) {
-                recordPosition = 0;
-                slices.clear();  // 重置切片
-                lastAmplitude = 0.0f;
-                lastThreshold = smoothedThreshold.value;  // 記錄當前 threshold
-            } else {
-                // 錄音停止：記錄實際長度並結束最後一個切片
-                layer.recordedLength = recordPosition;
-                if (!slices.empty() && slices.back().active) {
-                    slices.back().endSample = recordPosition;
+            if (!isRecording) {
+                // 背景端卡住（事件佇列滿）時不開始錄音
+                if (!releasePending && recorder.begin(0, 0)) {
+                    isRecording = true;
+                    recordPosition = 0;
+                    slices.clear();  // 重置切片
+                    requestSliceScan(0);  // 作廢尚未交回的掃描結果
+                    lastAmplitude = 0.0f;
+                    lastThreshold = smoothedThreshold.value;  // 記錄當前 threshold
                 }
+            } else {
+                stopRecording();
             }
         }
+        if (stopRecordRequest.load(std::memory_order_relaxed)) {
+            if (isRecording) stopRecording();
+            stopRecordRequest.store(false, std::memory_order_release);
+        }
 
         // PLAY/LOOP button: toggles between Loop ↔ Play
         float playTriggerSignal = params[PLAY_BUTTON_PARAM].getValue();
@@ -660,9 +942,9 @@ struct WeiiiDocumenta : Module {
         if (inputs[POLY_CV_INPUT].isConnected()) {
             float polyCv = inputs[POLY_CV_INPUT].getVoltage();
             polyValue = clamp(polyValue + polyCv / 10.0f * 7.0f, 1.0f, 8.0f); // 0-10V -> 0-7 additional voices
-            polyCvMod = clamp(polyCv / 10.0f, -1.0f, 1.0f);
+            cvMods.publish(CVMOD_POLY, clamp(polyCv / 10.0f, -1.0f, 1.0f));
         } else {
-            polyCvMod = 0.0f;
+            cvMods.clear(CVMOD_POLY);
         }
         int newNumVoices = (int)std::round(polyValue);
         newNumVoices = clamp(newNumVoices, 1, 8);
@@ -734,9 +1016,17 @@ struct WeiiiDocumenta : Module {
 
                 // Clear after 2 seconds
                 if (clearButtonHoldTimer >= 2.0f) {
+                    // 播放停止讀取後，由背景執行緒釋放儲存區塊
                     layer.clear();
                     recordPosition = 0;
                     slices.clear();
+                    requestSliceScan(0);
+                    // 錄音中的錄音段由 release 結束，一定送得出去
+                    releasePending = !recorder.release(0);
+                    if (isRecording && !recorder.begin(0, 0)) {
+                        // 錄音中清除：從頭重新錄；背景端卡住時改為停止錄音
+                        isRecording = false;
+                    }
                     clearButtonHoldTimer = 0.0f;  // Reset to prevent repeated clearing
                 }
             }
@@ -751,18 +1041,27 @@ struct WeiiiDocumenta : Module {
         float currentThreshold = smoothedThreshold.process();
         float currentMinSliceTime = params[THRESHOLD_CV_ATTEN_PARAM].getValue();
 
-        // 不在錄音時才進行重新掃描
+        // 不在錄音時才進行重新掃描；掃描本身在背景執行緒，這裡只送出要求
         if (!isRecording) {
             bool thresholdChanged = std::abs(currentThreshold - lastThreshold) > 0.05f;
             bool minTimeChanged = std::abs(currentMinSliceTime - lastMinSliceTime) > 0.001f;
 
             if (thresholdChanged || minTimeChanged) {
-                rescanSlices();
+                if (layer.recordedLength > 0) requestSliceScan(layer.recordedLength);
                 lastThreshold = currentThreshold;
                 lastMinSliceTime = currentMinSliceTime;
             }
         }
 
+        // 取回背景掃描結果：只交換 vector，音訊執行緒不配置記憶體
+        uint32_t readyScan = scanReady.load(std::memory_order_acquire);
+        if (readyScan != 0) {
+            if (readyScan == scanRequest.load(std::memory_order_relaxed)) {
+                std::swap(slices, scannedSlices);
+            }
+            scanReady.store(0, std::memory_order_release);
+        }
+
         // 更新燈號
         lights[REC_LIGHT].setBrightness(isRecording ? 1.0f : 0.0f);
 
@@ -791,13 +1090,8 @@ struct WeiiiDocumenta : Module {
 
         // 錄音（在原始速率執行，不進行 oversample）
         if (isRecording) {
-            if (recordPosition < (int)layer.bufferL.size()) {
-                layer.bufferL[recordPosition] = inputL;
-                layer.bufferR[recordPosition] = inputR;
-
-                // 即時更新錄音長度
-                layer.recordedLength = recordPosition + 1;
-
+            float frame[2] = {inputL, inputR};
+            if (recordPosition < maxRecordFrames(args.sampleRate) && recorder.write(frame)) {
                 // 切片檢測：偵測音量突變 使用混合訊號
                 float threshold = smoothedThreshold.value;
                 float mixedSample = (inputL + inputR) * 0.5f;
@@ -830,6 +1124,11 @@ struct WeiiiDocumenta : Module {
             }
         }
 
+        // 錄音長度跟隨背景端已搬入的樣本（停止後直到剩餘樣本搬完為止）
+        if (isRecording || !recorder.idle()) {
+            layer.recordedLength = recorder.committed();
+        }
+
         // 直接處理（移除 oversampling 以改善音質）
         auto [outputL, outputR] = processSingleSample(inputL, inputR, args.sampleRate, args.sampleTime);
 
@@ -842,9 +1141,9 @@ struct WeiiiDocumenta : Module {
                 float cv = inputs[SCAN_CV_INPUT].getVoltage();
                 float atten = params[SCAN_CV_ATTEN_PARAM].getValue();
                 scanValue = clamp(scanValue + (cv / 10.0f) * atten, 0.0f, 1.0f);
-                scanCvMod = clamp(cv / 10.0f * atten, -1.0f, 1.0f);
+                cvMods.publish(CVMOD_SCAN, clamp(cv / 10.0f * atten, -1.0f, 1.0f));
             } else {
-                scanCvMod = 0.0f;
+                cvMods.clear(CVMOD_SCAN);
             }
 
             // 處理 S&H 內建調變 Scan
@@ -907,10 +1206,11 @@ struct WeiiiDocumenta : Module {
                 if (inputs[SPEED_CV_INPUT].isConnected()) {
                     float speedCv = inputs[SPEED_CV_INPUT].getVoltage();
                     playbackSpeed = clamp(playbackSpeed + speedCv, -8.0f, 8.0f);
-                    speedCvMod = clamp(speedCv / 10.0f, -1.0f, 1.0f);
+                    cvMods.publish(CVMOD_SPEED, clamp(speedCv / 10.0f, -1.0f, 1.0f));
                 } else {
-                    speedCvMod = 0.0f;
+                    cvMods.clear(CVMOD_SPEED);
                 }
+                lastPlaybackSpeed = playbackSpeed;
 
                 // 檢查是否超出範圍（支援正反向播放）
                 bool isReverse = playbackSpeed < 0.0f;
@@ -1162,9 +1462,9 @@ struct WeiiiDocumenta : Module {
             float rateCv = inputs[SH_RATE_CV_INPUT].getVoltage();  // 0-10V
             float rateAtten = params[SH_RATE_CV_ATTEN_PARAM].getValue();
             shRateLog = clamp(shRateLog + rateCv * rateAtten, std::log2(0.01f), std::log2(100.0f));
-            shRateCvMod = clamp(rateCv / 10.0f * rateAtten, -1.0f, 1.0f);
+            cvMods.publish(CVMOD_SH_RATE, clamp(rateCv / 10.0f * rateAtten, -1.0f, 1.0f));
         } else {
-            shRateCvMod = 0.0f;
+            cvMods.clear(CVMOD_SH_RATE);
         }
         float shRate = std::pow(2.f, shRateLog);  // Convert from log2 to Hz
 
@@ -1197,9 +1497,9 @@ struct WeiiiDocumenta : Module {
             float gainCv = inputs[SH_AMOUNT_CV_INPUT].getVoltage();
             float gainAtten = params[SH_AMOUNT_CV_ATTEN_PARAM].getValue();
             shGain = clamp(shGain + gainCv * 0.5f * gainAtten, 0.0f, 5.0f);  // 0-10V -> 0-5x
-            shAmountCvMod = clamp(gainCv / 10.0f * gainAtten, -1.0f, 1.0f);
+            cvMods.publish(CVMOD_SH_AMOUNT, clamp(gainCv / 10.0f * gainAtten, -1.0f, 1.0f));
         } else {
-            shAmountCvMod = 0.0f;
+            cvMods.clear(CVMOD_SH_AMOUNT);
         }
 
         // Apply gain to bipolar output (±10V range)
@@ -1500,62 +1800,82 @@ struct WeiiiDocumenta : Module {
         if (morphTargetSpeed) params[SPEED_PARAM].setValue(morphers[idx++].originalValue);
     }
 
-    // 重新掃描切片：當 threshold 改變時重新偵測所有切片
-    void rescanSlices() {
-        if (layer.recordedLength <= 0) return;
+    // ---- 音訊執行緒：送出重新掃描要求；length 為 0 時只作廢進行中的掃描 ----
+    void requestSliceScan(int length) {
+        scanThreshold.store(smoothedThreshold.value, std::memory_order_relaxed);
+        float minSliceTime = params[THRESHOLD_CV_ATTEN_PARAM].getValue(); // 最小切片時間（秒）
+        scanMinSamples.store((int)(minSliceTime * APP->engine->getSampleRate()), std::memory_order_relaxed);
+        scanLength.store(length, std::memory_order_relaxed);
+        uint32_t next = scanRequest.load(std::memory_order_relaxed) + 1;
+        if (next == 0) next = 1;  // 0 保留給 scanReady 的「已取走」
+        scanRequest.store(next, std::memory_order_release);
+    }
 
-        // 清除舊切片
-        slices.clear();
+    // ---- 背景執行緒：重新偵測整段錄音的切片，結果交給音訊執行緒交換 ----
+    bool serviceSliceScan() {
+        // 上一個結果尚未被音訊執行緒取走
+        if (scanReady.load(std::memory_order_acquire) != 0) return true;
+        uint32_t request = scanRequest.load(std::memory_order_acquire);
+        if (request == scanServed) return false;
+        scanServed = request;
 
-        // 使用當前 threshold 重新掃描整個 buffer
-        float threshold = smoothedThreshold.value;
-        float minSliceTime = params[THRESHOLD_CV_ATTEN_PARAM].getValue(); // 最小切片時間（秒）
-        int minSliceSamples = (int)(minSliceTime * 48000.0f); // 假設 48kHz
+        int length = scanLength.load(std::memory_order_relaxed);
+        if (length <= 0) return false;
+        float threshold = scanThreshold.load(std::memory_order_relaxed);
+        int minSliceSamples = scanMinSamples.load(std::memory_order_relaxed);
+
+        scannedSlices.clear();
         float lastAmp = 0.0f;
+        int pos = 0;
+        while (pos < length) {
+            // 一次掃描一個區塊；期間有新要求就放棄這次結果
+            if (scanRequest.load(std::memory_order_acquire) != request) return true;
+            int blockEnd = std::min(length, (pos & ~AudioLayer::CHUNK_MASK) + AudioLayer::CHUNK_SIZE);
+            // 持鎖避免 UI 端同時釋放區塊；已釋放的區塊視為靜音
+            std::lock_guard<std::mutex> lock(layer.storageMutex);
+            for (; pos < blockEnd; pos++) {
+                // 使用混合訊號
+                float mixedSample = (layer.peekSample(0, pos) + layer.peekSample(1, pos)) * 0.5f;
+                float currentAmp = std::abs(mixedSample);
 
-        for (int pos = 0; pos < layer.recordedLength; pos++) {
-            // 使用混合訊號
-            float mixedSample = (layer.bufferL[pos] + layer.bufferR[pos]) * 0.5f;
-            float currentAmp = std::abs(mixedSample);
+                // 偵測從低音量到高音量的突變（attack）
+                if (lastAmp < threshold && currentAmp >= threshold) {
+                    // 結束上一個切片
+                    if (!scannedSlices.empty() && scannedSlices.back().active) {
+                        scannedSlices.back().endSample = pos - 1;
+                    }
 
-            // 偵測從低音量到高音量的突變（attack）
-            if (lastAmp < threshold && currentAmp >= threshold) {
-                // 結束上一個切片
-                if (!slices.empty() && slices.back().active) {
-                    slices.back().endSample = pos - 1;
+                    // 開始新切片
+                    Slice newSlice;
+                    newSlice.startSample = pos;
+                    newSlice.active = true;
+                    newSlice.peakAmplitude = 0.0f;
+                    scannedSlices.push_back(newSlice);
                 }
 
-                // 開始新切片
-                Slice newSlice;
-                newSlice.startSample = pos;
-                newSlice.active = true;
-                newSlice.peakAmplitude = 0.0f;
-                slices.push_back(newSlice);
-            }
+                // 更新當前切片的 peak amplitude
+                if (!scannedSlices.empty() && scannedSlices.back().active) {
+                    scannedSlices.back().peakAmplitude = std::max(
+                        scannedSlices.back().peakAmplitude, currentAmp);
+                }
 
-            // 更新當前切片的 peak amplitude
-            if (!slices.empty() && slices.back().active) {
-                slices.back().peakAmplitude = std::max(
-                    slices.back().peakAmplitude, currentAmp);
+                lastAmp = currentAmp;
             }
-
-            lastAmp = currentAmp;
         }
 
         // 結束最後一個切片
-        if (!slices.empty() && slices[slices.size() - 1].active) {
-            slices[slices.size() - 1].endSample = layer.recordedLength - 1;
+        if (!scannedSlices.empty() && scannedSlices.back().active) {
+            scannedSlices.back().endSample = length - 1;
         }
 
-        // 過濾掉太短的切片
-        std::vector<Slice> filteredSlices;
-        for (const auto& slice : slices) {
-            int sliceLength = slice.endSample - slice.startSample;
-            if (sliceLength >= minSliceSamples) {
-                filteredSlices.push_back(slice);
-            }
-        }
-        slices = filteredSlices;
+        // 過濾掉太短的切片（原地壓縮，沿用既有容量）
+        scannedSlices.erase(std::remove_if(scannedSlices.begin(), scannedSlices.end(),
+            [minSliceSamples](const Slice& slice) {
+                return slice.endSample - slice.startSample < minSliceSamples;
+            }), scannedSlices.end());
+
+        scanReady.store(request, std::memory_order_release);
+        return true;
     }
 
     json_t* dataToJson() override {
@@ -1577,6 +1897,9 @@ struct WeiiiDocumenta : Module {
         json_object_set_new(rootJ, "morphTargetShRate", json_boolean(morphTargetShRate));
         json_object_set_new(rootJ, "morphTargetSpeed", json_boolean(morphTargetSpeed));
 
+        json_object_set_new(rootJ, "maxRecordMinutes", json_integer(maxRecordMinutes));
+        json_object_set_new(rootJ, "interpolationMode", json_integer(interpolationMode));
+
         // 保存 buffer 資料與 slices
         if (layer.recordedLength > 0) {
             // Save recorded length
@@ -1590,23 +1913,35 @@ struct WeiiiDocumenta : Module {
             json_object_set_new(rootJ, "isRecording", json_boolean(isRecording));
             json_object_set_new(rootJ, "recordPosition", json_integer(recordPosition));
 
-            // Save buffer data using base64 encoding
-            // Convert float arrays to bytes for efficient storage
-            size_t bufferBytes = layer.recordedLength * sizeof(float);
-
-            // Left channel
-            std::string base64L = rack::string::toBase64(
-                (const uint8_t*)layer.bufferL.data(),
-                bufferBytes
-            );
-            json_object_set_new(rootJ, "bufferL", json_string(base64L.c_str()));
-
-            // Right channel
-            std::string base64R = rack::string::toBase64(
-                (const uint8_t*)layer.bufferR.data(),
-                bufferBytes
-            );
-            json_object_set_new(rootJ, "bufferR", json_string(base64R.c_str()));
+            int savedLength = layer.recordedLength;
+            bool useSidecar = savedLength > INLINE_MAX_FRAMES && sidecarSavedLength == savedLength;
+            sidecarSavedLength = -1;
+            if (useSidecar) {
+                // 長錄音已由這次存檔的 onSave() 寫入 patch storage，這裡只記檔名
+                json_object_set_new(rootJ, "bufferFile", json_string(SIDECAR_FILE));
+            } else {
+                // Save buffer data using base64 encoding
+                // Convert float arrays to bytes for efficient storage
+                size_t bufferBytes = savedLength * sizeof(float);
+                std::vector<float> channelData(savedLength);
+                std::lock_guard<std::mutex> lock(layer.storageMutex);
+
+                // Left channel
+                layer.readRange(0, 0, savedLength, channelData.data());
+                std::string base64L = rack::string::toBase64(
+                    (const uint8_t*)channelData.data(),
+                    bufferBytes
+                );
+                json_object_set_new(rootJ, "bufferL", json_string(base64L.c_str()));
+
+                // Right channel
+                layer.readRange(1, 0, savedLength, channelData.data());
+                std::string base64R = rack::string::toBase64(
+                    (const uint8_t*)channelData.data(),
+                    bufferBytes
+                );
+                json_object_set_new(rootJ, "bufferR", json_string(base64R.c_str()));
+            }
 
             // Save slices
             json_t* slicesJ = json_array();
@@ -1673,12 +2008,20 @@ struct WeiiiDocumenta : Module {
         json_t* morphTargetSpeedJ = json_object_get(rootJ, "morphTargetSpeed");
         if (morphTargetSpeedJ) morphTargetSpeed = json_boolean_value(morphTargetSpeedJ);
 
-        // 載入 buffer 資料
+        json_t* maxRecordMinutesJ = json_object_get(rootJ, "maxRecordMinutes");
+        if (maxRecordMinutesJ) maxRecordMinutes = clamp((int)json_integer_value(maxRecordMinutesJ), 1, 60);
+
+        json_t* interpolationModeJ = json_object_get(rootJ, "interpolationMode");
+        if (interpolationModeJ) interpolationMode = clamp((int)json_integer_value(interpolationModeJ), 0, RESAMPLE_MODES_LEN - 1);
+
+        // 載入 buffer 資料（先讓進行中的錄音搬完）
+        haltRecording(false);
+        sidecarFrames = 0;
         json_t* recordedLengthJ = json_object_get(rootJ, "recordedLength");
         if (recordedLengthJ) {
             int savedLength = json_integer_value(recordedLengthJ);
 
-            if (savedLength > 0 && savedLength <= (int)layer.bufferL.size()) {
+            if (savedLength > 0 && layer.reserve(savedLength)) {
                 layer.recordedLength = savedLength;
 
                 // Restore playback state
@@ -1701,10 +2044,14 @@ struct WeiiiDocumenta : Module {
                 if (recordPosJ) recordPosition = json_integer_value(recordPosJ);
 
                 // Restore buffer data from base64
+                json_t* bufferFileJ = json_object_get(rootJ, "bufferFile");
                 json_t* bufferLJ = json_object_get(rootJ, "bufferL");
                 json_t* bufferRJ = json_object_get(rootJ, "bufferR");
 
-                if (bufferLJ && bufferRJ) {
+                if (bufferFileJ) {
+                    // 長錄音存在 patch storage；載入 patch 時要等 onAdd() 才能讀取
+                    sidecarFrames = savedLength;
+                } else if (bufferLJ && bufferRJ) {
                     const char* base64L = json_string_value(bufferLJ);
                     const char* base64R = json_string_value(bufferRJ);
 
@@ -1715,11 +2062,19 @@ struct WeiiiDocumenta : Module {
 
                     if (bytesL.size() == expectedBytes && bytesR.size() == expectedBytes) {
                         // Copy decoded bytes back to float arrays
-                        std::memcpy(layer.bufferL.data(), bytesL.data(), expectedBytes);
-                        std::memcpy(layer.bufferR.data(), bytesR.data(), expectedBytes);
+                        std::lock_guard<std::mutex> lock(layer.storageMutex);
+                        layer.writeRange(0, 0, savedLength, (const float*)bytesL.data());
+                        layer.writeRange(1, 0, savedLength, (const float*)bytesR.data());
+                        layer.updatePeaks(0, savedLength);
                     }
                 }
 
+                // 存檔時仍在錄音：從已存的位置接續錄下去（sidecar 載入後才開始）
+                if (isRecording) {
+                    recordPosition = std::min(recordPosition, savedLength);
+                    if (sidecarFrames == 0) recorder.begin(0, recordPosition);
+                }
+
                 // Restore slices
                 json_t* slicesJ = json_object_get(rootJ, "slices");
                 if (slicesJ && json_is_array(slicesJ)) {
@@ -1747,6 +2102,166 @@ struct WeiiiDocumenta : Module {
                 }
             }
         }
+
+        // 已在引擎中的模組（復原 / 重做等）不會再收到 onAdd()，直接讀取
+        if (sidecarFrames > 0 && addedToEngine) {
+            restoreSidecar();
+        }
+    }
+
+    void onSave(const SaveEvent& e) override {
+        sidecarSavedLength = -1;
+        if (layer.recordedLength > INLINE_MAX_FRAMES) {
+            if (writeSidecar(system::join(createPatchStorageDirectory(), SIDECAR_FILE))) {
+                sidecarSavedLength = layer.recordedLength;
+            }
+        } else {
+            // 錄音已清除或變短：移除舊的 sidecar
+            system::remove(system::join(getPatchStorageDirectory(), SIDECAR_FILE));
+        }
+    }
+
+    void onAdd(const AddEvent& e) override {
+        addedToEngine = true;
+        if (sidecarFrames > 0) {
+            restoreSidecar();
+        }
+    }
+
+    void onRemove(const RemoveEvent& e) override {
+        addedToEngine = false;
+    }
+
+    /**
+     * 讀回 dataFromJson 記下的 sidecar；檔案遺失或較短時只保留實際讀到的長度，
+     * 不把補零的區塊當成錄音
+     */
+    void restoreSidecar() {
+        int expected = sidecarFrames;
+        sidecarFrames = 0;
+        int frames = readSidecar(system::join(getPatchStorageDirectory(), SIDECAR_FILE), expected);
+        if (frames < expected) {
+            WARN("weiiidocumenta: Recording restored %d of %d frames", frames, expected);
+        }
+        layer.recordedLength = frames;
+        recordPosition = std::min(recordPosition, frames);
+        layer.playbackPosition = std::min(layer.playbackPosition, std::max(frames - 1, 0));
+        slices.erase(std::remove_if(slices.begin(), slices.end(),
+                                    [=](const Slice& s) { return s.startSample >= frames; }),
+                     slices.end());
+        for (Slice& s : slices) {
+            s.endSample = std::min(s.endSample, frames);
+        }
+        if (frames == 0) {
+            isPlaying = false;
+            isLooping = false;
+            isRecording = false;
+            layer.clear();
+            layer.releaseStorage();
+            return;
+        }
+        if (isRecording) {
+            recorder.begin(0, recordPosition);
+        }
+    }
+
+    // patch storage 的 sidecar：32-bit float 立體聲 WAV，保留原始電壓值不量化
+    bool writeSidecar(const std::string& path) {
+        FILE* file = std::fopen(path.c_str(), "wb");
+        if (!file) {
+            WARN("weiiidocumenta: Could not write %s", path.c_str());
+            return false;
+        }
+
+        int frames = layer.recordedLength;
+        uint32_t sampleRate = (uint32_t)APP->engine->getSampleRate();
+        uint16_t audioFormat = 3;  // IEEE float
+        uint16_t numChannels = 2;
+        uint16_t bitsPerSample = 32;
+        uint32_t byteRate = sampleRate * numChannels * bitsPerSample / 8;
+        uint16_t blockAlign = numChannels * bitsPerSample / 8;
+        uint32_t dataSize = (uint32_t)frames * blockAlign;
+        uint32_t fileSize = 36 + dataSize;
+        uint32_t fmtSize = 16;
+
+        std::fwrite("RIFF", 1, 4, file);
+        std::fwrite(&fileSize, 4, 1, file);
+        std::fwrite("WAVE", 1, 4, file);
+        std::fwrite("fmt ", 1, 4, file);
+        std::fwrite(&fmtSize, 4, 1, file);
+        std::fwrite(&audioFormat, 2, 1, file);
+        std::fwrite(&numChannels, 2, 1, file);
+        std::fwrite(&sampleRate, 4, 1, file);
+        std::fwrite(&byteRate, 4, 1, file);
+        std::fwrite(&blockAlign, 2, 1, file);
+        std::fwrite(&bitsPerSample, 2, 1, file);
+        std::fwrite("data", 1, 4, file);
+        std::fwrite(&dataSize, 4, 1, file);
+
+        // 逐區塊交錯寫出，不需要一次複製整段錄音
+        const int BLOCK = 65536;
+        std::vector<float> left(BLOCK), right(BLOCK), interleaved(BLOCK * 2);
+        std::lock_guard<std::mutex> lock(layer.storageMutex);
+        for (int from = 0; from < frames; from += BLOCK) {
+            int n = std::min(BLOCK, frames - from);
+            layer.readRange(0, from, n, left.data());
+            layer.readRange(1, from, n, right.data());
+            for (int i = 0; i < n; i++) {
+                interleaved[i * 2] = left[i];
+                interleaved[i * 2 + 1] = right[i];
+            }
+            if (std::fwrite(interleaved.data(), sizeof(float), n * 2, file) != (size_t)(n * 2)) {
+                std::fclose(file);
+                WARN("weiiidocumenta: Could not write %s", path.c_str());
+                return false;
+            }
+        }
+        return std::fclose(file) == 0;
+    }
+
+    // 讀回 writeSidecar() 寫出的檔案（layer 已在 dataFromJson reserve），回傳實際讀到的樣本框數
+    int readSidecar(const std::string& path, int frames) {
+        FILE* file = std::fopen(path.c_str(), "rb");
+        if (!file) {
+            WARN("weiiidocumenta: Missing recording %s", path.c_str());
+            return 0;
+        }
+
+        char header[44];
+        uint16_t audioFormat = 0;
+        uint16_t numChannels = 0;
+        uint32_t dataSize = 0;
+        if (std::fread(header, 1, 44, file) == 44) {
+            std::memcpy(&audioFormat, header + 20, 2);
+            std::memcpy(&numChannels, header + 22, 2);
+            std::memcpy(&dataSize, header + 40, 4);
+        }
+        if (std::memcmp(header, "RIFF", 4) != 0 || audioFormat != 3 || numChannels != 2) {
+            std::fclose(file);
+            WARN("weiiidocumenta: Invalid recording %s", path.c_str());
+            return 0;
+        }
+        frames = std::min(frames, (int)(dataSize / (2 * sizeof(float))));
+
+        const int BLOCK = 65536;
+        std::vector<float> left(BLOCK), right(BLOCK), interleaved(BLOCK * 2);
+        std::lock_guard<std::mutex> lock(layer.storageMutex);
+        int read = 0;
+        while (read < frames) {
+            int n = std::min(BLOCK, frames - read);
+            n = (int)(std::fread(interleaved.data(), sizeof(float) * 2, n, file));
+            if (n <= 0) break;
+            for (int i = 0; i < n; i++) {
+                left[i] = interleaved[i * 2];
+                right[i] = interleaved[i * 2 + 1];
+            }
+            layer.writeRange(0, read, n, left.data());
+            layer.writeRange(1, read, n, right.data());
+            read += n;
+        }
+        layer.updatePeaks(0, read);
+        std::fclose(file);
+        return read;
     }
 
     // 儲存 WAV 檔案 (使用 VCV Rack 內建的 system API)
@@ -1767,7 +2282,7 @@ struct WeiiiDocumenta : Module {
         }
 
         // WAV file header (44 bytes for PCM)
-        uint32_t sampleRate = 48000;
+        uint32_t sampleRate = (uint32_t)APP->engine->getSampleRate();
         uint16_t numChannels = 2;
         uint16_t bitsPerSample = 16;
         uint32_t byteRate = sampleRate * numChannels * bitsPerSample / 8;
@@ -1797,9 +2312,10 @@ struct WeiiiDocumenta : Module {
         std::fwrite(&dataSize, 4, 1, file);
 
         // Write audio data (interleaved stereo, 16-bit PCM)
+        std::lock_guard<std::mutex> lock(layer.storageMutex);
         for (int i = 0; i < maxLength; i++) {
-            float mixL = layer.bufferL[i];
-            float mixR = layer.bufferR[i];
+            float mixL = layer.peekSample(0, i);
+            float mixR = layer.peekSample(1, i);
 
             // Clamp and convert to 16-bit PCM (從 ±10V 縮放到 ±1.0)
             int16_t sampleL = (int16_t)clamp((mixL / 10.0f) * 32767.0f, -32768.0f, 32767.0f);
@@ -1875,16 +2391,24 @@ struct WeiiiDocumenta : Module {
 
         std::fseek(file, dataPos, SEEK_SET);
 
-        // 清除當前錄音層
+        // 與 dataFromJson 相同：先停止錄音並等背景端搬完，再清除當前錄音層
+        haltRecording(true);
         layer.clear();
 
         int bytesPerSample = bitsPerSample / 8;
         int numFrames = dataSize / (numChannels * bytesPerSample);
-        int framesToCopy = std::min(numFrames, (int)layer.bufferL.size());
+        int framesToCopy = std::min(numFrames, maxRecordFrames(APP->engine->getSampleRate()));
 
         INFO("WAV info: bits=%d bytes=%d frames=%d toCopy=%d channels=%d",
              bitsPerSample, bytesPerSample, numFrames, framesToCopy, numChannels);
 
+        std::lock_guard<std::mutex> lock(layer.storageMutex);
+        if (!layer.reserve(framesToCopy)) {
+            std::fclose(file);
+            WARN("WAV file too long: %s", path.c_str());
+            return;
+        }
+
         for (int i = 0; i < framesToCopy; i++) {
             float sampleL = 0.0f;
             float sampleR = 0.0f;
@@ -1919,15 +2443,14 @@ struct WeiiiDocumenta : Module {
                     sampleR = sampleL;
                 }
             } else {
-                // Skip unsupported formats
+                // Skip unsupported formats (寫入靜音)
                 std::fseek(file, numChannels * bytesPerSample, SEEK_CUR);
-                continue;
             }
 
-            layer.bufferL[i] = sampleL;
-            layer.bufferR[i] = sampleR;
+            layer.write(i, sampleL, sampleR);
         }
 
+        layer.updatePeaks(0, framesToCopy);
         layer.recordedLength = framesToCopy;
         layer.playbackPosition = 0;
         layer.active = true;  // 確保 layer 啟用
@@ -1944,7 +2467,7 @@ struct WeiiiDocumenta : Module {
 
         // 掃描找出峰值振幅
         for (int i = 0; i < framesToCopy; i++) {
-            float amp = std::max(std::abs(layer.bufferL[i]), std::abs(layer.bufferR[i]));
+            float amp = std::max(std::abs(layer.sample(0, i)), std::abs(layer.sample(1, i)));
             if (amp > slices[0].peakAmplitude) {
                 slices[0].peakAmplitude = amp;
             }
@@ -1969,8 +2492,8 @@ struct WeiiiDocumenta : Module {
         INFO("Layer state: active=%d, recordedLength=%d",
              layer.active, layer.recordedLength);
 
-        // Rescan slices with current threshold to apply slice detection immediately
-        rescanSlices();
+        // 讓音訊執行緒在下一個 block 以目前 threshold 送出重新掃描要求
+        lastThreshold = -1.0f;
     }
 };
 
@@ -1994,6 +2517,56 @@ struct WaveformDisplay : TransparentWidget {
         nvgRGB(200, 200, 200)   // 白色
     };
 
+    /**
+     * 以 min/max 帶狀繪製單一聲道，centerY 為零點，height 為 10V 對應的高度
+     */
+    void drawChannelBand(const DrawArgs& args, const AudioLayer& layer, int channel,
+                         int recordedLen, float centerY, float height) {
+        const int PEAK_BLOCK = AudioLayer::PEAK_BLOCK;
+        int width = std::max(1, (int)box.size.x);
+        recordedLen = std::min(recordedLen, layer.capacity());
+
+        std::vector<float> bandMin(width), bandMax(width);
+        int points = 0;
+        for (int i = 0; i < width; i++) {
+            int begin = (int)((int64_t)i * recordedLen / width);
+            int end = std::max(begin + 1, (int)((int64_t)(i + 1) * recordedLen / width));
+            if (begin >= recordedLen) break;
+            end = std::min(end, recordedLen);
+
+            float lo, hi;
+            if (end - begin >= PEAK_BLOCK) {
+                layer.peakRange(channel, begin / PEAK_BLOCK, (end - 1) / PEAK_BLOCK, lo, hi);
+            } else {
+                lo = hi = layer.peekSample(channel, begin);
+                for (int s = begin + 1; s < end; s++) {
+                    float v = layer.peekSample(channel, s);
+                    lo = std::min(lo, v);
+                    hi = std::max(hi, v);
+                }
+            }
+            bandMin[i] = centerY - (lo / 10.0f) * height * 0.8f;
+            bandMax[i] = centerY - (hi / 10.0f) * height * 0.8f;
+            points++;
+        }
+        if (points == 0) return;
+
+        nvgBeginPath(args.vg);
+        for (int i = 0; i < points; i++) {
+            if (i == 0) nvgMoveTo(args.vg, i, bandMax[i]);
+            else nvgLineTo(args.vg, i, bandMax[i]);
+        }
+        for (int i = points - 1; i >= 0; i--) {
+            nvgLineTo(args.vg, i, bandMin[i]);
+        }
+        nvgClosePath(args.vg);
+        nvgFillColor(args.vg, nvgRGBA(255, 100, 100, 90));
+        nvgFill(args.vg);
+        nvgStrokeColor(args.vg, nvgRGBA(255, 100, 100, 255));
+        nvgStrokeWidth(args.vg, 1.0f);
+        nvgStroke(args.vg);
+    }
+
     void drawLayer(const DrawArgs& args, int layer) override {
         if (layer != 1) return;
         if (!module) return;
@@ -2018,40 +2591,11 @@ struct WaveformDisplay : TransparentWidget {
         // 繪製波形
         if (module->layer.recordedLength > 0) {
             int recordedLen = module->layer.recordedLength;
+            std::lock_guard<std::mutex> lock(module->layer.storageMutex);
 
-            // 繪製 L 聲道 上半部
-            nvgBeginPath(args.vg);
-            nvgStrokeColor(args.vg, nvgRGBA(255, 100, 100, 255));
-            nvgStrokeWidth(args.vg, 1.0f);
-
-            for (int i = 0; i < box.size.x; i++) {
-                int idx = (i * recordedLen) / (int)box.size.x;
-                if (idx >= recordedLen) break;
-
-                float sample = module->layer.bufferL[idx];
-                float y = quarterHeight - (sample / 10.0f) * quarterHeight * 0.8f;
-
-                if (i == 0) nvgMoveTo(args.vg, i, y);
-                else nvgLineTo(args.vg, i, y);
-            }
-            nvgStroke(args.vg);
-
-            // 繪製 R 聲道 下半部
-            nvgBeginPath(args.vg);
-            nvgStrokeColor(args.vg, nvgRGBA(255, 100, 100, 255));
-            nvgStrokeWidth(args.vg, 1.0f);
-
-            for (int i = 0; i < box.size.x; i++) {
-                int idx = (i * recordedLen) / (int)box.size.x;
-                if (idx >= recordedLen) break;
-
-                float sample = module->layer.bufferR[idx];
-                float y = halfHeight + quarterHeight - (sample / 10.0f) * quarterHeight * 0.8f;
-
-                if (i == 0) nvgMoveTo(args.vg, i, y);
-                else nvgLineTo(args.vg, i, y);
-            }
-            nvgStroke(args.vg);
+            // 每個像素取該範圍的 min/max（樣本夠多時直接查峰值索引）
+            drawChannelBand(args, module->layer, 0, recordedLen, quarterHeight, quarterHeight);
+            drawChannelBand(args, module->layer, 1, recordedLen, halfHeight + quarterHeight, quarterHeight);
         }
 
         // 繪製切片分界線
@@ -2119,7 +2663,7 @@ struct WaveformDisplay : TransparentWidget {
 
         // 繪製錄音掃描線
         if (module->isRecording) {
-            int bufferSize = module->layer.bufferL.size();
+            int bufferSize = module->maxRecordFrames(APP->engine->getSampleRate());
             float x = (float)module->recordPosition / bufferSize * box.size.x;
 
             nvgBeginPath(args.vg);
@@ -2275,6 +2819,7 @@ struct WeiiiDocumentaWidget : ModuleWidget {
     madzine::widgets::BaseCustomKnob* polyKnob = nullptr;
     madzine::widgets::BaseCustomKnob* shAmountKnob = nullptr;
     madzine::widgets::BaseCustomKnob* shRateKnob = nullptr;
+    madzine::widgets::CVModRingSync<WeiiiDocumenta::NUM_CVMODS> cvModSync;
 
     WeiiiDocumentaWidget(WeiiiDocumenta* module) {
         setModule(module);
@@ -2431,6 +2976,14 @@ struct WeiiiDocumentaWidget : ModuleWidget {
         polyKnob = createParamCentered<MediumGrayKnob>(Vec(120, 354), module, WeiiiDocumenta::POLY_PARAM);
         addParam(polyKnob);
 
+        cvModSync.bind(WeiiiDocumenta::CVMOD_THRESHOLD, thresholdKnob);
+        cvModSync.bind(WeiiiDocumenta::CVMOD_SCAN, scanKnob);
+        cvModSync.bind(WeiiiDocumenta::CVMOD_FEEDBACK, feedbackKnob);
+        cvModSync.bind(WeiiiDocumenta::CVMOD_SPEED, speedKnob);
+        cvModSync.bind(WeiiiDocumenta::CVMOD_POLY, polyKnob);
+        cvModSync.bind(WeiiiDocumenta::CVMOD_SH_AMOUNT, shAmountKnob);
+        cvModSync.bind(WeiiiDocumenta::CVMOD_SH_RATE, shRateKnob);
+
         // CV inputs 垂直排列在兩旋鈕中間 (X=88), Y對齊 I/L O/L (343) 和 I/R O/R (368)
         addInput(createInputCentered<PJ301MPort>(Vec(88, 343), module, WeiiiDocumenta::SPEED_CV_INPUT));
         addInput(createInputCentered<PJ301MPort>(Vec(88, 368), module, WeiiiDocumenta::POLY_CV_INPUT));
@@ -2449,22 +3002,8 @@ struct WeiiiDocumentaWidget : ModuleWidget {
         if (module) {
             panelThemeHelper.step(module);
 
-            // CV display updates
-            auto updateKnob = [&](madzine::widgets::BaseCustomKnob* knob, int inputId, float cvMod) {
-                if (knob) {
-                    bool connected = module->inputs[inputId].isConnected();
-                    knob->setModulationEnabled(connected);
-                    if (connected) knob->setModulation(cvMod);
-                }
-            };
-
-            updateKnob(thresholdKnob, WeiiiDocumenta::THRESHOLD_CV_INPUT, module->thresholdCvMod);
-            updateKnob(scanKnob, WeiiiDocumenta::SCAN_CV_INPUT, module->scanCvMod);
-            updateKnob(feedbackKnob, WeiiiDocumenta::FEEDBACK_AMOUNT_CV_INPUT, module->feedbackCvMod);
-            updateKnob(speedKnob, WeiiiDocumenta::SPEED_CV_INPUT, module->speedCvMod);
-            updateKnob(polyKnob, WeiiiDocumenta::POLY_CV_INPUT, module->polyCvMod);
-            updateKnob(shAmountKnob, WeiiiDocumenta::SH_AMOUNT_CV_INPUT, module->shAmountCvMod);
-            updateKnob(shRateKnob, WeiiiDocumenta::SH_RATE_CV_INPUT, module->shRateCvMod);
+            // CV modulation ring display (only touches knobs whose value changed)
+            cvModSync.sync(module->cvMods);
         }
         ModuleWidget::step();
     }
@@ -2502,6 +3041,29 @@ struct WeiiiDocumentaWidget : ModuleWidget {
             }
         }));
 
+        menu->addChild(createSubmenuItem("Max Recording Length", string::f("%d min", module->maxRecordMinutes),
+            [=](Menu* menu) {
+                static const int minutes[] = {1, 5, 10, 30, 60};
+                for (int m : minutes) {
+                    menu->addChild(createCheckMenuItem(string::f("%d min", m), "",
+                        [=]() { return module->maxRecordMinutes == m; },
+                        [=]() { module->maxRecordMinutes = m; }
+                    ));
+                }
+            }
+        ));
+
+        menu->addChild(createSubmenuItem("Interpolation", resampleModeName(module->interpolationMode),
+            [=](Menu* menu) {
+                for (int m = 0; m < RESAMPLE_MODES_LEN; m++) {
+                    menu->addChild(createCheckMenuItem(resampleModeName(m), "",
+                        [=]() { return module->interpolationMode == m; },
+                        [=]() { module->interpolationMode = m; }
+                    ));
+                }
+            }
+        ));
+
         menu->addChild(new MenuSeparator);
         menu->addChild(createMenuLabel("Morph Time"));
 
@@ -0,0 +1,95 @@
+#pragma once
+#include <rack.hpp>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include "KnobBase.hpp"
+
+using namespace rack;
+
+namespace madzine {
+namespace widgets {
+
+// 調變量變化小於此值時視為畫面上無差異（約 0.07° 旋鈕角度）
+constexpr float CV_MOD_VISUAL_EPSILON = 1.0f / 4096.0f;
+
+/**
+ * CV 調變顯示資料（模組端）
+ * 模組在 process() 中發佈各旋鈕的正規化調變量，只有在數值變化超過
+ * 視覺門檻或連接狀態改變時才遞增版本號，讓 Widget 可以跳過未變化的幀。
+ */
+template <int N>
+struct CVModBank {
+    float values[N] = {};
+    bool connected[N] = {};
+    std::atomic<uint32_t> version{0};
+
+    /**
+     * 發佈調變量（音訊執行緒呼叫）
+     * @param index 旋鈕索引
+     * @param normalizedMod 正規化調變量 -1.0 ~ +1.0
+     */
+    void publish(int index, float normalizedMod) {
+        if (connected[index] && std::fabs(normalizedMod - values[index]) < CV_MOD_VISUAL_EPSILON) return;
+        values[index] = normalizedMod;
+        connected[index] = true;
+        version.fetch_add(1, std::memory_order_release);
+    }
+
+    /**
+     * CV 未連接時清除調變量
+     */
+    void clear(int index) {
+        if (!connected[index] && values[index] == 0.0f) return;
+        values[index] = 0.0f;
+        connected[index] = false;
+        version.fetch_add(1, std::memory_order_release);
+    }
+};
+
+/**
+ * CV 調變顯示同步器（Widget 端）
+ * 綁定旋鈕後於 step() 呼叫 sync()，版本號未變時直接返回，
+ * 否則只更新實際改變的旋鈕。
+ */
+template <int N>
+struct CVModRingSync {
+    BaseCustomKnob* knobs[N] = {};
+    float shownValues[N] = {};
+    bool shownConnected[N] = {};
+    uint32_t lastVersion = 0;
+    bool primed = false;
+
+    void bind(int index, BaseCustomKnob* knob) {
+        knobs[index] = knob;
+        primed = false;
+    }
+
+    void sync(const CVModBank<N>& bank) {
+        uint32_t v = bank.version.load(std::memory_order_acquire);
+        if (primed && v == lastVersion) return;
+        lastVersion = v;
+
+        for (int i = 0; i < N; i++) {
+            BaseCustomKnob* knob = knobs[i];
+            if (!knob) continue;
+
+            bool conn = bank.connected[i];
+            if (!primed || conn != shownConnected[i]) {
+                knob->setModulationEnabled(conn);
+                shownConnected[i] = conn;
+            }
+            if (!conn) continue;
+
+            float value = bank.values[i];
+            if (!primed || std::fabs(value - shownValues[i]) >= CV_MOD_VISUAL_EPSILON) {
+                knob->setModulation(value);
+                shownValues[i] = value;
+            }
+        }
+        primed = true;
+    }
+};
+
+} // namespace widgets
+} // namespace madzine
@@ -0,0 +1,329 @@
+#pragma once
+#include <rack.hpp>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+using namespace rack;
+
+namespace madzine {
+namespace widgets {
+
+constexpr int SCOPE_MAX_CHANNELS = 16;
+constexpr int SCOPE_GROUPS = SCOPE_MAX_CHANNELS / 4;
+
+/**
+ * 一幀示波器資料：每個軌道、每一欄、每個聲部的 min/max
+ * 欄位以 [column][channel] 排列，音訊端可以直接整組 float_4 寫入
+ */
+template <int TRACKS, int COLUMNS>
+struct ScopeFrame {
+    alignas(16) float minValues[TRACKS][COLUMNS][SCOPE_MAX_CHANNELS];
+    alignas(16) float maxValues[TRACKS][COLUMNS][SCOPE_MAX_CHANNELS];
+    int channels[TRACKS] = {};
+    int headColumn = 0;     // 捲動模式下最舊一欄的位置
+    uint32_t sequence = 0;  // 每次發佈遞增，Widget 用來判斷是否需要重畫
+
+    ScopeFrame() {
+        std::fill(&minValues[0][0][0], &minValues[0][0][0] + TRACKS * COLUMNS * SCOPE_MAX_CHANNELS, 0.f);
+        std::fill(&maxValues[0][0][0], &maxValues[0][0][0] + TRACKS * COLUMNS * SCOPE_MAX_CHANNELS, 0.f);
+    }
+};
+
+/**
+ * 示波器擷取引擎（模組端寫入、Widget 端讀取）
+ *
+ * 音訊執行緒以 float_4 累積每一欄所有聲部的 min/max，欄完成時整組寫入。
+ * 完成的幀透過三重緩衝發佈：音訊端與 UI 端各持有一個緩衝，中間的緩衝以
+ * atomic exchange 交換，兩邊都不會等待，也不會讀到寫到一半的資料。
+ * 音訊端直接寫入自己持有的緩衝，發佈時只交換索引；換到的緩衝只補上它上次
+ * 發佈後才寫入的欄（以每欄的發佈序號判斷），不複製整幀。
+ * 長時間設定下，錄製中的幀約每 1/60 秒發佈一次，畫面不會停在舊幀。
+ */
+template <int TRACKS, int COLUMNS = 256>
+struct ScopeCapture {
+    using Frame = ScopeFrame<TRACKS, COLUMNS>;
+
+    static constexpr int FRESH_BIT = 4;
+    static constexpr int INDEX_MASK = 3;
+
+    // 捲動模式：不等觸發，持續覆寫最舊的一欄（QQ 用）
+    bool rolling = false;
+
+    Frame frames[3];
+
+    // 音訊執行緒
+    int writeIndex = 0;
+    int column = COLUMNS;  // == COLUMNS 表示等待觸發
+    int frameIndex = 0;
+    int samplesSincePublish = 0;
+    uint32_t sequence = 0;
+    simd::float_4 currentMin[TRACKS][SCOPE_GROUPS];
+    simd::float_4 currentMax[TRACKS][SCOPE_GROUPS];
+    int currentChannels[TRACKS] = {};
+    uint32_t columnSequence[COLUMNS] = {};  // 每欄最後一次寫入由哪次發佈帶出
+    uint32_t frameSequence[3] = {};         // 每個緩衝已包含到哪次發佈的內容
+
+    // 兩執行緒共用
+    std::atomic<int> middleIndex{1};
+
+    // UI 執行緒
+    int readIndex = 2;
+
+    ScopeCapture() {
+        resetColumn();
+    }
+
+    bool isRecording() const {
+        return rolling || column < COLUMNS;
+    }
+
+    /**
+     * 開始錄製新的一幀（觸發時呼叫）
+     */
+    void start() {
+        column = 0;
+        frameIndex = 0;
+        resetColumn();
+    }
+
+    /**
+     * 加入一個埠（Input 或 Output）所有聲部的目前電壓
+     */
+    template <typename TPort>
+    void addPort(int track, TPort& port) {
+        int channels = port.getChannels();
+        for (int c = 0; c < channels; c += 4) {
+            simd::float_4 v = port.template getVoltageSimd<simd::float_4>(c);
+            currentMin[track][c / 4] = simd::fmin(currentMin[track][c / 4], v);
+            currentMax[track][c / 4] = simd::fmax(currentMax[track][c / 4], v);
+        }
+        currentChannels[track] = std::max(currentChannels[track], channels);
+    }
+
+    /**
+     * 加入單聲部的計算值（例如模組內部訊號）
+     */
+    void addValue(int track, float value) {
+        currentMin[track][0] = simd::fmin(currentMin[track][0], simd::float_4(value));
+        currentMax[track][0] = simd::fmax(currentMax[track][0], simd::float_4(value));
+        currentChannels[track] = std::max(currentChannels[track], 1);
+    }
+
+    /**
+     * 每個樣本呼叫一次（在 addPort / addValue 之後）
+     * @param samplesPerColumn 每一欄涵蓋的樣本數
+     * @param sampleRate 取樣率，用來控制錄製中的發佈頻率
+     */
+    void step(int samplesPerColumn, float sampleRate) {
+        if (!isRecording()) return;
+
+        bool frameDone = false;
+        if (++frameIndex >= samplesPerColumn) {
+            frameIndex = 0;
+            commitColumn();
+            if (rolling) {
+                column = (column + 1) % COLUMNS;
+            } else if (++column >= COLUMNS) {
+                frameDone = true;
+            }
+        }
+
+        if (frameDone || ++samplesSincePublish >= (int)(sampleRate / 60.f)) {
+            publish();
+        }
+    }
+
+    /**
+     * UI 執行緒：若有新幀則換入，回傳是否換到新幀
+     */
+    bool poll() {
+        if (!(middleIndex.load(std::memory_order_acquire) & FRESH_BIT)) return false;
+        readIndex = middleIndex.exchange(readIndex, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+
+    /**
+     * UI 執行緒：目前持有的幀
+     */
+    const Frame& frame() const {
+        return frames[readIndex];
+    }
+
+private:
+    void resetColumn() {
+        for (int t = 0; t < TRACKS; t++) {
+            for (int g = 0; g < SCOPE_GROUPS; g++) {
+                currentMin[t][g] = INFINITY;
+                currentMax[t][g] = -INFINITY;
+            }
+            currentChannels[t] = 0;
+        }
+    }
+
+    void commitColumn() {
+        int col = (rolling ? column % COLUMNS : std::min(column, COLUMNS - 1));
+        Frame& f = frames[writeIndex];
+        for (int t = 0; t < TRACKS; t++) {
+            int groups = (currentChannels[t] + 3) / 4;
+            for (int g = 0; g < groups; g++) {
+                currentMin[t][g].store(&f.minValues[t][col][g * 4]);
+                currentMax[t][g].store(&f.maxValues[t][col][g * 4]);
+            }
+            f.channels[t] = currentChannels[t];
+        }
+        columnSequence[col] = sequence + 1;
+        resetColumn();
+    }
+
+    void publish() {
+        samplesSincePublish = 0;
+
+        Frame& f = frames[writeIndex];
+        f.headColumn = rolling ? (column % COLUMNS) : 0;
+        f.sequence = ++sequence;
+        frameSequence[writeIndex] = sequence;
+
+        int published = writeIndex;
+        writeIndex = middleIndex.exchange(writeIndex | FRESH_BIT, std::memory_order_acq_rel) & INDEX_MASK;
+
+        // 新的寫入緩衝只補上它上次發佈之後才寫入的欄（最多約兩次發佈間隔），
+        // 錄製中的幀才會保留尚未覆寫的欄
+        const Frame& src = frames[published];
+        Frame& dst = frames[writeIndex];
+        uint32_t since = frameSequence[writeIndex];
+        for (int t = 0; t < TRACKS; t++) {
+            dst.channels[t] = src.channels[t];
+        }
+        for (int col = 0; col < COLUMNS; col++) {
+            if ((int32_t)(columnSequence[col] - since) <= 0) continue;
+            for (int t = 0; t < TRACKS; t++) {
+                int n = ((src.channels[t] + 3) / 4) * 4;
+                if (n == 0) continue;
+                std::memcpy(dst.minValues[t][col], src.minValues[t][col], n * sizeof(float));
+                std::memcpy(dst.maxValues[t][col], src.maxValues[t][col], n * sizeof(float));
+            }
+        }
+    }
+};
+
+/**
+ * 繪製一個軌道所有聲部的 min/max 包絡
+ * y = center - value * gain（0 = 上緣，1 = 下緣，超出範圍者夾住）
+ * 路徑先抽取到實際像素寬度：同一像素內的欄合併 min/max，點數不超過像素數。
+ */
+template <int TRACKS, int COLUMNS>
+void drawScopeEnvelope(NVGcontext* vg, const ScopeFrame<TRACKS, COLUMNS>& frame, int track,
+                       math::Rect b, NVGcolor color, float center, float gain, float strokeWidth = 1.5f) {
+    int channels = frame.channels[track];
+    if (channels <= 0) return;
+
+    // 目前變換的縮放（含 framebuffer 的縮放與過取樣）決定像素數
+    float xform[6];
+    nvgCurrentTransform(vg, xform);
+    float scale = std::hypot(xform[0], xform[1]);
+    int points = clamp((int)std::ceil(b.size.x * scale), 2, COLUMNS);
+
+    auto toY = [&](float v) {
+        if (!std::isfinite(v)) v = 0.f;
+        return b.pos.y + b.size.y * clamp(center - v * gain, 0.f, 1.f);
+    };
+
+    float pointMin[COLUMNS];
+    float pointMax[COLUMNS];
+
+    for (int c = 0; c < channels; c++) {
+        for (int p = 0; p < points; p++) {
+            int begin = p * COLUMNS / points;
+            int end = std::max(begin + 1, (p + 1) * COLUMNS / points);
+            float lo = INFINITY, hi = -INFINITY;
+            for (int i = begin; i < end; i++) {
+                int col = (frame.headColumn + i) % COLUMNS;
+                lo = std::min(lo, frame.minValues[track][col][c]);
+                hi = std::max(hi, frame.maxValues[track][col][c]);
+            }
+            pointMin[p] = toY(lo);
+            pointMax[p] = toY(hi);
+        }
+
+        nvgBeginPath(vg);
+        for (int p = 0; p < points; p++) {
+            float x = b.pos.x + b.size.x * p / (points - 1);
+            if (p == 0)
+                nvgMoveTo(vg, x, pointMax[p]);
+            else
+                nvgLineTo(vg, x, pointMax[p]);
+        }
+        for (int p = points - 1; p >= 0; p--) {
+            float x = b.pos.x + b.size.x * p / (points - 1);
+            nvgLineTo(vg, x, pointMin[p]);
+        }
+        nvgClosePath(vg);
+
+        nvgFillColor(vg, nvgTransRGBAf(color, 0.35f));
+        nvgFill(vg);
+        nvgStrokeColor(vg, color);
+        nvgStrokeWidth(vg, strokeWidth * 0.5f);
+        nvgLineJoin(vg, NVG_ROUND);
+        nvgStroke(vg);
+    }
+}
+
+/**
+ * 示波器畫面快取
+ * 畫布（子 Widget）的 draw() 只在 setDirty() 後重新執行並鑲嵌路徑，
+ * 其餘幀直接貼上 framebuffer。layer = 1 時畫在發光層（與 LedDisplay 示波器相同），
+ * layer = 0 時畫在一般 draw()。
+ */
+struct ScopeFramebuffer : widget::FramebufferWidget {
+    int layer = 1;
+
+    void draw(const DrawArgs& args) override {
+        if (layer == 0)
+            FramebufferWidget::draw(args);
+    }
+
+    void drawLayer(const DrawArgs& args, int l) override {
+        if (layer != 0 && l == layer)
+            FramebufferWidget::draw(args);
+    }
+};
+
+/**
+ * 把示波器畫布包進 ScopeFramebuffer（位置與大小沿用畫布）
+ */
+inline ScopeFramebuffer* createScopeFramebuffer(widget::Widget* canvas, int layer = 1) {
+    ScopeFramebuffer* fb = new ScopeFramebuffer;
+    fb->layer = layer;
+    fb->box = canvas->box;
+    canvas->box.pos = Vec(0, 0);
+    fb->addChild(canvas);
+    return fb;
+}
+
+/**
+ * 畫布在 step() 中呼叫：通知外層 framebuffer 重畫
+ */
+inline void markScopeDirty(widget::Widget* canvas) {
+    if (widget::FramebufferWidget* fb = dynamic_cast<widget::FramebufferWidget*>(canvas->parent))
+        fb->setDirty();
+}
+
+/**
+ * 軌道顏色快取：顏色（接線顏色）改變時回傳 true
+ */
+template <int N>
+struct ScopeTrackColors {
+    NVGcolor colors[N] = {};
+
+    bool set(int index, NVGcolor color) {
+        NVGcolor& c = colors[index];
+        if (c.r == color.r && c.g == color.g && c.b == color.b && c.a == color.a) return false;
+        c = color;
+        return true;
+    }
+};
+
+} // namespace widgets
+} // namespace madzine
@@ -0,0 +1,273 @@
+// ============================================================
+// MultiInstanceStress - 多實例並行壓力測試（KNOWN_ISSUES ISSUE-F002）
+// ============================================================
+//
+// 同一份輸入下，N 個實例先在單一執行緒逐樣本輪流執行（與 Rack 單執行緒引擎相同）
+// 取得參考輸出，再讓 N 個新實例各自在一條 std::thread 上同時執行，
+// 逐樣本比對：任何實例間共用的可變狀態都會讓輸出與參考不同。
+//
+// - EllenRipley：透過外掛的 Model 建立完整模組（chaos S&H、grain、reverb 全開）
+// - UniRhythm：模組內的 pattern / humanize / 噪音產生器以 std::random_device 播種，
+//   輸出本來就不可重現，因此測試它的鼓聲合成核心（MinimalVoice，Sine 模式），
+//   並與模組相同，在各自第一次 process 時設定取樣率
+//
+// 建置與執行（需先建置外掛）：make stress && ./build/stress [實例數] [樣本數]
+
+#include "../src/plugin.hpp"
+#include "../src/WorldRhythm/MinimalDrumSynth.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Options {
+    int instances = 8;
+    int frames = 48000 * 4;
+};
+
+// ---- 共用工具 ----
+
+int findParam(engine::Module* m, const char* name) {
+    for (int i = 0; i < (int)m->paramQuantities.size(); i++) {
+        if (m->paramQuantities[i] && m->paramQuantities[i]->name == name) return i;
+    }
+    std::fprintf(stderr, "param not found: %s\n", name);
+    std::exit(2);
+}
+
+int findInput(engine::Module* m, const char* name) {
+    for (int i = 0; i < (int)m->inputInfos.size(); i++) {
+        if (m->inputInfos[i] && m->inputInfos[i]->name == name) return i;
+    }
+    std::fprintf(stderr, "input not found: %s\n", name);
+    std::exit(2);
+}
+
+// 所有實例共用的確定性測試訊號
+float testSignal(int frame, float sampleRate) {
+    float t = frame / sampleRate;
+    float burst = (frame % 12000) < 2400 ? 1.0f : 0.1f;
+    return 5.0f * burst * std::sin(2.0f * (float)M_PI * 220.0f * t);
+}
+
+// 每個 worker 一條執行緒，全部就緒後同時開始
+template <typename F>
+void runThreads(int count, F fn) {
+    std::atomic<int> ready{0};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < count; i++) {
+        threads.emplace_back([&, i]() {
+            ready++;
+            while (ready.load() < count) std::this_thread::yield();
+            fn(i);
+        });
+    }
+    for (std::thread& t : threads) t.join();
+}
+
+// 比對 N 組輸出與參考，回傳不一致的實例數
+int compare(const char* label, const std::vector<float>& reference,
+            const std::vector<std::vector<float>>& outputs) {
+    int failures = 0;
+    for (int i = 0; i < (int)outputs.size(); i++) {
+        const std::vector<float>& out = outputs[i];
+        for (size_t s = 0; s < reference.size(); s++) {
+            if (std::memcmp(&out[s], &reference[s], sizeof(float)) != 0) {
+                std::printf("  %s instance %d: first mismatch at value %zu (%g != %g)\n",
+                            label, i, s, out[s], reference[s]);
+                failures++;
+                break;
+            }
+        }
+    }
+    return failures;
+}
+
+// ---- EllenRipley：完整模組 ----
+
+struct RipleyRunner {
+    static constexpr int OUTPUTS = 3;  // Left, Right, Chaos CV
+    engine::Module* module = nullptr;
+    int leftIn = 0;
+    int rightIn = 0;
+    std::vector<float> out;
+    float sampleRate = 48000.0f;
+
+    void create(int frames) {
+        // 每個實例以相同的種子建立，grain 的 xorshift 種子因此相同
+        random::local().seed(0x1234, 0x5678);
+        module = modelEllenRipley->createModule();
+        sampleRate = APP->engine->getSampleRate();
+
+        leftIn = findInput(module, "Left Audio");
+        rightIn = findInput(module, "Right Audio");
+        module->inputs[leftIn].setChannels(1);
+        module->inputs[rightIn].setChannels(1);
+
+        // chaos S&H（Shape）與三個 chaos 調變都開啟，三段 wet/dry 都拉到一半
+        module->params[findParam(module, "Chaos Shape")].setValue(1.0f);
+        module->params[findParam(module, "Chaos Rate")].setValue(0.7f);
+        module->params[findParam(module, "Delay Chaos")].setValue(1.0f);
+        module->params[findParam(module, "Grain Chaos")].setValue(1.0f);
+        module->params[findParam(module, "Reverb Chaos")].setValue(1.0f);
+        module->params[findParam(module, "Delay Wet/Dry")].setValue(0.5f);
+        module->params[findParam(module, "Gratch Wet/Dry")].setValue(0.5f);
+        module->params[findParam(module, "Reverb Wet/Dry")].setValue(0.5f);
+
+        out.assign((size_t)frames * OUTPUTS, 0.0f);
+    }
+
+    void step(int frame) {
+        float x = testSignal(frame, sampleRate);
+        module->inputs[leftIn].setVoltage(x);
+        module->inputs[rightIn].setVoltage(-0.5f * x);
+
+        engine::Module::ProcessArgs args;
+        args.sampleRate = sampleRate;
+        args.sampleTime = 1.0f / sampleRate;
+        args.frame = frame;
+        module->process(args);
+
+        for (int o = 0; o < OUTPUTS; o++) {
+            out[(size_t)frame * OUTPUTS + o] = module->outputs[o].getVoltage(0);
+        }
+    }
+
+    void destroy() {
+        delete module;
+        module = nullptr;
+    }
+};
+
+int testEllenRipley(const Options& opt) {
+    std::printf("EllenRipley: %d instances x %d frames\n", opt.instances, opt.frames);
+
+    // 單執行緒：逐樣本輪流執行所有實例
+    std::vector<RipleyRunner> serial(opt.instances);
+    for (RipleyRunner& r : serial) r.create(opt.frames);
+    for (int f = 0; f < opt.frames; f++) {
+        for (RipleyRunner& r : serial) r.step(f);
+    }
+
+    std::vector<float> reference = serial[0].out;
+    std::vector<std::vector<float>> serialOut;
+    for (RipleyRunner& r : serial) {
+        serialOut.push_back(r.out);
+        r.destroy();
+    }
+
+    // 多執行緒：每條執行緒一個實例
+    std::vector<RipleyRunner> threaded(opt.instances);
+    for (RipleyRunner& r : threaded) r.create(opt.frames);
+    Context* context = contextGet();
+    runThreads(opt.instances, [&](int i) {
+        contextSet(context);
+        for (int f = 0; f < opt.frames; f++) threaded[i].step(f);
+    });
+
+    std::vector<std::vector<float>> threadedOut;
+    for (RipleyRunner& r : threaded) {
+        threadedOut.push_back(r.out);
+        r.destroy();
+    }
+
+    int failures = compare("serial", reference, serialOut)
+                 + compare("threaded", reference, threadedOut);
+    std::printf("  %s\n", failures ? "FAIL" : "ok");
+    return failures;
+}
+
+// ---- UniRhythm：鼓聲合成核心 ----
+
+struct DrumRunner {
+    static constexpr int VOICES = 4;
+    worldrhythm::MinimalVoice voices[VOICES];
+    bool sampleRateInitialized = false;
+    std::vector<float> out;
+    float sampleRate = 48000.0f;
+
+    void create(int frames, float sr) {
+        sampleRate = sr;
+        const float freqs[VOICES] = {55.0f, 110.0f, 440.0f, 1320.0f};
+        for (int v = 0; v < VOICES; v++) {
+            voices[v].setMode(worldrhythm::SynthMode::SINE);
+            voices[v].setFreq(freqs[v]);
+            voices[v].setDecay(80.0f + 60.0f * v);
+            voices[v].setSweep(v == 0 ? 120.0f : 0.0f);
+        }
+        out.assign((size_t)frames * VOICES, 0.0f);
+    }
+
+    void step(int frame) {
+        // 與 UniRhythm::process 相同：第一次執行時設定本實例的取樣率
+        if (!sampleRateInitialized) {
+            for (int v = 0; v < VOICES; v++) voices[v].setSampleRate(sampleRate);
+            sampleRateInitialized = true;
+        }
+        // 16 分音符（120 BPM）輪流觸發各聲部，力度依步數變化
+        int stepLength = (int)(sampleRate / 8.0f);
+        if (frame % stepLength == 0) {
+            int n = frame / stepLength;
+            voices[n % VOICES].trigger(0.4f + 0.15f * (n % 5));
+        }
+        for (int v = 0; v < VOICES; v++) {
+            out[(size_t)frame * VOICES + v] = voices[v].process();
+        }
+    }
+};
+
+int testUniRhythm(const Options& opt) {
+    std::printf("UniRhythm drum synth: %d instances x %d frames\n", opt.instances, opt.frames);
+    float sampleRate = APP->engine->getSampleRate();
+
+    std::vector<DrumRunner> serial(opt.instances);
+    for (DrumRunner& r : serial) r.create(opt.frames, sampleRate);
+    for (int f = 0; f < opt.frames; f++) {
+        for (DrumRunner& r : serial) r.step(f);
+    }
+
+    std::vector<float> reference = serial[0].out;
+    std::vector<std::vector<float>> serialOut;
+    for (DrumRunner& r : serial) serialOut.push_back(r.out);
+
+    std::vector<DrumRunner> threaded(opt.instances);
+    for (DrumRunner& r : threaded) r.create(opt.frames, sampleRate);
+    runThreads(opt.instances, [&](int i) {
+        for (int f = 0; f < opt.frames; f++) threaded[i].step(f);
+    });
+
+    std::vector<std::vector<float>> threadedOut;
+    for (DrumRunner& r : threaded) threadedOut.push_back(r.out);
+
+    int failures = compare("serial", reference, serialOut)
+                 + compare("threaded", reference, threadedOut);
+    std::printf("  %s\n", failures ? "FAIL" : "ok");
+    return failures;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (argc > 1) opt.instances = std::max(1, std::atoi(argv[1]));
+    if (argc > 2) opt.frames = std::max(1, std::atoi(argv[2]));
+
+    // 模組建構子需要 APP->engine（取樣率）；不啟動音訊裝置
+    random::init();
+    contextSet(new Context);
+    APP->engine = new engine::Engine;
+
+    int failures = testEllenRipley(opt) + testUniRhythm(opt);
+    if (failures) {
+        std::printf("FAILED (%d)\n", failures);
+        return 1;
+    }
+    std::printf("PASSED\n");
+    return 0;
+}